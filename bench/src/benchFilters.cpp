@@ -0,0 +1,118 @@
+#include "benchmark/benchmark.h"
+
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "log.h"
+#include "mockPlatform.h"
+#include "scene/dataLayer.h"
+#include "scene/filterProgram.h"
+#include "scene/filters.h"
+#include "scene/scene.h"
+#include "scene/sceneLayer.h"
+#include "scene/styleContext.h"
+#include "tile/tile.h"
+#include "tile/tileTask.h"
+
+#include <algorithm>
+
+#define RUN(FIXTURE, NAME)                                              \
+    BENCHMARK_DEFINE_F(FIXTURE, NAME)(benchmark::State& st) { while (st.KeepRunning()) { run(); } } \
+    BENCHMARK_REGISTER_F(FIXTURE, NAME);
+
+using namespace Tangram;
+
+const char scene_file[] = "res/scene.yaml";
+const char tile_file[] = "res/tile.mvt";
+
+std::shared_ptr<Scene> scene;
+std::shared_ptr<TileSource> source;
+std::shared_ptr<TileData> tileData;
+MockPlatform platform;
+
+void globalSetup() {
+    static std::atomic<bool> initialized{false};
+    if (initialized.exchange(true)) { return; }
+
+    SceneOptions sceneOptions{platform.resolveUrl(Url(scene_file))};
+    sceneOptions.numTileWorkers = 0;
+    sceneOptions.prefetchTiles = false;
+
+    scene = std::make_shared<Scene>(platform, std::move(sceneOptions));
+    if (!scene->load()) { exit(-1); }
+
+    for (auto& s : scene->tileSources()) {
+        source = s;
+        if (source->generateGeometry()) { break; }
+    }
+    // Decode all features upfront, only filter evaluation is measured
+    source->setLazyDecoding(false);
+
+    Tile tile({0,0,10,10});
+    auto task = source->createTask(tile.getID());
+    auto& t = dynamic_cast<BinaryTileTask&>(*task);
+
+    auto rawTileData = MockPlatform::getBytesFromFile(tile_file);
+    t.rawTileData = std::make_shared<std::vector<char>>(rawTileData);
+    tileData = source->parse(*task);
+    if (!tileData) {
+        LOGE("Invalid tile file '%s'", tile_file);
+        exit(-1);
+    }
+}
+
+// Evaluate the filters of all scene layers against all features of the tile, descending into
+// sublayers of matching layers like DrawRuleMergeSet::match
+template<bool compiled>
+class FilterFixture : public benchmark::Fixture {
+public:
+    StyleContext ctx;
+    uint32_t matches = 0;
+
+    void SetUp(const ::benchmark::State& state) override {
+        globalSetup();
+        ctx.initFunctions(*scene);
+        ctx.setTileID({0, 0, 10, 10});
+    }
+    void TearDown(const ::benchmark::State& state) override {
+        LOG(">>> %d", matches);
+    }
+
+    bool eval(const SceneLayer& _layer, const Feature& _feature) {
+        return compiled
+            ? _layer.filterProgram().eval(_feature, ctx)
+            : _layer.filter().eval(_feature, ctx);
+    }
+
+    void match(const SceneLayer& _layer, const Feature& _feature) {
+        if (!eval(_layer, _feature)) { return; }
+        matches++;
+        for (const auto& sublayer : _layer.sublayers()) {
+            match(sublayer, _feature);
+        }
+    }
+
+    __attribute__ ((noinline)) void run() {
+        for (const auto& datalayer : scene->layers()) {
+            for (const auto& collection : tileData->layers) {
+                if (!collection.name.empty()) {
+                    const auto& dlc = datalayer.collections();
+                    if (std::find(dlc.begin(), dlc.end(), collection.name) == dlc.end()) {
+                        continue;
+                    }
+                }
+                for (const auto& feature : collection.features) {
+                    ctx.setFeature(feature);
+                    match(datalayer, feature);
+                }
+            }
+        }
+    }
+};
+
+using FilterTreeFixture = FilterFixture<false>;
+RUN(FilterTreeFixture, FilterTreeBench)
+
+using FilterProgramFixture = FilterFixture<true>;
+RUN(FilterProgramFixture, FilterProgramBench)
+
+BENCHMARK_MAIN();
@@ -0,0 +1,70 @@
+#include "benchmark/benchmark.h"
+
+#include "map.h"
+#include "marker/markerManager.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "view/view.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+const char scene_yaml[] = "{}";
+
+// Number of polyline markers on the map
+const int numMarkers = 1000;
+
+std::unique_ptr<Scene> scene;
+MockPlatform platform;
+View view(256, 256);
+
+void globalSetup() {
+    static std::atomic<bool> initialized{false};
+    if (initialized.exchange(true)) { return; }
+
+    SceneOptions sceneOptions{scene_yaml, Url()};
+    sceneOptions.numTileWorkers = 0;
+    sceneOptions.prefetchTiles = false;
+
+    scene = std::make_unique<Scene>(platform, std::move(sceneOptions));
+    if (!scene->load() || !scene->completeScene(view)) { exit(-1); }
+    view.setZoom(10);
+
+    auto& markers = *scene->markerManager();
+    for (int i = 0; i < numMarkers; i++) {
+        std::vector<LngLat> line = { { i * 0.001, 0 }, { i * 0.001, 0.01 }, { i * 0.001 + 0.01, 0.01 } };
+        MarkerID id = markers.add();
+        markers.setPolyline(id, line.data(), line.size());
+        markers.setStylingFromString(id, "{ style: lines, color: red, width: 2px, order: 100 }");
+    }
+    markers.update(view, 0.f, view.update());
+}
+
+class MarkerManagerFixture : public benchmark::Fixture {
+public:
+    void SetUp(const ::benchmark::State& state) override {
+        globalSetup();
+    }
+
+    // One frame, in which the view moved when @_viewChanged is set
+    void run(bool _viewChanged) {
+        if (_viewChanged) {
+            view.translate(1, 0);
+            view.update();
+        }
+        benchmark::DoNotOptimize(scene->markerManager()->update(view, 0.016f, _viewChanged));
+    }
+};
+
+BENCHMARK_DEFINE_F(MarkerManagerFixture, IdleFrameBench)(benchmark::State& st) {
+    while (st.KeepRunning()) { run(false); }
+}
+BENCHMARK_REGISTER_F(MarkerManagerFixture, IdleFrameBench);
+
+BENCHMARK_DEFINE_F(MarkerManagerFixture, ViewChangedFrameBench)(benchmark::State& st) {
+    while (st.KeepRunning()) { run(true); }
+}
+BENCHMARK_REGISTER_F(MarkerManagerFixture, ViewChangedFrameBench);
+
+BENCHMARK_MAIN();
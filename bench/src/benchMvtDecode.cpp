@@ -0,0 +1,139 @@
+#include "benchmark/benchmark.h"
+
+#include "data/formats/mvt.h"
+#include "log.h"
+#include "mockPlatform.h"
+#include "pbf/pbf.hpp"
+
+#include <atomic>
+#include <vector>
+
+#define RUN(FIXTURE, NAME)                                              \
+    BENCHMARK_DEFINE_F(FIXTURE, NAME)(benchmark::State& st) { while (st.KeepRunning()) { run(); } } \
+    BENCHMARK_REGISTER_F(FIXTURE, NAME);
+
+using namespace Tangram;
+
+const char tile_file[] = "res/tile.mvt";
+
+#define LAYER 3
+#define LAYER_FEATURE 2
+#define LAYER_TILE_EXTENT 5
+#define FEATURE_TAGS 2
+#define FEATURE_GEOM 4
+
+std::vector<char> rawTileData;
+// Packed tag and geometry messages of all features in the tile
+std::vector<protobuf::message> tagMsgs;
+std::vector<protobuf::message> geometryMsgs;
+int tileExtent = 4096;
+
+void globalSetup() {
+    static std::atomic<bool> initialized{false};
+    if (initialized.exchange(true)) { return; }
+
+    rawTileData = MockPlatform::getBytesFromFile(tile_file);
+    if (rawTileData.empty()) {
+        LOGE("Invalid tile file '%s'", tile_file);
+        exit(-1);
+    }
+
+    protobuf::message item(rawTileData.data(), rawTileData.size());
+    while (item.next()) {
+        if (item.tag != LAYER) { item.skip(); continue; }
+
+        protobuf::message layer = item.getMessage();
+        while (layer.next()) {
+            if (layer.tag == LAYER_TILE_EXTENT) {
+                tileExtent = static_cast<int>(layer.int64());
+                continue;
+            }
+            if (layer.tag != LAYER_FEATURE) { layer.skip(); continue; }
+
+            protobuf::message feature = layer.getMessage();
+            while (feature.next()) {
+                if (feature.tag == FEATURE_TAGS) {
+                    tagMsgs.push_back(feature.getMessage());
+                } else if (feature.tag == FEATURE_GEOM) {
+                    geometryMsgs.push_back(feature.getMessage());
+                } else {
+                    feature.skip();
+                }
+            }
+        }
+    }
+    LOG("%d tag and %d geometry messages", int(tagMsgs.size()), int(geometryMsgs.size()));
+}
+
+// Decode all packed tags and geometries with one varint() call per value
+class VarintFixture : public benchmark::Fixture {
+public:
+    uint64_t sum = 0;
+
+    void SetUp(const ::benchmark::State& state) override {
+        globalSetup();
+    }
+    void TearDown(const ::benchmark::State& state) override {
+        LOG(">>> %llu", (unsigned long long)sum);
+    }
+
+    __attribute__ ((noinline)) void run() {
+        for (auto* msgs : { &tagMsgs, &geometryMsgs }) {
+            for (auto msg : *msgs) {
+                while (msg) { sum += msg.varint(); }
+            }
+        }
+    }
+};
+RUN(VarintFixture, VarintBench)
+
+// Decode all packed tags and geometries with message::varints()
+class PackedVarintFixture : public benchmark::Fixture {
+public:
+    uint64_t sum = 0;
+    std::vector<uint64_t> values;
+
+    void SetUp(const ::benchmark::State& state) override {
+        globalSetup();
+    }
+    void TearDown(const ::benchmark::State& state) override {
+        LOG(">>> %llu", (unsigned long long)sum);
+    }
+
+    __attribute__ ((noinline)) void run() {
+        for (auto* msgs : { &tagMsgs, &geometryMsgs }) {
+            for (auto msg : *msgs) {
+                size_t max = msg.getEnd() - msg.getData();
+                if (values.size() < max) { values.resize(max); }
+                size_t n = msg.varints(values.data(), max);
+                for (size_t i = 0; i < n; i++) { sum += values[i]; }
+            }
+        }
+    }
+};
+RUN(PackedVarintFixture, PackedVarintBench)
+
+// Decode and scale all feature geometries
+class MvtGeometryFixture : public benchmark::Fixture {
+public:
+    Mvt::ParserContext ctx{0};
+    size_t coordinates = 0;
+
+    void SetUp(const ::benchmark::State& state) override {
+        globalSetup();
+        ctx.tileExtent = tileExtent;
+    }
+    void TearDown(const ::benchmark::State& state) override {
+        LOG(">>> %d", int(coordinates));
+    }
+
+    __attribute__ ((noinline)) void run() {
+        for (auto& msg : geometryMsgs) {
+            Mvt::getGeometry(ctx, msg);
+            coordinates += ctx.geometry.coordinates.size();
+        }
+    }
+};
+RUN(MvtGeometryFixture, MvtGeometryBench)
+
+BENCHMARK_MAIN();
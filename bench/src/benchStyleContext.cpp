@@ -49,6 +49,9 @@ void globalSetup() {
         source = s;
         if (source->generateGeometry()) { break; }
     }
+    // Features are iterated directly from TileData::layers
+    source->setLazyDecoding(false);
+
     Tile tile({0,0,10,10});
     auto task = source->createTask(tile.getID());
     auto& t = dynamic_cast<BinaryTileTask&>(*task);
@@ -44,5 +44,20 @@ BENCHMARK_DEFINE_F(TileSourceFixture, TileSourceBench)(benchmark::State& st) {
 }
 BENCHMARK_REGISTER_F(TileSourceFixture, TileSourceBench);
 
+// Decode all layers and features up front, as done before lazy decoding
+BENCHMARK_DEFINE_F(TileSourceFixture, TileSourceEagerBench)(benchmark::State& st) {
+    source->setLazyDecoding(false);
+    while (st.KeepRunning()) {
+
+        tileData = source->parse(*tileTask);
+
+        if (!tileData) {
+            LOGE("Invalid tile file '%s'", tile_file);
+            exit(-1);
+        }
+    }
+}
+BENCHMARK_REGISTER_F(TileSourceFixture, TileSourceEagerBench);
+
 
 BENCHMARK_MAIN();
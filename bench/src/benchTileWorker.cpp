@@ -0,0 +1,91 @@
+#include "benchmark/benchmark.h"
+
+#include "data/tileSource.h"
+#include "log.h"
+#include "map.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "tile/tile.h"
+#include "tile/tileTask.h"
+#include "tile/tileWorker.h"
+
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+const char scene_file[] = "res/scene.yaml";
+const char tile_file[] = "res/tile.mvt";
+
+// Number of tiles built per iteration
+const int numTasks = 64;
+
+std::shared_ptr<Scene> scene;
+std::shared_ptr<TileSource> source;
+std::shared_ptr<std::vector<char>> rawTileData;
+MockPlatform platform;
+
+void globalSetup() {
+    static std::atomic<bool> initialized{false};
+    if (initialized.exchange(true)) { return; }
+
+    SceneOptions sceneOptions{platform.resolveUrl(Url(scene_file))};
+    sceneOptions.numTileWorkers = 0;
+    sceneOptions.prefetchTiles = false;
+
+    scene = std::make_shared<Scene>(platform, std::move(sceneOptions));
+    if (!scene->load()) { exit(-1); }
+
+    for (auto& s : scene->tileSources()) {
+        source = s;
+        if (source->generateGeometry()) { break; }
+    }
+
+    rawTileData = std::make_shared<std::vector<char>>(MockPlatform::getBytesFromFile(tile_file));
+    if (rawTileData->empty()) {
+        LOGE("Invalid tile file '%s'", tile_file);
+        exit(-1);
+    }
+}
+
+class TileWorkerFixture : public benchmark::Fixture {
+public:
+    std::unique_ptr<TileWorker> tileWorker;
+
+    void SetUp(const ::benchmark::State& state) override {
+        globalSetup();
+        tileWorker = std::make_unique<TileWorker>(platform, state.range(0));
+        tileWorker->setScene(*scene);
+        tileWorker->startJobs();
+    }
+    void TearDown(const ::benchmark::State& state) override {
+        tileWorker->stop();
+        tileWorker.reset();
+    }
+
+    void run() {
+        std::vector<std::shared_ptr<TileTask>> tasks;
+        for (int i = 0; i < numTasks; i++) {
+            auto task = source->createTask({i, 0, 10});
+            // Same tile data for each task, varying priorities
+            static_cast<BinaryTileTask&>(*task).rawTileData = rawTileData;
+            task->setPriority((i * 7919) % numTasks);
+            tasks.push_back(task);
+            tileWorker->enqueue(task);
+        }
+        for (auto& task : tasks) {
+            while (!task->isReady() && !task->isCanceled()) { std::this_thread::yield(); }
+        }
+    }
+};
+
+BENCHMARK_DEFINE_F(TileWorkerFixture, TileWorkerBench)(benchmark::State& st) {
+    while (st.KeepRunning()) { run(); }
+    st.SetItemsProcessed(st.iterations() * numTasks);
+}
+BENCHMARK_REGISTER_F(TileWorkerFixture, TileWorkerBench)
+    ->DenseRange(1, std::max(1u, std::thread::hardware_concurrency()))
+    ->UseRealTime();
+
+
+BENCHMARK_MAIN();
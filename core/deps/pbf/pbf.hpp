@@ -14,6 +14,20 @@
 #include <cstring>
 #include <cassert>
 
+// Block decoding of packed varints, see message::varints()
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define PBF_SIMD_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define PBF_SIMD_SHUFFLE 1
+#endif
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PBF_SIMD_NEON 1
+#define PBF_SIMD_SHUFFLE 1
+#endif
+
 #undef LIKELY
 #undef UNLIKELY
 
@@ -50,6 +64,8 @@ public:
     PBF_INLINE uint64_t varint();
     PBF_INLINE uint64_t varint2();
     PBF_INLINE int64_t svarint();
+    PBF_INLINE std::size_t varints(uint64_t* out, std::size_t max);
+    PBF_INLINE static int64_t zigzag(uint64_t n);
     PBF_INLINE std::string string();
     PBF_INLINE float float32();
     PBF_INLINE double float64();
@@ -141,12 +157,211 @@ uint64_t message::varint2() {
   return val;
 }
 
-int64_t message::svarint()
+int64_t message::zigzag(uint64_t n)
 {
-    uint64_t n = varint();
     return (n >> 1) ^ -static_cast<int64_t>((n & 1));
 }
 
+int64_t message::svarint()
+{
+    return zigzag(varint());
+}
+
+#if defined(PBF_SIMD_SSE2) || defined(PBF_SIMD_NEON)
+
+// Bit i is set when byte i of the 16 byte block has its continuation bit set
+static FORCEINLINE uint32_t continuationMask(const uint8_t* block)
+{
+#if defined(PBF_SIMD_SSE2)
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block))));
+#else
+    static const int8_t shifts[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+    uint8x16_t bits = vshlq_u8(vshrq_n_u8(vld1q_u8(block), 7), vld1q_s8(shifts));
+    return vaddv_u8(vget_low_u8(bits)) | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+#endif
+}
+
+// Zero-extend the 16 bytes of block, i.e. 16 single byte varints
+static FORCEINLINE void widenBytes(const uint8_t* block, uint64_t* out)
+{
+#if defined(PBF_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i words[2] = { _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero) };
+    for (int i = 0; i < 2; i++) {
+        __m128i lo = _mm_unpacklo_epi16(words[i], zero);
+        __m128i hi = _mm_unpackhi_epi16(words[i], zero);
+        __m128i* dst = reinterpret_cast<__m128i*>(out + 8 * i);
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi32(lo, zero));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi32(lo, zero));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi32(hi, zero));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi32(hi, zero));
+    }
+#else
+    uint8x16_t bytes = vld1q_u8(block);
+    uint16x8_t words[2] = { vmovl_u8(vget_low_u8(bytes)), vmovl_u8(vget_high_u8(bytes)) };
+    for (int i = 0; i < 2; i++) {
+        uint32x4_t lo = vmovl_u16(vget_low_u16(words[i]));
+        uint32x4_t hi = vmovl_u16(vget_high_u16(words[i]));
+        vst1q_u64(out + 8 * i + 0, vmovl_u32(vget_low_u32(lo)));
+        vst1q_u64(out + 8 * i + 2, vmovl_u32(vget_high_u32(lo)));
+        vst1q_u64(out + 8 * i + 4, vmovl_u32(vget_low_u32(hi)));
+        vst1q_u64(out + 8 * i + 6, vmovl_u32(vget_high_u32(hi)));
+    }
+#endif
+}
+
+#if defined(PBF_SIMD_SHUFFLE)
+
+// Byte shuffle gathering the varints of at most two bytes that end within the first 8 bytes of a
+// block into 16 bit lanes, indexed by the continuation bits of these 8 bytes
+struct VarintShuffle {
+    uint8_t indices[16];
+    uint8_t count;    // number of varints, 0 when a varint is longer than two bytes
+    uint8_t length;   // number of bytes taken by the varints
+};
+
+static inline const VarintShuffle* varintShuffles()
+{
+    static const struct Table {
+        VarintShuffle entries[256];
+        Table() {
+            for (uint32_t mask = 0; mask < 256; mask++) {
+                VarintShuffle& e = entries[mask];
+                std::memset(e.indices, 0x80, sizeof(e.indices));
+                uint8_t count = 0, start = 0;
+                bool valid = true;
+                for (uint8_t i = 0; i < 8; i++) {
+                    if (mask & (1u << i)) { continue; }
+                    if (i - start > 1) { valid = false; break; }
+                    e.indices[2 * count] = start;
+                    if (i > start) { e.indices[2 * count + 1] = i; }
+                    count++;
+                    start = i + 1;
+                }
+                e.count = valid ? count : 0;
+                e.length = valid ? start : 0;
+            }
+        }
+    } table;
+    return table.entries;
+}
+
+// Decode the varints selected by shuffle, always writes 8 values to out
+static FORCEINLINE void shuffleVarints(const uint8_t* block, const VarintShuffle& shuffle, uint64_t* out)
+{
+#if defined(PBF_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i words = _mm_shuffle_epi8(bytes, _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.indices)));
+    // low 7 bits from the first byte, the second byte shifted by 7
+    __m128i values = _mm_or_si128(_mm_and_si128(words, _mm_set1_epi16(0x007f)),
+                                  _mm_srli_epi16(_mm_and_si128(words, _mm_set1_epi16(0x7f00)), 1));
+    __m128i lo = _mm_unpacklo_epi16(values, zero);
+    __m128i hi = _mm_unpackhi_epi16(values, zero);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+    _mm_storeu_si128(dst + 0, _mm_unpacklo_epi32(lo, zero));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi32(lo, zero));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi32(hi, zero));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi32(hi, zero));
+#else
+    uint16x8_t words = vreinterpretq_u16_u8(vqtbl1q_u8(vld1q_u8(block), vld1q_u8(shuffle.indices)));
+    uint16x8_t values = vorrq_u16(vandq_u16(words, vdupq_n_u16(0x007f)),
+                                  vshrq_n_u16(vandq_u16(words, vdupq_n_u16(0x7f00)), 1));
+    uint32x4_t lo = vmovl_u16(vget_low_u16(values));
+    uint32x4_t hi = vmovl_u16(vget_high_u16(values));
+    vst1q_u64(out + 0, vmovl_u32(vget_low_u32(lo)));
+    vst1q_u64(out + 2, vmovl_u32(vget_high_u32(lo)));
+    vst1q_u64(out + 4, vmovl_u32(vget_low_u32(hi)));
+    vst1q_u64(out + 6, vmovl_u32(vget_high_u32(hi)));
+#endif
+}
+
+#endif
+
+#endif
+
+// Decode consecutive varints until max values are read or the end of the message is reached,
+// returns the number of values written to out. Values are the same as from repeated varint() calls.
+std::size_t message::varints(uint64_t* out, std::size_t max)
+{
+    std::size_t n = 0;
+
+#if defined(PBF_SIMD_SSE2) || defined(PBF_SIMD_NEON)
+    while (n < max && data_ < end_) {
+        const uint8_t* block = reinterpret_cast<const uint8_t*>(data_);
+        std::size_t available = static_cast<std::size_t>(end_ - data_);
+        uint32_t valid = 0xffff;
+
+        // Copy the last bytes of the message to not read past its end
+        uint8_t tail[16] = {};
+        if (available < 16) {
+            std::memcpy(tail, data_, available);
+            block = tail;
+            valid = (1u << available) - 1;
+        }
+
+        uint32_t mask = continuationMask(block);
+
+        if (mask == 0 && valid == 0xffff && max - n >= 16) {
+            widenBytes(block, out + n);
+            data_ += 16;
+            n += 16;
+            continue;
+        }
+
+#if defined(PBF_SIMD_SHUFFLE)
+        // The 8 bytes read by the shuffle are within the message
+        if (available >= 8 && max - n >= 8) {
+            const VarintShuffle& shuffle = varintShuffles()[mask & 0xff];
+            if (shuffle.count > 0) {
+                shuffleVarints(block, shuffle, out + n);
+                data_ += shuffle.length;
+                n += shuffle.count;
+                continue;
+            }
+        }
+#endif
+
+        // Decode the varints ending within the block: bit i of stops marks the last byte of one
+        uint32_t stops = ~mask & valid;
+        uint32_t pos = 0;
+        while (stops != 0 && n < max) {
+            uint32_t last = static_cast<uint32_t>(__builtin_ctz(stops));
+            uint32_t length = last + 1 - pos;
+
+            if (length <= 2) {
+                // Branchless for the common one and two byte varints: block[last] == block[pos]
+                // when length is one and is masked out
+                uint64_t high = static_cast<uint64_t>(block[last]) << 7;
+                out[n++] = (block[pos] & 0x7f) | (high & (0 - static_cast<uint64_t>(length - 1)));
+            } else if (length <= 9) {
+                uint64_t result = 0;
+                for (uint32_t i = 0; i < length; i++) {
+                    result |= static_cast<uint64_t>(block[pos + i] & 0x7f) << (7 * i);
+                }
+                out[n++] = result;
+            } else {
+                break;
+            }
+            pos = last + 1;
+            stops &= stops - 1;
+        }
+        data_ += pos;
+
+        if (pos == 0 && n < max) {
+            // Varint longer than 9 bytes or not terminated before the end of the message
+            out[n++] = varint();
+        }
+    }
+#endif
+
+    while (n < max && data_ < end_) {
+        out[n++] = varint();
+    }
+    return n;
+}
+
 std::string message::string()
 {
     uint64_t len = varint();
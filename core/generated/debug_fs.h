@@ -0,0 +1,9 @@
+const static char* debug_fs = R"RAW_GLSL(
+#ifdef GL_ES
+precision highp float;
+#endif
+varying vec4 v_color;
+void main() {
+    gl_FragColor = v_color;
+}
+)RAW_GLSL";
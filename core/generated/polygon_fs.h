@@ -0,0 +1,77 @@
+const static char* polygon_fs = R"RAW_GLSL(
+#pragma tangram: extensions
+#ifdef GL_ES
+precision highp float;
+#endif
+#pragma tangram: defines
+uniform mat4 u_model;
+uniform mat4 u_view;
+uniform mat4 u_proj;
+uniform mat3 u_normal_matrix;
+uniform vec4 u_tile_origin;
+uniform vec3 u_map_position;
+uniform vec2 u_resolution;
+uniform float u_time;
+uniform float u_meters_per_pixel;
+uniform float u_device_pixel_ratio;
+uniform mat3 u_inverse_normal_matrix;
+#pragma tangram: uniforms
+varying vec4 v_world_position;
+varying vec4 v_position;
+varying vec3 v_normal;
+#ifdef TANGRAM_RASTER_STYLE
+    uniform vec4 u_color;
+#else
+    varying vec4 v_color;
+#endif
+#ifdef TANGRAM_USE_TEX_COORDS
+    varying vec2 v_texcoord;
+#endif
+#ifdef TANGRAM_LIGHTING_VERTEX
+    varying vec4 v_lighting;
+#endif
+vec4 worldPosition() {
+    return v_world_position;
+}
+vec3 worldNormal() {
+    return normalize(u_inverse_normal_matrix * v_normal);
+}
+#ifdef TANGRAM_MODEL_POSITION_BASE_ZOOM_VARYING
+    varying vec4 v_modelpos_base_zoom;
+#endif
+#pragma tangram: material
+#pragma tangram: lighting
+#pragma tangram: raster
+#pragma tangram: global
+#ifndef TANGRAM_CUSTOM_MAIN
+void main(void) {
+    #pragma tangram: setup
+    #ifdef TANGRAM_RASTER_STYLE
+        vec4 color = u_color;
+    #else
+        vec4 color = v_color;
+    #endif
+    vec3 normal = v_normal;
+    #ifdef TANGRAM_RASTER_TEXTURE_COLOR
+        color *= sampleRaster(0);
+    #endif
+    #ifdef TANGRAM_RASTER_TEXTURE_NORMAL
+        normal = normalize(sampleRaster(0).rgb * 2.0 - 1.0);
+    #endif
+    #ifdef TANGRAM_MATERIAL_NORMAL_TEXTURE
+        calculateNormal(normal);
+    #endif
+    #if !defined(TANGRAM_LIGHTING_VERTEX)
+        #pragma tangram: normal
+    #endif
+    #pragma tangram: color
+    #if defined(TANGRAM_LIGHTING_FRAGMENT)
+        color = calculateLighting(v_position.xyz, normal, color);
+    #elif defined(TANGRAM_LIGHTING_VERTEX)
+        color *= v_lighting;
+    #endif
+    #pragma tangram: filter
+    gl_FragColor = color;
+}
+#endif
+)RAW_GLSL";
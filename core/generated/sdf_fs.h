@@ -0,0 +1,46 @@
+const static char* sdf_fs = R"RAW_GLSL(
+#pragma tangram: extensions
+#ifdef GL_ES
+precision highp float;
+#define LOWP lowp
+#else
+#define LOWP
+#endif
+#pragma tangram: defines
+uniform sampler2D u_tex;
+uniform vec3 u_map_position;
+uniform vec4 u_tile_origin;
+uniform vec2 u_resolution;
+uniform float u_time;
+uniform float u_meters_per_pixel;
+uniform float u_device_pixel_ratio;
+uniform float u_max_stroke_width;
+uniform LOWP int u_pass;
+#pragma tangram: uniforms
+varying vec4 v_color;
+varying vec2 v_texcoords;
+varying float v_sdf_threshold;
+varying float v_alpha;
+varying float v_sdf_pixel;
+#pragma tangram: global
+void main(void) {
+    vec4 color = v_color;
+    float signed_distance = texture2D(u_tex, v_texcoords).r;
+    float add_smooth = 0.25;
+    float filter_width = (v_sdf_pixel * (0.5 + add_smooth));
+    float start = max(v_sdf_threshold - filter_width, 0.0);
+    float end = v_sdf_threshold + filter_width;
+    float alpha;
+    if (u_pass == 0) {
+        alpha = smoothstep(start, end, signed_distance);
+    } else {
+        float signed_distance_1_over_2 = 1.0 / (2.0 * signed_distance);
+        float smooth_signed_distance = pow(signed_distance, signed_distance_1_over_2);
+        alpha = smoothstep(start, end, smooth_signed_distance);
+    }
+    color.a *= v_alpha * alpha;
+    #pragma tangram: color
+    #pragma tangram: filter
+    gl_FragColor = color;
+}
+)RAW_GLSL";
@@ -0,0 +1,10 @@
+const static char* selection_fs = R"RAW_GLSL(
+
+#ifdef GL_ES
+precision highp float;
+#endif
+varying vec4 v_selection_color;
+void main(void) {
+    gl_FragColor = v_selection_color;
+}
+)RAW_GLSL";
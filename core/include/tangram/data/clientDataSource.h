@@ -3,6 +3,7 @@
 #include "data/tileSource.h"
 #include "util/types.h"
 
+#include <functional>
 #include <mutex>
 
 namespace Tangram {
@@ -47,6 +48,11 @@ public:
 
     // Add geometry from a GeoJSON string
     void addData(const std::string& _data);
+    void addData(const char* _data, size_t _size);
+
+    // Add geometry from GeoJSON read in chunks: _read fills the buffer and returns the number
+    // of bytes read, or 0 at the end of the input
+    void addData(const std::function<size_t(char* _buffer, size_t _size)>& _read);
 
     uint64_t addPointFeature(Properties&& properties, LngLat coordinates, uint64_t id = -1);
 
@@ -57,15 +63,28 @@ public:
     // set properties for existing feature
     void setProperties(uint64_t id, Properties&& properties);
 
+    // Move an existing point feature, keeping its properties
+    bool movePointFeature(uint64_t id, LngLat coordinates);
+
+    // Remove a single feature. Its id is not reused by features added later.
+    bool removeFeature(uint64_t id);
+
     // Remove all feature data.
     void clearFeatures();
 
-    // Transform added feature data into tiles.
+    // Transform added feature data into tiles. Only features added, changed or removed since
+    // the last call are re-indexed, and only tiles overlapping them are reloaded.
     void generateTiles();
 
     void loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override;
     std::shared_ptr<TileTask> createTask(TileID _tileId) override;
 
+    bool tileChanged(const TileID& _tileId, int64_t _generation) const override;
+
+    void setLiveGenerations(int64_t _oldest, int64_t _newest) override;
+
+    void clearData() override;
+
     //void cancelLoadingTile(TileTask& _task) override {}
 
     bool isClient() const override { return true; }
@@ -74,10 +93,18 @@ protected:
 
     std::shared_ptr<TileData> parse(const TileTask& _task) const override;
 
+    template<class ReadFeatures>
+    void addFeatures(ReadFeatures _readFeatures);
+
     struct Storage;
     std::unique_ptr<Storage> m_store;
 
+    // Changes for tileChanged(), guarded by m_mutexChanges
+    struct Changes;
+    std::unique_ptr<Changes> m_changes;
+
     mutable std::mutex m_mutexStore;
+    mutable std::mutex m_mutexChanges;
     bool m_hasPendingData = false;
     bool m_generateCentroids = false;
 
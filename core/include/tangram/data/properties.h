@@ -1,5 +1,7 @@
 #pragma once
 
+#include "data/propertyKey.h"
+
 #include <string>
 #include <vector>
 
@@ -23,41 +25,50 @@ struct Properties {
     Properties& operator=(const Properties& _other) = default;
     Properties& operator=(Properties&& _other);
 
-    const Value& get(const std::string& key) const;
+    // Items are sorted by key id, lookup is a binary search over integers
+    const Value& get(PropertyKey key) const;
 
     void sort();
 
     void clear();
 
-    bool contains(const std::string& key) const;
+    bool contains(PropertyKey key) const;
 
-    bool getNumber(const std::string& key, double& value) const;
+    bool getNumber(PropertyKey key, double& value) const;
 
-    double getNumber(const std::string& key) const;
+    double getNumber(PropertyKey key) const;
 
-    bool getString(const std::string& key, std::string& value) const;
+    bool getString(PropertyKey key, std::string& value) const;
 
-    const std::string& getString(const std::string& key) const;
+    const std::string& getString(PropertyKey key) const;
 
-    std::string getAsString(const std::string& key) const;
+    std::string getAsString(PropertyKey key) const;
 
-    bool getAsString(const std::string& key, std::string& value) const;
+    bool getAsString(PropertyKey key, std::string& value) const;
 
     std::string toJson() const;
 
-    void setValue(std::string key, Value value);
-    void set(std::string key, std::string value);
-    void set(std::string key, double value);
+    void setValue(PropertyKey key, Value value);
+    void set(PropertyKey key, std::string value);
+    void set(PropertyKey key, double value);
 
     void setSorted(std::vector<Item>&& _items);
 
+    // Exchange items with the sorted @_items; the previous items are returned in @_items so that
+    // their storage can be reused for decoding the next feature
+    void swapSorted(std::vector<Item>& _items);
+
     // template <typename... Args> void set(std::string key, Args&&... args) {
     //     props.emplace_back(std::move(key), Value{std::forward<Args>(args)...});
     //     sort();
     // }
 
+    // Items in key id order, which depends on the order keys were first seen by this process
     const std::vector<Item>& items() const { return props; }
 
+    // Items in the stable order of keyComparator, for output
+    std::vector<const Item*> sortedItems() const;
+
     int32_t sourceId;
 
     static std::string asString(const Value& value);
@@ -69,6 +80,7 @@ struct Properties {
             return a.size() < b.size();
         }
     }
+
 private:
     std::vector<Item> props;
 };
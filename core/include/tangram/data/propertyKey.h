@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace Tangram {
+
+struct PropertyKeyTable;
+
+/* Interned feature property key.
+ *
+ * Each distinct key string is stored once in a global table and assigned a sequential id, so that
+ * Properties can be stored, sorted and looked up by integer. Key strings used repeatedly (filters,
+ * draw rule parameters, MVT layer keys) should be converted to PropertyKeys once and reused.
+ *
+ * The table holds at most maxInterned() keys, so that data with arbitrary keys (e.g. GeoJSON) does
+ * not grow it for the life of the process. Keys beyond that are shared through a second table
+ * while they are referenced: they also compare by id, but are released with their last copy.
+ */
+class PropertyKey {
+public:
+
+    PropertyKey() : m_entry(&emptyEntry()), m_id(0) {}
+
+    // Intern _name - implicit so that Properties can still be used with strings
+    PropertyKey(const std::string& _name) : PropertyKey(intern(_name)) {}
+    PropertyKey(const char* _name) : PropertyKey(intern(_name)) {}
+
+    PropertyKey(const PropertyKey& _other) : m_entry(_other.m_entry), m_id(_other.m_id) {
+        if (isShared()) { retain(); }
+    }
+    PropertyKey(PropertyKey&& _other) : m_entry(_other.m_entry), m_id(_other.m_id) {
+        _other.m_entry = &emptyEntry();
+        _other.m_id = 0;
+    }
+    ~PropertyKey() {
+        if (isShared()) { release(); }
+    }
+
+    PropertyKey& operator=(PropertyKey _other) {
+        std::swap(m_entry, _other.m_entry);
+        std::swap(m_id, _other.m_id);
+        return *this;
+    }
+
+    // Return the key for _name if it has been interned, otherwise an invalid key that matches no
+    // property; use this for lookups with arbitrary strings, e.g. from JavaScript
+    static PropertyKey find(const std::string& _name);
+
+    static constexpr uint32_t defaultMaxInterned = 1 << 16;
+
+    // Limit the number of keys in the table, keys interned before keep their ids
+    static void setMaxInterned(uint32_t _max);
+    static uint32_t maxInterned();
+    // Number of keys in the table
+    static uint32_t internedCount();
+
+    uint32_t id() const { return m_id; }
+    bool isValid() const { return m_id != invalidId; }
+    bool isInterned() const { return m_id < sharedId; }
+
+    const std::string& str() const { return *m_entry->name; }
+    const char* c_str() const { return str().c_str(); }
+    size_t size() const { return str().size(); }
+    bool empty() const { return str().empty(); }
+
+    operator const std::string&() const { return str(); }
+
+    bool operator==(const PropertyKey& _other) const { return m_id == _other.m_id; }
+    bool operator!=(const PropertyKey& _other) const { return m_id != _other.m_id; }
+    bool operator<(const PropertyKey& _other) const { return m_id < _other.m_id; }
+
+private:
+
+    static constexpr uint32_t invalidId = UINT32_MAX;
+    // Ids of keys beyond the table size start here, so that they sort after all interned keys
+    static constexpr uint32_t sharedId = 1u << 31;
+
+    friend struct PropertyKeyTable;
+
+    struct Entry {
+        Entry(uint32_t _id, const std::string* _name = nullptr) : name(_name), id(_id) {}
+        // Key of the table node
+        const std::string* name;
+        uint32_t id;
+        // References of a shared key
+        mutable std::atomic<uint32_t> refs{0};
+    };
+
+    PropertyKey(const Entry* _entry, uint32_t _id) : m_entry(_entry), m_id(_id) {
+        if (isShared()) { retain(); }
+    }
+
+    bool isShared() const { return m_id >= sharedId && m_id != invalidId; }
+    void retain() const { m_entry->refs.fetch_add(1, std::memory_order_relaxed); }
+    void release() const;
+
+    static PropertyKey intern(const std::string& _name);
+    static const Entry& emptyEntry();
+    static PropertyKeyTable& table();
+
+    const Entry* m_entry;
+    uint32_t m_id;
+};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tile/tileTask.h"
+#include "util/stats.h"
 
 #include <memory>
 #include <mutex>
@@ -13,6 +14,7 @@ struct TileData;
 struct TileID;
 struct Raster;
 class RasterSource;
+class MissingTileCache;
 class Tile;
 class TileManager;
 struct RawCache;
@@ -63,6 +65,11 @@ public:
 
         virtual void clear() { if (next) next->clear(); }
 
+        /* Add the counters of this and the next DataSources to @_stats */
+        virtual void getStats(TileSourceStats& _stats) const {
+            if (next) { next->getStats(_stats); }
+        }
+
         void setNext(std::unique_ptr<DataSource> _next) {
             next = std::move(_next);
             next->level = level + 1;
@@ -126,6 +133,15 @@ public:
     /* Generation ID of TileSource state (incremented for each update, e.g. on clearData()) */
     int64_t generation() const { return m_generation; }
 
+    /* Whether tiles of @_tileId built at @_generation are outdated */
+    virtual bool tileChanged(const TileID& _tileId, int64_t _generation) const {
+        return _generation < m_generation;
+    }
+
+    /* Called by TileManager with the lowest and highest generation of the tiles and tasks of
+     * this source it holds, i.e. tileChanged() will not be asked about older generations */
+    virtual void setLiveGenerations(int64_t _oldest, int64_t _newest) {}
+
     const ZoomOptions& zoomOptions() { return m_zoomOptions; }
     int32_t minDisplayZoom() const { return m_zoomOptions.minDisplayZoom; }
     int32_t maxDisplayZoom() const { return m_zoomOptions.maxDisplayZoom; }
@@ -156,9 +172,32 @@ public:
 
     void setFormat(Format format) { m_format = format; }
 
+    /* Decode MVT features only when building the tile, and their geometry only if a draw rule matches */
+    void setLazyDecoding(bool _lazy) { m_lazyDecoding = _lazy; }
+    bool lazyDecoding() const { return m_lazyDecoding; }
+
+    /* Keep MVT line and polygon geometry in 16-bit tile units until it is built into meshes,
+     * see Feature::quantizedCoordinates; set by the 'quantize_geometry' option of MVT sources */
+    void setQuantizedGeometry(bool _quantized) { m_quantizedGeometry = _quantized; }
+    bool quantizedGeometry() const { return m_quantizedGeometry; }
+
+    /* Restrict decoding to the named collections (e.g. MVT layers), as determined by the scene
+     * layers using this source; collections without a name are always decoded */
+    void setCollections(std::vector<std::string> _collections);
+    bool hasCollection(const std::string& _name) const;
+
+    /* Time spent building tiles of this source, updated by TileWorkers */
+    DurationCounter& buildTime() { return m_buildTime; }
+
+    /* Snapshot of the counters of this source and its DataSources */
+    TileSourceStats getStats() const;
+
     const OfflineInfo& offlineInfo() const { return m_offlineInfo; }
     void setOfflineInfo(const OfflineInfo& info) { m_offlineInfo = info; }
 
+    /* Tiles which recently failed to load, consulted before loading them again */
+    MissingTileCache& missingTiles() { return *m_missingTiles; }
+
 protected:
 
     void addRasterTasks(TileTask& _task);
@@ -186,10 +225,22 @@ protected:
 
     Format m_format = Format::GeoJson;
 
+    bool m_lazyDecoding = true;
+
+    bool m_quantizedGeometry = false;
+
+    // Sorted names of referenced collections, used if m_filterCollections is set
+    std::vector<std::string> m_collections;
+    bool m_filterCollections = false;
+
     /* vector of raster sources (as raster samplers) referenced by this datasource */
     std::vector<RasterSource*> m_rasterSources;
 
     std::unique_ptr<DataSource> m_sources;
+
+    std::unique_ptr<MissingTileCache> m_missingTiles;
+
+    DurationCounter m_buildTime;
 };
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "data/properties.h"
+#include "util/stats.h"
 #include "util/types.h"
 #include "sceneOptions.h"
 
@@ -393,6 +394,13 @@ public:
     // successfully updated, otherwise returns false.
     bool markerSetPolyline(MarkerID _marker, LngLat* _coordinates, int _count);
 
+    // Append _count LngLats from _coordinates to the polyline geometry of a marker, e.g. for a
+    // track which grows with each location update; only the end of the line is rebuilt, so the cost
+    // of an update depends on the number of points appended. Sets the geometry to a polyline if the
+    // marker has none; returns true if the marker ID was found and successfully updated, otherwise
+    // returns false.
+    bool markerAppendPolyline(MarkerID _marker, LngLat* _coordinates, int _count);
+
     // Set the geometry of a marker to a polygon with the given coordinates; _counts is a pointer
     // to a sequence of _rings integers and _coordinates is a pointer to a sequence of LngLats with
     // a total length equal to the sum of _counts; for each integer n in _counts, a polygon is created
@@ -465,12 +473,37 @@ public:
     // with its associated properties or null if no marker was found.
     void pickMarkerAt(float _x, float _y, MarkerPickCallback _onMarkerPickCallback);
 
+    // Find the features marked as 'interactive' whose geometry or labels are within _radius
+    // density-independent pixels of the screen position, without rendering a selection buffer.
+    // Returns the results nearest first, e.g. to work without a readable framebuffer. Geometry
+    // is picked on the ground plane ignoring terrain. Should be called from the thread that
+    // calls update().
+    std::vector<FeaturePickResult> pickFeaturesNear(float _x, float _y, float _radius);
+
+    // Find the labels of 'interactive' features near the screen position, see pickFeaturesNear().
+    std::vector<LabelPickResult> pickLabelsNear(float _x, float _y, float _radius);
+
+    // Find the 'interactive' markers near the screen position, see pickFeaturesNear().
+    std::vector<MarkerPickResult> pickMarkersNear(float _x, float _y, float _radius);
+
     // Run this task asynchronously to Tangram's main update loop.
     void runAsyncTask(std::function<void()> _task);
 
     // Send a signal to Tangram that the platform received a memory warning
     void onMemoryWarning();
 
+    // Get a snapshot of the counters of tile loading, building and caching. Should be called
+    // from the thread that calls update(); the counters themselves are updated without locking
+    MapStats getStats();
+
+    // Get the cost of building tile features for each data layer, sublayer and style of the
+    // current scene, sorted by decreasing build time. Costs are only collected while
+    // DebugFlags::layer_profile is set, which also shows the most expensive layers on screen.
+    std::vector<LayerStats> getLayerStats();
+
+    // Clear the costs returned by getLayerStats()
+    void resetLayerStats();
+
     // Sets an opaque default background color used as default color when a scene is being loaded
     // r, g, b must be between 0.0 and 1.0
     void setDefaultBackgroundColor(float r, float g, float b);
@@ -499,6 +532,7 @@ enum DebugFlags {
     tangram_stats,      // Tangram frame graph stats
     selection_buffer,   // Render selection framebuffer
     depth_buffer,   // Render depth framebuffer
+    layer_profile,      // Collect the cost of building tiles per scene layer and style, see Map::getLayerStats()
 };
 
 // Set debug features on or off using a boolean (see debug.h)
@@ -510,4 +544,11 @@ bool getDebugFlag(DebugFlags _flag);
 // Toggle the boolean state of a debug feature (see debug.h)
 void toggleDebugFlag(DebugFlags _flag);
 
+// Start recording trace events of tile loading and building, label placement and rendering
+void startTracing();
+
+// Stop recording trace events and return them as Chrome trace JSON, which can be opened in
+// chrome://tracing or ui.perfetto.dev
+std::string stopTracing();
+
 }
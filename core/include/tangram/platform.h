@@ -23,6 +23,8 @@ using UrlRequestHandle = uint64_t;
 struct UrlResponse {
     std::vector<char> content;
     const char* error = nullptr;
+    // HTTP status code, 0 when there was no response or the platform does not report it
+    int httpStatus = 0;
 };
 
 // Function type for receiving data from a URL request.
@@ -109,7 +111,10 @@ public:
 
     virtual std::vector<FontSourceHandle> systemFontFallbacksHandle() const;
 
-    size_t activeUrlRequests() const { return m_urlCallbacks.size(); }
+    size_t activeUrlRequests() const;
+
+    // Number of active URL requests that are queued by the implementation and not yet started
+    virtual size_t pendingUrlRequests() const { return 0; }
     void notifyStorage(int64_t dtot, int64_t doffl) const { if(onNotifyStorage) onNotifyStorage(dtot, doffl); }
 
     std::atomic_uint_fast64_t bytesDownloaded = {0};
@@ -141,7 +146,7 @@ protected:
 
     bool m_continuousRendering;
 
-    std::mutex m_callbackMutex;
+    mutable std::mutex m_callbackMutex;
     struct UrlRequestEntry {
         UrlCallback callback;
         UrlRequestId id;
@@ -68,12 +68,21 @@ public:
     /// 16MB default in-memory DataSource cache
     size_t memoryTileCacheSize = CACHE_SIZE;
 
-    /// persistent MBTiles DataSource cache
+    /// compression of the in-memory DataSource cache: 1 (fastest) to 9 (smallest), 0 for none
+    int memoryTileCacheCompression = 1;
+
+    /// persistent MBTiles DataSource cache, enabled when > 0
     size_t diskTileCacheSize = 0;
 
+    /// size limit of each MBTiles cache file in bytes, 0 for no limit
+    size_t diskTileCacheLimit = 0;
+
     /// default max-age (in seconds) for disk tile cache
     int64_t diskTileCacheMaxAge = 180*24*60*60;  // 180 days in seconds
 
+    /// persistent cache of built polygon and line geometry in diskCacheDir, 0 to disable
+    size_t diskGeometryCacheSize = 0;
+
     /// cache directory for tiles, fonts, etc
     std::string diskCacheDir;
 
@@ -23,6 +23,12 @@ class TileTask {
 
 public:
 
+    // Queue holding a task until it is processed, notified when the ordering of the task changes
+    struct Observer {
+        virtual ~Observer() {}
+        virtual void priorityChanged(TileTask& _task) = 0;
+    };
+
     TileTask(const TileID& _tileId, TileSource* _source);
 
     // No copies
@@ -57,12 +63,19 @@ public:
     }
 
     void setPriority(double _priority) {
-        m_priority.store(_priority);
+        if (m_priority.exchange(_priority) != float(_priority)) { notifyObserver(); }
     }
 
-    void setProxyState(bool isProxy) { m_proxyState = isProxy; }
+    void setProxyState(bool isProxy) {
+        if (m_proxyState.exchange(isProxy) != isProxy) { notifyObserver(); }
+    }
     bool isProxy() const { return m_proxyState; }
 
+    // Set by the queue holding this task, which is notified of priority and proxy state changes
+    //  so that it re-sorts only the changed tasks
+    void setObserver(Observer* _observer) { m_observer = _observer; }
+    Observer* observer() const { return m_observer; }
+
     auto& subTasks() { return m_subTasks; }
 
     // running on worker thread
@@ -87,6 +100,9 @@ public:
     int offlineId = 0;
     int shareCount = 0;
 
+    // Position of the task in the queue holding it, only accessed by that queue
+    size_t queuePosition = 0;
+
 protected:
 
     const TileID m_tileId;
@@ -111,6 +127,14 @@ protected:
 
     std::atomic<float> m_priority;
     std::atomic<bool> m_proxyState;
+
+    std::atomic<Observer*> m_observer{nullptr};
+
+private:
+
+    void notifyObserver() {
+        if (auto* observer = m_observer.load()) { observer->priorityChanged(*this); }
+    }
 };
 
 class BinaryTileTask : public TileTask {
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+/* Snapshot of a DurationCounter */
+struct DurationStats {
+    static constexpr size_t numBuckets = 24;
+
+    uint64_t count = 0;
+    double totalMs = 0;
+    // buckets[i] counts durations of [2^i, 2^(i+1)) microseconds; the first bucket also
+    // counts shorter and the last bucket longer durations
+    std::array<uint64_t, numBuckets> buckets{};
+
+    double averageMs() const { return count > 0 ? totalMs / count : 0; }
+};
+
+/* Event counter which can be updated and read from any thread without locking */
+class StatCounter {
+public:
+    void add(uint64_t _n = 1) { m_value.fetch_add(_n, std::memory_order_relaxed); }
+    uint64_t get() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_value{0};
+};
+
+/* Count, total and histogram of durations, which can be updated and read from any thread
+ * without locking */
+class DurationCounter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    DurationCounter() {
+        for (auto& bucket : m_buckets) { bucket.store(0, std::memory_order_relaxed); }
+    }
+
+    void add(Clock::duration _duration) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(_duration).count();
+        size_t bucket = 0;
+        while (us > 1 && bucket < DurationStats::numBuckets - 1) {
+            us >>= 1;
+            bucket++;
+        }
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_totalNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(_duration).count(),
+                            std::memory_order_relaxed);
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    DurationStats get() const {
+        DurationStats stats;
+        stats.count = m_count.load(std::memory_order_relaxed);
+        stats.totalMs = m_totalNs.load(std::memory_order_relaxed) * 1e-6;
+        for (size_t i = 0; i < DurationStats::numBuckets; i++) {
+            stats.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    /* Adds the lifetime of the scope to the counter */
+    struct scope {
+        DurationCounter& counter;
+        Clock::time_point start = Clock::now();
+        scope(DurationCounter& _counter) : counter(_counter) {}
+        ~scope() { counter.add(Clock::now() - start); }
+    };
+
+private:
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_totalNs{0};
+    std::array<std::atomic<uint64_t>, DurationStats::numBuckets> m_buckets;
+};
+
+struct TileSourceStats {
+    std::string name;
+    // Tiles built on TileWorker threads
+    DurationStats buildTime;
+    // Lookups of raw tile data in the in-memory cache
+    uint64_t memoryCacheHits = 0;
+    uint64_t memoryCacheMisses = 0;
+    // Raw tile data in the in-memory cache: bytes stored, and bytes before compression
+    size_t memoryCacheEntries = 0;
+    size_t memoryCacheBytes = 0;
+    size_t memoryCacheRawBytes = 0;
+    // Tile queries of the MBTiles database, and the tiles they looked up; queries of reader
+    // threads look up all requests which are pending at once
+    DurationStats mbtilesQueryTime;
+    uint64_t mbtilesQueryTiles = 0;
+    // Transactions writing cached tiles and access times to the MBTiles database, and the tiles
+    // and access times they wrote
+    DurationStats mbtilesWriteTime;
+    uint64_t mbtilesWriteRows = 0;
+    // Size of the tiles in the MBTiles cache, and tiles evicted to keep it within its limit
+    uint64_t mbtilesCacheBytes = 0;
+    uint64_t mbtilesEvictedTiles = 0;
+    // Reads of queued requests from PMTiles archives, and the tiles they looked up
+    DurationStats pmtilesReadTime;
+    uint64_t pmtilesReadTiles = 0;
+    // Tiles which recently failed to load, and loads skipped because of them
+    size_t missingTileEntries = 0;
+    uint64_t missingTileHits = 0;
+};
+
+/* Cost of building tile features of a scene layer with a style, see Map::getLayerStats() */
+struct LayerStats {
+    // Top-level scene layer
+    std::string dataLayer;
+    // Deepest sublayer contributing to the matched draw rule, e.g. "roads:major:labels".
+    // Empty for the entry of the data layer itself, which counts filter matching and geometry
+    // decoding.
+    std::string sublayer;
+    std::string style;
+    double timeMs = 0;
+    // Features built by the style or, for the data layer entry, features matched
+    uint64_t features = 0;
+    uint64_t vertices = 0;
+    uint64_t labels = 0;
+};
+
+/* Snapshot of the tile loading and building pipeline, see Map::getStats() */
+struct MapStats {
+    // Tasks waiting to be built by TileWorkers
+    size_t tileWorkerPending = 0;
+    // Time each TileWorker thread spent building tiles
+    std::vector<double> tileWorkerBusyMs;
+    // Tiles being loaded or built
+    int tilesInProgress = 0;
+    // Built tiles kept for reuse
+    uint64_t tileCacheHits = 0;
+    uint64_t tileCacheMisses = 0;
+    uint64_t tileCacheEvictions = 0;
+    size_t tileCacheEntries = 0;
+    size_t tileCacheBytes = 0;
+    // Tiles restored from the persistent geometry cache, see SceneOptions::diskGeometryCacheSize
+    uint64_t geometryCacheHits = 0;
+    uint64_t geometryCacheMisses = 0;
+    size_t geometryCacheBytes = 0;
+    // URL requests which have not completed, and of these the ones waiting to be started
+    size_t urlRequestsActive = 0;
+    size_t urlRequestsPending = 0;
+
+    std::vector<TileSourceStats> sources;
+};
+
+}
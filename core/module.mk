@@ -7,7 +7,9 @@ MODULE_SOURCES = \
   src/platform.cpp                    \
   src/data/clientDataSource.cpp       \
   src/data/memoryCacheDataSource.cpp  \
+  src/data/missingTileCache.cpp       \
   src/data/networkDataSource.cpp      \
+  src/data/pmtilesDataSource.cpp      \
   src/data/properties.cpp             \
   src/data/rasterSource.cpp           \
   src/data/tileSource.cpp             \
@@ -15,7 +17,9 @@ MODULE_SOURCES = \
   src/data/formats/mvt.cpp            \
   src/data/formats/topoJson.cpp       \
   src/debug/frameInfo.cpp             \
+  src/debug/layerProfile.cpp          \
   src/debug/textDisplay.cpp           \
+  src/debug/trace.cpp                 \
   src/gl/framebuffer.cpp              \
   src/gl/glError.cpp                  \
   src/gl/glyphTexture.cpp             \
@@ -42,6 +46,7 @@ MODULE_SOURCES = \
   src/scene/dataLayer.cpp             \
   src/scene/directionalLight.cpp      \
   src/scene/drawRule.cpp              \
+  src/scene/filterProgram.cpp         \
   src/scene/filters.cpp               \
   src/scene/importer.cpp              \
   src/scene/light.cpp                 \
@@ -56,6 +61,8 @@ MODULE_SOURCES = \
   src/scene/styleMixer.cpp            \
   src/scene/styleParam.cpp            \
   src/selection/featureSelection.cpp  \
+  src/selection/selectionIndex.cpp    \
+  src/selection/selectionPicker.cpp   \
   src/selection/selectionQuery.cpp    \
   src/style/debugStyle.cpp            \
   src/style/debugTextStyle.cpp        \
@@ -73,6 +80,8 @@ MODULE_SOURCES = \
   src/text/textUtil.cpp               \
   src/tile/tile.cpp                   \
   src/tile/tileBuilder.cpp            \
+  src/tile/tileCache.cpp              \
+  src/tile/tileGeometryCache.cpp      \
   src/tile/tileManager.cpp            \
   src/tile/tileTask.cpp               \
   src/tile/tileWorker.cpp             \
@@ -86,6 +95,7 @@ MODULE_SOURCES = \
   src/util/jobQueue.cpp               \
   src/util/json.cpp                   \
   src/util/mapProjection.cpp          \
+  src/util/mappedFile.cpp             \
   src/util/skyManager.cpp             \
   src/util/stbImage.cpp               \
   src/util/url.cpp                    \
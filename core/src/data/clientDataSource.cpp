@@ -1,5 +1,6 @@
 #include "data/clientDataSource.h"
 
+#include "data/formats/geoJson.h"
 #include "log.h"
 #include "platform.h"
 #include "tile/tileTask.h"
@@ -11,33 +12,140 @@
 
 #include "mapbox/geojsonvt.hpp"
 
-// RapidJson parser
-#include "mapbox/geojson.hpp"
-#include <mapbox/geojson_impl.hpp>
 
-
-#include <regex>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_set>
 
 namespace Tangram {
 
 using namespace mapbox;
 
-geojsonvt::Options options() {
-    geojsonvt::Options opt;
-    opt.maxZoom = 18;
-    opt.indexMaxZoom = 5;
-    opt.indexMaxPoints = 100000;
-    opt.solidChildren = true;
-    opt.tolerance = 3;
-    opt.extent = 4096;
-    opt.buffer = 0;
-    return opt;
+// Tiles are clipped from the geometry of all zoom levels, which is simplified at this zoom
+static constexpr uint8_t maxSimplifyZoom = 18;
+static constexpr double simplifyTolerance = 3;
+static constexpr uint16_t tileExtent = 4096;
+
+// Zoom of the deepest nodes of the index of features and changes
+static constexpr int indexZoom = 14;
+// Changes kept for an index node before they are merged into one region
+static constexpr size_t maxNodeChanges = 8;
+// Beyond these numbers of changed features or index nodes with changes all tiles are reloaded
+static constexpr size_t maxTrackedFeatures = 1024;
+static constexpr size_t maxChangedNodes = 16384;
+
+using Box = geometry::box<double>;
+
+static Box tileBox(const TileID& _tileId) {
+    const double z2 = 1u << _tileId.z;
+    return { { _tileId.x / z2, _tileId.y / z2 }, { (_tileId.x + 1) / z2, (_tileId.y + 1) / z2 } };
+}
+
+static bool intersects(const Box& _a, const Box& _b) {
+    return _a.min.x <= _b.max.x && _b.min.x <= _a.max.x &&
+           _a.min.y <= _b.max.y && _b.min.y <= _a.max.y;
+}
+
+static uint64_t morton(int _z, uint32_t _x, uint32_t _y) {
+    uint64_t code = 0;
+    for (int i = 0; i < _z; i++) {
+        code |= uint64_t((_x >> i) & 1) << (2 * i);
+        code |= uint64_t((_y >> i) & 1) << (2 * i + 1);
+    }
+    return code;
+}
+
+// Key of the index node of the tile at zoom @_z with Morton code @_morton. Keys of the nodes
+// within a tile follow the key of its own node.
+static uint64_t nodeKey(int _z, uint64_t _morton) {
+    return (_morton << (2 * (indexZoom - _z)) << 5) | uint64_t(_z);
+}
+
+// Key of the deepest index node containing @_box
+static uint64_t boxNodeKey(const Box& _box) {
+    const double n = 1u << indexZoom;
+    auto cell = [n](double v) { return uint32_t(std::max(0., std::min(v * n, n - 1))); };
+    uint32_t x0 = cell(_box.min.x), x1 = cell(_box.max.x);
+    uint32_t y0 = cell(_box.min.y), y1 = cell(_box.max.y);
+    int z = indexZoom;
+    while (x0 != x1 || y0 != y1) {
+        x0 >>= 1; x1 >>= 1;
+        y0 >>= 1; y1 >>= 1;
+        z--;
+    }
+    return nodeKey(z, morton(z, x0, y0));
 }
 
+// Calls @_fn for each node of @_nodes which may hold geometry within @_tileId: the nodes
+// containing the tile and the nodes within it
+template <typename Nodes, typename Fn>
+static void visitNodes(Nodes& _nodes, const TileID& _tileId, Fn _fn) {
+    const int z = std::min(int(_tileId.z), indexZoom);
+    const uint32_t x = uint32_t(_tileId.x) >> (_tileId.z - z);
+    const uint32_t y = uint32_t(_tileId.y) >> (_tileId.z - z);
+
+    for (int i = 0; i <= z; i++) {
+        auto it = _nodes.find(nodeKey(i, morton(i, x >> (z - i), y >> (z - i))));
+        if (it != _nodes.end()) { _fn(it->second); }
+    }
+    if (z < indexZoom) {
+        uint64_t code = morton(z, x, y);
+        auto end = _nodes.lower_bound(nodeKey(z, code + 1));
+        for (auto it = _nodes.upper_bound(nodeKey(z, code)); it != end; ++it) {
+            _fn(it->second);
+        }
+    }
+}
+
+// Regions of features changed by generateTiles(), guarded by their own lock rather than the store
+// lock, so that tileChanged() does not wait for tiles being clipped
+struct ClientDataSource::Changes {
+    struct Change {
+        int64_t generation;
+        Box region;
+    };
+    // Regions of changed features by the deepest index node containing them, oldest first
+    std::map<uint64_t, std::vector<Change>> nodes;
+    // Generations and keys of the nodes in the order changes were added, to prune them
+    std::deque<std::pair<int64_t, uint64_t>> added;
+    // Tiles built before this generation are outdated regardless of changes
+    int64_t resetGeneration = 0;
+    // Newest generation of tiles in use, see setLiveGenerations()
+    int64_t newestGeneration = 0;
+
+    void add(const Box& _region, int64_t _generation);
+    void prune(int64_t _generation);
+    bool tileChanged(const TileID& _tileId, int64_t _generation) const;
+
+    void reset(int64_t _generation) {
+        resetGeneration = _generation;
+        nodes.clear();
+        added.clear();
+    }
+};
+
 struct ClientDataSource::Storage {
-    std::unique_ptr<geojsonvt::GeoJSONVT> tiles;
     geometry::feature_collection<double> features;
     std::vector<Properties> properties;
+
+    // Projected geometry of each indexed feature, split at the antimeridian, and its centroid
+    std::vector<geojsonvt::detail::vt_features> tileGeometry;
+    // Ids of features by the deepest index node containing their geometry
+    std::map<uint64_t, std::vector<uint64_t>> index;
+
+    // Indexed features changed since the last generateTiles()
+    std::unordered_set<uint64_t> changedFeatures;
+    // Features were cleared since the last generateTiles()
+    bool cleared = false;
+
+    void markChanged(uint64_t _id) {
+        if (_id < tileGeometry.size()) { changedFeatures.insert(_id); }
+    }
+
+    void indexFeature(uint64_t _id, bool _centroid);
+    void removeFromIndex(uint64_t _id);
 };
 
 struct ClientDataSource::PolylineBuilderData : mapbox::geometry::multi_line_string<double> {
@@ -99,13 +207,14 @@ ClientDataSource::ClientDataSource(Platform& _platform, const std::string& _name
 
     m_generateGeometry = true;
     m_store = std::make_unique<Storage>();
+    m_changes = std::make_unique<Changes>();
 
     if (!_url.empty()) {
         UrlCallback onUrlFinished = [&, this](UrlResponse&& response) {
             if (response.error) {
                 LOGE("Unable to retrieve data from '%s': %s", _url.c_str(), response.error);
             } else {
-                addData(std::string(response.content.begin(), response.content.end()));
+                addData(response.content.data(), response.content.size());
                 generateTiles();
             }
             m_hasPendingData = false;
@@ -152,51 +261,184 @@ struct add_centroid {
     }
 };
 
-struct prop_visitor {
-    Properties& props;
-    std::string& key;
-    void operator()(std::string v) {
-        props.set(key, std::move(v));
+void ClientDataSource::Storage::indexFeature(uint64_t _id, bool _centroid) {
+
+    static const geometry::property_map centroidProperties{ { "label_placement", true } };
+
+    const double tolerance = simplifyTolerance / tileExtent / (1u << maxSimplifyZoom);
+    const auto& geom = features[_id].geometry;
+
+    geojsonvt::detail::vt_features projected;
+    projected.emplace_back(geometry::geometry<double>::visit(geom, geojsonvt::detail::project{ tolerance }),
+                           geometry::property_map{}, _id);
+
+    auto& pieces = tileGeometry[_id];
+    pieces = geojsonvt::detail::wrap(projected, 0);
+
+    if (_centroid) {
+        geometry::point<double> centroid;
+        if (geometry::geometry<double>::visit(geom, add_centroid{ centroid })) {
+            pieces.emplace_back(geojsonvt::detail::project{ tolerance }(centroid), centroidProperties, _id);
+        }
     }
-    void operator()(bool v) {
-        props.set(key, double(v));
+
+    // Removed features have no geometry
+    pieces.erase(std::remove_if(pieces.begin(), pieces.end(),
+                                [](auto& piece) { return piece.num_points == 0; }),
+                 pieces.end());
+
+    for (const auto& piece : pieces) {
+        auto& node = index[boxNodeKey(piece.bbox)];
+        if (node.empty() || node.back() != _id) { node.push_back(_id); }
     }
-    void operator()(uint64_t v) {
-        props.set(key, double(v));
+}
+
+void ClientDataSource::Storage::removeFromIndex(uint64_t _id) {
+    for (const auto& piece : tileGeometry[_id]) {
+        auto it = index.find(boxNodeKey(piece.bbox));
+        if (it == index.end()) { continue; }
+        auto& node = it->second;
+        node.erase(std::remove(node.begin(), node.end(), _id), node.end());
+        if (node.empty()) { index.erase(it); }
     }
-    void operator()(int64_t v) {
-        props.set(key, double(v));
+    tileGeometry[_id].clear();
+}
+
+void ClientDataSource::Changes::add(const Box& _region, int64_t _generation) {
+
+    const uint64_t key = boxNodeKey(_region);
+    auto& node = nodes[key];
+    node.push_back({ _generation, _region });
+    if (added.empty() || added.back() != std::make_pair(_generation, key)) {
+        added.emplace_back(_generation, key);
     }
-    void operator()(double v) {
-        props.set(key, v);
+
+    if (node.size() > maxNodeChanges) {
+        // Merge the changes which the newest tiles already include, these only outdate older
+        // tiles; all changes if that leaves too many
+        auto end = std::find_if(node.begin(), node.end(), [&](const Change& _change) {
+            return _change.generation > newestGeneration;
+        });
+        if (end - node.begin() < 2) { end = node.end(); }
+
+        Change& merged = node.front();
+        for (auto it = node.begin() + 1; it != end; ++it) {
+            merged.generation = std::max(merged.generation, it->generation);
+            merged.region.min.x = std::min(merged.region.min.x, it->region.min.x);
+            merged.region.min.y = std::min(merged.region.min.y, it->region.min.y);
+            merged.region.max.x = std::max(merged.region.max.x, it->region.max.x);
+            merged.region.max.y = std::max(merged.region.max.y, it->region.max.y);
+        }
+        node.erase(node.begin() + 1, end);
     }
+}
 
-    template <typename T>
-    void operator()(T) {
-        // Ignore all other basic value types
+void ClientDataSource::Changes::prune(int64_t _generation) {
+
+    // Changes up to @_generation are only needed for older tiles, which are treated as outdated
+    resetGeneration = std::max(resetGeneration, _generation);
+
+    while (!added.empty() && added.front().first <= _generation) {
+        auto it = nodes.find(added.front().second);
+        added.pop_front();
+        if (it == nodes.end()) { continue; }
+
+        auto& node = it->second;
+        auto end = std::find_if(node.begin(), node.end(), [&](const Change& _change) {
+            return _change.generation > _generation;
+        });
+        node.erase(node.begin(), end);
+        if (node.empty()) { nodes.erase(it); }
     }
-};
+}
+
+bool ClientDataSource::Changes::tileChanged(const TileID& _tileId, int64_t _generation) const {
+
+    if (_generation < resetGeneration) { return true; }
+
+    const Box box = tileBox(_tileId);
+    bool changed = false;
+    visitNodes(nodes, _tileId, [&](const std::vector<Change>& _node) {
+        for (const auto& change : _node) {
+            if (change.generation > _generation && intersects(change.region, box)) {
+                changed = true;
+            }
+        }
+    });
+    return changed;
+}
 
 void ClientDataSource::generateTiles() {
 
     std::lock_guard<std::mutex> lock(m_mutexStore);
 
-    if (m_generateCentroids) {
-        for (const auto &feat : m_store->features) {
-            geometry::point<double> centroid;
-            const auto& properties = m_store->properties[feat.id.get<uint64_t>()];
-            if (geometry::geometry<double>::visit(feat.geometry, add_centroid{ centroid })) {
-                uint64_t id = m_store->features.size();
-                m_store->features.emplace_back(centroid, id);
-                m_store->properties.push_back(properties);
-                auto& props = m_store->properties.back();
-                props.set("label_placement", 1.0);
-            }
+    auto& store = *m_store;
+    const size_t numIndexed = store.tileGeometry.size();
+    const size_t numChanged = store.changedFeatures.size() + store.features.size() - numIndexed;
+    if (numChanged == 0 && !store.cleared) { return; }
+
+    const int64_t generation = m_generation + 1;
+
+    // Many changes are not worth tracking
+    bool trackChanges = !store.cleared && numChanged <= maxTrackedFeatures;
+    store.cleared = false;
+
+    // Regions of the changed features, added to the changes once they are all indexed
+    std::vector<Box> regions;
+    auto addRegions = [&](const geojsonvt::detail::vt_features& _pieces) {
+        for (const auto& piece : _pieces) { regions.push_back(piece.bbox); }
+    };
+
+    // Tiles overlapping the old and the new geometry of changed features are outdated
+    for (auto id : store.changedFeatures) {
+        if (trackChanges) { addRegions(store.tileGeometry[id]); }
+        store.removeFromIndex(id);
+        store.indexFeature(id, m_generateCentroids);
+        if (trackChanges) { addRegions(store.tileGeometry[id]); }
+    }
+    store.changedFeatures.clear();
+
+    store.tileGeometry.resize(store.features.size());
+    for (uint64_t id = numIndexed; id < store.features.size(); id++) {
+        store.indexFeature(id, m_generateCentroids);
+        if (trackChanges) { addRegions(store.tileGeometry[id]); }
+    }
+
+    {
+        std::lock_guard<std::mutex> lockChanges(m_mutexChanges);
+        auto& changes = *m_changes;
+        if (trackChanges) {
+            for (const auto& region : regions) { changes.add(region, generation); }
         }
+        if (!trackChanges || changes.nodes.size() > maxChangedNodes) { changes.reset(generation); }
+
+        // Add the changes before the generation that makes tileChanged() look at them
+        m_generation = generation;
     }
+}
 
-    m_store->tiles = std::make_unique<geojsonvt::GeoJSONVT>(m_store->features, options());
-    m_generation++;
+bool ClientDataSource::tileChanged(const TileID& _tileId, int64_t _generation) const {
+
+    if (_generation >= m_generation) { return false; }
+
+    std::lock_guard<std::mutex> lock(m_mutexChanges);
+    return m_changes->tileChanged(_tileId, _generation);
+}
+
+void ClientDataSource::setLiveGenerations(int64_t _oldest, int64_t _newest) {
+
+    std::lock_guard<std::mutex> lock(m_mutexChanges);
+    m_changes->prune(_oldest);
+    m_changes->newestGeneration = _newest;
+}
+
+void ClientDataSource::clearData() {
+
+    TileSource::clearData();
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+    std::lock_guard<std::mutex> lockChanges(m_mutexChanges);
+    m_changes->reset(m_generation);
 }
 
 void ClientDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
@@ -221,32 +463,120 @@ void ClientDataSource::clearFeatures() {
 
     m_store->features.clear();
     m_store->properties.clear();
+
+    // All tiles are reloaded by the next generateTiles()
+    m_store->tileGeometry.clear();
+    m_store->index.clear();
+    m_store->changedFeatures.clear();
+    m_store->cleared = true;
+}
+
+// Convert GeoJSON geometry to the longitude and latitude geometry of the feature store
+static geometry::geometry<double> storeGeometry(const GeoJson::Geometry& _geometry) {
+
+    const auto& positions = _geometry.positions;
+
+    auto line = [&](const GeometryRange& _range) {
+        geometry::line_string<double> line;
+        line.reserve(_range.size());
+        for (uint32_t i = _range.begin; i < _range.end; i++) {
+            line.emplace_back(positions[i].longitude, positions[i].latitude);
+        }
+        return line;
+    };
+
+    auto polygon = [&](const GeometryRange& _range) {
+        geometry::polygon<double> polygon;
+        polygon.reserve(_range.size());
+        for (uint32_t r = _range.begin; r < _range.end; r++) {
+            const auto& ring = _geometry.lines[r];
+            polygon.emplace_back();
+            polygon.back().reserve(ring.size());
+            for (uint32_t i = ring.begin; i < ring.end; i++) {
+                polygon.back().emplace_back(positions[i].longitude, positions[i].latitude);
+            }
+        }
+        return polygon;
+    };
+
+    switch (_geometry.type) {
+    case GeometryType::points:
+        if (positions.size() == 1) {
+            return geometry::point<double>(positions[0].longitude, positions[0].latitude);
+        } else {
+            geometry::multi_point<double> points;
+            points.reserve(positions.size());
+            for (const auto& p : positions) { points.emplace_back(p.longitude, p.latitude); }
+            return points;
+        }
+    case GeometryType::lines:
+        if (_geometry.lines.size() == 1) {
+            return line(_geometry.lines[0]);
+        } else {
+            geometry::multi_line_string<double> lines;
+            lines.reserve(_geometry.lines.size());
+            for (const auto& range : _geometry.lines) { lines.push_back(line(range)); }
+            return lines;
+        }
+    case GeometryType::polygons:
+        if (_geometry.polygons.size() == 1) {
+            return polygon(_geometry.polygons[0]);
+        } else {
+            geometry::multi_polygon<double> polygons;
+            polygons.reserve(_geometry.polygons.size());
+            for (const auto& range : _geometry.polygons) { polygons.push_back(polygon(range)); }
+            return polygons;
+        }
+    default:
+        return geometry::geometry_collection<double>{};
+    }
 }
 
 void ClientDataSource::addData(const std::string& _data) {
+    addData(_data.data(), _data.size());
+}
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
+void ClientDataSource::addData(const char* _data, size_t _size) {
+    addFeatures([&](const GeoJson::FeatureFn& _onFeature, const char** _error, size_t* _errorOffset) {
+        return GeoJson::readFeatures(_data, _size, m_id, _onFeature, _error, _errorOffset);
+    });
+}
 
-    const auto json = geojson::parse(_data);
-    auto features = geojsonvt::geojson::visit(json, geojsonvt::ToFeatureCollection{});
+void ClientDataSource::addData(const std::function<size_t(char* _buffer, size_t _size)>& _read) {
+    addFeatures([&](const GeoJson::FeatureFn& _onFeature, const char** _error, size_t* _errorOffset) {
+        return GeoJson::readFeatures(_read, m_id, _onFeature, _error, _errorOffset);
+    });
+}
 
-    for (auto& feature : features) {
+template<class ReadFeatures>
+void ClientDataSource::addFeatures(ReadFeatures _readFeatures) {
 
-        feature.id = uint64_t(m_store->properties.size());
-        m_store->properties.emplace_back();
-        Properties& props = m_store->properties.back();
+    // Features are read without holding the lock and then moved to the store
+    geometry::feature_collection<double> features;
+    std::vector<Properties> properties;
 
-        for (const auto& prop : feature.properties) {
-            auto key = prop.first;
-            prop_visitor visitor = {props, key};
-            mapbox::util::apply_visitor(visitor, prop.second);
-        }
-        feature.properties.clear();
+    auto onFeature = [&](const std::string&, GeoJson::Geometry& _geometry, Properties& _properties) {
+        features.emplace_back(storeGeometry(_geometry));
+        properties.push_back(std::move(_properties));
+    };
+
+    const char* error;
+    size_t offset;
+    if (!_readFeatures(onFeature, &error, &offset)) {
+        LOGE("GeoJSON parsing failed for source '%s': %s (%u)", m_name.c_str(), error, offset);
     }
 
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    uint64_t id = m_store->features.size();
+    for (auto& feature : features) { feature.id = id++; }
+
     m_store->features.insert(m_store->features.end(),
                              std::make_move_iterator(features.begin()),
                              std::make_move_iterator(features.end()));
+    m_store->properties.insert(m_store->properties.end(),
+                               std::make_move_iterator(properties.begin()),
+                               std::make_move_iterator(properties.end()));
 }
 
 uint64_t ClientDataSource::addPointFeature(Properties&& properties, LngLat coordinates, uint64_t id) {
@@ -257,6 +587,7 @@ uint64_t ClientDataSource::addPointFeature(Properties&& properties, LngLat coord
     if (id < m_store->features.size()) {
       m_store->features[id] = {geom, id};
       m_store->properties[id] = std::move(properties);
+      m_store->markChanged(id);
     } else {
       id = m_store->features.size();
       m_store->features.emplace_back(geom, id);
@@ -273,6 +604,7 @@ uint64_t ClientDataSource::addPolylineFeature(Properties&& properties, PolylineB
     if (id < m_store->features.size()) {
       m_store->features[id] = {*geom, id};
       m_store->properties[id] = std::move(properties);
+      m_store->markChanged(id);
     } else {
       id = m_store->features.size();
       m_store->features.emplace_back(*geom, id);
@@ -289,6 +621,7 @@ uint64_t ClientDataSource::addPolygonFeature(Properties&& properties, PolygonBui
     if (id < m_store->features.size()) {
       m_store->features[id] = {*geom, id};
       m_store->properties[id] = std::move(properties);
+      m_store->markChanged(id);
     } else {
       id = m_store->features.size();
       m_store->features.emplace_back(*geom, id);
@@ -298,8 +631,36 @@ uint64_t ClientDataSource::addPolygonFeature(Properties&& properties, PolygonBui
 }
 
 void ClientDataSource::setProperties(uint64_t id, Properties&& properties) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
     if (id >= m_store->properties.size()) return;
     m_store->properties[id] = std::move(properties);
+    m_store->markChanged(id);
+}
+
+bool ClientDataSource::movePointFeature(uint64_t id, LngLat coordinates) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    if (id >= m_store->features.size()) { return false; }
+    auto& geom = m_store->features[id].geometry;
+    if (!geom.is<geometry::point<double>>()) { return false; }
+
+    geom = geometry::point<double>{coordinates.longitude, coordinates.latitude};
+    m_store->markChanged(id);
+    return true;
+}
+
+bool ClientDataSource::removeFeature(uint64_t id) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    if (id >= m_store->features.size()) { return false; }
+    m_store->features[id].geometry = geometry::geometry_collection<double>{};
+    m_store->properties[id] = Properties();
+    m_store->markChanged(id);
+    return true;
 }
 
 struct add_geometry {
@@ -318,28 +679,30 @@ struct add_geometry {
         feature.points.push_back(transformPoint(p));
         return true;
     }
-    bool operator()(const geometry::line_string<int16_t>& geom) {
-        feature.geometryType = GeometryType::lines;
-        feature.lines.emplace_back();
-        Line& line = feature.lines.back();
-        for (const auto& p : geom) {
+    // Append the transformed points to the feature coordinates, skipping repeated points
+    void addCoordinates(const std::vector<geometry::point<int16_t>>& points) {
+        size_t begin = feature.coordinates.size();
+        for (const auto& p : points) {
             auto tp = transformPoint(p);
-            if (line.size() > 0 && tp == line.back()) { continue; }
-            line.push_back(tp);
+            if (feature.coordinates.size() > begin && tp == feature.coordinates.back()) { continue; }
+            feature.coordinates.push_back(tp);
         }
+    }
+
+    bool operator()(const geometry::line_string<int16_t>& geom) {
+        feature.geometryType = GeometryType::lines;
+        size_t begin = feature.coordinates.size();
+        addCoordinates(geom);
+        feature.endLine(begin);
         return true;
     }
     bool operator()(const geometry::polygon<int16_t>& geom) {
         feature.geometryType = GeometryType::polygons;
-        feature.polygons.emplace_back();
+        feature.beginPolygon();
         for (const auto& ring : geom) {
-            feature.polygons.back().emplace_back();
-            Line& line = feature.polygons.back().back();
-            for (const auto& p : ring) {
-                auto tp = transformPoint(p);
-                if (line.size() > 0 && tp == line.back()) { continue; }
-                line.push_back(tp);
-            }
+            size_t begin = feature.coordinates.size();
+            addCoordinates(ring);
+            feature.endRing(begin);
         }
         return true;
     }
@@ -372,17 +735,48 @@ std::shared_ptr<TileData> ClientDataSource::parse(const TileTask& _task) const {
 
     auto data = std::make_shared<TileData>();
 
-    if (!m_store->tiles) { return nullptr; }
-    auto tile = m_store->tiles->getTile(_task.tileId().z, _task.tileId().x, _task.tileId().y);
-
     data->layers.emplace_back("");  // empty name will skip filtering by 'collection'
     Layer& layer = data->layers.back();
 
-    for (auto& it : tile.features) {
+    const auto& tileId = _task.tileId();
+    const Box box = tileBox(tileId);
+
+    std::vector<uint64_t> ids;
+    visitNodes(m_store->index, tileId, [&](const std::vector<uint64_t>& _node) {
+        ids.insert(ids.end(), _node.begin(), _node.end());
+    });
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    geojsonvt::detail::vt_features features;
+    Box bounds = { { 2, 1 }, { -1, 0 } };
+    for (auto id : ids) {
+        for (const auto& piece : m_store->tileGeometry[id]) {
+            if (!intersects(piece.bbox, box)) { continue; }
+            features.push_back(piece);
+            bounds.min.x = std::min(bounds.min.x, piece.bbox.min.x);
+            bounds.min.y = std::min(bounds.min.y, piece.bbox.min.y);
+            bounds.max.x = std::max(bounds.max.x, piece.bbox.max.x);
+            bounds.max.y = std::max(bounds.max.y, piece.bbox.max.y);
+        }
+    }
+    if (features.empty()) { return data; }
+
+    features = geojsonvt::detail::clip<0>(features, box.min.x, box.max.x, bounds.min.x, bounds.max.x);
+    features = geojsonvt::detail::clip<1>(features, box.min.y, box.max.y, bounds.min.y, bounds.max.y);
+
+    const double tolerance = tileId.z >= maxSimplifyZoom ? 0 :
+        simplifyTolerance / ((1u << tileId.z) * double(tileExtent));
+    geojsonvt::detail::InternalTile tile(features, tileId.z, tileId.x, tileId.y, tileExtent, 0, tolerance);
+
+    for (auto& it : tile.tile.features) {
         Feature feature(m_id);
 
         if (geometry::geometry<int16_t>::visit(it.geometry, add_geometry{ feature })) {
             feature.props = m_store->properties[it.id.get<uint64_t>()];
+            if (!it.properties.empty()) {
+                feature.props.set("label_placement", 1.0);
+            }
             layer.features.emplace_back(std::move(feature));
         }
     }
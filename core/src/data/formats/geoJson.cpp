@@ -7,154 +7,435 @@
 #include "util/mapProjection.h"
 
 #include "glm/glm.hpp"
+#include "rapidjson/encodedstream.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+
+#include <cstring>
 
 namespace Tangram {
 
-bool GeoJson::isFeatureCollection(const JsonValue& _in) {
+namespace {
 
-    // A FeatureCollection must have a "type" of "FeatureCollection"
-    // and a member named "features" that is an array.
-    // http://geojson.org/geojson-spec.html#feature-collection-objects
+// Input read with a GeoJson::ReadFn is buffered in chunks of this size
+constexpr size_t chunkSize = 64 * 1024;
 
-    auto type = _in.FindMember("type");
-    if (type == _in.MemberEnd() || !type->value.IsString() ||
-        std::strcmp(type->value.GetString(), "FeatureCollection") != 0) {
-        return false;
-    }
+/* rapidjson input stream of the chunks returned by a GeoJson::ReadFn */
+class ChunkStream {
+public:
+    typedef char Ch;
 
-    auto features = _in.FindMember("features");
-    if (features == _in.MemberEnd() || !features->value.IsArray()) {
-        return false;
+    ChunkStream(const GeoJson::ReadFn& _read) : m_read(_read), m_buffer(chunkSize) {
+        m_current = m_end = m_buffer.data();
+        fill();
+        // Skip UTF-8 byte order mark
+        if (static_cast<unsigned char>(Peek()) == 0xEFu) { Take(); }
+        if (static_cast<unsigned char>(Peek()) == 0xBBu) { Take(); }
+        if (static_cast<unsigned char>(Peek()) == 0xBFu) { Take(); }
     }
 
-    return true;
+    Ch Peek() const { return m_current < m_end ? *m_current : '\0'; }
 
-}
+    Ch Take() {
+        if (m_current == m_end) { return '\0'; }
+        Ch c = *m_current++;
+        if (m_current == m_end) { fill(); }
+        return c;
+    }
 
-Point GeoJson::getPoint(const JsonValue& _in, const Transform& _proj) {
-    return _proj(LngLat(_in[0].GetDouble(), _in[1].GetDouble()));
-}
+    size_t Tell() const { return m_offset + (m_current - m_buffer.data()); }
 
-Line GeoJson::getLine(const JsonValue& _in, const Transform& _proj) {
+    // Not implemented
+    void Put(Ch) {}
+    void Flush() {}
+    Ch* PutBegin() { return nullptr; }
+    size_t PutEnd(Ch*) { return 0; }
 
-    Line line;
-    for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        line.push_back(getPoint(*itr, _proj));
+private:
+    void fill() {
+        m_offset += m_end - m_buffer.data();
+        size_t size = m_read(m_buffer.data(), m_buffer.size());
+        m_current = m_buffer.data();
+        m_end = m_current + std::min(size, m_buffer.size());
     }
-    return line;
-
-}
 
-Polygon GeoJson::getPolygon(const JsonValue& _in, const Transform& _proj) {
+    const GeoJson::ReadFn& m_read;
+    std::vector<char> m_buffer;
+    const char* m_current = nullptr;
+    const char* m_end = nullptr;
+    // Offset of the buffer in the input
+    size_t m_offset = 0;
+};
+
+/* SAX handler building the geometry and properties of one feature at a time */
+class FeatureHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, FeatureHandler> {
+public:
+
+    FeatureHandler(int32_t _sourceId, const GeoJson::FeatureFn& _onFeature)
+        : m_sourceId(_sourceId), m_onFeature(_onFeature) {}
+
+    bool StartObject() {
+        switch (context()) {
+        case Context::none:
+            beginGeometry();
+            return push(Context::root);
+        case Context::root:
+        case Context::feature:
+            if (m_key == "geometry") {
+                beginGeometry();
+                return push(Context::geometry);
+            }
+            if (m_key == "properties") {
+                m_properties.clear();
+                return push(Context::properties);
+            }
+            if (context() == Context::root) {
+                // Member of an object of named FeatureCollections
+                m_layer = m_key;
+                return push(Context::layer);
+            }
+            break;
+        case Context::features:
+            m_properties.clear();
+            beginGeometry();
+            return push(Context::feature);
+        default:
+            break;
+        }
+        return push(Context::skip);
+    }
 
-    Polygon polygon;
-    for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        polygon.push_back(getLine(*itr, _proj));
+    bool EndObject(rapidjson::SizeType) {
+        auto ended = context();
+        m_stack.pop_back();
+
+        switch (ended) {
+        case Context::root:
+            // A Feature or a geometry
+            if (m_hasCoordinates) { endGeometry(); }
+            emitFeature();
+            break;
+        case Context::layer:
+            m_layer.clear();
+            break;
+        case Context::feature:
+            emitFeature();
+            break;
+        case Context::geometry:
+            endGeometry();
+            break;
+        default:
+            break;
+        }
+        return true;
     }
-    return polygon;
 
-}
+    bool StartArray() {
+        switch (context()) {
+        case Context::root:
+        case Context::layer:
+            if (m_key == "features") { return push(Context::features); }
+            if (m_key == "coordinates" && context() == Context::root) {
+                return beginCoordinates();
+            }
+            break;
+        case Context::geometry:
+            if (m_key == "coordinates") { return beginCoordinates(); }
+            break;
+        case Context::coordinates:
+            m_depth++;
+            return true;
+        default:
+            break;
+        }
+        return push(Context::skip);
+    }
 
-Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
+    bool EndArray(rapidjson::SizeType) {
+        if (context() == Context::coordinates) {
+            endArray();
+            if (--m_depth > 0) { return true; }
+        }
+        m_stack.pop_back();
+        return true;
+    }
 
-    std::vector<PropertyItem> items;
-    items.reserve(_in.MemberCount());
+    bool Key(const char* _str, rapidjson::SizeType _length, bool) {
+        m_key.assign(_str, _length);
+        return true;
+    }
 
-    for (auto it = _in.MemberBegin(); it != _in.MemberEnd(); ++it) {
+    bool String(const char* _str, rapidjson::SizeType _length, bool) {
+        switch (context()) {
+        case Context::root:
+        case Context::geometry:
+            if (m_key == "type") { setType(_str); }
+            break;
+        case Context::properties:
+            m_properties.emplace_back(m_key, std::string(_str, _length));
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
 
-        const auto& name = it->name.GetString();
-        const auto& value = it->value;
-        if (value.IsNumber()) {
-            items.emplace_back(name, value.GetDouble());
-        } else if (it->value.IsString()) {
-            items.emplace_back(name, value.GetString());
-        } else if (it->value.IsBool()) {
-            items.emplace_back(name, double(value.GetBool()));
+    bool Bool(bool _value) {
+        if (context() == Context::properties) {
+            m_properties.emplace_back(m_key, double(_value));
         }
+        return true;
     }
 
-    Properties properties;
-    properties.sourceId = _sourceId;
-    properties.setSorted(std::move(items));
-    properties.sort();
+    bool Int(int _value) { return number(_value); }
+    bool Uint(unsigned _value) { return number(_value); }
+    bool Int64(int64_t _value) { return number(_value); }
+    bool Uint64(uint64_t _value) { return number(_value); }
+    bool Double(double _value) { return number(_value); }
+
+private:
+
+    enum class Context {
+        none,
+        // Top-level object: a FeatureCollection, a Feature, a geometry or named FeatureCollections
+        root,
+        // FeatureCollection in the top-level object
+        layer,
+        // Array of features of a FeatureCollection
+        features,
+        feature,
+        geometry,
+        coordinates,
+        properties,
+        // Values which are not needed
+        skip,
+    };
 
-    return properties;
+    Context context() const { return m_stack.empty() ? Context::none : m_stack.back(); }
 
-}
+    bool push(Context _context) {
+        m_stack.push_back(_context);
+        return true;
+    }
 
-Feature GeoJson::getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId) {
+    bool number(double _value) {
+        switch (context()) {
+        case Context::coordinates:
+            // The first number determines the depth of positions
+            if (m_positionDepth == 0) { m_positionDepth = m_depth; }
+            if (m_depth == m_positionDepth && m_positionSize < 2) {
+                m_position[m_positionSize] = _value;
+            }
+            m_positionSize++;
+            break;
+        case Context::properties:
+            m_properties.emplace_back(m_key, _value);
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
 
-    Feature feature;
+    void beginGeometry() {
+        m_geometry.clear();
+        m_type = GeometryType::unknown;
+        m_typeDepth = 0;
+        m_positionDepth = 0;
+        m_positionSize = 0;
+        m_hasCoordinates = false;
+    }
 
-    // Copy properties into tile data
-    auto properties = _in.FindMember("properties");
-    if (properties != _in.MemberEnd()) {
-        feature.props = getProperties(properties->value, _sourceId);
+    bool beginCoordinates() {
+        m_hasCoordinates = true;
+        m_depth = 1;
+        return push(Context::coordinates);
     }
 
-    // Copy geometry into tile data
-    const JsonValue& geometry = _in["geometry"];
-    const JsonValue& coords = geometry["coordinates"];
-    const std::string& geometryType = geometry["type"].GetString();
+    // Close an array of coordinates at m_depth
+    void endArray() {
+        auto& geometry = m_geometry;
+        if (m_depth == m_positionDepth) {
+            if (m_positionSize >= 2) {
+                geometry.positions.emplace_back(m_position[0], m_position[1]);
+            }
+            m_positionSize = 0;
+        } else if (m_depth == m_positionDepth - 1) {
+            uint32_t begin = geometry.lines.empty() ? 0 : geometry.lines.back().end;
+            geometry.lines.push_back({ begin, uint32_t(geometry.positions.size()) });
+        } else if (m_depth == m_positionDepth - 2) {
+            uint32_t begin = geometry.polygons.empty() ? 0 : geometry.polygons.back().end;
+            geometry.polygons.push_back({ begin, uint32_t(geometry.lines.size()) });
+        }
+    }
 
-    if (geometryType.compare("Point") == 0) {
+    void setType(const char* _type) {
+        static const struct { const char* name; GeometryType type; int depth; } types[] = {
+            { "Point", GeometryType::points, 1 },
+            { "MultiPoint", GeometryType::points, 2 },
+            { "LineString", GeometryType::lines, 2 },
+            { "MultiLineString", GeometryType::lines, 3 },
+            { "Polygon", GeometryType::polygons, 3 },
+            { "MultiPolygon", GeometryType::polygons, 4 },
+        };
+        for (const auto& type : types) {
+            if (std::strcmp(_type, type.name) == 0) {
+                m_type = type.type;
+                m_typeDepth = type.depth;
+            }
+        }
+    }
 
-        feature.geometryType = GeometryType::points;
-        feature.points.push_back(getPoint(coords, _proj));
+    void endGeometry() {
+        // Unsupported types, like GeometryCollection, and coordinates not matching the type
+        // are left without geometry
+        if (m_positionDepth != m_typeDepth || m_geometry.positions.empty()) {
+            m_geometry.clear();
+        } else {
+            m_geometry.type = m_type;
+        }
+    }
 
-    } else if (geometryType.compare("MultiPoint") == 0) {
+    void emitFeature() {
+        if (m_geometry.type == GeometryType::unknown) { return; }
 
-        feature.geometryType = GeometryType::points;
-        for (auto pointCoords = coords.Begin(); pointCoords != coords.End(); ++pointCoords) {
-            feature.points.push_back(getPoint(*pointCoords, _proj));
-        }
+        Properties properties;
+        properties.sourceId = m_sourceId;
+        properties.setSorted(std::move(m_properties));
+        properties.sort();
+        m_properties.clear();
 
-    } else if (geometryType.compare("LineString") == 0) {
+        m_onFeature(m_layer, m_geometry, properties);
+        m_geometry.clear();
+    }
 
-        feature.geometryType = GeometryType::lines;
-        feature.lines.push_back(getLine(coords, _proj));
+    int32_t m_sourceId;
+    const GeoJson::FeatureFn& m_onFeature;
+
+    std::vector<Context> m_stack;
+    std::string m_key;
+    std::string m_layer;
+
+    GeoJson::Geometry m_geometry;
+    std::vector<PropertyItem> m_properties;
+
+    // Geometry type and depth of positions in its coordinates
+    GeometryType m_type = GeometryType::unknown;
+    int m_typeDepth = 0;
+    bool m_hasCoordinates = false;
+    // Depth of the current array of coordinates, and of the positions in them
+    int m_depth = 0;
+    int m_positionDepth = 0;
+    double m_position[2] = { 0, 0 };
+    int m_positionSize = 0;
+};
+
+template<class Stream>
+bool readStream(Stream& _stream, int32_t _sourceId, const GeoJson::FeatureFn& _onFeature,
+                const char** _error, size_t* _errorOffset) {
+
+    FeatureHandler handler(_sourceId, _onFeature);
+    rapidjson::Reader reader;
+    auto result = reader.Parse(_stream, handler);
+
+    *_error = nullptr;
+    *_errorOffset = 0;
+    if (result.IsError()) {
+        *_error = rapidjson::GetParseError_En(result.Code());
+        *_errorOffset = result.Offset();
+        return false;
+    }
+    return true;
+}
 
-    } else if (geometryType.compare("MultiLineString") == 0) {
+} // namespace
 
-        feature.geometryType = GeometryType::lines;
-        for (auto lineCoords = coords.Begin(); lineCoords != coords.End(); ++lineCoords) {
-            feature.lines.push_back(getLine(*lineCoords, _proj));
-        }
+void GeoJson::Geometry::clear() {
+    type = GeometryType::unknown;
+    positions.clear();
+    lines.clear();
+    polygons.clear();
+}
 
-    } else if (geometryType.compare("Polygon") == 0) {
+bool GeoJson::readFeatures(const char* _data, size_t _size, int32_t _sourceId, const FeatureFn& _onFeature,
+                           const char** _error, size_t* _errorOffset) {
 
-        feature.geometryType = GeometryType::polygons;
-        feature.polygons.push_back(getPolygon(coords, _proj));
+    rapidjson::MemoryStream mstream(_data, _size);
+    rapidjson::EncodedInputStream<rapidjson::UTF8<char>, rapidjson::MemoryStream> istream(mstream);
+    return readStream(istream, _sourceId, _onFeature, _error, _errorOffset);
+}
 
-    } else if (geometryType.compare("MultiPolygon") == 0) {
+bool GeoJson::readFeatures(const ReadFn& _read, int32_t _sourceId, const FeatureFn& _onFeature,
+                           const char** _error, size_t* _errorOffset) {
 
-        feature.geometryType = GeometryType::polygons;
-        for (auto polyCoords = coords.Begin(); polyCoords != coords.End(); ++polyCoords) {
-            feature.polygons.push_back(getPolygon(*polyCoords, _proj));
-        }
+    ChunkStream stream(_read);
+    return readStream(stream, _sourceId, _onFeature, _error, _errorOffset);
+}
 
-    }
+void GeoJson::addGeometry(const Geometry& _geometry, const Transform& _proj, Feature& _feature) {
 
-    return feature;
+    _feature.geometryType = _geometry.type;
 
+    switch (_geometry.type) {
+    case GeometryType::points:
+        for (const auto& position : _geometry.positions) {
+            _feature.points.push_back(_proj(position));
+        }
+        break;
+    case GeometryType::lines:
+        _feature.coordinates.reserve(_feature.coordinates.size() + _geometry.positions.size());
+        for (const auto& line : _geometry.lines) {
+            size_t begin = _feature.coordinates.size();
+            for (uint32_t i = line.begin; i < line.end; i++) {
+                _feature.coordinates.push_back(_proj(_geometry.positions[i]));
+            }
+            _feature.endLine(begin);
+        }
+        break;
+    case GeometryType::polygons:
+        _feature.coordinates.reserve(_feature.coordinates.size() + _geometry.positions.size());
+        for (const auto& polygon : _geometry.polygons) {
+            _feature.beginPolygon();
+            for (uint32_t r = polygon.begin; r < polygon.end; r++) {
+                const auto& ring = _geometry.lines[r];
+                size_t begin = _feature.coordinates.size();
+                for (uint32_t i = ring.begin; i < ring.end; i++) {
+                    _feature.coordinates.push_back(_proj(_geometry.positions[i]));
+                }
+                _feature.endRing(begin);
+            }
+        }
+        break;
+    default:
+        break;
+    }
 }
 
-Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId) {
+Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
 
-    Layer layer("");
+    std::vector<PropertyItem> items;
+    items.reserve(_in.MemberCount());
 
-    auto features = _in.FindMember("features");
+    for (auto it = _in.MemberBegin(); it != _in.MemberEnd(); ++it) {
 
-    if (features == _in.MemberEnd()) {
-        LOGE("GeoJSON missing 'features' member");
-        return layer;
+        const auto& name = it->name.GetString();
+        const auto& value = it->value;
+        if (value.IsNumber()) {
+            items.emplace_back(name, value.GetDouble());
+        } else if (it->value.IsString()) {
+            items.emplace_back(name, value.GetString());
+        } else if (it->value.IsBool()) {
+            items.emplace_back(name, double(value.GetBool()));
+        }
     }
 
-    for (auto featureIt = features->value.Begin(); featureIt != features->value.End(); ++featureIt) {
-        layer.features.push_back(getFeature(*featureIt, _proj, _sourceId));
-    }
+    Properties properties;
+    properties.sourceId = _sourceId;
+    properties.setSorted(std::move(items));
+    properties.sort();
 
-    return layer;
+    return properties;
 
 }
 
@@ -164,16 +445,6 @@ std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, int32_t _sou
 
     std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
 
-    // Parse data into a JSON document
-    const char* error;
-    size_t offset;
-    auto document = JsonParseBytes(task.rawTileData->data(), task.rawTileData->size(), &error, &offset);
-
-    if (error) {
-        LOGE("Json parsing failed on tile [%s]: %s (%u)", task.tileId().toString().c_str(), error, offset);
-        return tileData;
-    }
-
     BoundingBox tileBounds(MapProjection::tileBounds(task.tileId()));
     glm::dvec2 tileOrigin = tileBounds.min;
     double tileInverseScale = 1.0 / tileBounds.width();
@@ -186,20 +457,24 @@ std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, int32_t _sou
         };
     };
 
-    // Transform JSON data into TileData using GeoJson functions
-    if (GeoJson::isFeatureCollection(document)) {
-        tileData->layers.push_back(GeoJson::getLayer(document, projFn, _sourceId));
-    } else {
-        for (auto layer = document.MemberBegin(); layer != document.MemberEnd(); ++layer) {
-            if (GeoJson::isFeatureCollection(layer->value)) {
-                tileData->layers.push_back(GeoJson::getLayer(layer->value, projFn, _sourceId));
-                tileData->layers.back().name = layer->name.GetString();
-            }
+    // Build features while parsing, without a JSON document
+    const char* error;
+    size_t offset;
+    auto onFeature = [&](const std::string& _layer, Geometry& _geometry, Properties& _properties) {
+        // Features of a collection are read one after another
+        if (tileData->layers.empty() || tileData->layers.back().name != _layer) {
+            tileData->layers.emplace_back(_layer);
         }
-    }
-
+        auto& features = tileData->layers.back().features;
+        features.emplace_back();
+        features.back().props = std::move(_properties);
+        addGeometry(_geometry, projFn, features.back());
+    };
 
-    // Discard original JSON object and return TileData
+    if (!readFeatures(task.rawTileData->data(), task.rawTileData->size(), _sourceId, onFeature,
+                      &error, &offset)) {
+        LOGE("Json parsing failed on tile [%s]: %s (%u)", task.tileId().toString().c_str(), error, offset);
+    }
 
     return tileData;
 
@@ -14,19 +14,48 @@ namespace GeoJson {
 
 using Transform = std::function<Point(LngLat _lngLat)>;
 
-bool isFeatureCollection(const JsonValue& _in);
+// Reads up to _size bytes of input into _buffer, returning the number of bytes read or 0 at the
+// end of the input
+using ReadFn = std::function<size_t(char* _buffer, size_t _size)>;
 
-Point getPoint(const JsonValue& _in, const Transform& _proj);
+/* Geometry of a feature as read from GeoJSON
+ *
+ * Single and multi-part geometries of the same type are not distinguished: a Point is a single
+ * position, a LineString a single line and a Polygon a single polygon.
+ */
+struct Geometry {
+    GeometryType type = GeometryType::unknown;
+    std::vector<LngLat> positions;
+    // Lines or polygon rings as ranges of 'positions'
+    std::vector<GeometryRange> lines;
+    // Polygons as ranges of 'lines'
+    std::vector<GeometryRange> polygons;
 
-Line getLine(const JsonValue& _in, const Transform& _proj);
+    // Remove all positions, keeping the allocated buffers for reuse
+    void clear();
+};
 
-Polygon getPolygon(const JsonValue& _in, const Transform& _proj);
+// Called for each feature read, with the name of the FeatureCollection containing it in a
+// top-level object of collections, and an empty name otherwise. The geometry is reused for the
+// next feature.
+using FeatureFn = std::function<void(const std::string& _layer, Geometry& _geometry,
+                                     Properties& _properties)>;
 
-Properties getProperties(const JsonValue& _in, int32_t _sourceId);
+/* Read the features of a FeatureCollection, of an object with named FeatureCollections, or of a
+ * single Feature or geometry, without building a JSON document. Returns false and sets _error
+ * and _errorOffset for invalid input, after passing the features read until then to
+ * _onFeature. */
+bool readFeatures(const char* _data, size_t _size, int32_t _sourceId, const FeatureFn& _onFeature,
+                  const char** _error, size_t* _errorOffset);
+
+// Read features from input in chunks, see above
+bool readFeatures(const ReadFn& _read, int32_t _sourceId, const FeatureFn& _onFeature,
+                  const char** _error, size_t* _errorOffset);
 
-Feature getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
+// Append _geometry with coordinates transformed by _proj to the geometry of _feature
+void addGeometry(const Geometry& _geometry, const Transform& _proj, Feature& _feature);
 
-Layer getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
+Properties getProperties(const JsonValue& _in, int32_t _sourceId);
 
 std::shared_ptr<TileData> parseTile(const TileTask& _task, int32_t _sourceId);
 
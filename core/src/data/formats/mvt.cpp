@@ -1,5 +1,6 @@
 #include "data/formats/mvt.h"
 #include "data/propertyItem.h"
+#include "data/tileSource.h"
 #include "tile/tile.h"
 #include "tile/tileTask.h"
 #include "log.h"
@@ -24,13 +25,25 @@
 
 namespace Tangram {
 
-void Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
+// Decode the packed varints of _msg into _ctx.varints, returns the number of values
+static size_t decodeVarints(Mvt::ParserContext& _ctx, protobuf::message _msg) {
+    // A varint takes at least one byte
+    size_t maxValues = _msg.getEnd() - _msg.getData();
+    if (_ctx.varints.size() < maxValues) {
+        _ctx.varints.resize(maxValues);
+    }
+    return _msg.varints(_ctx.varints.data(), maxValues);
+}
+
+void Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn, bool _quantize) {
 
     // previously, this fn was creating new Geometry instance every time, but vector realloc was showing
     //  up in profiling, so we now reuse ParserContext.geometry
     Geometry& geometry = _ctx.geometry;
     geometry.sizes.clear();
     geometry.coordinates.clear();
+    geometry.tileCoordinates.clear();
+    geometry.quantizable = _quantize;
 
     GeomCmd cmd = GeomCmd::moveTo;
     uint32_t cmdRepeat = 0;
@@ -42,36 +55,72 @@ void Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
 
     size_t numCoordinates = 0;
 
-    while(_geomIn.getData() < _geomIn.getEnd()) {
+    // Decode all commands and parameters of the packed geometry in one pass
+    const size_t numValues = decodeVarints(_ctx, _geomIn);
+    const uint64_t* values = _ctx.varints.data();
+    size_t i = 0;
+
+    while(i < numValues) {
 
         if(cmdRepeat == 0) { // get new command, length and parameters..
-            uint32_t cmdData = static_cast<uint32_t>(_geomIn.varint());
+            uint32_t cmdData = static_cast<uint32_t>(values[i++]);
             cmd = static_cast<GeomCmd>(cmdData & 0x7); //first 3 bits of the cmdData
             cmdRepeat = cmdData >> 3; //last 5 bits
         }
 
         if(cmd == GeomCmd::moveTo || cmd == GeomCmd::lineTo) { // get parameters/points
+            if (numValues - i < 2) {
+                throw std::runtime_error("unterminated varint, unexpected end of buffer");
+            }
             // if cmd is move then move to a new line/set of points and save this line
             if(cmd == GeomCmd::moveTo && numCoordinates > 0) {
                 geometry.sizes.push_back(numCoordinates);
                 numCoordinates = 0;
             }
 
-            x += _geomIn.svarint();
-            y += _geomIn.svarint();
+            x += protobuf::message::zigzag(values[i++]);
+            y += protobuf::message::zigzag(values[i++]);
 
-            // bring the points in 0 to 1 space
-            Point p;
-            p.x = invTileExtent * (double)x;
-            p.y = invTileExtent * (double)(_ctx.tileExtent - y);
+            // flip y to point up like tile coordinates
+            int64_t ty = _ctx.tileExtent - y;
 
-            if (numCoordinates == 0 || geometry.coordinates.back() != p) {
-                geometry.coordinates.push_back(p);
-                numCoordinates++;
+            if (geometry.quantizable &&
+                (x < INT16_MIN || x > INT16_MAX || ty < INT16_MIN || ty > INT16_MAX)) {
+                // Out of range of tile units, continue with tile coordinates
+                geometry.quantizable = false;
+                geometry.coordinates.reserve(geometry.tileCoordinates.size() + 1);
+                for (const auto& q : geometry.tileCoordinates) {
+                    geometry.coordinates.emplace_back(invTileExtent * q.x, invTileExtent * q.y);
+                }
+                geometry.tileCoordinates.clear();
+            }
+
+            if (geometry.quantizable) {
+                QuantizedPoint q(int16_t(x), int16_t(ty));
+                if (numCoordinates == 0 || geometry.tileCoordinates.back() != q) {
+                    geometry.tileCoordinates.push_back(q);
+                    numCoordinates++;
+                }
+            } else {
+                // bring the points in 0 to 1 space
+                Point p;
+                p.x = invTileExtent * (double)x;
+                p.y = invTileExtent * (double)ty;
+
+                if (numCoordinates == 0 || geometry.coordinates.back() != p) {
+                    geometry.coordinates.push_back(p);
+                    numCoordinates++;
+                }
             }
         } else if(cmd == GeomCmd::closePath) {
             // end of a polygon, push first point in this line as last and push line to poly
-            geometry.coordinates.push_back(geometry.coordinates[geometry.coordinates.size() - numCoordinates]);
+            if (geometry.quantizable) {
+                size_t first = geometry.tileCoordinates.size() - numCoordinates;
+                geometry.tileCoordinates.push_back(geometry.tileCoordinates[first]);
+            } else {
+                size_t first = geometry.coordinates.size() - numCoordinates;
+                geometry.coordinates.push_back(geometry.coordinates[first]);
+            }
             geometry.sizes.push_back(numCoordinates + 1);
             numCoordinates = 0;
         }
@@ -86,13 +135,11 @@ void Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
     //return geometry;
 }
 
-Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
-
-    Feature feature(_ctx.sourceId);
+bool Mvt::getFeatureTags(ParserContext& _ctx, protobuf::message _featureIn, Feature& _feature) {
 
     _ctx.featureTags.clear();
     _ctx.featureTags.assign(_ctx.keys.size(), -1);
-
+    _ctx.geometryMsg = protobuf::message();
 
     while(_featureIn.next()) {
         switch(_featureIn.tag) {
@@ -102,26 +149,27 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
                 break;
 
             case FEATURE_TAGS: {
-                protobuf::message tagsMsg = _featureIn.getMessage();
+                const size_t numTags = decodeVarints(_ctx, _featureIn.getMessage());
+                const uint64_t* tags = _ctx.varints.data();
 
-                while(tagsMsg) {
-                    auto tagKey = tagsMsg.varint();
+                for (size_t i = 0; i < numTags; i += 2) {
+                    auto tagKey = tags[i];
 
                     if(_ctx.keys.size() <= tagKey) {
                         LOGE("accessing out of bound key");
-                        return feature;
+                        return false;
                     }
 
-                    if(!tagsMsg) {
+                    if(i + 1 == numTags) {
                         LOGE("uneven number of feature tag ids");
-                        return feature;
+                        return false;
                     }
 
-                    auto valueKey = tagsMsg.varint();
+                    auto valueKey = tags[i + 1];
 
                     if( _ctx.values.size() <= valueKey ) {
                         LOGE("accessing out of bound values");
-                        return feature;
+                        return false;
                     }
 
                     _ctx.featureTags[tagKey] = valueKey;
@@ -129,11 +177,11 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
                 break;
             }
             case FEATURE_TYPE:
-                feature.geometryType = (GeometryType)_featureIn.varint();
+                _feature.geometryType = (GeometryType)_featureIn.varint();
                 break;
-            // Actual geometry data
+            // Actual geometry data - decoded by getFeatureGeometry()
             case FEATURE_GEOM:
-                getGeometry(_ctx, _featureIn.getMessage());  //_ctx.geometry =
+                _ctx.geometryMsg = _featureIn.getMessage();
                 break;
 
             default:
@@ -142,7 +190,8 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
         }
     }
 
-    std::vector<Properties::Item> properties;
+    auto& properties = _ctx.properties;
+    properties.clear();
     properties.reserve(_ctx.featureTags.size());
 
     for (int tagKey : _ctx.orderedKeys) {
@@ -151,60 +200,95 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
             properties.emplace_back(_ctx.keys[tagKey], _ctx.values[tagValue]);
         }
     }
-    feature.props.setSorted(std::move(properties));
+    _feature.props.swapSorted(properties);
+
+    return true;
+}
+
+void Mvt::getFeatureGeometry(ParserContext& _ctx, Feature& _feature) {
+
+    // Points are always kept in tile coordinates
+    getGeometry(_ctx, _ctx.geometryMsg,
+                _ctx.quantize && _feature.geometryType != GeometryType::points);
 
-    switch(feature.geometryType) {
+    const Geometry& geometry = _ctx.geometry;
+
+    bool quantized = geometry.quantizable;
+    if (quantized) {
+        _feature.quantizedScale = 1.0 / (_ctx.tileExtent - 1.0);
+    }
+
+    switch(_feature.geometryType) {
         case GeometryType::points:
-            feature.points.insert(feature.points.begin(),
-                                  _ctx.geometry.coordinates.begin(),
-                                  _ctx.geometry.coordinates.end());
+            _feature.points.insert(_feature.points.end(),
+                                   geometry.coordinates.begin(),
+                                   geometry.coordinates.end());
             break;
 
         case GeometryType::lines:
         {
-            auto pos = _ctx.geometry.coordinates.begin();
-            feature.lines.reserve(_ctx.geometry.sizes.size());
-            for (int length : _ctx.geometry.sizes) {
+            size_t begin;
+            if (quantized) {
+                begin = _feature.quantizedCoordinates.size();
+                _feature.quantizedCoordinates.insert(_feature.quantizedCoordinates.end(),
+                                                     geometry.tileCoordinates.begin(),
+                                                     geometry.tileCoordinates.end());
+            } else {
+                begin = _feature.coordinates.size();
+                _feature.coordinates.insert(_feature.coordinates.end(),
+                                            geometry.coordinates.begin(),
+                                            geometry.coordinates.end());
+            }
+            _feature.lineRanges.reserve(_feature.lineRanges.size() + geometry.sizes.size());
+            for (int length : geometry.sizes) {
                 //if (length == 0) { continue; }  -- no longer possible for 0 to be added to sizes
-                Line line;
-                line.reserve(length);
-                line.insert(line.begin(), pos, pos + length);
-                pos += length;
-                feature.lines.emplace_back(std::move(line));
+                _feature.lineRanges.push_back({ uint32_t(begin), uint32_t(begin + length) });
+                begin += length;
             }
             break;
         }
         case GeometryType::polygons:
         {
-            auto pos = _ctx.geometry.coordinates.begin();
-            auto rpos = _ctx.geometry.coordinates.rend();
-            for (int length : _ctx.geometry.sizes) {
+            auto pos = geometry.coordinates.begin();
+            auto rpos = geometry.coordinates.rend();
+            auto tile = geometry.tileCoordinates.begin();
+            for (int length : geometry.sizes) {
                 //if (length == 0) { continue; }
-                float area = signedArea(pos, pos + length);
-                if (area == 0) {
-                    pos += length;
-                    rpos -= length;
-                    continue;
-                }
-                int winding = area > 0 ? 1 : -1;
-                // Determine exterior winding from first polygon.
-                if (_ctx.winding == 0) {
-                    _ctx.winding = winding;
+                // Winding of tile units is the same as of tile coordinates
+                float area = quantized ? signedArea(tile, tile + length) : signedArea(pos, pos + length);
+                if (area != 0) {
+                    int winding = area > 0 ? 1 : -1;
+                    // Determine exterior winding from first polygon.
+                    if (_ctx.winding == 0) {
+                        _ctx.winding = winding;
+                    }
+                    if (winding == _ctx.winding || _feature.polygonRanges.empty()) {
+                        // This is an exterior polygon.
+                        _feature.beginPolygon();
+                    }
+                    if (quantized) {
+                        size_t begin = _feature.quantizedCoordinates.size();
+                        if (_ctx.winding > 0) {
+                            _feature.quantizedCoordinates.insert(_feature.quantizedCoordinates.end(),
+                                                                 tile, tile + length);
+                        } else {
+                            _feature.quantizedCoordinates.insert(_feature.quantizedCoordinates.end(),
+                                                                 std::reverse_iterator<decltype(tile)>(tile + length),
+                                                                 std::reverse_iterator<decltype(tile)>(tile));
+                        }
+                        _feature.endRing(begin);
+                    } else if (_ctx.winding > 0) {
+                        _feature.addRing(pos, pos + length);
+                    } else {
+                        _feature.addRing(rpos - length, rpos);
+                    }
                 }
-                Line line;
-                line.reserve(length);
-                if (_ctx.winding > 0) {
-                    line.insert(line.end(), pos, pos + length);
+                if (quantized) {
+                    tile += length;
                 } else {
-                    line.insert(line.end(), rpos - length, rpos);
-                }
-                pos += length;
-                rpos -= length;
-                if (winding == _ctx.winding || feature.polygons.empty()) {
-                    // This is an exterior polygon.
-                    feature.polygons.emplace_back();
+                    pos += length;
+                    rpos -= length;
                 }
-                feature.polygons.back().push_back(std::move(line));
             }
             break;
         }
@@ -213,22 +297,29 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
         default:
             break;
     }
+}
 
+Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
+
+    Feature feature(_ctx.sourceId);
+
+    if (getFeatureTags(_ctx, _featureIn, feature)) {
+        getFeatureGeometry(_ctx, feature);
+    }
     return feature;
 }
 
 //#define TANGRAM_DUMP_MVT_STATS
 
-Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
-
-    Layer layer("");
+void Mvt::getLayerTables(ParserContext& _ctx, protobuf::message _layerIn, std::string& _name) {
 
     _ctx.keys.clear();
     _ctx.values.clear();
     _ctx.featureMsgs.clear();
 
     bool lastWasFeature = false;
-    size_t numFeatures = 0;
+    size_t& numFeatures = _ctx.numFeatures;
+    numFeatures = 0;
     protobuf::message featureItr;
 #ifdef TANGRAM_DUMP_MVT_STATS
     auto layerPBFSize = _layerIn.getEnd() - _layerIn.getData();
@@ -239,7 +330,7 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
 
         switch(_layerIn.tag) {
             case LAYER_NAME: {
-                layer.name = _layerIn.string();
+                _name = _layerIn.string();
                 break;
             }
             case LAYER_FEATURE: {
@@ -301,10 +392,10 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     }
 
 #ifdef TANGRAM_DUMP_MVT_STATS
-    LOGW("  Layer %s: %d features, %d bytes in PBF", layer.name.c_str(), numFeatures, layerPBFSize);
+    LOGW("  Layer %s: %d features, %d bytes in PBF", _name.c_str(), numFeatures, layerPBFSize);
 #endif
 
-    if (_ctx.featureMsgs.empty()) { return layer; }
+    if (_ctx.featureMsgs.empty()) { return; }
 
     //// Assign ordering to keys for faster sorting
     _ctx.orderedKeys.clear();
@@ -316,10 +407,17 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     // sort by Property key ordering
     std::sort(_ctx.orderedKeys.begin(), _ctx.orderedKeys.end(),
               [&](int a, int b) {
-                  return Properties::keyComparator(_ctx.keys[a], _ctx.keys[b]);
+                  return _ctx.keys[a] < _ctx.keys[b];
               });
+}
+
+Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
 
-    layer.features.reserve(numFeatures);
+    Layer layer("");
+
+    getLayerTables(_ctx, _layerIn, layer.name);
+
+    layer.features.reserve(_ctx.numFeatures);
     for (auto& featureItr : _ctx.featureMsgs) {
         do {
             auto featureMsg = featureItr.getMessage();
@@ -332,14 +430,101 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     return layer;
 }
 
-std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, int32_t _sourceId) {
+Mvt::LazyLayer::LazyLayer(const std::string& _name, protobuf::message _layerIn,
+                          std::shared_ptr<std::vector<char>> _rawData, int32_t _sourceId, bool _quantize)
+    : Tangram::LazyLayer(_name), m_rawData(std::move(_rawData)), m_layerMsg(_layerIn), m_ctx(_sourceId) {
+    m_ctx.quantize = _quantize;
+}
+
+void Mvt::LazyLayer::rewind() {
+    m_nextRun = 0;
+    m_featureItr = protobuf::message();
+    m_geometryMsgs.clear();
+
+    if (m_initialized) { return; }
+    m_initialized = true;
+
+    try {
+        std::string layerName;
+        getLayerTables(m_ctx, m_layerMsg, layerName);
+    } catch(const std::exception& e) {
+        LOGE("Cannot parse layer %s: %s", name.c_str(), e.what());
+        m_valid = false;
+    }
+}
+
+bool Mvt::LazyLayer::nextFeature(Feature& _feature) {
+
+    _feature.props.clear();
+    _feature.props.sourceId = m_ctx.sourceId;
+    _feature.geometryType = GeometryType::polygons;
+    _feature.clearGeometry();
+
+    if (!m_valid) { return false; }
+
+    try {
+        // m_featureItr points at the last feature of the current run of consecutive features
+        if (!(m_featureItr.next() && m_featureItr.tag == LAYER_FEATURE)) {
+            if (m_nextRun >= m_ctx.featureMsgs.size()) { return false; }
+            m_featureItr = m_ctx.featureMsgs[m_nextRun++];
+        }
+        auto featureMsg = m_featureItr.getMessage();
+
+        if (!getFeatureTags(m_ctx, featureMsg, _feature)) {
+            // keep going with next feature, as the eager parser does
+            _feature.props.clear();
+            m_ctx.geometryMsg = protobuf::message();
+        }
+        m_geometryMsgs.push_back(m_ctx.geometryMsg);
+        return true;
+    } catch(const std::exception& e) {
+        LOGE("Cannot parse feature of layer %s: %s", name.c_str(), e.what());
+        m_valid = false;
+        return false;
+    }
+}
+
+void Mvt::LazyLayer::getGeometry(Feature& _feature) {
+    if (!m_valid) { return; }
+
+    try {
+        getFeatureGeometry(m_ctx, _feature);
+    } catch(const std::exception& e) {
+        LOGE("Cannot parse feature geometry of layer %s: %s", name.c_str(), e.what());
+        m_valid = false;
+    }
+}
+
+void Mvt::LazyLayer::getGeometry(size_t _index, Feature& _feature) {
+    if (_index >= m_geometryMsgs.size()) { return; }
+
+    m_ctx.geometryMsg = m_geometryMsgs[_index];
+    getGeometry(_feature);
+}
+
+std::string Mvt::getLayerName(protobuf::message _layerIn) {
+    // name is usually the first field, so this is cheap
+    while (_layerIn.next()) {
+        if (_layerIn.tag == LAYER_NAME) {
+            return _layerIn.string();
+        }
+        _layerIn.skip();
+    }
+    return "";
+}
+
+std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, const TileSource& _source) {
 
     auto tileData = std::make_shared<TileData>();
 
     auto& task = static_cast<const BinaryTileTask&>(_task);
 
     protobuf::message item(task.rawTileData->data(), task.rawTileData->size());
-    ParserContext ctx(_sourceId);
+    int32_t sourceId = _source.id();
+    bool lazy = _source.lazyDecoding();
+    bool quantize = _source.quantizedGeometry();
+    ParserContext ctx(sourceId);
+    ctx.quantize = quantize;
 
 #ifdef TANGRAM_DUMP_MVT_STATS
     LOGW("Stats for vector tile %s (%d bytes):", _task.tileId().toString().c_str(), task.rawTileData->size());
@@ -348,7 +533,17 @@ std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, int32_t _sourceI
     try {
         while(item.next()) {
             if(item.tag == LAYER) {
-                tileData->layers.push_back(getLayer(ctx, item.getMessage()));
+                // getMessage() skips over the layer, no need to look further if it is not used
+                auto layerMsg = item.getMessage();
+                auto name = getLayerName(layerMsg);
+                if (!_source.hasCollection(name)) { continue; }
+
+                if (lazy) {
+                    tileData->lazyLayers.push_back(
+                        std::make_unique<LazyLayer>(name, layerMsg, task.rawTileData, sourceId, quantize));
+                } else {
+                    tileData->layers.push_back(getLayer(ctx, layerMsg));
+                }
             } else {
                 item.skip();
             }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/propertyItem.h"
 #include "data/tileData.h"
 #include "pbf/pbf.hpp"
 #include "util/variant.h"
@@ -11,31 +12,48 @@
 namespace Tangram {
 
 class Tile;
+class TileSource;
 class TileTask;
 class MapProjection;
 
 namespace Mvt {
 
     struct Geometry {
+        // Tile coordinates, unless the geometry is quantizable
         std::vector<Point> coordinates;
         std::vector<int> sizes;
+        // Tile units with y pointing up, instead of 'coordinates' when quantizable
+        std::vector<QuantizedPoint> tileCoordinates;
+        // Whether the geometry was decoded with quantization and all tile units are in the
+        // range of QuantizedPoint
+        bool quantizable = false;
     };
 
     struct ParserContext {
         ParserContext(int32_t _sourceId) : sourceId(_sourceId){}
 
         int32_t sourceId;
-        std::vector<std::string> keys;
+        // Layer keys, interned once per layer
+        std::vector<PropertyKey> keys;
         std::vector<Value> values;
         std::vector<protobuf::message> featureMsgs;
         Geometry geometry;
+        // Geometry of the last feature read by getFeatureTags()
+        protobuf::message geometryMsg;
         // Map Key ID -> Tag values
         std::vector<int> featureTags;
-        // Key IDs sorted by Property key ordering
+        // Key IDs sorted by PropertyKey id
         std::vector<int> orderedKeys;
+        // Reused property storage, see Properties::swapSorted()
+        std::vector<Properties::Item> properties;
+        // Reused buffer for packed tags and geometry, see protobuf::message::varints()
+        std::vector<uint64_t> varints;
 
+        size_t numFeatures = 0;
         int tileExtent = 0;
         int winding = 0;
+        // Keep line and polygon geometry in tile units, see TileSource::quantizedGeometry()
+        bool quantize = false;
     };
 
     enum GeomCmd {
@@ -44,13 +62,56 @@ namespace Mvt {
         closePath = 7
     };
 
-    void getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
+    /* Layer that keeps its features as protobuf messages into the raw tile data; key/value tables are
+     * decoded on first use and feature geometry only when requested by TileBuilder, i.e. after the
+     * feature matched a draw rule */
+    class LazyLayer : public Tangram::LazyLayer {
+    public:
+        LazyLayer(const std::string& _name, protobuf::message _layerIn,
+                  std::shared_ptr<std::vector<char>> _rawData, int32_t _sourceId, bool _quantize);
+
+        void rewind() override;
+        bool nextFeature(Feature& _feature) override;
+        void getGeometry(Feature& _feature) override;
+        void getGeometry(size_t _index, Feature& _feature) override;
+
+    private:
+        // Keeps the data referenced by m_layerMsg and m_ctx.featureMsgs alive
+        std::shared_ptr<std::vector<char>> m_rawData;
+        protobuf::message m_layerMsg;
+        ParserContext m_ctx;
+        bool m_initialized = false;
+        bool m_valid = true;
+
+        // iteration state
+        size_t m_nextRun = 0;
+        protobuf::message m_featureItr;
+        // Geometry messages of the features returned since rewind()
+        std::vector<protobuf::message> m_geometryMsgs;
+    };
+
+    // Decode _geomIn into _ctx.geometry, as tile units with _quantize when they fit
+    void getGeometry(ParserContext& _ctx, protobuf::message _geomIn, bool _quantize = false);
+
+    // Read properties and geometry type of _featureIn, geometry message is stored for getFeatureGeometry
+    bool getFeatureTags(ParserContext& _ctx, protobuf::message _featureIn, Feature& _feature);
+
+    void getFeatureGeometry(ParserContext& _ctx, Feature& _feature);
 
     Feature getFeature(ParserContext& _ctx, protobuf::message _featureIn);
 
+    // Read name, key/value tables and feature messages of _layerIn into _ctx
+    void getLayerTables(ParserContext& _ctx, protobuf::message _layerIn, std::string& _name);
+
     Layer getLayer(ParserContext& _ctx, protobuf::message _layerIn);
 
-    std::shared_ptr<TileData> parseTile(const TileTask& _task, int32_t _sourceId);
+    // Read layer name without decoding the rest of _layerIn
+    std::string getLayerName(protobuf::message _layerIn);
+
+    // Layers not referenced by the scene (see TileSource::hasCollection) are skipped; with
+    // TileSource::lazyDecoding() layers are added to TileData::lazyLayers and decoded while
+    // building the tile
+    std::shared_ptr<TileData> parseTile(const TileTask& _task, const TileSource& _source);
 
 } // namespace Mvt
 
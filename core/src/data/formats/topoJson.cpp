@@ -50,7 +50,7 @@ TopoJson::Topology TopoJson::getTopology(const JsonDocument& _document, const Tr
             continue;
         }
 
-        Line arc;
+        std::vector<Point> arc;
         arc.reserve(jsonArc.Size());
 
         // Quantized position
@@ -63,7 +63,7 @@ TopoJson::Topology TopoJson::getTopology(const JsonDocument& _document, const Tr
             arc.push_back(getPoint(jsonCoords, topo, q));
         }
 
-        topo.arcs.push_back(arc);
+        topo.arcs.push_back(std::move(arc));
     }
 
     return topo;
@@ -83,12 +83,10 @@ Point TopoJson::getPoint(const JsonValue& _coordinates, const Topology& _topolog
 
 }
 
-Line TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology) {
-
-    Line line;
+void TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology, std::vector<Point>& _coordinates) {
 
     if (!_arcs.IsArray()) {
-        return line;
+        return;
     }
 
     for (auto arcIt = _arcs.Begin(); arcIt != _arcs.End(); ++arcIt) {
@@ -100,7 +98,7 @@ Line TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology) {
             index = -1 - index;
         }
 
-        if (index < 0 || (std::vector<Line>::size_type)index >= _topology.arcs.size()) {
+        if (index < 0 || (size_t)index >= _topology.arcs.size()) {
             continue;
         }
 
@@ -123,32 +121,37 @@ Line TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology) {
         }
 
         for (auto pointIt = begin; pointIt != end; pointIt += inc) {
-            line.push_back(*pointIt);
+            _coordinates.push_back(*pointIt);
         }
 
     }
 
-    return line;
+}
+
+void TopoJson::addLine(const JsonValue& _arcs, const Topology& _topology, Feature& _feature) {
+
+    size_t begin = _feature.coordinates.size();
+    getLine(_arcs, _topology, _feature.coordinates);
+    _feature.endLine(begin);
 
 }
 
-Polygon TopoJson::getPolygon(const JsonValue& _arcSets, const Topology& _topology) {
+void TopoJson::addPolygon(const JsonValue& _arcSets, const Topology& _topology, Feature& _feature) {
 
-    Polygon polygon;
+    _feature.beginPolygon();
 
     if (!_arcSets.IsArray()) {
-        return polygon;
+        return;
     }
 
     for (auto arcSetIt = _arcSets.Begin(); arcSetIt != _arcSets.End(); ++arcSetIt) {
 
-        auto ring = getLine(*arcSetIt, _topology);
-        polygon.push_back(ring);
+        size_t begin = _feature.coordinates.size();
+        getLine(*arcSetIt, _topology, _feature.coordinates);
+        _feature.endRing(begin);
 
     }
 
-    return polygon;
-
 }
 
 Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _source) {
@@ -192,7 +195,7 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         feature.geometryType = GeometryType::lines;
         auto arcsIt = _geometry.FindMember(keyArcs);
         if (arcsIt != _geometry.MemberEnd()) {
-            feature.lines.push_back(getLine(arcsIt->value, _topology));
+            addLine(arcsIt->value, _topology, feature);
         }
     } else if (type == "MultiLineString") {
         feature.geometryType = GeometryType::lines;
@@ -200,14 +203,14 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         if (arcsIt != _geometry.MemberEnd() && arcsIt->value.IsArray()) {
             auto& arcs = arcsIt->value;
             for (auto arcList = arcs.Begin(); arcList != arcs.End(); ++arcList) {
-                feature.lines.push_back(getLine(*arcList, _topology));
+                addLine(*arcList, _topology, feature);
             }
         }
     } else if (type == "Polygon") {
         feature.geometryType = GeometryType::polygons;
         auto arcsIt = _geometry.FindMember(keyArcs);
         if (arcsIt != _geometry.MemberEnd()) {
-            feature.polygons.push_back(getPolygon(arcsIt->value, _topology));
+            addPolygon(arcsIt->value, _topology, feature);
         }
     } else if (type == "MultiPolygon") {
         feature.geometryType = GeometryType::polygons;
@@ -215,7 +218,7 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         if (arcsIt != _geometry.MemberEnd() && arcsIt->value.IsArray()) {
             auto& arcs = arcsIt->value;
             for (auto arcList = arcs.Begin(); arcList != arcs.End(); ++arcList) {
-                feature.polygons.push_back(getPolygon(*arcList, _topology));
+                addPolygon(*arcList, _topology, feature);
             }
         }
     } else if (type == "GeometryCollection") {
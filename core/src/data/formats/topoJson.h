@@ -19,7 +19,7 @@ using Transform = std::function<Point(LngLat _lngLat)>;
 struct Topology {
     glm::dvec2 scale = { 1., 1. };
     glm::dvec2 translate = { 0., 0. };
-    std::vector<Line> arcs;
+    std::vector<std::vector<Point>> arcs;
     Transform proj;
 };
 
@@ -27,9 +27,14 @@ Topology getTopology(const JsonDocument& _document, const Transform& _proj);
 
 Point getPoint(const JsonValue& _coordinates, const Topology& _topology, glm::ivec2& _cursor);
 
-Line getLine(const JsonValue& _arcs, const Topology& _topology);
+// Append the coordinates of a line made from _arcs to _coordinates
+void getLine(const JsonValue& _arcs, const Topology& _topology, std::vector<Point>& _coordinates);
 
-Polygon getPolygon(const JsonValue& _arcs, const Topology& _topology);
+// Append a line to the geometry of _feature
+void addLine(const JsonValue& _arcs, const Topology& _topology, Feature& _feature);
+
+// Append a polygon to the geometry of _feature
+void addPolygon(const JsonValue& _arcs, const Topology& _topology, Feature& _feature);
 
 Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _sourceId);
 
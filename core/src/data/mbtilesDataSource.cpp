@@ -1,5 +1,7 @@
 #include "data/mbtilesDataSource.h"
 
+#include "data/missingTileCache.h"
+#include "debug/trace.h"
 #include "util/asyncWorker.h"
 #include "util/zlibHelper.h"
 #include "log.h"
@@ -12,6 +14,8 @@
 #include "sqlitepp.h"
 #include "hash-library/md5.cpp"
 
+#include <algorithm>
+
 
 namespace Tangram {
 
@@ -56,6 +60,8 @@ CREATE UNIQUE INDEX IF NOT EXISTS images_id ON images (tile_id);
 CREATE UNIQUE INDEX IF NOT EXISTS name ON metadata (name);
 CREATE UNIQUE INDEX IF NOT EXISTS offline_index ON offline_tiles (tile_id, offline_id);
 CREATE UNIQUE INDEX IF NOT EXISTS last_access_index ON tile_last_access (tile_id);
+-- index for finding least recently used tiles to evict
+CREATE INDEX IF NOT EXISTS last_access_time ON tile_last_access (last_access);
 -- need index on map.tile_id for tile deletion
 CREATE INDEX IF NOT EXISTS map_tile_id ON map (tile_id);
 
@@ -77,7 +83,7 @@ CREATE VIEW IF NOT EXISTS tiles AS
     FROM map
     JOIN images ON images.tile_id = map.tile_id;
 
-PRAGMA user_version = 3;
+PRAGMA user_version = 4;
 
 COMMIT;)SQL_ESC";
 
@@ -90,6 +96,7 @@ struct MBTilesQueries {
     SQLiteStmt getOffline = nullptr;
     SQLiteStmt putOffline = nullptr;
     SQLiteStmt putLastAccess = nullptr;
+    SQLiteStmt evictTiles = nullptr;
 
     struct tag_cache {};
     MBTilesQueries(sqlite3* db);
@@ -107,15 +114,50 @@ MBTilesQueries::MBTilesQueries(sqlite3* db, tag_cache) :
     getOffline(db, "SELECT 1,tile_id FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?;"),
     putOffline(db, "REPLACE INTO offline_tiles (tile_id, offline_id) VALUES (?, ?);"),
     putLastAccess(db, "REPLACE INTO tile_last_access (tile_id, last_access) VALUES"
-        " (?, CAST(strftime('%s') AS INTEGER));") {}
+        " (?, CAST(strftime('%s') AS INTEGER));"),
+    // delete_tile trigger removes the map and tile_last_access rows
+    evictTiles(db, "DELETE FROM images WHERE tile_id IN (SELECT tile_id FROM tile_last_access"
+        " WHERE tile_id NOT IN (SELECT tile_id FROM offline_tiles) ORDER BY last_access LIMIT ?);") {}
+
+// Most tiles looked up by one query of a reader thread
+static constexpr size_t maxReadBatch = 16;
+
+// Pending cache writes are committed when there are this many tiles and access times, when the
+// oldest has waited this long, or when the worker is idle for a while
+static constexpr size_t maxPendingWrites = 64;
+static constexpr auto maxWriteDelay = std::chrono::seconds(2);
+static constexpr auto idleWriteDelay = std::chrono::milliseconds(250);
+
+// Tiles evicted by one transaction, and the share of the cache size limit to evict down to
+static constexpr int evictBatchSize = 32;
+static constexpr float evictTargetRatio = 0.9f;
+
+struct MBTilesReader {
+    SQLiteDB db;
+    // Statements looking up 1 to maxReadBatch tiles, by number of tiles - 1
+    std::vector<SQLiteStmt> queries;
+};
+
+static std::string batchQuery(bool _cacheMode, size_t _count) {
+    std::string sql = _cacheMode
+        ? "SELECT zoom_level, tile_column, tile_row, tile_data, images.tile_id, images.created_at"
+          " FROM images JOIN map ON images.tile_id = map.tile_id"
+        : "SELECT zoom_level, tile_column, tile_row, tile_data FROM tiles";
+    sql += " WHERE (zoom_level, tile_column, tile_row) IN (VALUES (?, ?, ?)";
+    for (size_t i = 1; i < _count; i++) { sql += ", (?, ?, ?)"; }
+    sql += ");";
+    return sql;
+}
 
 MBTilesDataSource::MBTilesDataSource(Platform& _platform, std::string _name, std::string _path,
-                                     std::string _mime, int64_t _maxCacheAge, bool _offlineFallback)
+                                     std::string _mime, int64_t _maxCacheAge, bool _offlineFallback,
+                                     size_t _maxCacheSize)
     : m_name(_name),
       m_path(_path),
       m_mime(_mime),
       m_cacheMode(_maxCacheAge > 0),
       m_maxCacheAge(_maxCacheAge),
+      m_maxCacheSize(_maxCacheSize),
       m_offlineMode(_offlineFallback),
       m_platform(_platform) {
 
@@ -124,10 +166,37 @@ MBTilesDataSource::MBTilesDataSource(Platform& _platform, std::string _name, std
     if (m_maxCacheAge > (1<<30)) { m_maxCacheAge = std::min(m_maxCacheAge, int64_t(secSinceEpoch())); }
 
     openMBTiles();
+
+    if (m_db && m_cacheMode) {
+        m_worker->setIdleTask(idleWriteDelay, [this](){
+            flushWrites();
+            limitCacheSize();
+        });
+        if (m_maxCacheSize > 0) {
+            m_worker->enqueue([this](){ initEviction(); });
+        }
+    }
+
+    // Offline fallback reads only when the next source fails, on the worker
+    if (m_db && !m_offlineMode) {
+        openReaders(std::max(2u, std::min(4u, std::thread::hardware_concurrency())));
+    }
 }
 
 // need explicit destructor since MBTilesQueries is incomplete in header
-MBTilesDataSource::~MBTilesDataSource() {}
+MBTilesDataSource::~MBTilesDataSource() {
+    {
+        std::lock_guard<std::mutex> lock(m_readMutex);
+        m_readersRunning = false;
+    }
+    m_readCondition.notify_all();
+    for (auto& thread : m_readerThreads) { thread.join(); }
+
+    // Run the writes still queued, then commit what the worker left pending
+    m_worker->waitForCompletion();
+    m_worker.reset();
+    if (m_db) { flushWrites(); }
+}
 
 bool MBTilesDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
 
@@ -145,77 +214,223 @@ bool MBTilesDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb
 
     if (_task->rawSource == this->level) {
 
-        m_worker->enqueue([this, _task, _cb](){
-            if (_task->isCanceled()) {  // task may have been canceled while in queue
-              LOGV("%s - canceled tile: %s", m_name.c_str(), _task->tileId().toString().c_str());
-              return;
+        // Lookups which write offline ids run on the writer
+        if (_task->offlineId || m_readers.empty()) {
+            m_worker->enqueue([this, _task, _cb](){
+                if (_task->isCanceled()) {  // task may have been canceled while in queue
+                  LOGV("%s - canceled tile: %s", m_name.c_str(), _task->tileId().toString().c_str());
+                  return;
+                }
+                auto prana = _task->prana();  // lock Scene when running callback on thread
+                if (!prana) {
+                    LOGW("MBTilesDataSource callback for deleted Scene!");
+                    return;
+                }
+                TileID tileId = _task->tileId();
+                LOGTO(">>> DB query for %s %s",
+                      _task->source() ? _task->source()->name().c_str() : "?", tileId.toString().c_str());
+
+                auto tileData = std::make_unique<std::vector<char>>();
+                int64_t createdAt = 0;
+                Trace::begin("MBTilesDataSource::getTileData");
+                {
+                    DurationCounter::scope _time(m_queryTime);
+                    getTileData(tileId, *tileData, createdAt, _task->offlineId);
+                }
+                Trace::end("MBTilesDataSource::getTileData");
+                m_queryTiles.add();
+                LOGTO("<<< DB query for %s %s%s", _task->source() ? _task->source()->name().c_str() : "?",
+                      tileId.toString().c_str(), tileData->empty() ? " (not found)" : "");
+
+                onTileData(_task, _cb, std::move(tileData), createdAt);
+            });
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(m_readMutex);
+                m_readQueue.push_back({ _task, _cb });
             }
-            auto prana = _task->prana();  // lock Scene when running callback on thread
-            if (!prana) {
-                LOGW("MBTilesDataSource callback for deleted Scene!");
-                return;
+            m_readCondition.notify_one();
+        }
+        return true;
+    }
+
+    return loadNextSource(_task, _cb);
+}
+
+void MBTilesDataSource::onTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb,
+                                   std::unique_ptr<std::vector<char>> _tileData, int64_t _createdAt) {
+
+    TileID tileId = _task->tileId();
+    auto& task = static_cast<BinaryTileTask&>(*_task);
+
+    // if tile is expired, request from network, falling back to stale tile on failure
+    int64_t minCreatedAt = m_maxCacheAge > (1<<30) ? m_maxCacheAge
+                                                   : int64_t(secSinceEpoch()) - m_maxCacheAge;
+    TileTaskCb stalecb;
+    if (next && m_cacheMode && _createdAt < minCreatedAt) {
+        LOGV("%s - stale tile: %s", m_name.c_str(), tileId.toString().c_str());
+        // can't capture unique_ptr, and callback not guaranteed to be called so can't use bare ptr
+        // ... and we don't want to put stale data in rawTileData or we'd need a flag to skip writing
+        //  back to DB (erroneously updating creation time) should network request fail
+        std::shared_ptr<std::vector<char>> staleData(std::move(_tileData));
+        stalecb.func = [_cb, staleData](std::shared_ptr<TileTask> _task2) {
+            auto prana2 = _task2->prana();  // lock Scene when running callback on thread
+            if (!prana2) { return; }
+
+            if (!_task2->hasData()) {
+                static_cast<BinaryTileTask&>(*_task2).rawTileData = staleData;
+                // The tile is not missing while there is stale data for it
+                if (_task2->source()) { _task2->source()->missingTiles().erase(_task2->tileId()); }
             }
-            TileID tileId = _task->tileId();
-            LOGTO(">>> DB query for %s %s",
-                  _task->source() ? _task->source()->name().c_str() : "?", tileId.toString().c_str());
+            _cb.func(_task2);
+        };
+    }
 
-            auto& task = static_cast<BinaryTileTask&>(*_task);
-            auto tileData = std::make_unique<std::vector<char>>();
-            // RasterTileTask::hasData() doesn't check if rawTileData is empty - it probably should, but
-            //  let's not set rawTileData to empty vector, to match NetworkDataSource behavior
-            int64_t createdAt = 0;
-            getTileData(tileId, *tileData, createdAt, task.offlineId);
-            LOGTO("<<< DB query for %s %s%s", _task->source() ? _task->source()->name().c_str() : "?",
-                  tileId.toString().c_str(), tileData->empty() ? " (not found)" : "");
-
-            // if tile is expired, request from network, falling back to stale tile on failure
-            int64_t minCreatedAt = m_maxCacheAge > (1<<30) ? m_maxCacheAge
-                                                           : int64_t(secSinceEpoch()) - m_maxCacheAge;
-            TileTaskCb stalecb;
-            if (next && m_cacheMode && createdAt < minCreatedAt) {
-                LOGV("%s - stale tile: %s", m_name.c_str(), tileId.toString().c_str());
-                // can't capture unique_ptr, and callback not guaranteed to be called so can't use bare ptr
-                // ... and we don't want to put stale data in rawTileData or we'd need a flag to skip writing
-                //  back to DB (erroneously updating creation time) should network request fail
-                std::shared_ptr<std::vector<char>> staleData(std::move(tileData));
-                stalecb.func = [_cb, staleData](std::shared_ptr<TileTask> _task2) {
-                    auto prana2 = _task2->prana();  // lock Scene when running callback on thread
-                    if (!prana2) { return; }
-
-                    if (!_task2->hasData()) {
-                        static_cast<BinaryTileTask&>(*_task2).rawTileData = staleData;
-                    }
-                    _cb.func(_task2);
-                };
+    if (_tileData && !_tileData->empty()) {
+        task.rawTileData = std::move(_tileData);  // known data race w/ TileTask::hasData() on main thread
+        LOGV("%s - loaded tile: %s, %d bytes", m_name.c_str(), tileId.toString().c_str(), task.rawTileData->size());
+
+        _cb.func(_task);
+
+    } else if (next && _task->source() && _task->source()->missingTiles().contains(tileId)) {
+        // Loading from next source failed recently
+        LOGV("%s - skip missing tile: %s", m_name.c_str(), tileId.toString().c_str());
+        (stalecb.func ? stalecb : _cb).func(_task);
+
+    } else if (next) {
+        LOGV("%s - requesting tile: %s", m_name.c_str(), tileId.toString().c_str());
+
+        // Don't try this source again
+        _task->rawSource = next->level;
+
+        if (!loadNextSource(_task, stalecb.func ? stalecb :_cb)) {
+            // Trigger TileManager update so that tile will be
+            // downloaded next time; the retry gives up while the failure is remembered
+            if (_task->source()) {
+                _task->source()->missingTiles().put(tileId, MissingTileCache::Failure::offline);
             }
+            _task->setNeedsLoading(true);
+            m_platform.requestRender();
+        }
+    } else {
+        LOGD("%s - missing tile: %s", m_name.c_str(), _task->tileId().toString().c_str());
+        _cb.func(_task);  // added 2022-09-27 ... were doing this in loadNextSource, why not here?
+    }
+}
 
-            if (tileData && !tileData->empty()) {
-                task.rawTileData = std::move(tileData);  // known data race w/ TileTask::hasData() on main thread
-                LOGV("%s - loaded tile: %s, %d bytes", m_name.c_str(), tileId.toString().c_str(), task.rawTileData->size());
+void MBTilesDataSource::runReader(MBTilesReader& _reader) {
+    Trace::setThreadName(("MBTilesDataSource reader: " + m_name).c_str());
+
+    std::vector<ReadRequest> requests;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_readMutex);
+            m_readCondition.wait(lock, [&]{ return !m_readersRunning || !m_readQueue.empty(); });
+            if (!m_readersRunning) { break; }
+
+            // Coalesce requests which queued up while all readers were busy, sharing them
+            // between readers
+            size_t count = (m_readQueue.size() + m_readers.size() - 1) / m_readers.size();
+            count = std::min(count, maxReadBatch);
+            for (size_t i = 0; i < count; i++) {
+                requests.push_back(std::move(m_readQueue.front()));
+                m_readQueue.pop_front();
+            }
+        }
+        readTiles(_reader, requests);
+        requests.clear();
+    }
+}
 
-                _cb.func(_task);
+void MBTilesDataSource::readTiles(MBTilesReader& _reader, std::vector<ReadRequest>& _requests) {
 
-            } else if (next) {
-                LOGV("%s - requesting tile: %s", m_name.c_str(), tileId.toString().c_str());
+    // Lock Scenes while running callbacks on this thread
+    std::vector<std::shared_ptr<ScenePrana>> pranas;
+    _requests.erase(std::remove_if(_requests.begin(), _requests.end(), [&](auto& request) {
+        if (request.task->isCanceled()) {  // task may have been canceled while in queue
+            LOGV("%s - canceled tile: %s", m_name.c_str(), request.task->tileId().toString().c_str());
+            return true;
+        }
+        auto prana = request.task->prana();
+        if (!prana) {
+            LOGW("MBTilesDataSource callback for deleted Scene!");
+            return true;
+        }
+        pranas.push_back(std::move(prana));
+        return false;
+    }), _requests.end());
 
-                // Don't try this source again
-                _task->rawSource = next->level;
+    // Tiles waiting to be written by the worker are not in the database yet
+    _requests.erase(std::remove_if(_requests.begin(), _requests.end(), [&](auto& request) {
+        auto data = std::make_unique<std::vector<char>>();
+        if (!getPendingTileData(request.task->tileId(), *data)) { return false; }
+        onTileData(std::move(request.task), std::move(request.cb), std::move(data), int64_t(secSinceEpoch()));
+        return true;
+    }), _requests.end());
+
+    if (_requests.empty()) { return; }
+
+    struct Result {
+        std::unique_ptr<std::vector<char>> data = std::make_unique<std::vector<char>>();
+        int64_t createdAt = 0;
+    };
+    std::vector<Result> results(_requests.size());
+    std::vector<std::string> accessed;
+
+    auto& query = _reader.queries[_requests.size() - 1];
+    int loc = 1;
+    for (auto& request : _requests) {
+        const auto& tileId = request.task->tileId();
+        // MBTiles uses TMS (tile row incr. south to north) while TileID is WMTS
+        query.bind_at(loc, int(tileId.z), tileId.x, (1 << tileId.z) - 1 - tileId.y);
+        loc += 3;
+    }
 
-                if (!loadNextSource(_task, stalecb.func ? stalecb :_cb)) {
-                    // Trigger TileManager update so that tile will be
-                    // downloaded next time.
-                    _task->setNeedsLoading(true);
-                    m_platform.requestRender();
+    Trace::begin("MBTilesDataSource::readTiles");
+    {
+        DurationCounter::scope _time(m_queryTime);
+        query.exec([&](int z, int x, int y, sqlite3_stmt* stmt) {
+            y = (1 << z) - 1 - y;
+            const char* blob = (const char*) sqlite3_column_blob(stmt, 3);
+            const int length = sqlite3_column_bytes(stmt, 3);
+
+            for (size_t i = 0; i < _requests.size(); i++) {
+                const auto& tileId = _requests[i].task->tileId();
+                if (tileId.z != z || tileId.x != x || tileId.y != y) { continue; }
+
+                decodeTileData(blob, length, *results[i].data);
+                if (m_cacheMode) {
+                    results[i].createdAt = sqlite3_column_int64(stmt, 5);
+                    accessed.emplace_back((const char*)sqlite3_column_text(stmt, 4));
                 }
-            } else {
-                LOGD("%s - missing tile: %s", m_name.c_str(), _task->tileId().toString().c_str());
-                _cb.func(_task);  // added 2022-09-27 ... were doing this in loadNextSource, why not here?
             }
         });
-        return true;
     }
+    Trace::end("MBTilesDataSource::readTiles");
+    m_queryTiles.add(_requests.size());
 
-    return loadNextSource(_task, _cb);
+    if (!accessed.empty()) {
+        m_worker->enqueue([this, accessed = std::move(accessed)]() mutable {
+            for (auto& tileid : accessed) { queueLastAccess(std::move(tileid)); }
+            flushWritesIfDue();
+        });
+    }
+
+    for (size_t i = 0; i < _requests.size(); i++) {
+        onTileData(std::move(_requests[i].task), std::move(_requests[i].cb),
+                   std::move(results[i].data), results[i].createdAt);
+    }
+}
+
+void MBTilesDataSource::getStats(TileSourceStats& _stats) const {
+    _stats.mbtilesQueryTime = m_queryTime.get();
+    _stats.mbtilesQueryTiles = m_queryTiles.get();
+    _stats.mbtilesWriteTime = m_writeTime.get();
+    _stats.mbtilesWriteRows = m_writeRows.get();
+    _stats.mbtilesCacheBytes = m_cacheBytes.load(std::memory_order_relaxed);
+    _stats.mbtilesEvictedTiles = m_evictedTiles.get();
+
+    if (next) { next->getStats(_stats); }
 }
 
 bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
@@ -241,8 +456,10 @@ bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTask
                     // rawTileData now points to uncompressed data for building tile, while tileData points
                     //  to compressed data received from server to be stored in DB
                     if (m_cacheMode && m_schemaOptions.compression != Compression::undefined) {
-                        m_db->exec("REPLACE INTO metadata (name, value) VALUES ('compression', 'undefined');");
-                        m_schemaOptions.compression = Compression::undefined;
+                        std::lock_guard<std::mutex> lock(m_writeMutex);
+                        if (m_schemaOptions.compression.exchange(Compression::undefined) != Compression::undefined) {
+                            m_db->exec("REPLACE INTO metadata (name, value) VALUES ('compression', 'undefined');");
+                        }
                     }
                 }
             }
@@ -254,8 +471,9 @@ bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTask
                         task.rawTileData->clear();
                     }
                 } else {
-                    m_worker->enqueue([this, _task, tileData](){
-                        storeTileData(_task->tileId(), *tileData);
+                    m_worker->enqueue([this, tileId = _task->tileId(), tileData](){
+                        queueTileData(tileId, tileData);
+                        flushWritesIfDue();
                     });
                 }
             }
@@ -277,6 +495,9 @@ bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTask
 
                 int64_t tileAge = 0;
                 getTileData(_task->tileId(), *task.rawTileData, tileAge, task.offlineId);
+                if (task.hasData() && _task->source()) {
+                    _task->source()->missingTiles().erase(_task->tileId());
+                }
 
                 LOGV("loaded tile: %s, %d", _task->tileId().toString().c_str(), task.rawTileData->size());
 
@@ -306,13 +527,14 @@ static void runMigrations(SQLiteDB& db) {
             db.exec("CREATE INDEX IF NOT EXISTS map_tile_id ON map (tile_id);");
             db.exec("PRAGMA user_version = 3;");
         }
+        if(ver < 4) {
+            db.exec("CREATE INDEX IF NOT EXISTS last_access_time ON tile_last_access (last_access);");
+            db.exec("PRAGMA user_version = 4;");
+        }
     });
 }
 
-void MBTilesDataSource::openMBTiles() {
-
-    auto mode = SQLITE_OPEN_FULLMUTEX;
-    mode |= m_cacheMode ? SQLITE_OPEN_READWRITE : SQLITE_OPEN_READONLY;
+bool MBTilesDataSource::openDB(SQLiteDB& _db, int _mode) const {
 
     auto url = Url(m_path);
     auto path = url.path();
@@ -322,12 +544,20 @@ void MBTilesDataSource::openMBTiles() {
         path.erase(path.begin()); // Remove leading '/'.
     }
 
+    return sqlite3_open_v2(path.c_str(), &_db.db, _mode, vfs) == SQLITE_OK;
+}
+
+void MBTilesDataSource::openMBTiles() {
+
+    auto mode = SQLITE_OPEN_FULLMUTEX;
+    mode |= m_cacheMode ? SQLITE_OPEN_READWRITE : SQLITE_OPEN_READONLY;
+
     SQLiteDB db;
-    if (sqlite3_open_v2(path.c_str(), &db.db, mode, vfs) != SQLITE_OK) {
+    if (!openDB(db, mode)) {
         // ensure that we only run initSchema() on newly created file, not just if testSchema() fails (which
         //  can happen on valid existing database if locked)
         mode |= SQLITE_OPEN_CREATE;
-        if (m_cacheMode && sqlite3_open_v2(path.c_str(), &db.db, mode, vfs) == SQLITE_OK) {
+        if (m_cacheMode && openDB(db, mode)) {
             LOG("Creating SQLite database %s", m_path.c_str());
             initSchema(db, m_name, m_mime);
         } else {
@@ -335,7 +565,7 @@ void MBTilesDataSource::openMBTiles() {
             return;
         }
     }
-    LOG("SQLite database opened: %s", path.c_str());
+    LOG("SQLite database opened: %s", m_path.c_str());
 
     if (!testSchema(db)) {
         LOGE("Invalid MBTiles schema");
@@ -356,6 +586,8 @@ void MBTilesDataSource::openMBTiles() {
     // schema updates
     if (m_cacheMode) {
         runMigrations(db);
+        // Let reader connections proceed while the writer commits
+        db.exec("PRAGMA journal_mode=WAL;");
     }
 
     m_queries = m_cacheMode ? std::make_unique<MBTilesQueries>(db.db, MBTilesQueries::tag_cache{})
@@ -363,6 +595,30 @@ void MBTilesDataSource::openMBTiles() {
     m_db = std::make_unique<SQLiteDB>(std::move(db));
 }
 
+void MBTilesDataSource::openReaders(int _count) {
+
+    for (int i = 0; i < _count; i++) {
+        auto reader = std::make_unique<MBTilesReader>();
+        if (!openDB(reader->db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX)) {
+            LOGW("Unable to open SQLite reader connection: %s - %s", m_path.c_str(), reader->db.errMsg());
+            break;
+        }
+        // Read pages of large offline packs through mmap instead of copying them to the page cache
+        reader->db.exec("PRAGMA mmap_size = 268435456;");
+        // Wait for the writer rather than failing while it holds a lock
+        sqlite3_busy_timeout(reader->db.db, 1000);
+
+        for (size_t count = 1; count <= maxReadBatch; count++) {
+            reader->queries.emplace_back(reader->db.db, batchQuery(m_cacheMode, count));
+        }
+        m_readers.push_back(std::move(reader));
+    }
+
+    for (auto& reader : m_readers) {
+        m_readerThreads.emplace_back(&MBTilesDataSource::runReader, this, std::ref(*reader));
+    }
+}
+
 /**
  * We check to see if the database has the MBTiles Schema.
  * Sets m_schemaOptions from metadata table
@@ -405,14 +661,14 @@ bool MBTilesDataSource::testSchema(SQLiteDB& db) {
         }
     });
 
-    // one issue w/ WAL is lack of clean application exit on mobile to flush it
-    //db.exec("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;");
-
     return true;
 }
 
 void MBTilesDataSource::initSchema(SQLiteDB& db, std::string _name, std::string _mimeType) {
 
+    // Let eviction return the pages of deleted tiles to the file system; must be set before
+    // creating tables
+    db.exec("PRAGMA auto_vacuum = INCREMENTAL;");
     // Otherwise, we need to execute schema.sql to set up the db with the right schema.
     db.exec(SCHEMA);
     // Fill in metadata table.
@@ -443,6 +699,18 @@ bool MBTilesDataSource::getTileData(const TileID& _tileId,
     int z = _tileId.z;
     int y = (1 << z) - 1 - _tileId.y;
 
+    // Offline downloads must find tiles which are already cached
+    if (offlineId && !m_pendingTiles.empty()) { flushWrites(); }
+
+    if (!offlineId && getPendingTileData(_tileId, _data)) {
+        _tileAge = int64_t(secSinceEpoch());
+        return true;
+    }
+
+    // Offline ids are written on the connection of the write transactions
+    std::unique_lock<std::mutex> lock(m_writeMutex, std::defer_lock);
+    if (offlineId) { lock.lock(); }
+
     // offlineId > 0 indicates request to set offline_id; not necessary to read data
     if (offlineId > 0) {
         return m_queries->getOffline.bind(z, _tileId.x, y).exec([&](int, const char* tileid){
@@ -458,33 +726,54 @@ bool MBTilesDataSource::getTileData(const TileID& _tileId,
         std::string tileid = m_cacheMode ? (const char*)sqlite3_column_text(stmt, 1) : "";
         _tileAge = m_cacheMode ? sqlite3_column_int64(stmt, 2) : 0;
 
-        if ((m_schemaOptions.compression == Compression::undefined) ||
-            (m_schemaOptions.compression == Compression::deflate)) {
+        decodeTileData(blob, length, _data);
 
-            if (zlib_inflate(blob, length, _data) != 0) {
-                if (m_schemaOptions.compression == Compression::undefined) {
-                    _data.resize(length);
-                    memcpy(_data.data(), blob, length);
-                } else {
-                    LOGW("Invalid deflate compression");
-                }
-            }
-        } else {
-            _data.resize(length);
-            memcpy(_data.data(), blob, length);
-        }
         if (offlineId) {
             if (!m_queries->putOffline.bind(tileid, std::abs(offlineId)).exec()) {
                 _data.clear();  // force retry if writing offline id fails
             }
         }
         if (m_cacheMode) {
-            m_queries->putLastAccess.bind(tileid).exec();
+            queueLastAccess(std::move(tileid));
         }
     });
 }
 
+bool MBTilesDataSource::decodeTileData(const char* _blob, int _length, std::vector<char>& _data) const {
+
+    if ((m_schemaOptions.compression == Compression::undefined) ||
+        (m_schemaOptions.compression == Compression::deflate)) {
+
+        if (zlib_inflate(_blob, _length, _data) == 0) { return true; }
+
+        if (m_schemaOptions.compression == Compression::deflate) {
+            LOGW("Invalid deflate compression");
+            return false;
+        }
+    }
+    _data.resize(_length);
+    memcpy(_data.data(), _blob, _length);
+    return true;
+}
+
 bool MBTilesDataSource::storeTileData(const TileID& _tileId, const std::vector<char>& _data, int offlineId) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+
+    do {
+        if (!m_db->exec("BEGIN;")) { break; }
+        if (!writeTileData(_tileId, _data, offlineId)) { break; }
+        if (!m_db->exec("COMMIT;")) { break; }
+        m_platform.notifyStorage(_data.size(), 0);
+        LOGD("%s - store tile: %s", m_name.c_str(), _tileId.toString().c_str());
+        return true;
+    } while (0);
+
+    LOGE("%s - SQL error storing tile %s: %s", m_name.c_str(), _tileId.toString().c_str(), m_db->errMsg());
+    m_db->exec("ROLLBACK;");
+    return false;
+}
+
+bool MBTilesDataSource::writeTileData(const TileID& _tileId, const std::vector<char>& _data, int offlineId) {
     int z = _tileId.z;
     int y = (1 << z) - 1 - _tileId.y;
 
@@ -499,28 +788,164 @@ bool MBTilesDataSource::storeTileData(const TileID& _tileId, const std::vector<c
     MD5 md5;
     std::string md5id = md5(data, size);
 
+    if (!m_queries->putMap.bind(z, _tileId.x, y, md5id).exec()) { return false; }
+    sqlite3_bind_text(m_queries->putImage.stmt, 1, md5id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_blob(m_queries->putImage.stmt, 2, data, size, SQLITE_STATIC);
+    if (!m_queries->putImage.exec()) { return false; }
+
+    if (offlineId) {
+        return m_queries->putOffline.bind(md5id, std::abs(offlineId)).exec();
+    }
+    return m_queries->putLastAccess.bind(md5id).exec();
+}
+
+void MBTilesDataSource::queueTileData(const TileID& _tileId, std::shared_ptr<std::vector<char>> _data) {
+    if (m_pendingTiles.empty() && m_pendingAccess.empty()) {
+        m_pendingSince = std::chrono::steady_clock::now();
+    }
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    for (auto& pending : m_pendingTiles) {
+        if (pending.tileId == _tileId) {
+            pending.data = std::move(_data);
+            return;
+        }
+    }
+    m_pendingTiles.push_back({ _tileId, std::move(_data) });
+}
+
+bool MBTilesDataSource::getPendingTileData(const TileID& _tileId, std::vector<char>& _data) {
+    std::shared_ptr<std::vector<char>> data;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        for (auto& pending : m_pendingTiles) {
+            if (pending.tileId == _tileId) {
+                data = pending.data;
+                break;
+            }
+        }
+    }
+    // Decoded like data read from the database
+    return data && decodeTileData(data->data(), data->size(), _data);
+}
+
+void MBTilesDataSource::queueLastAccess(std::string _tileId) {
+    if (m_pendingTiles.empty() && m_pendingAccess.empty()) {
+        m_pendingSince = std::chrono::steady_clock::now();
+    }
+    // Repeated accesses of a tile are written once
+    m_pendingAccess.insert(std::move(_tileId));
+}
+
+void MBTilesDataSource::flushWritesIfDue() {
+    if (m_pendingTiles.size() + m_pendingAccess.size() >= maxPendingWrites ||
+        std::chrono::steady_clock::now() - m_pendingSince >= maxWriteDelay) {
+        flushWrites();
+    }
+}
+
+void MBTilesDataSource::flushWrites() {
+    if (m_pendingTiles.empty() && m_pendingAccess.empty()) { return; }
+
+    Trace::scope _trace("MBTilesDataSource::flushWrites");
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+
+    size_t size = 0;
     do {
+        DurationCounter::scope _time(m_writeTime);
         if (!m_db->exec("BEGIN;")) { break; }
-        if (!m_queries->putMap.bind(z, _tileId.x, y, md5id).exec()) { break; }
-        sqlite3_bind_text(m_queries->putImage.stmt, 1, md5id.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_blob(m_queries->putImage.stmt, 2, data, size, SQLITE_STATIC);
-        if (!m_queries->putImage.exec()) { break; }
 
-        if (offlineId) {
-            if (!m_queries->putOffline.bind(md5id, std::abs(offlineId)).exec()) { break; }
-        } else {
-            if (!m_queries->putLastAccess.bind(md5id).exec()) { break; }
+        bool ok = true;
+        for (auto& pending : m_pendingTiles) {
+            if (!(ok = writeTileData(pending.tileId, *pending.data, 0))) { break; }
+            size += pending.data->size();
+        }
+        for (auto it = m_pendingAccess.begin(); ok && it != m_pendingAccess.end(); ++it) {
+            ok = m_queries->putLastAccess.bind(*it).exec();
         }
+        if (!ok) { break; }
 
         if (!m_db->exec("COMMIT;")) { break; }
+        m_writeRows.add(m_pendingTiles.size() + m_pendingAccess.size());
         m_platform.notifyStorage(size, 0);
-        LOGD("%s - store tile: %s", m_name.c_str(), _tileId.toString().c_str());
-        return true;
+        LOGD("%s - stored %d tiles, %d access times", m_name.c_str(),
+             m_pendingTiles.size(), m_pendingAccess.size());
+
+        // Cleared after the commit, so that readers find the tiles either here or in the database
+        std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+        m_pendingTiles.clear();
+        m_pendingAccess.clear();
+        return;
     } while (0);
 
-    LOGE("%s - SQL error storing tile %s: %s", m_name.c_str(), _tileId.toString().c_str(), m_db->errMsg());
+    LOGE("%s - SQL error storing %d tiles: %s", m_name.c_str(), m_pendingTiles.size(), m_db->errMsg());
     m_db->exec("ROLLBACK;");
-    return false;
+
+    // Retry with the next flush, unless writes keep failing
+    m_pendingSince = std::chrono::steady_clock::now();
+    if (m_pendingTiles.size() + m_pendingAccess.size() >= 4 * maxPendingWrites) {
+        std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+        m_pendingTiles.clear();
+        m_pendingAccess.clear();
+    }
+}
+
+uint64_t MBTilesDataSource::usedBytes() {
+    int64_t pages = 0, freePages = 0, pageSize = 0;
+    m_db->stmt("PRAGMA page_count;").exec([&](int64_t n){ pages = n; });
+    m_db->stmt("PRAGMA freelist_count;").exec([&](int64_t n){ freePages = n; });
+    m_db->stmt("PRAGMA page_size;").exec([&](int64_t n){ pageSize = n; });
+    return std::max<int64_t>(pages - freePages, 0) * pageSize;
+}
+
+void MBTilesDataSource::initEviction() {
+    // Databases created before incremental vacuum was enabled would need a full VACUUM to switch,
+    // rewriting the whole file. Their freed pages are reused by later writes instead, and
+    // usedBytes() does not count them.
+    m_db->stmt("PRAGMA auto_vacuum;").exec([&](int mode){ m_incrementalVacuum = (mode == 2); });
+    limitCacheSize();
+}
+
+void MBTilesDataSource::limitCacheSize() {
+    if (m_maxCacheSize == 0) { return; }
+
+    uint64_t used = usedBytes();
+    m_cacheBytes.store(used, std::memory_order_relaxed);
+
+    // Once above the limit, evict down to the target to not run again right away
+    if (!m_evicting && used <= m_maxCacheSize) { return; }
+    if (used <= uint64_t(m_maxCacheSize * evictTargetRatio)) {
+        m_evicting = false;
+        return;
+    }
+    m_evicting = true;
+
+    Trace::scope _trace("MBTilesDataSource::evictTiles");
+    int evicted = 0;
+    {
+        // Short transaction per batch, so that other writes and offline downloads get in between
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        if (m_queries->evictTiles.bind(evictBatchSize).exec()) {
+            evicted = sqlite3_changes(m_db->db);
+        } else {
+            LOGE("%s - SQL error evicting tiles: %s", m_name.c_str(), m_db->errMsg());
+        }
+        if (m_incrementalVacuum) { m_db->exec("PRAGMA incremental_vacuum;"); }
+    }
+
+    if (evicted == 0) {
+        // Only offline tiles are left
+        m_evicting = false;
+        return;
+    }
+    m_evictedTiles.add(evicted);
+
+    uint64_t remaining = usedBytes();
+    m_cacheBytes.store(remaining, std::memory_order_relaxed);
+    m_platform.notifyStorage(int64_t(remaining) - int64_t(used), 0);
+    LOGD("%s - evicted %d tiles, %d bytes", m_name.c_str(), evicted, int(used - remaining));
+
+    // Continue after the jobs which queued up meanwhile
+    m_worker->enqueue([this](){ limitCacheSize(); });
 }
 
 }
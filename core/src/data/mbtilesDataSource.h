@@ -2,6 +2,15 @@
 
 #include "data/tileSource.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
 struct sqlite3;
 class SQLiteDB;
 
@@ -10,13 +19,17 @@ namespace Tangram {
 class Platform;
 
 struct MBTilesQueries;
+struct MBTilesReader;
 class AsyncWorker;
 
 class MBTilesDataSource : public TileSource::DataSource {
 public:
 
+    /* Cache mode with @_maxCacheAge > 0: store tiles loaded from next source, evicting least
+     * recently used tiles of the database when it grows beyond @_maxCacheSize bytes, if set */
     MBTilesDataSource(Platform& _platform, std::string _name, std::string _path, std::string _mime,
-                      int64_t _maxCacheAge = 0, bool _offlineFallback = false);
+                      int64_t _maxCacheAge = 0, bool _offlineFallback = false,
+                      size_t _maxCacheSize = 0);
 
     ~MBTilesDataSource() override;
 
@@ -24,14 +37,48 @@ public:
 
     void clear() override {}
 
+    void getStats(TileSourceStats& _stats) const override;
+
     SQLiteDB* getDB() { return m_db.get(); }
 
 private:
+    struct ReadRequest {
+        std::shared_ptr<TileTask> task;
+        TileTaskCb cb;
+    };
+
     bool getTileData(const TileID& _tileId, std::vector<char>& _data, int64_t& _tileAge, int offlineId);
-    bool storeTileData(const TileID& _tileId, const std::vector<char>& _data, int offlineId = 0);
+    bool decodeTileData(const char* _blob, int _length, std::vector<char>& _data) const;
+    // Store tile of an offline download in its own transaction
+    bool storeTileData(const TileID& _tileId, const std::vector<char>& _data, int offlineId);
+    bool writeTileData(const TileID& _tileId, const std::vector<char>& _data, int offlineId);
     bool loadNextSource(std::shared_ptr<TileTask> _task, TileTaskCb _cb);
 
+    // Pass tile data read from the database to @_cb, or load missing and stale tiles from next
+    void onTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb,
+                    std::unique_ptr<std::vector<char>> _data, int64_t _createdAt);
+
+    // Reader thread: look up pending requests in batches with its own connection
+    void runReader(MBTilesReader& _reader);
+    void readTiles(MBTilesReader& _reader, std::vector<ReadRequest>& _requests);
+
+    // Write-behind of cached tiles and access times, called on the worker
+    void queueTileData(const TileID& _tileId, std::shared_ptr<std::vector<char>> _data);
+    void queueLastAccess(std::string _tileId);
+    // Data of a tile waiting to be written, for lookups from any thread
+    bool getPendingTileData(const TileID& _tileId, std::vector<char>& _data);
+    void flushWritesIfDue();
+    void flushWrites();
+
+    // Background eviction of tiles which are not part of an offline download, run on the
+    // worker in short transactions
+    void initEviction();
+    void limitCacheSize();
+    uint64_t usedBytes();
+
+    bool openDB(SQLiteDB& _db, int _mode) const;
     void openMBTiles();
+    void openReaders(int _count);
     bool testSchema(SQLiteDB& db);
     void initSchema(SQLiteDB& db, std::string _name, std::string _mimeType);
 
@@ -44,6 +91,7 @@ private:
     // Store tiles from next source
     bool m_cacheMode;
     int64_t m_maxCacheAge;
+    size_t m_maxCacheSize;
 
     // Offline fallback: Try next source (download) first, then fall back to mbtiles
     bool m_offlineMode;
@@ -51,8 +99,42 @@ private:
     // Pointer to SQLite DB of MBTiles store
     std::unique_ptr<SQLiteDB> m_db;
     std::unique_ptr<MBTilesQueries> m_queries;
+    // Single writer for cache mode, also running lookups which write offline ids
     std::unique_ptr<AsyncWorker> m_worker;
 
+    // Read-only connections, each used by one reader thread
+    std::vector<std::unique_ptr<MBTilesReader>> m_readers;
+    std::vector<std::thread> m_readerThreads;
+    std::deque<ReadRequest> m_readQueue;
+    std::mutex m_readMutex;
+    std::condition_variable m_readCondition;
+    bool m_readersRunning = true;
+
+    // Tiles and access times waiting to be written in one transaction, used on the worker.
+    // Readers look up pending tiles, so the worker changes m_pendingTiles under m_pendingMutex.
+    struct PendingTile {
+        TileID tileId;
+        std::shared_ptr<std::vector<char>> data;
+    };
+    std::vector<PendingTile> m_pendingTiles;
+    std::mutex m_pendingMutex;
+    std::unordered_set<std::string> m_pendingAccess;
+    std::chrono::steady_clock::time_point m_pendingSince;
+    // Held for every write on m_db, keeping write transactions of the worker and of offline
+    // downloads apart
+    std::mutex m_writeMutex;
+    // Evicting until the database is below the target size, used on the worker only
+    bool m_evicting = false;
+    // Whether evicted pages are returned to the file system, set on the worker
+    bool m_incrementalVacuum = false;
+    std::atomic<uint64_t> m_cacheBytes{0};
+
+    DurationCounter m_queryTime;
+    StatCounter m_queryTiles;
+    DurationCounter m_writeTime;
+    StatCounter m_writeRows;
+    StatCounter m_evictedTiles;
+
     // Platform reference
     Platform& m_platform;
 
@@ -64,7 +146,8 @@ private:
     };
 
     struct {
-        Compression compression = Compression::undefined;
+        // Changed by network callbacks while readers decode tiles
+        std::atomic<Compression> compression{Compression::undefined};
         bool isCache = false;
         //bool utfGrid = false;
     } m_schemaOptions;
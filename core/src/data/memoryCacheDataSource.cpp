@@ -2,86 +2,201 @@
 
 #include "tile/tileHash.h"
 #include "tile/tileID.h"
+#include "util/zlibHelper.h"
 #include "log.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <unordered_map>
 
 namespace Tangram {
 
+// Whether @_data is in a format that does not compress any further
+static bool isCompressedFormat(const std::vector<char>& _data) {
+    if (_data.size() < 4) { return false; }
+    auto b = reinterpret_cast<const unsigned char*>(_data.data());
+    // gzip, PNG, JPEG and WebP (RIFF)
+    return (b[0] == 0x1F && b[1] == 0x8B) ||
+        (b[0] == 0x89 && b[1] == 'P' && b[2] == 'N' && b[3] == 'G') ||
+        (b[0] == 0xFF && b[1] == 0xD8) ||
+        (b[0] == 'R' && b[1] == 'I' && b[2] == 'F' && b[3] == 'F');
+}
+
 struct RawCache {
 
-    // Used to ensure safe access from async loading threads
-    std::mutex m_mutex;
+    // Tiles are spread over independently locked shards, so that lookups from the main thread
+    // and insertions from loading threads rarely wait for each other
+    static constexpr size_t numShards = 8;
+
+    struct CacheEntry {
+        TileID tileID;
+        // Stored payload, deflated unless 'compressed' is false
+        std::shared_ptr<std::vector<char>> data;
+        size_t rawSize;
+        bool compressed;
+    };
 
     // LRU in-memory cache for raw tile data
-    using CacheEntry = std::pair<TileID, std::shared_ptr<std::vector<char>>>;
     using CacheList = std::list<CacheEntry>;
     using CacheMap = std::unordered_map<TileID, typename CacheList::iterator>;
 
-    CacheMap m_cacheMap;
-    CacheList m_cacheList;
-    int m_usage = 0;
-    int m_maxUsage = 0;
+    struct Shard {
+        // Used to ensure safe access from async loading threads
+        std::mutex m_mutex;
+        CacheMap m_cacheMap;
+        CacheList m_cacheList;
+        // Stored bytes, and bytes of the tile data before compression
+        size_t m_usage = 0;
+        size_t m_rawUsage = 0;
+    };
+
+    std::array<Shard, numShards> m_shards;
+
+    // Budget of stored bytes shared by all shards, so that a tile larger than an even share of
+    // the budget can still be cached
+    std::atomic<size_t> m_maxUsage{0};
+    // Stored bytes of all shards
+    std::atomic<size_t> m_usage{0};
+    std::atomic<int> m_compressionLevel{1};
+
+    Shard& shard(const TileID& _tileID) {
+        return m_shards[std::hash<TileID>{}(_tileID) % numShards];
+    }
 
     bool get(BinaryTileTask& _task) {
 
-        if (m_maxUsage <= 0) { return false; }
+        if (m_maxUsage == 0) { return false; }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
         const auto& taskTileID = _task.tileId();
         TileID id(taskTileID.x, taskTileID.y, taskTileID.z);
+        auto& shard = this->shard(id);
 
-        auto it = m_cacheMap.find(id);
-        if (it != m_cacheMap.end()) {
-            // Move cached entry to start of list
-            m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
-            _task.rawTileData = m_cacheList.front().second;
+        std::shared_ptr<std::vector<char>> data;
+        size_t rawSize = 0;
+        {
+            std::lock_guard<std::mutex> lock(shard.m_mutex);
 
-            return true;
+            auto it = shard.m_cacheMap.find(id);
+            if (it == shard.m_cacheMap.end()) { return false; }
+
+            // Move cached entry to start of list
+            shard.m_cacheList.splice(shard.m_cacheList.begin(), shard.m_cacheList, it->second);
+            const auto& entry = shard.m_cacheList.front();
+            if (!entry.compressed) {
+                _task.rawTileData = entry.data;
+                return true;
+            }
+            data = entry.data;
+            rawSize = entry.rawSize;
         }
 
-        return false;
+        // Inflate outside of the lock, the entry keeps its payload until the last reader is done
+        auto rawData = std::make_shared<std::vector<char>>();
+        rawData->reserve(rawSize);
+        if (zlib_inflate(data->data(), data->size(), *rawData) != 0) {
+            LOGE("Invalid compressed tile data in cache: %s", id.toString().c_str());
+            return false;
+        }
+        _task.rawTileData = std::move(rawData);
+        return true;
     }
+
     void put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef) {
 
-        if (m_maxUsage <= 0) { return; }
+        size_t maxUsage = m_maxUsage;
+        if (maxUsage == 0) { return; }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
         TileID id(tileID.x, tileID.y, tileID.z);
 
-        m_cacheList.push_front({id, rawDataRef});
-        m_cacheMap[id] = m_cacheList.begin();
+        CacheEntry entry{ id, rawDataRef, rawDataRef->size(), false };
 
-        m_usage += rawDataRef->size();
+        int level = m_compressionLevel;
+        if (level > 0 && !isCompressedFormat(*rawDataRef)) {
+            auto compressed = std::make_shared<std::vector<char>>();
+            if (zlib_deflate(rawDataRef->data(), rawDataRef->size(), *compressed, level) == 0 &&
+                compressed->size() < rawDataRef->size() * 9 / 10) {
+                compressed->shrink_to_fit();
+                entry.data = std::move(compressed);
+                entry.compressed = true;
+            }
+        }
 
-        while (m_usage > m_maxUsage) {
-            if (m_cacheList.empty()) {
-                LOGE("Error: invalid cache state!");
-                m_usage = 0;
-                break;
+        auto& shard = this->shard(id);
+        {
+            std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+            auto it = shard.m_cacheMap.find(id);
+            if (it != shard.m_cacheMap.end()) {
+                m_usage -= it->second->data->size();
+                shard.m_usage -= it->second->data->size();
+                shard.m_rawUsage -= it->second->rawSize;
+                shard.m_cacheList.erase(it->second);
+                shard.m_cacheMap.erase(it);
             }
 
-            // LOGE("Limit raw cache tiles:%d, %fMB ", m_cacheList.size(),
-            //        double(m_cacheUsage) / (1024*1024));
+            // A tile that does not fit would only evict all others and itself; the outdated
+            // entry for it is removed all the same
+            if (entry.data->size() > maxUsage) { return; }
+
+            m_usage += entry.data->size();
+            shard.m_usage += entry.data->size();
+            shard.m_rawUsage += entry.rawSize;
+            shard.m_cacheList.push_front(std::move(entry));
+            shard.m_cacheMap[id] = shard.m_cacheList.begin();
 
-            auto& entry = m_cacheList.back();
-            m_usage -= entry.second->size();
+            // Evict from this shard first, keeping the new entry
+            evict(shard, maxUsage, 1);
+        }
 
-            m_cacheMap.erase(entry.first);
-            m_cacheList.pop_back();
+        // Then from the others, locking one shard at a time
+        size_t index = &shard - m_shards.data();
+        for (size_t i = 1; i < numShards && m_usage > maxUsage; i++) {
+            auto& other = m_shards[(index + i) % numShards];
+            std::lock_guard<std::mutex> lock(other.m_mutex);
+            evict(other, maxUsage, 0);
+        }
+    }
+
+    // Remove least recently used entries of _shard, keeping at least _keep entries, until all
+    // shards use at most _maxUsage bytes
+    void evict(Shard& _shard, size_t _maxUsage, size_t _keep) {
+        while (m_usage > _maxUsage && _shard.m_cacheList.size() > _keep) {
+
+            auto& last = _shard.m_cacheList.back();
+            m_usage -= last.data->size();
+            _shard.m_usage -= last.data->size();
+            _shard.m_rawUsage -= last.rawSize;
+
+            _shard.m_cacheMap.erase(last.tileID);
+            _shard.m_cacheList.pop_back();
         }
     }
 
     void clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_cacheMap.clear();
-        m_cacheList.clear();
-        m_usage = 0;
+        for (auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.m_mutex);
+            shard.m_cacheMap.clear();
+            shard.m_cacheList.clear();
+            m_usage -= shard.m_usage;
+            shard.m_usage = 0;
+            shard.m_rawUsage = 0;
+        }
+    }
+
+    void getUsage(size_t& _entries, size_t& _usage, size_t& _rawUsage) {
+        for (auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.m_mutex);
+            _entries += shard.m_cacheList.size();
+            _usage += shard.m_usage;
+            _rawUsage += shard.m_rawUsage;
+        }
     }
 };
 
+constexpr size_t RawCache::numShards;
 
 MemoryCacheDataSource::MemoryCacheDataSource() :
     m_cache(std::make_unique<RawCache>()) {
@@ -93,6 +208,10 @@ void MemoryCacheDataSource::setCacheSize(size_t _cacheSize) {
     m_cache->m_maxUsage = _cacheSize;
 }
 
+void MemoryCacheDataSource::setCompressionLevel(int _level) {
+    m_cache->m_compressionLevel = std::min(_level, 9);
+}
+
 bool MemoryCacheDataSource::cacheGet(BinaryTileTask& _task) {
     return m_cache->get(_task);
 }
@@ -110,9 +229,11 @@ bool MemoryCacheDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTa
         cacheGet(task);
 
         if (task.hasData()) {
+            m_hits.add();
             _cb.func(_task);
             return true;
         }
+        m_misses.add();
 
         // Try next source on subsequent calls
         if (next) { _task->rawSource = next->level; }
@@ -124,9 +245,14 @@ bool MemoryCacheDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTa
 
             auto& task = static_cast<BinaryTileTask&>(*_task);
 
-            if (task.hasData()) { cachePut(task.tileId(), task.rawTileData); }
+            // Hand the tile on before compressing it for the cache, which does not modify it
+            std::shared_ptr<std::vector<char>> rawData;
+            if (task.hasData()) { rawData = task.rawTileData; }
+            TileID tileID = task.tileId();
 
-            _cb.func(_task);
+            _cb.func(std::move(_task));
+
+            if (rawData) { cachePut(tileID, std::move(rawData)); }
         }});
     }
 
@@ -139,4 +265,12 @@ void MemoryCacheDataSource::clear() {
     if (next) { next->clear(); }
 }
 
+void MemoryCacheDataSource::getStats(TileSourceStats& _stats) const {
+    _stats.memoryCacheHits += m_hits.get();
+    _stats.memoryCacheMisses += m_misses.get();
+    m_cache->getUsage(_stats.memoryCacheEntries, _stats.memoryCacheBytes, _stats.memoryCacheRawBytes);
+
+    if (next) { next->getStats(_stats); }
+}
+
 }
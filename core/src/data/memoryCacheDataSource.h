@@ -14,11 +14,18 @@ public:
 
     void clear() override;
 
+    void getStats(TileSourceStats& _stats) const override;
+
     /* @_cacheSize: Set size of in-memory cache for tile data in bytes.
      * This cache holds unprocessed tile data for fast recreation of recently used tiles.
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* @_level: Compression of cached tile data, from 1 (fastest) to 9 (smallest), or 0 to
+     * store tile data uncompressed. Data is decompressed when a tile is loaded from the cache.
+     */
+    void setCompressionLevel(int _level);
+
 private:
     bool cacheGet(BinaryTileTask& _task);
 
@@ -26,6 +33,9 @@ private:
 
     std::unique_ptr<RawCache> m_cache;
 
+    StatCounter m_hits;
+    StatCounter m_misses;
+
 };
 
 }
@@ -0,0 +1,67 @@
+#include "data/missingTileCache.h"
+
+namespace Tangram {
+
+constexpr size_t MissingTileCache::maxEntries;
+
+void MissingTileCache::put(const TileID& _tileID, Failure _failure) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(_tileID);
+    if (it != m_entries.end()) {
+        m_expiry.erase(it->second);
+    } else {
+        // Drop expired entries, then the ones expiring first when there are too many recent
+        // failures, e.g. when going offline
+        while (!m_expiry.empty() &&
+               (m_expiry.begin()->first <= now || m_entries.size() >= maxEntries)) {
+            remove(m_expiry.begin());
+        }
+        it = m_entries.emplace(_tileID, m_expiry.end()).first;
+    }
+    it->second = m_expiry.emplace(now + m_timeouts[int(_failure)], _tileID);
+}
+
+void MissingTileCache::remove(ExpiryQueue::iterator _it) {
+    m_entries.erase(_it->second);
+    m_expiry.erase(_it);
+}
+
+bool MissingTileCache::contains(const TileID& _tileID) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(_tileID);
+    if (it == m_entries.end()) { return false; }
+    if (it->second->first <= Clock::now()) {
+        remove(it->second);
+        return false;
+    }
+    m_hits.add();
+    return true;
+}
+
+void MissingTileCache::erase(const TileID& _tileID) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(_tileID);
+    if (it != m_entries.end()) { remove(it->second); }
+}
+
+void MissingTileCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_expiry.clear();
+    m_entries.clear();
+}
+
+void MissingTileCache::setTimeout(Failure _failure, Clock::duration _timeout) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timeouts[int(_failure)] = _timeout;
+}
+
+void MissingTileCache::getStats(TileSourceStats& _stats) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    _stats.missingTileEntries = m_entries.size();
+    _stats.missingTileHits = m_hits.get();
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "tile/tileHash.h"
+#include "tile/tileID.h"
+#include "util/stats.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace Tangram {
+
+/* Negative cache of tiles which a TileSource failed to load
+ *
+ * Entries expire after a time depending on the kind of failure, so that tiles which a server
+ * does not have are not requested again for a while, while tiles which failed for lack of a
+ * connection are retried soon. Used from any thread.
+ */
+class MissingTileCache {
+public:
+    enum class Failure {
+        // Server has no such tile, or returned an empty one
+        notFound,
+        // Server failed or was too busy to respond
+        timeout,
+        // No response from server
+        offline,
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    void put(const TileID& _tileID, Failure _failure);
+
+    // Whether loading @_tileID failed recently; counts a hit when it did
+    bool contains(const TileID& _tileID);
+
+    // Forget the failure once a tile was loaded from elsewhere, like stale or offline data
+    void erase(const TileID& _tileID);
+
+    void clear();
+
+    // Time to remember a failure of kind @_failure
+    void setTimeout(Failure _failure, Clock::duration _timeout);
+
+    void getStats(TileSourceStats& _stats) const;
+
+private:
+    // Entries kept before the ones expiring first are removed
+    static constexpr size_t maxEntries = 4096;
+
+    using ExpiryQueue = std::multimap<Clock::time_point, TileID>;
+
+    void remove(ExpiryQueue::iterator _it);
+
+    mutable std::mutex m_mutex;
+    // Entries ordered by expiry, and the position of each tile's entry
+    ExpiryQueue m_expiry;
+    std::unordered_map<TileID, ExpiryQueue::iterator> m_entries;
+
+    Clock::duration m_timeouts[3] = {
+        std::chrono::minutes(10),
+        std::chrono::minutes(1),
+        std::chrono::seconds(15),
+    };
+
+    StatCounter m_hits;
+};
+
+}
@@ -1,5 +1,6 @@
 #include "data/networkDataSource.h"
 
+#include "data/missingTileCache.h"
 #include "log.h"
 #include "platform.h"
 #include "util/mapProjection.h"
@@ -94,6 +95,19 @@ std::string NetworkDataSource::buildUrlForTile(const TileID& tile, const std::st
     return url;
 }
 
+// Kind of failure of a response without tile data
+static MissingTileCache::Failure failureKind(const UrlResponse& response) {
+    int status = response.httpStatus;
+    if (!response.error || (status >= 200 && status < 300)) {
+        return MissingTileCache::Failure::notFound;
+    }
+    if (status == 0) { return MissingTileCache::Failure::offline; }
+    if (status == 408 || status == 429 || status >= 500) {
+        return MissingTileCache::Failure::timeout;
+    }
+    return MissingTileCache::Failure::notFound;
+}
+
 bool NetworkDataSource::loadTileData(std::shared_ptr<TileTask> task, TileTaskCb callback) {
 
     if (task->rawSource != this->level) {
@@ -103,6 +117,13 @@ bool NetworkDataSource::loadTileData(std::shared_ptr<TileTask> task, TileTaskCb
 
     auto tileId = task->tileId();
 
+    // Don't request tiles again which recently failed
+    if (task->source() && task->source()->missingTiles().contains(tileId)) {
+        LOGV("Skip request for missing tile %s", tileId.toString().c_str());
+        callback.func(std::move(task));
+        return true;
+    }
+
     std::string urlstr;
     if (m_urlFunction >= 0) {
         auto lockedCtx = m_context.getJSContext();
@@ -141,6 +162,9 @@ bool NetworkDataSource::loadTileData(std::shared_ptr<TileTask> task, TileTaskCb
         } else if (!response.content.empty()) {
             dlTask.rawTileData = std::make_shared<std::vector<char>>(std::move(response.content));
         }
+        if (!dlTask.hasData() && task->source() && response.error != Platform::cancel_message) {
+            task->source()->missingTiles().put(task->tileId(), failureKind(response));
+        }
         callback.func(std::move(task));
     };
 
@@ -0,0 +1,334 @@
+#include "data/pmtilesDataSource.h"
+
+#include "debug/trace.h"
+#include "util/asyncWorker.h"
+#include "util/mappedFile.h"
+#include "util/url.h"
+#include "util/zlibHelper.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Tangram {
+
+// https://github.com/protomaps/PMTiles/blob/main/spec/v3/spec.md
+static constexpr size_t headerSize = 127;
+
+// Compression of directories and tiles; brotli and zstd are not supported
+static constexpr uint8_t compressionNone = 1;
+static constexpr uint8_t compressionGzip = 2;
+
+// Leaf directories kept decoded
+static constexpr size_t maxLeaves = 32;
+// Root directory and up to three levels of leaf directories
+static constexpr int maxDirectoryDepth = 4;
+// Tiles are paged in together when the gap between them is at most this many bytes
+static constexpr uint64_t maxPrefetchGap = 64 * 1024;
+
+static uint64_t readUint64(const char* _data) {
+    auto b = reinterpret_cast<const unsigned char*>(_data);
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) { value = (value << 8) | b[i]; }
+    return value;
+}
+
+struct VarintReader {
+    const unsigned char* pos;
+    const unsigned char* end;
+    bool ok = true;
+
+    uint64_t read() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos == end) { break; }
+            unsigned char b = *pos++;
+            value |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) { return value; }
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+uint64_t PMTilesDataSource::tileIdToHilbert(const TileID& _tileId) {
+    // Tiles of all lower zoom levels come first
+    uint64_t id = ((uint64_t(1) << (_tileId.z * 2)) - 1) / 3;
+    int64_t x = _tileId.x, y = _tileId.y;
+    for (int a = _tileId.z - 1; a >= 0; a--) {
+        int64_t s = int64_t(1) << a;
+        int64_t rx = s & x;
+        int64_t ry = s & y;
+        id += uint64_t((3 * rx) ^ ry) << a;
+        // Rotate the quadrant
+        if (ry == 0) {
+            if (rx != 0) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return id;
+}
+
+PMTilesDataSource::PMTilesDataSource(std::string _name, std::string _path)
+    : m_name(_name),
+      m_path(_path) {
+
+    if (!openArchive()) {
+        m_file.reset();
+        return;
+    }
+    m_worker = std::make_unique<AsyncWorker>(("PMTilesDataSource worker: " + _name).c_str());
+}
+
+// need explicit destructor since MappedFile is incomplete in header
+PMTilesDataSource::~PMTilesDataSource() {
+    // Stop the worker before unmapping the archive
+    m_worker.reset();
+}
+
+bool PMTilesDataSource::openArchive() {
+
+    auto url = Url(m_path);
+    if (url.scheme() == "asset") {
+        LOGE("PMTiles archives cannot be read from app assets: %s", m_path.c_str());
+        return false;
+    }
+
+    m_file = std::make_unique<MappedFile>(url.path());
+    const char* data = m_file->data();
+    if (!data) {
+        LOGE("Unable to open PMTiles archive: %s", m_path.c_str());
+        return false;
+    }
+    if (m_file->size() < headerSize || memcmp(data, "PMTiles", 7) != 0 || data[7] != 3) {
+        LOGE("Invalid PMTiles archive, only version 3 is supported: %s", m_path.c_str());
+        return false;
+    }
+
+    uint64_t rootOffset = readUint64(data + 8);
+    uint64_t rootLength = readUint64(data + 16);
+    m_leafDirectoriesOffset = readUint64(data + 40);
+    m_tileDataOffset = readUint64(data + 56);
+    m_internalCompression = data[97];
+    m_tileCompression = data[98];
+    m_minZoom = data[100];
+    m_maxZoom = data[101];
+
+    if (m_internalCompression != compressionNone && m_internalCompression != compressionGzip) {
+        LOGE("PMTiles archive has unsupported directory compression %d: %s",
+             m_internalCompression, m_path.c_str());
+        return false;
+    }
+    if (m_tileCompression > compressionGzip) {
+        LOGE("PMTiles archive has unsupported tile compression %d: %s",
+             m_tileCompression, m_path.c_str());
+        return false;
+    }
+
+    if (!readDirectory(rootOffset, rootLength, m_rootDirectory)) {
+        LOGE("Invalid PMTiles root directory: %s", m_path.c_str());
+        return false;
+    }
+
+    LOG("PMTiles archive opened: %s, zoom %d-%d", m_path.c_str(), m_minZoom, m_maxZoom);
+    return true;
+}
+
+bool PMTilesDataSource::readDirectory(uint64_t _offset, uint64_t _length, Directory& _directory) const {
+
+    if (_offset > m_file->size() || _length > m_file->size() - _offset) { return false; }
+    const char* data = m_file->data() + _offset;
+
+    std::vector<char> inflated;
+    if (m_internalCompression == compressionGzip) {
+        if (zlib_inflate(data, _length, inflated) != 0) { return false; }
+        data = inflated.data();
+        _length = inflated.size();
+    }
+
+    VarintReader reader{ reinterpret_cast<const unsigned char*>(data),
+                         reinterpret_cast<const unsigned char*>(data) + _length };
+
+    uint64_t numEntries = reader.read();
+    // Each entry takes at least four bytes
+    if (!reader.ok || numEntries > _length / 4) { return false; }
+    _directory.resize(numEntries);
+
+    // Columns of tile IDs as deltas, run lengths, lengths and offsets
+    uint64_t tileId = 0;
+    for (auto& entry : _directory) {
+        tileId += reader.read();
+        entry.tileId = tileId;
+    }
+    for (auto& entry : _directory) { entry.runLength = reader.read(); }
+    for (auto& entry : _directory) { entry.length = reader.read(); }
+    for (size_t i = 0; i < _directory.size(); i++) {
+        uint64_t offset = reader.read();
+        // Zero continues after the data of the previous entry
+        if (offset == 0 && i > 0) {
+            _directory[i].offset = _directory[i-1].offset + _directory[i-1].length;
+        } else {
+            _directory[i].offset = offset - 1;
+        }
+    }
+    return reader.ok;
+}
+
+const PMTilesDataSource::Directory* PMTilesDataSource::leafDirectory(uint64_t _offset, uint64_t _length) {
+
+    auto it = m_leafIndex.find(_offset);
+    if (it != m_leafIndex.end()) {
+        m_leaves.splice(m_leaves.begin(), m_leaves, it->second);
+        return &it->second->directory;
+    }
+
+    Leaf leaf{ _offset, {} };
+    if (!readDirectory(m_leafDirectoriesOffset + _offset, _length, leaf.directory)) {
+        LOGW("%s - invalid PMTiles leaf directory at %d", m_name.c_str(), int(_offset));
+        return nullptr;
+    }
+
+    m_leaves.push_front(std::move(leaf));
+    m_leafIndex[_offset] = m_leaves.begin();
+    if (m_leaves.size() > maxLeaves) {
+        m_leafIndex.erase(m_leaves.back().offset);
+        m_leaves.pop_back();
+    }
+    return &m_leaves.front().directory;
+}
+
+bool PMTilesDataSource::findTile(const TileID& _tileId, uint64_t& _offset, uint32_t& _length) {
+
+    if (_tileId.z < m_minZoom || _tileId.z > m_maxZoom) { return false; }
+
+    uint64_t id = tileIdToHilbert(_tileId);
+    const Directory* directory = &m_rootDirectory;
+
+    for (int depth = 0; depth < maxDirectoryDepth && directory; depth++) {
+        // Last entry starting at or before the tile
+        auto it = std::upper_bound(directory->begin(), directory->end(), id,
+                                   [](uint64_t _id, const Entry& _entry) { return _id < _entry.tileId; });
+        if (it == directory->begin()) { return false; }
+        const Entry& entry = *(--it);
+
+        if (entry.runLength == 0) {
+            directory = leafDirectory(entry.offset, entry.length);
+            continue;
+        }
+        if (id >= entry.tileId + entry.runLength) { return false; }
+
+        _offset = m_tileDataOffset + entry.offset;
+        _length = entry.length;
+        return _offset <= m_file->size() && _length <= m_file->size() - _offset;
+    }
+    return false;
+}
+
+bool PMTilesDataSource::decodeTile(const char* _data, size_t _length, std::vector<char>& _tile) const {
+
+    if (m_tileCompression == compressionGzip) {
+        if (zlib_inflate(_data, _length, _tile) == 0) { return true; }
+        LOGW("%s - invalid gzip compression", m_name.c_str());
+        _tile.clear();
+        return false;
+    }
+    // Uncompressed and unknown compression, which tile decoders detect by themselves
+    _tile.assign(_data, _data + _length);
+    return true;
+}
+
+bool PMTilesDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
+
+    if (!m_file || _task->rawSource != this->level) {
+        return false;
+    }
+
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        wasEmpty = m_queue.empty();
+        m_queue.push_back({ _task, _cb });
+    }
+    // Requests which queue up until the worker gets to them are read together
+    if (wasEmpty) { m_worker->enqueue([this](){ readTiles(); }); }
+
+    return true;
+}
+
+void PMTilesDataSource::readTiles() {
+
+    std::vector<ReadRequest> requests;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        std::swap(requests, m_queue);
+    }
+
+    // Lock Scenes while running callbacks on this thread
+    std::vector<std::shared_ptr<ScenePrana>> pranas;
+    std::vector<ReadRequest> missing;
+
+    Trace::begin("PMTilesDataSource::readTiles");
+    auto start = DurationCounter::Clock::now();
+
+    requests.erase(std::remove_if(requests.begin(), requests.end(), [&](auto& request) {
+        if (request.task->isCanceled()) {  // task may have been canceled while in queue
+            LOGV("%s - canceled tile: %s", m_name.c_str(), request.task->tileId().toString().c_str());
+            return true;
+        }
+        auto prana = request.task->prana();
+        if (!prana) {
+            LOGW("PMTilesDataSource callback for deleted Scene!");
+            return true;
+        }
+        pranas.push_back(std::move(prana));
+
+        if (!this->findTile(request.task->tileId(), request.offset, request.length)) {
+            missing.push_back(std::move(request));
+            return true;
+        }
+        return false;
+    }), requests.end());
+
+    // Page in the data of adjacent tiles together, in archive order
+    std::sort(requests.begin(), requests.end(), [](auto& _a, auto& _b) { return _a.offset < _b.offset; });
+    for (size_t i = 0; i < requests.size();) {
+        uint64_t offset = requests[i].offset;
+        uint64_t end = offset + requests[i].length;
+        for (i++; i < requests.size() && requests[i].offset <= end + maxPrefetchGap; i++) {
+            end = std::max(end, requests[i].offset + requests[i].length);
+        }
+        m_file->prefetch(offset, end - offset);
+    }
+
+    for (auto& request : requests) {
+        auto& task = static_cast<BinaryTileTask&>(*request.task);
+        auto tileData = std::make_shared<std::vector<char>>();
+        decodeTile(m_file->data() + request.offset, request.length, *tileData);
+        task.rawTileData = std::move(tileData);
+        LOGV("%s - loaded tile: %s, %d bytes", m_name.c_str(), task.tileId().toString().c_str(),
+             task.rawTileData->size());
+    }
+    m_readTime.add(DurationCounter::Clock::now() - start);
+    m_readTiles.add(requests.size() + missing.size());
+    Trace::end("PMTilesDataSource::readTiles");
+
+    for (auto& request : requests) {
+        request.cb.func(request.task);
+    }
+
+    // Tiles missing in the archive are left empty
+    for (auto& request : missing) {
+        LOGD("%s - missing tile: %s", m_name.c_str(), request.task->tileId().toString().c_str());
+        request.cb.func(request.task);
+    }
+}
+
+void PMTilesDataSource::getStats(TileSourceStats& _stats) const {
+    _stats.pmtilesReadTime = m_readTime.get();
+    _stats.pmtilesReadTiles = m_readTiles.get();
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "data/tileSource.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+class AsyncWorker;
+class MappedFile;
+
+/* Tiles of a local PMTiles (version 3) archive
+ *
+ * The archive is mapped into memory. Tiles are found by binary search of their Hilbert tile ID in
+ * the root directory, which is kept decoded, and in leaf directories, of which the most recently
+ * used are kept. Requests which queue up while the worker is busy are read together, paging in
+ * the data of adjacent tiles at once. Tiles missing in the archive are left empty; the archive is
+ * the only source of its TileSource.
+ */
+class PMTilesDataSource : public TileSource::DataSource {
+public:
+
+    PMTilesDataSource(std::string _name, std::string _path);
+
+    ~PMTilesDataSource() override;
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override;
+
+    void getStats(TileSourceStats& _stats) const override;
+
+    // Hilbert curve position of @_tileId among the tiles of all zoom levels up to its own
+    static uint64_t tileIdToHilbert(const TileID& _tileId);
+
+private:
+    struct Entry {
+        uint64_t tileId;
+        uint64_t offset;
+        uint32_t length;
+        // Number of consecutive tile IDs with the same data, 0 for entries of leaf directories
+        uint32_t runLength;
+    };
+    using Directory = std::vector<Entry>;
+
+    struct ReadRequest {
+        std::shared_ptr<TileTask> task;
+        TileTaskCb cb;
+        // Position of the tile data in the archive
+        uint64_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    bool openArchive();
+    bool readDirectory(uint64_t _offset, uint64_t _length, Directory& _directory) const;
+    const Directory* leafDirectory(uint64_t _offset, uint64_t _length);
+
+    // Find the position of the data of @_tileId in the archive; false when it has no such tile
+    bool findTile(const TileID& _tileId, uint64_t& _offset, uint32_t& _length);
+
+    bool decodeTile(const char* _data, size_t _length, std::vector<char>& _tile) const;
+
+    // Worker: read all queued requests
+    void readTiles();
+
+    std::string m_name;
+    std::string m_path;
+
+    std::unique_ptr<MappedFile> m_file;
+
+    uint64_t m_leafDirectoriesOffset = 0;
+    uint64_t m_tileDataOffset = 0;
+    uint8_t m_internalCompression = 0;
+    uint8_t m_tileCompression = 0;
+    uint8_t m_minZoom = 0;
+    uint8_t m_maxZoom = 0;
+
+    Directory m_rootDirectory;
+
+    // Decoded leaf directories by offset, used on the worker only
+    struct Leaf {
+        uint64_t offset;
+        Directory directory;
+    };
+    std::list<Leaf> m_leaves;
+    std::unordered_map<uint64_t, std::list<Leaf>::iterator> m_leafIndex;
+
+    std::unique_ptr<AsyncWorker> m_worker;
+    std::mutex m_queueMutex;
+    std::vector<ReadRequest> m_queue;
+
+    DurationCounter m_readTime;
+    StatCounter m_readTiles;
+};
+
+}
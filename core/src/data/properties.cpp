@@ -2,10 +2,167 @@
 #include "data/properties.h"
 #include "rapidjson/writer.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace Tangram {
 
+struct PropertyKeyTable {
+    using Entries = std::unordered_map<std::string, PropertyKey::Entry>;
+
+    std::mutex mutex;
+    // node-based maps: key strings and entries keep their address when the tables grow
+    Entries interned;
+    // keys beyond maxInterned, removed when their last PropertyKey is released
+    Entries shared;
+    // ids of removed shared keys, for reuse
+    std::vector<uint32_t> freeIds;
+    uint32_t nextSharedId = PropertyKey::sharedId;
+    uint32_t maxInterned = PropertyKey::defaultMaxInterned;
+    // incremented whenever a key is added, to validate cached lookup misses
+    std::atomic<uint32_t> generation{0};
+
+    PropertyKeyTable() {
+        add(interned, "", 0);
+    }
+
+    static const PropertyKey::Entry& add(Entries& _entries, const std::string& _name, uint32_t _id) {
+        auto it = _entries.emplace(std::piecewise_construct, std::forward_as_tuple(_name),
+                                   std::forward_as_tuple(_id)).first;
+        it->second.name = &it->first;
+        return it->second;
+    }
+
+    // Find the key for _name, adding it if _add is set; the lock must be held
+    PropertyKey get(const std::string& _name, bool _add) {
+        auto it = interned.find(_name);
+        if (it != interned.end()) { return PropertyKey(&it->second, it->second.id); }
+
+        it = shared.find(_name);
+        if (it != shared.end()) { return PropertyKey(&it->second, it->second.id); }
+
+        if (!_add) { return PropertyKey(&PropertyKey::emptyEntry(), PropertyKey::invalidId); }
+
+        generation++;
+        if (interned.size() < maxInterned) {
+            auto& entry = add(interned, _name, uint32_t(interned.size()));
+            return PropertyKey(&entry, entry.id);
+        }
+        uint32_t id = nextSharedId;
+        if (freeIds.empty()) {
+            nextSharedId++;
+        } else {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        auto& entry = add(shared, _name, id);
+        return PropertyKey(&entry, entry.id);
+    }
+};
+
+PropertyKeyTable& PropertyKey::table() {
+    // Never destroyed: PropertyKeys with static storage duration may be released after it
+    static auto* table = new PropertyKeyTable();
+    return *table;
+}
+
+const PropertyKey::Entry& PropertyKey::emptyEntry() {
+    static const std::string name;
+    static const Entry empty(0, &name);
+    return empty;
+}
+
+void PropertyKey::setMaxInterned(uint32_t _max) {
+    auto& keys = table();
+    std::lock_guard<std::mutex> lock(keys.mutex);
+    keys.maxInterned = _max;
+}
+
+uint32_t PropertyKey::maxInterned() {
+    auto& keys = table();
+    std::lock_guard<std::mutex> lock(keys.mutex);
+    return keys.maxInterned;
+}
+
+uint32_t PropertyKey::internedCount() {
+    auto& keys = table();
+    std::lock_guard<std::mutex> lock(keys.mutex);
+    return uint32_t(keys.interned.size());
+}
+
+void PropertyKey::release() const {
+    // Only the last reference takes the lock, so that a shared key is not removed while it is
+    // being looked up: references are only added from zero with the lock held
+    uint32_t refs = m_entry->refs.load(std::memory_order_relaxed);
+    while (refs > 1) {
+        if (m_entry->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    auto& keys = table();
+    std::lock_guard<std::mutex> lock(keys.mutex);
+    if (--m_entry->refs == 0) {
+        keys.freeIds.push_back(m_id);
+        keys.shared.erase(keys.shared.find(*m_entry->name));
+    }
+}
+
+// Thread-local caches are cleared when they reach this size
+static constexpr size_t maxCachedKeys = 4096;
+
+PropertyKey PropertyKey::intern(const std::string& _name) {
+    // Avoid taking the table lock for keys this thread has seen before
+    thread_local std::unordered_map<std::string, PropertyKey> cache;
+
+    auto cached = cache.find(_name);
+    if (cached != cache.end()) { return cached->second; }
+
+    auto& keys = table();
+    PropertyKey key;
+    {
+        std::lock_guard<std::mutex> lock(keys.mutex);
+        key = keys.get(_name, true);
+    }
+    if (cache.size() >= maxCachedKeys) { cache.clear(); }
+    cache.emplace(_name, key);
+    return key;
+}
+
+PropertyKey PropertyKey::find(const std::string& _name) {
+    thread_local std::unordered_map<std::string, PropertyKey> cache;
+    // misses are valid as long as no key was added to the tables
+    thread_local std::unordered_map<std::string, uint32_t> missing;
+
+    auto cached = cache.find(_name);
+    if (cached != cache.end()) { return cached->second; }
+
+    auto& keys = table();
+    auto miss = missing.find(_name);
+    if (miss != missing.end() && miss->second == keys.generation) {
+        return PropertyKey(&emptyEntry(), invalidId);
+    }
+
+    PropertyKey key;
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(keys.mutex);
+        key = keys.get(_name, false);
+        generation = keys.generation;
+    }
+    if (!key.isValid()) {
+        if (missing.size() >= maxCachedKeys) { missing.clear(); }
+        missing[_name] = generation;
+        return key;
+    }
+    if (cache.size() >= maxCachedKeys) { cache.clear(); }
+    cache.emplace(_name, key);
+    return key;
+}
+
 std::string doubleToString(double _doubleValue) {
     std::string value = std::to_string(_doubleValue);
 
@@ -19,7 +176,9 @@ std::string doubleToString(double _doubleValue) {
 
 Properties::Properties() : sourceId(0) {}
 
-Properties::Properties(std::vector<Item>&& _items) : sourceId(0), props(_items) {}
+Properties::Properties(std::vector<Item>&& _items) : sourceId(0), props(std::move(_items)) {
+    sort();
+}
 
 Properties::~Properties() {}
 
@@ -33,34 +192,30 @@ void Properties::setSorted(std::vector<Item>&& _items) {
     props = std::move(_items);
 }
 
-const Value& Properties::get(const std::string& key) const {
+void Properties::swapSorted(std::vector<Item>& _items) {
+    props.swap(_items);
+}
+
+const Value& Properties::get(PropertyKey key) const {
 
-    const auto it = std::find_if(props.begin(), props.end(),
-                                 [&](const auto& item) {
-                                     return item.key == key;
-                                 });
-    if (it == props.end()) {
+    auto it = std::lower_bound(props.begin(), props.end(), key,
+                               [](auto& item, auto& key) {
+                                   return item.key < key;
+                               });
+    if (it == props.end() || it->key != key) {
         return NOT_A_VALUE;
     }
 
-    // auto it = std::lower_bound(props.begin(), props.end(), key,
-    //                            [](auto& item, auto& key) {
-    //                                return keyComparator(item.key, key);
-    //                            });
-    // if (it == props.end() || it->key != key) {
-    //     return NOT_FOUND;
-    // }
-
     return it->value;
 }
 
 void Properties::clear() { props.clear(); }
 
-bool Properties::contains(const std::string& key) const {
+bool Properties::contains(PropertyKey key) const {
     return !get(key).is<none_type>();
 }
 
-bool Properties::getNumber(const std::string& key, double& value) const {
+bool Properties::getNumber(PropertyKey key, double& value) const {
     auto& it = get(key);
     if (it.is<double>()) {
         value = it.get<double>();
@@ -69,7 +224,7 @@ bool Properties::getNumber(const std::string& key, double& value) const {
     return false;
 }
 
-double Properties::getNumber(const std::string& key) const {
+double Properties::getNumber(PropertyKey key) const {
     auto& it = get(key);
     if (it.is<double>()) {
         return it.get<double>();
@@ -77,7 +232,7 @@ double Properties::getNumber(const std::string& key) const {
     return 0;
 }
 
-bool Properties::getString(const std::string& key, std::string& value) const {
+bool Properties::getString(PropertyKey key, std::string& value) const {
     auto& it = get(key);
     if (it.is<std::string>()) {
         value = it.get<std::string>();
@@ -86,7 +241,7 @@ bool Properties::getString(const std::string& key, std::string& value) const {
     return false;
 }
 
-const std::string& Properties::getString(const std::string& key) const {
+const std::string& Properties::getString(PropertyKey key) const {
     const static std::string EMPTY_STRING = "";
 
     auto& it = get(key);
@@ -96,7 +251,7 @@ const std::string& Properties::getString(const std::string& key) const {
     return EMPTY_STRING;
 }
 
-bool Properties::getAsString(const std::string& key, std::string& value) const {
+bool Properties::getAsString(PropertyKey key, std::string& value) const {
     auto& it = get(key);
 
     if (it.is<std::string>()) {
@@ -119,7 +274,7 @@ std::string Properties::asString(const Value& value) {
     return "";
 }
 
-std::string Properties::getAsString(const std::string& key) const {
+std::string Properties::getAsString(PropertyKey key) const {
     return asString(get(key));
 }
 
@@ -127,37 +282,47 @@ void Properties::sort() {
     std::sort(props.begin(), props.end());
 }
 
-void Properties::setValue(std::string key, Value value) {
+void Properties::setValue(PropertyKey key, Value value) {
 
     auto it = std::lower_bound(props.begin(), props.end(), key,
-        [](auto& item, auto& key) { return keyComparator(item.key, key); });
+        [](auto& item, auto& key) { return item.key < key; });
 
     if (it == props.end() || it->key != key) {
-        props.emplace(it, std::move(key), std::move(value));
+        props.emplace(it, key, std::move(value));
     } else {
         it->value = std::move(value);
     }
 }
 
-void Properties::set(std::string key, std::string value) {
+void Properties::set(PropertyKey key, std::string value) {
     setValue(key, Value(std::move(value)));
 }
 
-void Properties::set(std::string key, double value) {
+void Properties::set(PropertyKey key, double value) {
     setValue(key, Value(value));
 }
 
+std::vector<const Properties::Item*> Properties::sortedItems() const {
+    std::vector<const Item*> items;
+    items.reserve(props.size());
+    for (const auto& item : props) { items.push_back(&item); }
+    std::sort(items.begin(), items.end(), [](auto* a, auto* b) {
+        return keyComparator(a->key, b->key);
+    });
+    return items;
+}
+
 std::string Properties::toJson() const {
     // use rapidjson to handle escaping " and \ in strings
     rapidjson::StringBuffer sb;
     rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
     writer.StartObject();
-    for (const auto& item : props) {
-        writer.String(item.key.c_str());
-        if (item.value.is<std::string>()) {
-            writer.String(item.value.get<std::string>().c_str());
-        } else if (item.value.is<double>()) {
-            double val = item.value.get<double>();
+    for (const auto* item : sortedItems()) {
+        writer.String(item->key.c_str());
+        if (item->value.is<std::string>()) {
+            writer.String(item->value.get<std::string>().c_str());
+        } else if (item->value.is<double>()) {
+            double val = item->value.get<double>();
             if (std::isfinite(val)) { writer.Double(val); }
             else { writer.Null(); }
         } else {
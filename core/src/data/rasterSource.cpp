@@ -111,13 +111,15 @@ void RasterSource::generateGeometry(bool _generateGeometry) {
     if (m_generateGeometry) {
         Feature rasterFeature;
         rasterFeature.geometryType = GeometryType::polygons;
-        rasterFeature.polygons = { { {
-                    {0.0f, 0.0f},
-                    {1.0f, 0.0f},
-                    {1.0f, 1.0f},
-                    {0.0f, 1.0f},
-                    {0.0f, 0.0f}
-                } } };
+        std::vector<Point> ring = {
+            {0.0f, 0.0f},
+            {1.0f, 0.0f},
+            {1.0f, 1.0f},
+            {0.0f, 1.0f},
+            {0.0f, 0.0f}
+        };
+        rasterFeature.beginPolygon();
+        rasterFeature.addRing(ring);
         rasterFeature.props = Properties();
 
         m_tileData = std::make_shared<TileData>();
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "glm/fwd.hpp"
 #include "glm/vec2.hpp"
 #include "data/properties.h"
 
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -39,6 +43,10 @@ Data heirarchy:
   one collection each of <Point>s, <Line>s, and <Polygon>s. Only the geometry
   collection corresponding to the feature's geometryType should contain data.
 
+  A <LazyLayer> is a <Layer> whose features are kept in their encoded form
+  (e.g. MVT protobuf) and decoded one at a time into a reusable <Feature>;
+  geometry is only decoded on request, i.e. for features matched by a filter.
+
   A <Properties> contains a sorted vector of key-value pairs storing the
   properties of a <Feature>
 
@@ -50,6 +58,24 @@ Data heirarchy:
 
   A <Point> is 2 32-bit floating point coordinates representing x and y.
 
+Geometry storage:
+
+  The coordinates of all lines and polygon rings of a <Feature> are stored in
+  one flat buffer. Lines and rings are <GeometryRange>s of this buffer and
+  polygons are ranges of rings, so that a feature needs only a few allocations
+  regardless of the number of its lines and rings, and a reused <Feature> (see
+  <LazyLayer>) does not allocate at all once its buffers have grown.
+
+  <Line> and <Polygon> are lightweight views into these buffers; they are only
+  valid as long as the feature is not modified.
+
+  Optionally (see TileSource::setQuantizedGeometry()) the buffer holds
+  16-bit integer tile units of the source, e.g. MVT extent units, with a
+  scale to tile coordinates, halving the memory of the coordinates. MVT
+  decoding writes them without computing tile coordinates; mesh builders and
+  the selection index convert them per vertex, and label builders one line
+  or polygon at a time.
+
 */
 namespace Tangram {
 
@@ -62,9 +88,159 @@ enum GeometryType {
 
 using Point = glm::vec2;
 
-using Line = std::vector<Point>;
+// Point in integer tile units, see Feature::quantizedCoordinates
+using QuantizedPoint = glm::i16vec2;
+
+/* View of a contiguous sequence of T owned by another container */
+template<class T>
+class Span {
+public:
+    using value_type = T;
+    using const_iterator = const T*;
+
+    Span() {}
+    Span(const T* _data, size_t _size) : m_data(_data), m_size(_size) {}
+    Span(const std::vector<T>& _vector) : m_data(_vector.data()), m_size(_vector.size()) {}
+
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+    std::reverse_iterator<const T*> rbegin() const { return std::reverse_iterator<const T*>(end()); }
+    std::reverse_iterator<const T*> rend() const { return std::reverse_iterator<const T*>(begin()); }
 
-using Polygon = std::vector<Line>;
+    const T& operator[](size_t _index) const { return m_data[_index]; }
+    const T& front() const { return m_data[0]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+private:
+    const T* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+using Line = Span<Point>;
+
+/* Range [begin, end) of a Feature geometry buffer */
+struct GeometryRange {
+    uint32_t begin;
+    uint32_t end;
+
+    uint32_t size() const { return end - begin; }
+};
+
+/* View of a sequence of lines that are ranges of a shared coordinate buffer
+ *
+ * The iterator yields line views by reference to its own current value, so it
+ * is meant for range-based for loops and indexed access only.
+ */
+template<class P>
+class BasicLineList {
+public:
+    using line_type = Span<P>;
+    using value_type = line_type;
+
+    class const_iterator {
+    public:
+        const_iterator(const P* _coordinates, const GeometryRange* _range)
+            : m_coordinates(_coordinates), m_range(_range) {}
+
+        const line_type& operator*() {
+            m_line = line_type(m_coordinates + m_range->begin, m_range->size());
+            return m_line;
+        }
+        const_iterator& operator++() { m_range++; return *this; }
+        bool operator!=(const const_iterator& _other) const { return m_range != _other.m_range; }
+        bool operator==(const const_iterator& _other) const { return m_range == _other.m_range; }
+
+    private:
+        const P* m_coordinates;
+        const GeometryRange* m_range;
+        line_type m_line;
+    };
+
+    BasicLineList() {}
+    BasicLineList(const P* _coordinates, const GeometryRange* _ranges, size_t _size)
+        : m_coordinates(_coordinates), m_ranges(_ranges), m_size(_size) {}
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    line_type operator[](size_t _index) const {
+        const auto& range = m_ranges[_index];
+        return line_type(m_coordinates + range.begin, range.size());
+    }
+    line_type front() const { return (*this)[0]; }
+    line_type back() const { return (*this)[m_size - 1]; }
+
+    const_iterator begin() const { return { m_coordinates, m_ranges }; }
+    const_iterator end() const { return { m_coordinates, m_ranges + m_size }; }
+
+private:
+    const P* m_coordinates = nullptr;
+    const GeometryRange* m_ranges = nullptr;
+    size_t m_size = 0;
+};
+
+/* View of a sequence of polygons that are ranges of a shared ring buffer */
+template<class P>
+class BasicPolygonList {
+public:
+    using polygon_type = BasicLineList<P>;
+    using value_type = polygon_type;
+
+    class const_iterator {
+    public:
+        const_iterator(const BasicPolygonList& _list, size_t _index) : m_list(_list), m_index(_index) {}
+
+        const polygon_type& operator*() {
+            m_polygon = m_list[m_index];
+            return m_polygon;
+        }
+        const_iterator& operator++() { m_index++; return *this; }
+        bool operator!=(const const_iterator& _other) const { return m_index != _other.m_index; }
+        bool operator==(const const_iterator& _other) const { return m_index == _other.m_index; }
+
+    private:
+        const BasicPolygonList& m_list;
+        size_t m_index;
+        polygon_type m_polygon;
+    };
+
+    BasicPolygonList() {}
+    BasicPolygonList(const P* _coordinates, const GeometryRange* _rings,
+                     const GeometryRange* _polygons, size_t _size)
+        : m_coordinates(_coordinates), m_rings(_rings), m_polygons(_polygons), m_size(_size) {}
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    polygon_type operator[](size_t _index) const {
+        const auto& range = m_polygons[_index];
+        return polygon_type(m_coordinates, m_rings + range.begin, range.size());
+    }
+    polygon_type front() const { return (*this)[0]; }
+    polygon_type back() const { return (*this)[m_size - 1]; }
+
+    const_iterator begin() const { return { *this, 0 }; }
+    const_iterator end() const { return { *this, m_size }; }
+
+private:
+    const P* m_coordinates = nullptr;
+    const GeometryRange* m_rings = nullptr;
+    const GeometryRange* m_polygons = nullptr;
+    size_t m_size = 0;
+};
+
+using LineList = BasicLineList<Point>;
+using Polygon = LineList;
+using PolygonList = BasicPolygonList<Point>;
+
+using QuantizedLine = Span<QuantizedPoint>;
+using QuantizedLineList = BasicLineList<QuantizedPoint>;
+using QuantizedPolygon = QuantizedLineList;
+using QuantizedPolygonList = BasicPolygonList<QuantizedPoint>;
 
 struct Feature {
     Feature() {}
@@ -73,10 +249,110 @@ struct Feature {
     GeometryType geometryType = GeometryType::polygons;
 
     std::vector<Point> points;
-    std::vector<Line> lines;
-    std::vector<Polygon> polygons;
+
+    // Coordinates of all lines and polygon rings
+    std::vector<Point> coordinates;
+    // Lines and polygon rings as ranges of 'coordinates', or of 'quantizedCoordinates' when
+    // the feature is quantized
+    std::vector<GeometryRange> lineRanges;
+    std::vector<GeometryRange> ringRanges;
+    // Polygons as ranges of 'ringRanges'
+    std::vector<GeometryRange> polygonRanges;
+
+    // Line and polygon coordinates in integer tile units (e.g. of the MVT tile extent), used
+    // instead of 'coordinates' when quantizedScale is set; see TileSource::setQuantizedGeometry()
+    std::vector<QuantizedPoint> quantizedCoordinates;
+    // Scale from tile units to tile coordinates
+    double quantizedScale = 0;
 
     Properties props;
+
+    bool isQuantized() const { return quantizedScale != 0; }
+
+    LineList lines() const {
+        return { coordinates.data(), lineRanges.data(), lineRanges.size() };
+    }
+
+    PolygonList polygons() const {
+        return { coordinates.data(), ringRanges.data(), polygonRanges.data(), polygonRanges.size() };
+    }
+
+    QuantizedLineList quantizedLines() const {
+        return { quantizedCoordinates.data(), lineRanges.data(), lineRanges.size() };
+    }
+
+    QuantizedPolygonList quantizedPolygons() const {
+        return { quantizedCoordinates.data(), ringRanges.data(), polygonRanges.data(), polygonRanges.size() };
+    }
+
+    Point dequantize(QuantizedPoint _point) const {
+        return { float(quantizedScale * _point.x), float(quantizedScale * _point.y) };
+    }
+
+    // Copy the geometry of this feature into _out with tile coordinates
+    void dequantize(Feature& _out) const {
+        _out.clearGeometry();
+        _out.geometryType = geometryType;
+        _out.points = points;
+        _out.coordinates.reserve(quantizedCoordinates.size());
+        for (auto& point : quantizedCoordinates) {
+            _out.coordinates.push_back(dequantize(point));
+        }
+        _out.lineRanges = lineRanges;
+        _out.ringRanges = ringRanges;
+        _out.polygonRanges = polygonRanges;
+    }
+
+    // Add a line from the coordinates appended since _begin
+    void endLine(size_t _begin) {
+        lineRanges.push_back({ uint32_t(_begin), uint32_t(geometrySize()) });
+    }
+
+    template<class Iterator>
+    void addLine(Iterator _begin, Iterator _end) {
+        size_t begin = coordinates.size();
+        coordinates.insert(coordinates.end(), _begin, _end);
+        endLine(begin);
+    }
+
+    void addLine(Line _line) { addLine(_line.begin(), _line.end()); }
+
+    // Start a new polygon; its rings are added with addRing() or endRing()
+    void beginPolygon() {
+        uint32_t rings = ringRanges.size();
+        polygonRanges.push_back({ rings, rings });
+    }
+
+    // Add a ring to the current polygon from the coordinates appended since _begin
+    void endRing(size_t _begin) {
+        ringRanges.push_back({ uint32_t(_begin), uint32_t(geometrySize()) });
+        polygonRanges.back().end = ringRanges.size();
+    }
+
+    template<class Iterator>
+    void addRing(Iterator _begin, Iterator _end) {
+        size_t begin = coordinates.size();
+        coordinates.insert(coordinates.end(), _begin, _end);
+        endRing(begin);
+    }
+
+    void addRing(Line _ring) { addRing(_ring.begin(), _ring.end()); }
+
+    // Remove all geometry, keeping the allocated buffers for reuse
+    void clearGeometry() {
+        points.clear();
+        coordinates.clear();
+        lineRanges.clear();
+        ringRanges.clear();
+        polygonRanges.clear();
+        quantizedCoordinates.clear();
+        quantizedScale = 0;
+    }
+
+private:
+    size_t geometrySize() const {
+        return isQuantized() ? quantizedCoordinates.size() : coordinates.size();
+    }
 };
 
 struct Layer {
@@ -89,10 +365,36 @@ struct Layer {
 
 };
 
+struct LazyLayer {
+
+    LazyLayer(const std::string& _name) : name(_name) {}
+
+    virtual ~LazyLayer() {}
+
+    std::string name;
+
+    // Restart iteration over features
+    virtual void rewind() = 0;
+
+    // Decode properties and geometry type of the next feature into _feature and clear its
+    // geometry; returns false when there are no more features
+    virtual bool nextFeature(Feature& _feature) = 0;
+
+    // Decode geometry of the feature last returned by nextFeature()
+    virtual void getGeometry(Feature& _feature) = 0;
+
+    // Decode geometry of the feature returned by the @_index-th call of nextFeature() since
+    // rewind(), e.g. for features whose properties were decoded ahead
+    virtual void getGeometry(size_t _index, Feature& _feature) = 0;
+
+};
+
 struct TileData {
 
     std::vector<Layer> layers;
 
+    std::vector<std::unique_ptr<LazyLayer>> lazyLayers;
+
 };
 
 }
@@ -3,6 +3,7 @@
 #include "data/formats/geoJson.h"
 #include "data/formats/mvt.h"
 #include "data/formats/topoJson.h"
+#include "data/missingTileCache.h"
 #include "data/tileData.h"
 #include "data/rasterSource.h"
 #include "platform.h"
@@ -12,6 +13,7 @@
 #include "log.h"
 #include "util/geom.h"
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 
@@ -21,7 +23,8 @@ TileSource::TileSource(const std::string& _name, std::unique_ptr<DataSource> _so
                        ZoomOptions _zoomOptions) :
     m_name(_name),
     m_zoomOptions(_zoomOptions),
-    m_sources(std::move(_sources)) {
+    m_sources(std::move(_sources)),
+    m_missingTiles(std::make_unique<MissingTileCache>()) {
 
     static std::atomic<int32_t> s_serial;
 
@@ -74,6 +77,7 @@ void TileSource::addRasterTasks(TileTask& _task) {
 void TileSource::clearData() {
 
     if (m_sources) { m_sources->clear(); }
+    m_missingTiles->clear();
 
     m_generation++;
 }
@@ -100,17 +104,40 @@ std::shared_ptr<TileData> TileSource::parse(const TileTask& _task) const {
     switch (m_format) {
     case Format::TopoJson: return TopoJson::parseTile(_task, m_id);
     case Format::GeoJson: return GeoJson::parseTile(_task, m_id);
-    case Format::Mvt: return Mvt::parseTile(_task, m_id);
+    case Format::Mvt: return Mvt::parseTile(_task, *this);
     }
     assert(false);
     return nullptr;
 }
 
+void TileSource::setCollections(std::vector<std::string> _collections) {
+    m_collections = std::move(_collections);
+    std::sort(m_collections.begin(), m_collections.end());
+    m_collections.erase(std::unique(m_collections.begin(), m_collections.end()), m_collections.end());
+    m_filterCollections = true;
+}
+
+bool TileSource::hasCollection(const std::string& _name) const {
+    if (!m_filterCollections || _name.empty()) { return true; }
+    return std::binary_search(m_collections.begin(), m_collections.end(), _name);
+}
+
 void TileSource::cancelLoadingTile(TileTask& _task) {
     // handling of shareCount and subtasks now done in TileManager::TileEntry::clearTask()
     if (m_sources) { m_sources->cancelLoadingTile(_task); }
 }
 
+TileSourceStats TileSource::getStats() const {
+    TileSourceStats stats;
+    stats.name = m_name;
+    stats.buildTime = m_buildTime.get();
+    m_missingTiles->getStats(stats);
+
+    if (m_sources) { m_sources->getStats(stats); }
+
+    return stats;
+}
+
 void TileSource::addRasterSource(std::shared_ptr<TileSource> _rasterSource) {
     if (!_rasterSource) {
         LOGE("No raster source");
@@ -1,5 +1,6 @@
 #include "debug/frameInfo.h"
 
+#include "debug/layerProfile.h"
 #include "debug/textDisplay.h"
 #include "gl.h"
 #include "gl/glError.h"
@@ -10,6 +11,7 @@
 #include "labels/labelManager.h"
 #include "tile/tileCache.h"
 
+#include <algorithm>
 #include <deque>
 #include <ctime>
 #if defined(DEBUG) && defined(TANGRAM_LINUX)
@@ -90,7 +92,8 @@ void FrameInfo::end(const std::string& tag) {
 void FrameInfo::draw(RenderState& rs, const View& _view, Map& _map) {
     ++s_frameCount;
 
-    if (!getDebugFlag(DebugFlags::tangram_infos) && !getDebugFlag(DebugFlags::tangram_stats)) { return; }
+    if (!getDebugFlag(DebugFlags::tangram_infos) && !getDebugFlag(DebugFlags::tangram_stats) &&
+        !getDebugFlag(DebugFlags::layer_profile)) { return; }
 
     static std::deque<float> updatetime;
     static std::deque<float> rendertime;
@@ -99,7 +102,8 @@ void FrameInfo::draw(RenderState& rs, const View& _view, Map& _map) {
     float avgTimeCpu = 0.f;
     float avgTimeUpdate = 0.f;
 
-    if (profInfos.empty() || getDebugFlag(DebugFlags::tangram_stats)) {
+    if ((profInfos.empty() && getDebugFlag(DebugFlags::tangram_infos)) ||
+        getDebugFlag(DebugFlags::tangram_stats)) {
         static int cpt = 0;
 
         clock_t endCpu = clock();
@@ -142,8 +146,9 @@ void FrameInfo::draw(RenderState& rs, const View& _view, Map& _map) {
     TileManager& tileManager = *scene.tileManager();
     auto& tileCache = *tileManager.getTileCache();
 
+    std::vector<std::string> debuginfos;
+
     if (getDebugFlag(DebugFlags::tangram_infos)) {
-        std::vector<std::string> debuginfos;
 
         auto& tiles = tileManager.getVisibleTiles();
         std::map<int, int> sourceCounts;
@@ -196,7 +201,25 @@ void FrameInfo::draw(RenderState& rs, const View& _view, Map& _map) {
             debuginfos.push_back(fstring("LngLat:%f,%f", center.longitude, center.latitude));
             debuginfos.push_back(fstring("tilt:%.2fdeg", _view.getPitch() * 57.3));
         }
+    }
+
+    if (getDebugFlag(DebugFlags::layer_profile)) {
+        // Most expensive layers since the profile was reset
+        const size_t maxLayers = 16;
+        auto layers = scene.layerProfile()->get();
+
+        debuginfos.push_back("=== Layer build time ===");
+        for (size_t i = 0; i < std::min(layers.size(), maxLayers); i++) {
+            const auto& layer = layers[i];
+            const auto& name = layer.sublayer.empty() ? layer.dataLayer : layer.sublayer;
+            const char* style = layer.style.empty() ? "(match)" : layer.style.c_str();
+            debuginfos.push_back(fstring("%.1fms %s [%s] features:%llu vertices:%llu labels:%llu",
+                layer.timeMs, name.c_str(), style, (unsigned long long)layer.features,
+                (unsigned long long)layer.vertices, (unsigned long long)layer.labels));
+        }
+    }
 
+    if (!debuginfos.empty()) {
         TextDisplay::Instance().draw(rs, _view, debuginfos);
     }
 
@@ -0,0 +1,61 @@
+#include "debug/layerProfile.h"
+
+#include "scene/sceneLayer.h"
+#include "util/hash.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+size_t LayerProfile::KeyHash::operator()(const Key& _key) const {
+    size_t seed = 0;
+    hash_combine(seed, _key.dataLayer);
+    hash_combine(seed, _key.sublayer);
+    hash_combine(seed, _key.style);
+    return seed;
+}
+
+void LayerProfile::merge(Batch& _batch) {
+    if (_batch.empty()) { return; }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : _batch) {
+        auto& total = m_totals[entry.first];
+        total.time += entry.second.time;
+        total.features += entry.second.features;
+        total.vertices += entry.second.vertices;
+        total.labels += entry.second.labels;
+    }
+    _batch.clear();
+}
+
+void LayerProfile::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_totals.clear();
+}
+
+std::vector<LayerStats> LayerProfile::get() const {
+    std::vector<LayerStats> stats;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.reserve(m_totals.size());
+        for (const auto& entry : m_totals) {
+            const auto& key = entry.first;
+            const auto& cost = entry.second;
+
+            LayerStats layer;
+            layer.dataLayer = key.dataLayer->name();
+            if (key.sublayer) { layer.sublayer = key.sublayer; }
+            if (key.style) { layer.style = *key.style; }
+            layer.timeMs = std::chrono::duration<double, std::milli>(cost.time).count();
+            layer.features = cost.features;
+            layer.vertices = cost.vertices;
+            layer.labels = cost.labels;
+            stats.push_back(std::move(layer));
+        }
+    }
+    std::sort(stats.begin(), stats.end(), [](auto& a, auto& b) { return a.timeMs > b.timeMs; });
+    return stats;
+}
+
+}
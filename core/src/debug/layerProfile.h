@@ -0,0 +1,70 @@
+#pragma once
+
+#include "util/stats.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+class SceneLayer;
+
+/* Cost of building tile features per scene layer, collected while DebugFlags::layer_profile is set
+ *
+ * Costs are attributed to a data layer, the deepest sublayer contributing to a matched draw rule
+ * and the style the rule is built with. The time of matching a feature against the filters of a
+ * data layer is attributed to the data layer alone, without sublayer and style.
+ *
+ * Each TileBuilder sums the costs of a tile into its own Batch and merges it once the tile is
+ * built, so TileWorkers only contend for the totals once per tile.
+ */
+class LayerProfile {
+
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Key {
+        const SceneLayer* dataLayer;
+        // Name of the sublayer, owned by the scene; nullptr for the data layer entry
+        const char* sublayer;
+        // Name of the style, owned by the scene; nullptr for the data layer entry
+        const std::string* style;
+
+        bool operator==(const Key& _other) const {
+            return dataLayer == _other.dataLayer && sublayer == _other.sublayer &&
+                style == _other.style;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& _key) const;
+    };
+
+    struct Cost {
+        Clock::duration time{0};
+        uint64_t features = 0;
+        uint64_t vertices = 0;
+        uint64_t labels = 0;
+    };
+
+    using Batch = std::unordered_map<Key, Cost, KeyHash>;
+
+    // Add the costs of @_batch to the totals and clear it
+    void merge(Batch& _batch);
+
+    void reset();
+
+    // Totals by data layer, sublayer and style, sorted by decreasing time
+    std::vector<LayerStats> get() const;
+
+private:
+
+    mutable std::mutex m_mutex;
+    Batch m_totals;
+};
+
+}
@@ -0,0 +1,168 @@
+#include "debug/trace.h"
+
+#include "rapidjson/writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+constexpr size_t Trace::bufferSize;
+
+std::atomic<bool> Trace::s_enabled{false};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Event {
+    const char* name;
+    Clock::time_point time;
+    int64_t value;
+    char phase;
+};
+
+struct ThreadBuffer {
+    // Only contended while the trace is exported
+    std::mutex mutex;
+    std::vector<Event> events;
+    // Position of the next event in the ring
+    size_t next = 0;
+    uint32_t tid = 0;
+    std::string name;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    Clock::time_point startTime;
+    uint32_t nextTid = 1;
+};
+
+Registry& registry() {
+    static Registry s_registry;
+    return s_registry;
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer->tid = reg.nextTid++;
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+}
+
+void Trace::record(Phase _phase, const char* _name, int64_t _value) {
+    auto& buffer = threadBuffer();
+    Event event{ _name, Clock::now(), _value, static_cast<char>(_phase) };
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < bufferSize) {
+        buffer.events.push_back(event);
+    } else {
+        buffer.events[buffer.next] = event;
+    }
+    buffer.next = (buffer.next + 1) % bufferSize;
+}
+
+void Trace::setThreadName(const char* _name) {
+    auto& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = _name;
+}
+
+void Trace::start() {
+    auto& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        // Drop buffers of exited threads, which are only referenced by the registry
+        reg.buffers.erase(std::remove_if(reg.buffers.begin(), reg.buffers.end(),
+                                         [](auto& b) { return b.use_count() == 1; }),
+                          reg.buffers.end());
+        for (auto& buffer : reg.buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->events.clear();
+            buffer->next = 0;
+        }
+        reg.startTime = Clock::now();
+    }
+    s_enabled = true;
+}
+
+std::string Trace::stop() {
+    s_enabled = false;
+    return toJson();
+}
+
+std::string Trace::toJson() {
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+    writer.StartObject();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("traceEvents");
+    writer.StartArray();
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+
+        if (!buffer->name.empty()) {
+            writer.StartObject();
+            writer.Key("name"); writer.String("thread_name");
+            writer.Key("ph"); writer.String("M");
+            writer.Key("pid"); writer.Uint(1);
+            writer.Key("tid"); writer.Uint(buffer->tid);
+            writer.Key("args");
+            writer.StartObject();
+            writer.Key("name"); writer.String(buffer->name.c_str());
+            writer.EndObject();
+            writer.EndObject();
+        }
+
+        // Oldest event first once the ring has wrapped around
+        size_t count = buffer->events.size();
+        size_t first = count < bufferSize ? 0 : buffer->next;
+
+        for (size_t i = 0; i < count; i++) {
+            const auto& event = buffer->events[(first + i) % count];
+            if (event.time < reg.startTime) { continue; }
+
+            std::chrono::duration<double, std::micro> ts = event.time - reg.startTime;
+            const char phase[2] = { event.phase, 0 };
+
+            writer.StartObject();
+            writer.Key("name"); writer.String(event.name);
+            writer.Key("ph"); writer.String(phase);
+            writer.Key("ts"); writer.Double(ts.count());
+            writer.Key("pid"); writer.Uint(1);
+            writer.Key("tid"); writer.Uint(buffer->tid);
+            if (event.phase == static_cast<char>(Phase::counter)) {
+                writer.Key("args");
+                writer.StartObject();
+                writer.Key("value"); writer.Int64(event.value);
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+
+    return sb.GetString();
+}
+
+}
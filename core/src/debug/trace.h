@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Tangram {
+
+/* Recording of timed events for inspection in chrome://tracing or ui.perfetto.dev
+ *
+ * While tracing is enabled, begin/end and counter events are recorded with their thread into
+ * per-thread ring buffers, which keep the most recent Trace::bufferSize events of each thread.
+ * When tracing is disabled a trace point only loads one atomic flag, so trace points can stay
+ * in release builds.
+ *
+ * Event names are not copied: they must be string literals or otherwise outlive the trace.
+ */
+struct Trace {
+
+    // Maximum number of events kept per thread
+    static constexpr size_t bufferSize = 1 << 16;
+
+    // Discard previously recorded events and start recording
+    static void start();
+
+    // Stop recording and return the recorded events, see toJson()
+    static std::string stop();
+
+    // Recorded events in Chrome trace event format
+    static std::string toJson();
+
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    static void begin(const char* _name) {
+        if (enabled()) { record(Phase::begin, _name, 0); }
+    }
+
+    static void end(const char* _name) {
+        if (enabled()) { record(Phase::end, _name, 0); }
+    }
+
+    static void counter(const char* _name, int64_t _value) {
+        if (enabled()) { record(Phase::counter, _name, _value); }
+    }
+
+    // Set the name of the calling thread shown in the trace
+    static void setThreadName(const char* _name);
+
+    struct scope {
+        const char* name;
+        bool active;
+        scope(const char* _name) : name(_name), active(enabled()) {
+            if (active) { record(Phase::begin, name, 0); }
+        }
+        ~scope() {
+            if (active) { record(Phase::end, name, 0); }
+        }
+    };
+
+private:
+
+    enum class Phase : char {
+        begin = 'B',
+        end = 'E',
+        counter = 'C',
+    };
+
+    static void record(Phase _phase, const char* _name, int64_t _value);
+
+    static std::atomic<bool> s_enabled;
+};
+
+}
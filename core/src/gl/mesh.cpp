@@ -216,6 +216,119 @@ size_t MeshBase::bufferSize() const {
     return m_nVertices * m_vertexLayout->getStride() + m_nIndices * sizeof(GLushort);
 }
 
+namespace {
+
+// Layout of serialized meshes: header, vertex offsets, vertex data, index data
+struct MeshHeader {
+    uint32_t drawMode;
+    uint32_t stride;
+    uint32_t nVertices;
+    uint32_t nIndices;
+    uint32_t nOffsets;
+};
+
+void append(std::vector<char>& _out, const void* _data, size_t _size) {
+    auto* bytes = static_cast<const char*>(_data);
+    _out.insert(_out.end(), bytes, bytes + _size);
+}
+
+}
+
+bool MeshBase::serialize(std::vector<char>& _out) const {
+    if (!m_isCompiled || !m_glVertexData) { return false; }
+
+    MeshHeader header;
+    header.drawMode = m_drawMode;
+    header.stride = m_vertexLayout->getStride();
+    header.nVertices = m_nVertices;
+    header.nIndices = m_nIndices;
+    header.nOffsets = m_vertexOffsets.size();
+
+    _out.reserve(_out.size() + sizeof(header) + header.nOffsets * 2 * sizeof(uint32_t) +
+                 bufferSize());
+
+    append(_out, &header, sizeof(header));
+    for (auto& offset : m_vertexOffsets) {
+        append(_out, &offset.first, sizeof(uint32_t));
+        append(_out, &offset.second, sizeof(uint32_t));
+    }
+    append(_out, m_glVertexData, m_nVertices * header.stride);
+    if (m_nIndices > 0) {
+        append(_out, m_glIndexData, m_nIndices * sizeof(GLushort));
+    }
+    return true;
+}
+
+bool MeshBase::deserialize(const char* _data, size_t _size) {
+    if (m_isCompiled || _size < sizeof(MeshHeader)) { return false; }
+
+    MeshHeader header;
+    std::memcpy(&header, _data, sizeof(header));
+
+    size_t stride = m_vertexLayout->getStride();
+    size_t offsetBytes = size_t(header.nOffsets) * 2 * sizeof(uint32_t);
+    size_t vertexBytes = size_t(header.nVertices) * stride;
+    size_t indexBytes = size_t(header.nIndices) * sizeof(GLushort);
+
+    if (header.stride != stride || header.drawMode != m_drawMode ||
+        _size != sizeof(header) + offsetBytes + vertexBytes + indexBytes) {
+        return false;
+    }
+    const char* pos = _data + sizeof(header);
+
+    std::vector<std::pair<uint32_t, uint32_t>> vertexOffsets(header.nOffsets);
+    size_t sumIndices = 0, sumVertices = 0;
+    for (auto& offset : vertexOffsets) {
+        std::memcpy(&offset.first, pos, sizeof(uint32_t));
+        std::memcpy(&offset.second, pos + sizeof(uint32_t), sizeof(uint32_t));
+        pos += 2 * sizeof(uint32_t);
+        sumIndices += offset.first;
+        sumVertices += offset.second;
+    }
+    // Batches are drawn from the buffers in order, see draw(); meshes without indices have none
+    if (vertexOffsets.empty() ? header.nIndices != 0 :
+        sumIndices != header.nIndices || sumVertices != header.nVertices) {
+        return false;
+    }
+    m_vertexOffsets = std::move(vertexOffsets);
+
+    m_nVertices = header.nVertices;
+    m_glVertexData = new GLbyte[vertexBytes];
+    std::memcpy(m_glVertexData, pos, vertexBytes);
+    pos += vertexBytes;
+
+    m_nIndices = header.nIndices;
+    if (m_nIndices > 0) {
+        m_glIndexData = new GLushort[m_nIndices];
+        std::memcpy(m_glIndexData, pos, indexBytes);
+    }
+
+    m_isCompiled = true;
+    return true;
+}
+
+void CachedMesh::remapAttribute(const std::string& _attribName,
+                                const fastmap<uint32_t, uint32_t>& _values) {
+    if (!m_glVertexData || _values.size() == 0) { return; }
+
+    for (auto& attrib : m_vertexLayout->getAttribs()) {
+        if (attrib.name != _attribName) { continue; }
+
+        size_t stride = m_vertexLayout->getStride();
+        GLbyte* end = m_glVertexData + m_nVertices * stride;
+
+        for (GLbyte* vertex = m_glVertexData + attrib.offset; vertex < end; vertex += stride) {
+            uint32_t value;
+            std::memcpy(&value, vertex, sizeof(value));
+            auto it = _values.find(value);
+            if (it != _values.end()) {
+                std::memcpy(vertex, &it->second, sizeof(value));
+            }
+        }
+        return;
+    }
+}
+
 // Add indices by collecting them into batches to draw as much as
 // possible in one draw call.  The indices must be shifted by the
 // number of vertices that are present in the current batch.
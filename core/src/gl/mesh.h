@@ -73,6 +73,18 @@ public:
 
     size_t bufferSize() const;
 
+    /*
+     * Appends the compiled vertices and indices to _out; returns false if the
+     * geometry is not compiled or was already uploaded
+     */
+    bool serialize(std::vector<char>& _out) const;
+
+    /*
+     * Compiles the geometry written by serialize() from _size bytes at _data;
+     * returns false if the data does not match the vertex layout
+     */
+    bool deserialize(const char* _data, size_t _size);
+
 protected:
 
     // Used in draw for legth and offsets: sumIndices, sumVertices
@@ -151,6 +163,10 @@ public:
         return MeshBase::draw(rs, shader, useVao);
     }
 
+    bool serialize(std::vector<char>& _out) const override {
+        return MeshBase::serialize(_out);
+    }
+
     void compile(const std::vector<MeshData<T>>& _meshes);
 
     void compile(const MeshData<T>& _mesh);
@@ -171,6 +187,38 @@ public:
                          size_t _attribOffset = 0);
 };
 
+/*
+ * CachedMesh - Mesh of a style restored from serialized vertex data, see
+ * TileGeometryCache
+ */
+class CachedMesh : public StyledMesh, protected MeshBase {
+public:
+
+    CachedMesh(std::shared_ptr<VertexLayout> _vertexLayout, GLenum _drawMode)
+        : MeshBase(_vertexLayout, _drawMode) {}
+
+    size_t bufferSize() const override {
+        return MeshBase::bufferSize();
+    }
+
+    bool draw(RenderState& rs, ShaderProgram& shader, bool useVao = true) override {
+        return MeshBase::draw(rs, shader, useVao);
+    }
+
+    bool serialize(std::vector<char>& _out) const override {
+        return MeshBase::serialize(_out);
+    }
+
+    bool deserialize(const char* _data, size_t _size) {
+        return MeshBase::deserialize(_data, _size);
+    }
+
+    /*
+     * Replaces the values of the 32 bit attribute _attribName by their mapping
+     * in _values, e.g. to assign new feature selection colors
+     */
+    void remapAttribute(const std::string& _attribName, const fastmap<uint32_t, uint32_t>& _values);
+};
 
 template<class T>
 void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
@@ -206,7 +206,8 @@ int DuktapeContext::jsHasProperty(duk_context *_ctx) {
         return 0;
     }
 
-    const char* key = duk_require_string(_ctx, 1);
+    // Lookup without interning: keys that were never seen cannot be present.
+    auto key = PropertyKey::find(duk_require_string(_ctx, 1));
     auto result = static_cast<duk_bool_t>(context->_feature->props.contains(key));
     duk_push_boolean(_ctx, result);
 
@@ -230,7 +231,7 @@ int DuktapeContext::jsGetProperty(duk_context *_ctx) {
     }
 
     // Get the property name (second parameter)
-    const char* key = duk_require_string(_ctx, 1);
+    auto key = PropertyKey::find(duk_require_string(_ctx, 1));
 
     auto it = context->_feature->props.get(key);
     if (it.is<std::string>()) {
@@ -175,7 +175,7 @@ bool JSCoreContext::jsHasPropertyCallback(JSContextRef, JSObjectRef object, JSSt
     }
     char nameBuffer[128]; // This should be enough for all the names we use - could make it dynamically-sized if needed.
     JSStringGetUTF8CString(property, nameBuffer, sizeof(nameBuffer));
-    return feature->props.contains(nameBuffer);
+    return feature->props.contains(PropertyKey::find(nameBuffer));
 }
 
 JSValueRef JSCoreContext::jsGetPropertyCallback(JSContextRef context, JSObjectRef object, JSStringRef property, JSValueRef*) {
@@ -190,7 +190,7 @@ JSValueRef JSCoreContext::jsGetPropertyCallback(JSContextRef context, JSObjectRe
     JSValueRef jsValue = nullptr;
     char nameBuffer[128]; // This should be enough for all the names we use - could make it dynamically-sized if needed.
     JSStringGetUTF8CString(property, nameBuffer, sizeof(nameBuffer));
-    auto it = feature->props.get(nameBuffer);
+    auto it = feature->props.get(PropertyKey::find(nameBuffer));
     if (it.is<std::string>()) {
         jsValue = jsCoreContext->_strings.get(context, it.get<std::string>());
     } else if (it.is<double>()) {
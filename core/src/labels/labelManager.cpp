@@ -1,6 +1,7 @@
 #include "labels/labelManager.h"
 
 #include "data/tileSource.h"
+#include "debug/trace.h"
 #include "gl/primitives.h"
 #include "gl/shaderProgram.h"
 #include "labels/curvedLabel.h"
@@ -11,6 +12,7 @@
 #include "marker/marker.h"
 #include "platform.h"
 #include "scene/scene.h"
+#include "selection/selectionIndex.h"
 #include "style/pointStyle.h"
 #include "style/style.h"
 #include "style/textStyle.h"
@@ -26,6 +28,7 @@
 #include "glm/gtx/norm.hpp"
 
 #include <cassert>
+#include <limits>
 
 namespace Tangram {
 
@@ -145,6 +148,29 @@ std::pair<Label*, const Tile*> LabelManager::getLabel(uint32_t _selectionColor)
     return {nullptr, nullptr};
 }
 
+void LabelManager::getLabelsNear(glm::vec2 _position, float _radius, std::vector<LabelHit>& _hits) {
+
+    std::vector<OBB> obbs;
+
+    for (auto& entry : m_selectionLabels) {
+        if (!entry.label->visibleState()) { continue; }
+
+        obbs.clear();
+        Range obbsRange;
+        ScreenTransform transform { m_transforms, entry.transformRange };
+        OBBBuffer buffer { obbs, obbsRange };
+        entry.label->obbs(transform, buffer);
+
+        float distance = std::numeric_limits<float>::max();
+        for (const auto& obb : obbs) {
+            distance = std::min(distance, SelectionIndex::quadDistance(_position, obb.getQuad()));
+        }
+        if (distance <= _radius) {
+            _hits.push_back({ entry.label, entry.tile, entry.marker, distance });
+        }
+    }
+}
+
 static Style* getStyleById(const Scene& _scene, uint32_t id) {
     for (const auto& style : _scene.styles()) {
         if (style->getID() == id) { return style.get(); }
@@ -522,6 +548,8 @@ void LabelManager::updateLabelSet(const ViewState& _viewState, float _dt, const
                             const std::vector<std::unique_ptr<Marker>>& _markers,
                             bool _onlyRender) {
 
+    Trace::scope _trace("LabelManager::updateLabelSet");
+
     m_transforms.clear();
     m_obbs.clear();
 
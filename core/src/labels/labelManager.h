@@ -46,6 +46,18 @@ public:
 
     std::pair<Label*, const Tile*> getLabel(uint32_t _selectionColor) const;
 
+    struct LabelHit {
+        Label* label;
+        const Tile* tile;
+        const Marker* marker;
+        // Distance in pixels from the queried position to the label, 0 when it is on the label
+        float distance;
+    };
+
+    // Append the visible selectable labels whose bounding boxes are within _radius of _position,
+    // in screen coordinates of the last update, to _hits
+    void getLabelsNear(glm::vec2 _position, float _radius, std::vector<LabelHit>& _hits);
+
 protected:
 
     using AABB = isect2d::AABB<glm::vec2>;
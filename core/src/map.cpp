@@ -2,6 +2,8 @@
 
 #include "debug/textDisplay.h"
 #include "debug/frameInfo.h"
+#include "debug/layerProfile.h"
+#include "debug/trace.h"
 #include "gl.h"
 #include "gl/glError.h"
 #include "gl/framebuffer.h"
@@ -15,12 +17,14 @@
 #include "platform.h"
 #include "scene/scene.h"
 #include "scene/sceneLoader.h"
+#include "selection/selectionPicker.h"
 #include "selection/selectionQuery.h"
 #include "style/material.h"
 #include "style/style.h"
 #include "text/fontContext.h"
 #include "tile/tile.h"
 #include "tile/tileCache.h"
+#include "tile/tileGeometryCache.h"
 #include "util/asyncWorker.h"
 #include "util/elevationManager.h"
 #include "util/fastmap.h"
@@ -101,7 +105,7 @@ public:
 };
 
 
-static std::bitset<9> g_flags = 0;
+static std::bitset<10> g_flags = 0;
 
 Map::Map(std::unique_ptr<Platform> _platform) : platform(std::move(_platform)) {
     LOGTOInit();
@@ -237,6 +241,8 @@ void Map::setViewport(int _newX, int _newY, int _newWidth, int _newHeight) {
 
 MapState Map::update(float _dt) {
 
+    Trace::scope _trace("Map::update");
+
     FrameInfo::beginUpdate();
     FrameInfo::begin("Update");
 
@@ -282,6 +288,8 @@ MapState Map::update(float _dt) {
 
 void Map::render() {
 
+    Trace::scope _trace("Map::render");
+
     auto& scene = *impl->scene;
     auto& view = impl->view;
     auto& renderState = impl->renderState;
@@ -829,6 +837,12 @@ bool Map::markerSetPolyline(MarkerID _marker, LngLat* _coordinates, int _count)
     return success;
 }
 
+bool Map::markerAppendPolyline(MarkerID _marker, LngLat* _coordinates, int _count) {
+    bool success = impl->scene->markerManager()->appendPolyline(_marker, _coordinates, _count);
+    platform->requestRender();
+    return success;
+}
+
 bool Map::markerSetPolygon(MarkerID _marker, LngLat* _coordinates, int* _counts, int _rings) {
     bool success = impl->scene->markerManager()->setPolygon(_marker, _coordinates, _counts, _rings);
     platform->requestRender();
@@ -901,6 +915,30 @@ void Map::pickMarkerAt(float _x, float _y, MarkerPickCallback _onMarkerPickCallb
     platform->requestRender();
 }
 
+std::vector<FeaturePickResult> Map::pickFeaturesNear(float _x, float _y, float _radius) {
+    if (!impl->scene || !impl->scene->isReady()) { return {}; }
+
+    auto& scene = *impl->scene;
+    SelectionPicker picker(impl->view, *scene.tileManager(), *scene.labelManager(), *scene.markerManager());
+    return picker.pickFeatures({_x, _y}, _radius);
+}
+
+std::vector<LabelPickResult> Map::pickLabelsNear(float _x, float _y, float _radius) {
+    if (!impl->scene || !impl->scene->isReady()) { return {}; }
+
+    auto& scene = *impl->scene;
+    SelectionPicker picker(impl->view, *scene.tileManager(), *scene.labelManager(), *scene.markerManager());
+    return picker.pickLabels({_x, _y}, _radius);
+}
+
+std::vector<MarkerPickResult> Map::pickMarkersNear(float _x, float _y, float _radius) {
+    if (!impl->scene || !impl->scene->isReady()) { return {}; }
+
+    auto& scene = *impl->scene;
+    SelectionPicker picker(impl->view, *scene.tileManager(), *scene.labelManager(), *scene.markerManager());
+    return picker.pickMarkers({_x, _y}, _radius);
+}
+
 void Map::handleTapGesture(float _posX, float _posY) {
     cancelCameraAnimation();
     impl->inputHandler.handleTapGesture(_posX, _posY);
@@ -955,6 +993,9 @@ void Map::setupGL() {
 
     LOG("setup GL");
 
+    // setupGL() is called on the rendering thread
+    Trace::setThreadName("Render");
+
     impl->renderState.invalidate();
 
     //impl->scene->tileManager()->clearTileSets();
@@ -989,6 +1030,37 @@ void Map::onMemoryWarning() {
     }
 }
 
+MapStats Map::getStats() {
+    MapStats stats;
+    stats.urlRequestsActive = platform->activeUrlRequests();
+    stats.urlRequestsPending = platform->pendingUrlRequests();
+
+    if (!impl->scene) { return stats; }
+
+    if (auto* tileWorker = impl->scene->tileWorker()) {
+        tileWorker->getStats(stats);
+    }
+    if (auto* tileManager = impl->scene->tileManager()) {
+        tileManager->getStats(stats);
+    }
+    if (auto& geometryCache = impl->scene->geometryCache()) {
+        geometryCache->getStats(stats);
+    }
+    return stats;
+}
+
+std::vector<LayerStats> Map::getLayerStats() {
+    if (!impl->scene) { return {}; }
+
+    return impl->scene->layerProfile()->get();
+}
+
+void Map::resetLayerStats() {
+    if (!impl->scene) { return; }
+
+    impl->scene->layerProfile()->reset();
+}
+
 void Map::setDefaultBackgroundColor(float r, float g, float b) {
     impl->renderState.defaultOpaqueClearColor(r, g, b);
 }
@@ -1022,4 +1094,12 @@ void toggleDebugFlag(DebugFlags _flag) {
     // }
 }
 
+void startTracing() {
+    Trace::start();
+}
+
+std::string stopTracing() {
+    return Trace::stop();
+}
+
 }
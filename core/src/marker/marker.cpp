@@ -5,6 +5,7 @@
 #include "scene/dataLayer.h"
 #include "scene/drawRule.h"
 #include "scene/scene.h"
+#include "selection/selectionIndex.h"
 #include "style/style.h"
 #include "view/view.h"
 
@@ -22,6 +23,7 @@ Marker::~Marker() {
 
 void Marker::reset() {
     m_mesh.reset();
+    m_revision++;
     m_drawRuleData.reset();
     m_drawRule.reset();
     m_drawRuleSet.reset(new DrawRuleMergeSet());
@@ -31,31 +33,74 @@ void Marker::reset() {
 void Marker::setBounds(BoundingBox bounds) {
     m_bounds = bounds;
     m_origin = bounds.min; // South-West corner
+    m_extent = glm::max(bounds.width(), bounds.height());
+}
+
+void Marker::expandBounds(const BoundingBox& bounds) {
+    m_bounds.expand(bounds.min.x, bounds.min.y);
+    m_bounds.expand(bounds.max.x, bounds.max.y);
 }
 
 void Marker::setStyling(std::string styling, bool isPath) {
     m_styling.string = styling;
     m_styling.isPath = isPath;
     m_builtZoomLevel = -1;
+    m_revision++;
 }
 
-void Marker::setFeature(std::unique_ptr<Feature> feature) {
+void Marker::setFeature(std::shared_ptr<Feature> feature) {
     m_feature = std::move(feature);
+    m_lineParts.clear();
+    m_lineContinued = false;
+    m_selectionIndex.reset();
 }
 
-void Marker::setTexture(std::unique_ptr<Texture> texture) {
-    m_texture = std::move(texture);
+void Marker::continueLine(std::shared_ptr<Feature> feature, bool completePart) {
+    if (completePart) {
+        m_lineParts.push_back(std::move(m_feature));
+    }
+    m_feature = std::move(feature);
+    m_lineContinued = true;
+    m_selectionIndex.reset();
 }
 
-bool Marker::evaluateRuleForContext(StyleContext& ctx) {
-    return m_drawRuleSet->evaluateRuleForContext(*drawRule(), ctx);
+void Marker::setLineParts(std::vector<std::shared_ptr<Feature>> lineParts) {
+    m_lineParts = std::move(lineParts);
+    m_selectionIndex.reset();
 }
 
-void Marker::setDrawRuleData(std::unique_ptr<DrawRuleData> drawRuleData) {
+bool Marker::takeLineContinued() {
+    bool continued = m_lineContinued;
+    m_lineContinued = false;
+    return continued;
+}
+
+const SelectionIndex& Marker::selectionIndex() {
+    if (!m_selectionIndex) {
+        m_selectionIndex = std::make_unique<SelectionIndex>();
+        for (const auto& part : m_lineParts) {
+            if (part) { m_selectionIndex->add(m_selectionColor, *part); }
+        }
+        if (m_feature) { m_selectionIndex->add(m_selectionColor, *m_feature); }
+        m_selectionIndex->build();
+    }
+    return *m_selectionIndex;
+}
+
+void Marker::setTexture(std::shared_ptr<Texture> texture) {
+    m_texture = std::move(texture);
+}
+
+void Marker::setDrawRuleData(std::shared_ptr<DrawRuleData> drawRuleData) {
     m_drawRuleData = std::move(drawRuleData);
     m_drawRule = std::make_unique<DrawRule>(*m_drawRuleData, "", 0);
 }
 
+void Marker::setDrawRule(const DrawRule& drawRule) {
+    m_drawRuleData.reset();
+    m_drawRule = std::make_unique<DrawRule>(drawRule);
+}
+
 void Marker::mergeRules(const SceneLayer& layer) {
     m_drawRuleSet->mergeRules(layer);
 }
@@ -71,7 +116,7 @@ bool Marker::finalizeRuleMergingForName(const std::string& name) {
     }
     if (found) {
         // Clear leftover data (outside the loop so we don't invalidate iterators).
-        m_drawRuleData.reset(nullptr);
+        m_drawRuleData.reset();
         m_drawRuleSet->matchedRules().clear();
     }
     return found;
@@ -81,6 +126,7 @@ void Marker::setMesh(uint32_t styleId, uint32_t zoom, std::unique_ptr<StyledMesh
     m_mesh = std::move(mesh);
     m_styleId = styleId;
     m_builtZoomLevel = zoom;
+    m_revision++;
 
     float scale;
     if (m_feature && m_feature->geometryType == GeometryType::points) {
@@ -93,6 +139,7 @@ void Marker::setMesh(uint32_t styleId, uint32_t zoom, std::unique_ptr<StyledMesh
 
 void Marker::clearMesh() {
     m_mesh.reset();
+    m_revision++;
 }
 
 void Marker::setEase(const glm::dvec2& dest, float duration, EaseType e) {
@@ -122,6 +169,7 @@ void Marker::setDrawOrder(int drawOrder) {
 
 void Marker::setSelectionColor(uint32_t selectionColor) {
     m_selectionColor = selectionColor;
+    m_selectionIndex.reset();
 }
 
 int Marker::builtZoomLevel() const {
@@ -141,7 +189,11 @@ uint32_t Marker::styleId() const {
 }
 
 float Marker::extent() const {
-    return glm::max(m_bounds.width(), m_bounds.height());
+    return m_extent;
+}
+
+uint32_t Marker::revision() const {
+    return m_revision;
 }
 
 Feature* Marker::feature() const {
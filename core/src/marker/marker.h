@@ -8,6 +8,7 @@
 #include "glm/vec2.hpp"
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Tangram {
 
@@ -15,7 +16,7 @@ class SceneLayer;
 class DrawRuleMergeSet;
 class MapProjection;
 class Scene;
-class StyleContext;
+class SelectionIndex;
 class Texture;
 class View;
 struct DrawRule;
@@ -45,14 +46,31 @@ public:
     // maximum dimension (extent) of the bounds.
     void setBounds(BoundingBox bounds);
 
-    // Set the feature whose geometry will be used to build the marker.
-    void setFeature(std::unique_ptr<Feature> feature);
+    // Expand the bounds to include _bounds, keeping the origin and extent of the coordinates in
+    // the feature, e.g. for points appended to a polyline.
+    void expandBounds(const BoundingBox& bounds);
+
+    // Set the feature whose geometry will be used to build the marker. The feature is shared with
+    // mesh builds in progress and must not be modified afterwards.
+    void setFeature(std::shared_ptr<Feature> feature);
+
+    // Continue the polyline feature of the marker with _feature, which contains the last points of
+    // the current feature followed by appended points. With _completePart the current feature is
+    // kept as a completed part of the line, otherwise it is replaced.
+    void continueLine(std::shared_ptr<Feature> feature, bool completePart);
+
+    // Set the completed parts of a polyline preceding the feature, see lineParts().
+    void setLineParts(std::vector<std::shared_ptr<Feature>> lineParts);
 
     // Sets the styling struct for the marker
     void setStyling(std::string styling, bool isPath);
 
-    // Set the new draw rule data that will be used to build the marker.
-    void setDrawRuleData(std::unique_ptr<DrawRuleData> drawRuleData);
+    // Set the new draw rule data that will be used to build the marker; the data may be shared
+    // by markers with the same styling.
+    void setDrawRuleData(std::shared_ptr<DrawRuleData> drawRuleData);
+
+    // Set a copy of a previously resolved draw rule, see drawRule().
+    void setDrawRule(const DrawRule& drawRule);
 
     // Merge draw rules from the given layer into the internal draw rule set.
     void mergeRules(const SceneLayer& layer);
@@ -67,7 +85,7 @@ public:
 
     void clearMesh();
 
-    void setTexture(std::unique_ptr<Texture> texture);
+    void setTexture(std::shared_ptr<Texture> texture);
 
     // Set an ease for the origin of this marker in Mercator meters.
     void setEase(const glm::dvec2& destination, float duration, EaseType ease);
@@ -96,18 +114,39 @@ public:
     // Get the ordering of this marker relative to other markers.
     int drawOrder() const;
 
-    // Get the length of the maximum dimension of the bounds of this marker. This is used as
-    // the scale in the model matrix.
+    // Get the length of the maximum dimension of the bounds of this marker as last set by
+    // setBounds(). This is used as the scale in the model matrix.
     float extent() const;
 
+    // Get the number of times the mesh of this marker was cleared or replaced; a mesh built for
+    // an earlier revision is outdated.
+    uint32_t revision() const;
+
     StyledMesh* mesh() const;
 
+    // Get the draw rule resolved from the styling, before evaluating functions and stops.
     DrawRule* drawRule() const;
 
     Feature* feature() const;
 
     Texture* texture() const;
 
+    const std::shared_ptr<Feature>& sharedFeature() const { return m_feature; }
+
+    const std::shared_ptr<Texture>& sharedTexture() const { return m_texture; }
+
+    const std::shared_ptr<DrawRuleData>& drawRuleData() const { return m_drawRuleData; }
+
+    // Get the completed parts of a polyline with appended points; the feature is the last part.
+    const std::vector<std::shared_ptr<Feature>>& lineParts() const { return m_lineParts; }
+
+    // Whether points were appended to the polyline since the last call.
+    bool takeLineContinued();
+
+    // Get the geometry of the feature and line parts of this marker for picking, indexed in the
+    // coordinates of the feature when first used after the geometry changed.
+    const SelectionIndex& selectionIndex();
+
     const BoundingBox& bounds() const;
 
     // Get the origin of the geometry for this marker, i.e. the South-West corner of the bounds.
@@ -120,8 +159,6 @@ public:
 
     const Styling& styling() const { return m_styling; }
 
-    bool evaluateRuleForContext(StyleContext& ctx);
-
     bool isEasing() const;
 
     bool isVisible() const;
@@ -137,11 +174,13 @@ public:
 
 protected:
 
-    std::unique_ptr<Feature> m_feature;
+    std::shared_ptr<Feature> m_feature;
+    std::vector<std::shared_ptr<Feature>> m_lineParts;
+    std::unique_ptr<SelectionIndex> m_selectionIndex;
     std::unique_ptr<StyledMesh> m_mesh;
-    std::unique_ptr<Texture> m_texture;
+    std::shared_ptr<Texture> m_texture;
     std::unique_ptr<DrawRuleMergeSet> m_drawRuleSet;
-    std::unique_ptr<DrawRuleData> m_drawRuleData;
+    std::shared_ptr<DrawRuleData> m_drawRuleData;
     std::unique_ptr<DrawRule> m_drawRule;
 
     Styling m_styling;
@@ -152,6 +191,8 @@ protected:
 
     int m_builtZoomLevel = -1;
 
+    uint32_t m_revision = 0;
+
     uint32_t m_selectionColor = 0;
 
     int m_drawOrder = 0;
@@ -162,6 +203,9 @@ protected:
     // Bounding box in global projection space which describes the origin and extent of the coordinates in the Feature
     BoundingBox m_bounds;
 
+    // Unit length of the coordinates in the Feature, see setBounds() and expandBounds()
+    float m_extent = 0;
+
     // Matrix relating marker-local coordinates to global projection space coordinates;
     // Note that this matrix does not contain the relative translation from the global origin to the marker origin.
     // Distances from the global origin are too large to represent precisely in 32-bit floats, so we only apply the
@@ -174,6 +218,8 @@ protected:
 
     bool m_visible = true;
 
+    bool m_lineContinued = false;
+
 };
 
 } // namespace Tangram
@@ -1,5 +1,6 @@
 #include "marker/markerManager.h"
 
+#include "data/propertyItem.h"
 #include "data/tileData.h"
 #include "gl/texture.h"
 #include "marker/marker.h"
@@ -11,14 +12,190 @@
 #include "labels/labelSet.h"
 #include "log.h"
 #include "selection/featureSelection.h"
+#include "util/asyncWorker.h"
+#include "util/geom.h"
 
 #include <algorithm>
+#include <atomic>
 
 namespace Tangram {
 
 // ':' Delimiter for style params and layer-sublayer naming
 static const char DELIMITER = ':';
 
+// Styling strings whose parsed draw rules are kept for other markers; applications building
+// a styling string per marker should not grow the cache without bounds
+static const size_t MAX_CACHED_STYLINGS = 256;
+
+// Points of a polyline marker in one part of the line; each part is built into its own mesh so
+// that appending points rebuilds only the last part
+static const size_t MAX_LINE_PART_POINTS = 1024;
+
+// Polyline vertices are stored with 16-bit positions in units of 1/8192 of the marker extent;
+// points appended beyond this multiple of the extent move the line into new bounds
+static const float MAX_LINE_FRAME = 3.f;
+
+// Minimal extent in meters of polyline markers, for lines whose points are all equal
+static const double MIN_LINE_EXTENT = 1.0;
+
+// Points closer than this fraction of a pixel to the simplified line are dropped when building
+// polyline markers
+static const float LINE_SIMPLIFY_PIXELS = 0.5f;
+
+namespace {
+
+// Douglas-Peucker simplification of the lines of _feature; returns null when no point is dropped
+std::unique_ptr<Feature> simplifyLines(const Feature& _feature, float _tolerance) {
+
+    const auto& points = _feature.coordinates;
+    if (_feature.isQuantized() || points.size() < 3) { return nullptr; }
+
+    float sqTolerance = _tolerance * _tolerance;
+    std::vector<bool> keep(points.size(), false);
+    std::vector<GeometryRange> stack;
+
+    for (const auto& range : _feature.lineRanges) {
+        if (range.size() == 0) { continue; }
+        keep[range.begin] = keep[range.end - 1] = true;
+        stack.push_back({ range.begin, range.end - 1 });
+
+        while (!stack.empty()) {
+            auto segment = stack.back();
+            stack.pop_back();
+
+            float maxSqDistance = 0;
+            uint32_t farthest = 0;
+            for (uint32_t i = segment.begin + 1; i < segment.end; i++) {
+                float sqDistance = pointSegmentDistanceSq(points[i], points[segment.begin],
+                                                          points[segment.end]);
+                if (sqDistance > maxSqDistance) {
+                    maxSqDistance = sqDistance;
+                    farthest = i;
+                }
+            }
+            if (maxSqDistance > sqTolerance) {
+                keep[farthest] = true;
+                stack.push_back({ segment.begin, farthest });
+                stack.push_back({ farthest, segment.end });
+            }
+        }
+    }
+
+    if (std::find(keep.begin(), keep.end(), false) == keep.end()) { return nullptr; }
+
+    auto simplified = std::make_unique<Feature>();
+    simplified->geometryType = _feature.geometryType;
+    simplified->props = _feature.props;
+    for (const auto& range : _feature.lineRanges) {
+        size_t begin = simplified->coordinates.size();
+        for (uint32_t i = range.begin; i < range.end; i++) {
+            if (keep[i]) { simplified->coordinates.push_back(points[i]); }
+        }
+        simplified->endLine(begin);
+    }
+    return simplified;
+}
+
+// Bounds for the coordinates of a polyline, with an extent for lines whose points are all equal
+BoundingBox lineBounds(BoundingBox _bounds) {
+    if (std::max(_bounds.width(), _bounds.height()) < MIN_LINE_EXTENT) {
+        _bounds.max = _bounds.min + glm::dvec2(MIN_LINE_EXTENT);
+    }
+    return _bounds;
+}
+
+// Copy of the line _feature with coordinates relative to _origin and _extent instead of
+// _oldOrigin and _oldExtent
+std::shared_ptr<Feature> rebaseLine(const Feature& _feature, glm::dvec2 _oldOrigin, double _oldExtent,
+                                    glm::dvec2 _origin, double _extent) {
+    auto feature = std::make_shared<Feature>(_feature);
+    for (auto& point : feature->coordinates) {
+        glm::dvec2 meters = glm::dvec2(point) * _oldExtent + _oldOrigin;
+        point = glm::vec2((meters - _origin) / _extent);
+    }
+    return feature;
+}
+
+}
+
+// Style builders and JS functions for building marker meshes on one thread
+struct MarkerManager::BuildContext {
+    StyleContext styleContext;
+    fastmap<std::string, std::unique_ptr<StyleBuilder>> styleBuilders;
+    // Holds the parameters evaluated from functions and stops
+    DrawRuleMergeSet ruleSet;
+    // Marker for setting up style builders with the state of another marker
+    Marker marker{0};
+
+    explicit BuildContext(const Scene& _scene) {
+        styleContext.initFunctions(_scene);
+        for (const auto& style : _scene.styles()) {
+            styleBuilders[style->getName()] = style->createBuilder();
+        }
+    }
+};
+
+// Mesh of a polyline marker with one mesh for each part of the line, see Marker::lineParts()
+struct MarkerManager::LineMesh : public StyledMesh {
+    std::vector<std::unique_ptr<StyledMesh>> parts;
+    // Last part of the line when the meshes were built
+    std::shared_ptr<Feature> tail;
+
+    bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) override {
+        bool drawn = false;
+        for (auto& part : parts) {
+            if (part) { drawn |= part->draw(rs, _shader, _useVao); }
+        }
+        return drawn;
+    }
+
+    size_t bufferSize() const override {
+        size_t size = 0;
+        for (auto& part : parts) {
+            if (part) { size += part->bufferSize(); }
+        }
+        return size;
+    }
+};
+
+struct MarkerManager::BuiltMesh {
+    std::unique_ptr<StyledMesh> mesh;
+    uint32_t styleId = 0;
+    uint32_t selectionColor = 0;
+};
+
+// Markers to be rebuilt for a zoom level, with the state needed to build them while the
+// markers themselves may be modified
+struct MarkerManager::MeshBatch {
+    struct Entry {
+        MarkerID id;
+        uint32_t revision;
+        // Origin and extent of the feature coordinates
+        BoundingBox frame;
+        std::shared_ptr<Feature> feature;
+        std::vector<std::shared_ptr<Feature>> lineParts;
+        std::shared_ptr<Texture> texture;
+        // Keeps the parameters of the rule alive
+        std::shared_ptr<DrawRuleData> drawRuleData;
+        DrawRule rule;
+        BuiltMesh result;
+
+        explicit Entry(const Marker& _marker)
+            : id(_marker.id()), revision(_marker.revision()),
+              frame{ _marker.origin(), _marker.origin() + glm::dvec2(_marker.extent()) },
+              feature(_marker.sharedFeature()), lineParts(_marker.lineParts()),
+              texture(_marker.sharedTexture()),
+              drawRuleData(_marker.drawRuleData()), rule(*_marker.drawRule()) {}
+    };
+
+    int zoom = 0;
+    // Functions from styling strings which were added since the previous batch
+    std::vector<std::string> functions;
+    // Sorted by marker ID once the meshes are built
+    std::vector<Entry> entries;
+    std::atomic<bool> done{false};
+};
+
 MarkerManager::MarkerManager(const Scene& _scene, MarkerManager* _oldInst) : m_scene(_scene) {
     if(_oldInst && !_oldInst->m_markers.empty()) {
         m_dirty = true;
@@ -33,6 +210,9 @@ MarkerManager::MarkerManager(const Scene& _scene, MarkerManager* _oldInst) : m_s
 MarkerManager::~MarkerManager() {
     if(!m_markers.empty())
         LOGD("Destroying MarkerManager with %d markers.", int(m_markers.size()));
+
+    // Finish the running batch before destroying its context
+    m_worker.reset();
 }
 
 
@@ -77,7 +257,7 @@ bool MarkerManager::setBitmap(MarkerID markerID, int width, int height, float de
 
     TextureOptions options;
     options.displayScale = 1.f / density;
-    auto texture = std::make_unique<Texture>(options);
+    auto texture = std::make_shared<Texture>(options);
     texture->setPixelData(width, height, sizeof(GLuint),
                           reinterpret_cast<const GLubyte*>(bitmapData),
                           width * height * sizeof(GLuint));
@@ -112,7 +292,16 @@ bool MarkerManager::setProperties(MarkerID markerID, Properties&& properties) {
     if (!marker) { return false; }
     if (!marker->feature()) { LOGE("Marker geometry must be set before properties!"); return false; }
     marker->clearMesh();
-    marker->feature()->props = std::move(properties);
+    // Replace the features, which may be used by a mesh build on the marker worker
+    auto lineParts = marker->lineParts();
+    for (auto& part : lineParts) {
+        part = std::make_shared<Feature>(*part);
+        part->props = properties;
+    }
+    auto feature = std::make_shared<Feature>(*marker->feature());
+    feature->props = std::move(properties);
+    marker->setFeature(std::move(feature));
+    marker->setLineParts(std::move(lineParts));
     m_dirty = true;
     return true;
 }
@@ -178,8 +367,6 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
     // Build a feature for the new set of polyline points.
     auto feature = std::make_unique<Feature>();
     feature->geometryType = GeometryType::lines;
-    feature->lines.emplace_back();
-    auto& line = feature->lines.back();
 
     // Determine the bounds of the polyline.
     BoundingBox bounds;
@@ -192,17 +379,19 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
     bounds.max = MapProjection::lngLatToProjectedMeters({bounds.max.x, bounds.max.y});
 
     // Update the marker's bounds.
-    marker->setBounds(bounds);
+    marker->setBounds(lineBounds(bounds));
 
     float scale = 1.f / marker->extent();
 
     // Project and offset the coordinates into the marker-local coordinate system.
     auto origin = marker->origin(); // SW corner.
+    feature->coordinates.reserve(count);
     for (int i = 0; i < count; ++i) {
         auto degrees = LngLat(coordinates[i].longitude, coordinates[i].latitude);
         auto meters = MapProjection::lngLatToProjectedMeters(degrees);
-        line.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale);
+        feature->coordinates.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale);
     }
+    feature->endLine(0);
 
     // Update the feature data for the marker.
     marker->setFeature(std::move(feature));
@@ -210,6 +399,84 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
     return true;
 }
 
+bool MarkerManager::appendPolyline(MarkerID markerID, LngLat* coordinates, int count) {
+    Marker* marker = getMarkerOrNull(markerID);
+    if (!marker) { return false; }
+
+    const Feature* current = marker->feature();
+    if (!current || current->geometryType != GeometryType::lines ||
+        current->lineRanges.size() != 1 || current->isQuantized()) {
+        return setPolyline(markerID, coordinates, count);
+    }
+
+    if (!coordinates || count < 1) { return false; }
+
+    m_dirty = true;
+
+    // Meshes with labels along the line are not built per part, rebuild them entirely
+    if (marker->mesh() && !dynamic_cast<LineMesh*>(marker->mesh())) {
+        marker->clearMesh();
+    }
+
+    std::vector<glm::dvec2> meters;
+    meters.reserve(count);
+    BoundingBox bounds = marker->bounds();
+    for (int i = 0; i < count; ++i) {
+        meters.push_back(MapProjection::lngLatToProjectedMeters(coordinates[i]));
+        bounds.expand(meters.back().x, meters.back().y);
+    }
+
+    double extent = marker->extent();
+    glm::dvec2 origin = marker->origin();
+    glm::dvec2 min = (bounds.min - origin) / extent;
+    glm::dvec2 max = (bounds.max - origin) / extent;
+
+    if (min.x < -MAX_LINE_FRAME || min.y < -MAX_LINE_FRAME ||
+        max.x > MAX_LINE_FRAME || max.y > MAX_LINE_FRAME) {
+        // Move all points into the new bounds and rebuild the whole line
+        marker->setBounds(lineBounds(bounds));
+        auto lineParts = marker->lineParts();
+        for (auto& part : lineParts) {
+            part = rebaseLine(*part, origin, extent, marker->origin(), marker->extent());
+        }
+        marker->setFeature(rebaseLine(*current, origin, extent, marker->origin(), marker->extent()));
+        marker->setLineParts(std::move(lineParts));
+        marker->clearMesh();
+
+        current = marker->feature();
+        extent = marker->extent();
+        origin = marker->origin();
+    } else {
+        marker->expandBounds(bounds);
+    }
+
+    size_t begin = 0;
+    while (begin < size_t(count)) {
+        // Continue a complete part with a new part starting with its last point, so that parts
+        // share a vertex but no segment
+        bool completePart = current->coordinates.size() >= MAX_LINE_PART_POINTS;
+        size_t keep = completePart ? 1 : current->coordinates.size();
+        size_t end = std::min(size_t(count), begin + MAX_LINE_PART_POINTS - keep);
+
+        auto part = std::make_shared<Feature>();
+        part->geometryType = GeometryType::lines;
+        part->props = current->props;
+        part->coordinates.reserve(keep + end - begin);
+        part->coordinates.insert(part->coordinates.end(), current->coordinates.end() - keep,
+                                 current->coordinates.end());
+        for (size_t i = begin; i < end; ++i) {
+            part->coordinates.emplace_back((meters[i] - origin) / extent);
+        }
+        part->endLine(0);
+
+        marker->continueLine(std::move(part), completePart);
+        current = marker->feature();
+        begin = end;
+    }
+
+    return true;
+}
+
 bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* counts, int rings) {
     if (!m_scene.isReady()) { return false; }
 
@@ -224,8 +491,6 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     // Build a feature for the new set of polygon points.
     auto feature = std::make_unique<Feature>();
     feature->geometryType = GeometryType::polygons;
-    feature->polygons.emplace_back();
-    auto& polygon = feature->polygons.back();
 
     // Determine the bounds of the polygon.
     BoundingBox bounds;
@@ -252,15 +517,16 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     // Project and offset the coordinates into the marker-local coordinate system.
     auto origin = marker->origin(); // SW corner.
     ring = coordinates;
+    feature->beginPolygon();
     for (int i = 0; i < rings; ++i) {
         int count = counts[i];
-        polygon.emplace_back();
-        auto& line = polygon.back();
+        size_t begin = feature->coordinates.size();
         for (int j = 0; j < count; ++j) {
             auto degrees = LngLat(ring[j].longitude, ring[j].latitude);
             auto meters = MapProjection::lngLatToProjectedMeters(degrees);
-            line.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale);
+            feature->coordinates.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale);
         }
+        feature->endRing(begin);
         ring += count;
     }
 
@@ -270,55 +536,158 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     return true;
 }
 
-MarkerManager::UpdateState MarkerManager::update(const View& _view, float _dt) {
+MarkerManager::UpdateState MarkerManager::update(const View& _view, float _dt, bool _viewChanged) {
     if (!m_scene.isReady() || (!m_dirty && m_markers.empty())) { return {false, false}; }
 
     // do this here instead of Scene::update so we don't print every time map is moved
     LOGTInit(">>> update");
 
-    if (!m_styleContext) {
+    if (!m_buildContext) {
         // First call to update after scene became ready
         // Initialize Stylecontext and StyleBuilders.
-        m_styleContext = std::make_unique<StyleContext>();
-        m_styleContext->initFunctions(m_scene);
-        for (const auto& style : m_scene.styles()) {
-            m_styleBuilders[style->getName()] = style->createBuilder();
-        }
+        m_buildContext = std::make_unique<BuildContext>(m_scene);
     }
 
-    m_zoom = _view.getIntegerZoom();
+    int zoom = _view.getIntegerZoom();
+    bool zoomChanged = (zoom != m_zoom);
+    m_zoom = zoom;
 
     bool rebuilt = false;
-    bool easing = false;
+    bool outdated = false;
     bool dirty = m_dirty;
     m_dirty = false;
 
+    // Markers only change with their eases as long as neither they nor the view were modified
+    bool visitAll = dirty || zoomChanged || _viewChanged;
+
+    if (m_meshBatch && m_meshBatch->done) {
+        // Discard meshes built for a zoom level which is not current anymore
+        if (m_meshBatch->zoom == m_zoom) {
+            finishMeshBatch(*m_meshBatch);
+            rebuilt = true;
+        }
+        m_meshBatch.reset();
+        // Start the next batch for markers which are still outdated
+        visitAll = true;
+    }
+
     // Sort the marker list by draw order - now done here instead of in add() and setDrawOrder()
     if (dirty) {
         std::stable_sort(m_markers.begin(), m_markers.end(), Marker::compareByDrawOrder);
     }
 
-    for (auto& marker : m_markers) {
-        // skip hidden markers (else we'll end up rendering continuously since buildStyling() doesn't finish)
-        if (!marker->isVisible()) { continue; }
-
-        int builtZoom = marker->builtZoomLevel();
-        if (m_zoom != builtZoom || !marker->mesh()) {
-            if (builtZoom < 0) { buildStyling(*marker); }
-
-            // prevent continuous rendering if marker styling fails
-            if (buildMesh(*marker, m_zoom))
-                rebuilt = true;
-            else
-                LOGE("Error building marker mesh.");
-        }
+    if (visitAll) {
+        m_easingMarkers.clear();
+
+        for (auto& marker : m_markers) {
+            // skip hidden markers (else we'll end up rendering continuously since buildStyling() doesn't finish)
+            if (!marker->isVisible()) { continue; }
+
+            int builtZoom = marker->builtZoomLevel();
+            if (builtZoom < 0 || !marker->mesh()) {
+                if (builtZoom < 0) { buildStyling(*marker); }
+
+                // prevent continuous rendering if marker styling fails
+                if (buildMesh(*marker, m_zoom))
+                    rebuilt = true;
+                else
+                    LOGE("Error building marker mesh.");
+            } else if (builtZoom != m_zoom) {
+                // Keep drawing the mesh of the previous zoom level until the batch is done
+                outdated = true;
+            } else if (marker->takeLineContinued()) {
+                rebuilt |= updateLineMesh(*marker);
+            }
 
-        marker->update(_dt, _view);
-        easing |= marker->isEasing();
+            marker->update(_dt, _view);
+            if (marker->isEasing()) { m_easingMarkers.push_back(marker.get()); }
+        }
+    } else {
+        for (auto* marker : m_easingMarkers) { marker->update(_dt, _view); }
     }
+
+    m_easingMarkers.erase(std::remove_if(m_easingMarkers.begin(), m_easingMarkers.end(),
+                                         [](const Marker* _marker) { return !_marker->isEasing(); }),
+                          m_easingMarkers.end());
+    bool easing = !m_easingMarkers.empty();
+
+    if (outdated && !m_meshBatch) { startMeshBatch(); }
+
     LOGT("<<< update");
 
-    return {rebuilt || easing || dirty, easing};
+    // Keep updating while the batch is built to swap it in when it is done
+    return {rebuilt || easing || dirty, easing || bool(m_meshBatch)};
+}
+
+void MarkerManager::startMeshBatch() {
+    auto batch = std::make_shared<MeshBatch>();
+    batch->zoom = m_zoom;
+    batch->functions.assign(m_functions.begin() + m_workerFunctions, m_functions.end());
+    m_workerFunctions = m_functions.size();
+
+    for (const auto& marker : m_markers) {
+        if (!marker->isVisible() || !marker->mesh() || marker->builtZoomLevel() == m_zoom) {
+            continue;
+        }
+        batch->entries.emplace_back(*marker);
+    }
+
+    if (!m_worker) {
+        m_worker = std::make_unique<AsyncWorker>("MarkerManager worker");
+    }
+
+    m_meshBatch = batch;
+    m_worker->enqueue([this, batch]() {
+        if (!m_workerContext) {
+            m_workerContext = std::make_unique<BuildContext>(m_scene);
+        }
+        auto& context = *m_workerContext;
+        for (const auto& function : batch->functions) {
+            context.styleContext.addFunction(function);
+        }
+
+        for (auto& entry : batch->entries) {
+            context.marker.setBounds(entry.frame);
+            context.marker.setFeature(entry.feature);
+            context.marker.setLineParts(entry.lineParts);
+            context.marker.setTexture(entry.texture);
+            buildMesh(context.marker, entry.rule, batch->zoom, context, entry.result);
+        }
+        context.marker.setFeature(nullptr);
+        context.marker.setTexture(nullptr);
+
+        // For finding the entries of markers on the main thread without an index
+        std::sort(batch->entries.begin(), batch->entries.end(),
+                  [](const MeshBatch::Entry& _a, const MeshBatch::Entry& _b) { return _a.id < _b.id; });
+
+        batch->done = true;
+    });
+}
+
+void MarkerManager::finishMeshBatch(MeshBatch& batch) {
+    auto& entries = batch.entries;
+
+    for (auto& marker : m_markers) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), marker->id(),
+                                   [](const MeshBatch::Entry& _entry, MarkerID _id) { return _entry.id < _id; });
+        if (it == entries.end() || it->id != marker->id()) { continue; }
+
+        // Skip markers which were modified or rebuilt since the batch started
+        auto& entry = *it;
+        if (entry.revision != marker->revision()) { continue; }
+
+        if (entry.result.mesh) {
+            marker->setSelectionColor(entry.result.selectionColor);
+            marker->setMesh(entry.result.styleId, batch.zoom, std::move(entry.result.mesh));
+            // Add points which were appended since the batch started
+            if (entry.feature != marker->sharedFeature()) {
+                updateLineMesh(*marker);
+            }
+        } else {
+            LOGE("Error building marker mesh.");
+            marker->clearMesh();
+        }
+    }
 }
 
 void MarkerManager::removeAll() {
@@ -331,6 +700,9 @@ void MarkerManager::rebuildAll() {
 
     m_dirty = true;
 
+    // Markers are built on the first update after the scene became ready
+    if (!m_buildContext) { return; }
+
     for (auto& entry : m_markers) {
         buildStyling(*entry);
         buildMesh(*entry, m_zoom);
@@ -338,6 +710,8 @@ void MarkerManager::rebuildAll() {
 }
 
 void MarkerManager::clearMeshes() {
+    m_dirty = true;
+
     for (auto& entry : m_markers) {
         entry->clearMesh();
     }
@@ -353,53 +727,24 @@ bool MarkerManager::buildStyling(Marker& marker) {
 
     // If the Marker styling is a path, find the layers it specifies.
     if (markerStyling.isPath) {
-        auto path = markerStyling.string;
-        // The DELIMITER used by layers is currently ":", but Marker paths use "." (scene.h).
-        std::replace(path.begin(), path.end(), '.', DELIMITER);
-        // Start iterating over the delimited path components.
-        size_t start = 0, end = 0;
-        end = path.find(DELIMITER, start);
-        if (path.compare(start, end - start, "layers") != 0) {
-            // If the path doesn't begin with 'layers' it isn't a layer heirarchy.
-            return false;
-        }
-        // Find the DataLayer named in our path.
-        const SceneLayer* currentLayer = nullptr;
-        size_t layerStart = end + 1;
-        start = end + 1;
-        end = path.find(DELIMITER, start);
-        for (const auto& layer : m_scene.layers()) {
-            if (path.compare(layerStart, end - layerStart, layer.name()) == 0) {
-                currentLayer = &layer;
-                marker.mergeRules(layer);
-                break;
-            }
-        }
-        // Search sublayers recursively until we can't find another token or layer.
-        while (end != std::string::npos && currentLayer != nullptr) {
-            start = end + 1;
-            end = path.find(DELIMITER, start);
-            const auto& layers = currentLayer->sublayers();
-            currentLayer = nullptr;
-            for (const auto& layer : layers) {
-                if (path.compare(layerStart, end - layerStart, layer.name()) == 0) {
-                    currentLayer = &layer;
-                    marker.mergeRules(layer);
-                    break;
-                }
-            }
+        auto cached = m_pathRules.find(markerStyling.string);
+        if (cached != m_pathRules.end()) {
+            marker.setDrawRule(*cached->second);
+            return true;
         }
-        // The last token found should have been "draw".
-        if (path.compare(start, end - start, "draw") != 0) {
+        if (!mergePathRules(marker, markerStyling.string)) {
             return false;
         }
-        // The draw group name should come next.
-        start = end + 1;
-        end = path.find(DELIMITER, start);
-        // Find the rule in the merged set whose name matches the final token.
-        return marker.finalizeRuleMergingForName(path.substr(start, end - start));
+        if (m_pathRules.size() >= MAX_CACHED_STYLINGS) { m_pathRules.clear(); }
+        m_pathRules[markerStyling.string] = std::make_unique<DrawRule>(*marker.drawRule());
+        return true;
     }
 
+    auto cached = m_stylingRules.find(markerStyling.string);
+    if (cached != m_stylingRules.end()) {
+        marker.setDrawRuleData(cached->second);
+        return true;
+    }
 
     // If the styling is not a path, try to load it as a string of YAML.
     size_t prevFunctionCount = m_functions.size();
@@ -424,60 +769,199 @@ bool MarkerManager::buildStyling(Marker& marker) {
     }
     // Compile any new JS functions used for styling.
     for (auto i = prevFunctionCount; i < m_functions.size(); ++i) {
-        m_styleContext->addFunction(m_functions[i]);
+        m_buildContext->styleContext.addFunction(m_functions[i]);
     }
 
-    marker.setDrawRuleData(std::make_unique<DrawRuleData>("", 0, std::move(params)));
+    auto drawRuleData = std::make_shared<DrawRuleData>("", 0, std::move(params));
+    if (m_stylingRules.size() >= MAX_CACHED_STYLINGS) { m_stylingRules.clear(); }
+    m_stylingRules[markerStyling.string] = drawRuleData;
+    marker.setDrawRuleData(std::move(drawRuleData));
 
     return true;
 }
 
+bool MarkerManager::mergePathRules(Marker& marker, std::string path) {
+    // The DELIMITER used by layers is currently ":", but Marker paths use "." (scene.h).
+    std::replace(path.begin(), path.end(), '.', DELIMITER);
+    // Start iterating over the delimited path components.
+    size_t start = 0, end = 0;
+    end = path.find(DELIMITER, start);
+    if (path.compare(start, end - start, "layers") != 0) {
+        // If the path doesn't begin with 'layers' it isn't a layer heirarchy.
+        return false;
+    }
+    // Find the DataLayer named in our path.
+    const SceneLayer* currentLayer = nullptr;
+    size_t layerStart = end + 1;
+    start = end + 1;
+    end = path.find(DELIMITER, start);
+    for (const auto& layer : m_scene.layers()) {
+        if (path.compare(layerStart, end - layerStart, layer.name()) == 0) {
+            currentLayer = &layer;
+            marker.mergeRules(layer);
+            break;
+        }
+    }
+    // Search sublayers recursively until we can't find another token or layer.
+    while (end != std::string::npos && currentLayer != nullptr) {
+        start = end + 1;
+        end = path.find(DELIMITER, start);
+        const auto& layers = currentLayer->sublayers();
+        currentLayer = nullptr;
+        for (const auto& layer : layers) {
+            if (path.compare(layerStart, end - layerStart, layer.name()) == 0) {
+                currentLayer = &layer;
+                marker.mergeRules(layer);
+                break;
+            }
+        }
+    }
+    // The last token found should have been "draw".
+    if (path.compare(start, end - start, "draw") != 0) {
+        return false;
+    }
+    // The draw group name should come next.
+    start = end + 1;
+    end = path.find(DELIMITER, start);
+    // Find the rule in the merged set whose name matches the final token.
+    return marker.finalizeRuleMergingForName(path.substr(start, end - start));
+}
+
 bool MarkerManager::buildMesh(Marker& marker, int zoom) {
 
     marker.clearMesh();
 
+    if (!marker.feature() || !marker.drawRule()) { return false; }
+
+    // Evaluate a copy to keep the rule of the marker for building it at other zoom levels
+    DrawRule rule = *marker.drawRule();
+    BuiltMesh result;
+    if (!buildMesh(marker, rule, zoom, *m_buildContext, result)) { return false; }
+
+    marker.setSelectionColor(result.selectionColor);
+    marker.setMesh(result.styleId, zoom, std::move(result.mesh));
+
+    return true;
+}
+
+bool MarkerManager::buildMesh(const Marker& marker, DrawRule& rule, int zoom, BuildContext& context,
+                              BuiltMesh& result) const {
+
     auto feature = marker.feature();
-    auto rule = marker.drawRule();
-    if (!feature || !rule) { return false; }
+    if (!feature) { return false; }
+
+    uint32_t selectionColor = 0;
+    StyleBuilder* styler = evaluateRule(marker, rule, zoom, context, selectionColor);
+    if (!styler) { return false; }
+
+    result.selectionColor = selectionColor;
+    result.styleId = styler->style().getID();
+
+    if (feature->geometryType == GeometryType::lines) {
+        auto mesh = std::make_unique<LineMesh>();
+        if (buildLineParts(marker, rule, zoom, *styler, 0, *mesh)) {
+            mesh->tail = marker.sharedFeature();
+            result.mesh = std::move(mesh);
+            return true;
+        }
+    }
+
+    styler->setup(marker, zoom);
+
+    bool added = false;
+    for (const auto& part : marker.lineParts()) {
+        added |= styler->addFeature(*part, rule);
+    }
+    added |= styler->addFeature(*feature, rule);
+    if (!added) { return false; }
+
+    result.mesh = styler->build();
+
+    return true;
+}
+
+StyleBuilder* MarkerManager::evaluateRule(const Marker& marker, DrawRule& rule, int zoom,
+                                          BuildContext& context, uint32_t& selectionColor) const {
 
     StyleBuilder* styler = nullptr;
     {
-        auto name = rule->getStyleName();
-        auto it = m_styleBuilders.find(name);
-        if (it != m_styleBuilders.end()) {
+        auto name = rule.getStyleName();
+        auto it = context.styleBuilders.find(name);
+        if (it != context.styleBuilders.end()) {
             styler = it->second.get();
         } else {
             LOGN("Invalid style %s", name.c_str());
-            return false;
+            return nullptr;
         }
     }
 
     // Apply default draw rules defined for this style
-    styler->style().applyDefaultDrawRules(*rule);
-
-    m_styleContext->setTileID(TileID(0, 0, zoom));
-    m_styleContext->setFeature(*feature);
-    bool valid = marker.evaluateRuleForContext(*m_styleContext);
+    styler->style().applyDefaultDrawRules(rule);
 
-    if (!valid) { return false; }
+    context.styleContext.setTileID(TileID(0, 0, zoom));
+    context.styleContext.setFeature(*marker.feature());
+    bool valid = context.ruleSet.evaluateRuleForContext(rule, context.styleContext);
 
-    styler->setup(marker, zoom);
+    if (!valid) { return nullptr; }
 
-    uint32_t selectionColor = 0;
     bool interactive = false;
-    if (rule->get(StyleParamKey::interactive, interactive) && interactive) {
+    if (rule.get(StyleParamKey::interactive, interactive) && interactive) {
         if (selectionColor == 0) {
             selectionColor = m_scene.featureSelection()->nextColorIdentifier();
         }
-        rule->selectionColor = selectionColor;
+        rule.selectionColor = selectionColor;
     } else {
-        rule->selectionColor = 0;
+        selectionColor = 0;
+        rule.selectionColor = 0;
     }
 
-    if (!styler->addFeature(*feature, *rule)) { return false; }
+    return styler;
+}
+
+bool MarkerManager::buildLineParts(const Marker& marker, const DrawRule& rule, int zoom,
+                                   StyleBuilder& styler, size_t first, LineMesh& mesh) const {
+
+    const auto& parts = marker.lineParts();
+    mesh.parts.resize(parts.size() + 1);
+
+    // Simplify lines below the resolution of the zoom level, in marker units
+    float metersPerPixel = MapProjection::metersPerTileAtZoom(zoom) / (256.f * styler.style().pixelScale());
+    float tolerance = LINE_SIMPLIFY_PIXELS * metersPerPixel / marker.extent();
+
+    for (size_t i = first; i < mesh.parts.size(); i++) {
+        const Feature& part = i < parts.size() ? *parts[i] : *marker.feature();
+        auto simplified = simplifyLines(part, tolerance);
 
-    marker.setSelectionColor(selectionColor);
-    marker.setMesh(styler->style().getID(), zoom, styler->build());
+        styler.setup(marker, zoom);
+        if (!styler.addFeature(simplified ? *simplified : part, rule)) { return false; }
+
+        mesh.parts[i] = styler.build();
+        if (dynamic_cast<LabelSet*>(mesh.parts[i].get())) { return false; }
+    }
+    return true;
+}
+
+bool MarkerManager::updateLineMesh(Marker& marker) {
+
+    auto* mesh = dynamic_cast<LineMesh*>(marker.mesh());
+    if (!mesh || mesh->tail == marker.sharedFeature() || !marker.drawRule()) { return false; }
+
+    // Keep the selection color of the parts which are not rebuilt
+    DrawRule rule = *marker.drawRule();
+    uint32_t selectionColor = marker.selectionColor();
+    StyleBuilder* styler = evaluateRule(marker, rule, m_zoom, *m_buildContext, selectionColor);
+
+    // The previous last part needs to be rebuilt unless it was completed without adding points
+    size_t first = mesh->parts.size() - 1;
+    const auto& parts = marker.lineParts();
+    if (first < parts.size() && parts[first] == mesh->tail) { first++; }
+
+    if (!styler || !buildLineParts(marker, rule, m_zoom, *styler, first, *mesh)) {
+        LOGE("Error building marker mesh.");
+        marker.clearMesh();
+        return false;
+    }
+    mesh->tail = marker.sharedFeature();
 
     return true;
 }
@@ -11,6 +11,7 @@
 
 namespace Tangram {
 
+class AsyncWorker;
 class MapProjection;
 class Marker;
 class StyleBuilder;
@@ -65,14 +66,24 @@ public:
     // Set a marker to a polyline feature at the given position; returns true if the marker was found and updated.
     bool setPolyline(MarkerID markerID, LngLat* coordinates, int count);
 
+    // Append points to the polyline feature of a marker, or set a polyline if the marker has none.
+    // Usually only the last part of the line is rebuilt, so the cost depends on the number of
+    // points appended and not on the length of the line; points far outside of the bounds of the
+    // line move it into new bounds and rebuild it entirely. Returns true if the marker was found
+    // and updated.
+    bool appendPolyline(MarkerID markerID, LngLat* coordinates, int count);
+
     // Set a marker to a polygon feature at the given position; returns true if the marker was found and updated.
     bool setPolygon(MarkerID markerID, LngLat* coordinates, int* counts, int rings);
 
     // Update the zoom level for all markers; markers are built for one zoom
     // level at a time so when the current zoom changes, all marker meshes are
-    // rebuilt. Returns true when any Markers changed since last call to update.
+    // rebuilt on the marker worker and swapped in together once they are ready.
+    // All markers are visited when markers were modified or @_viewChanged is set,
+    // otherwise only markers with an ease in progress are updated.
+    // Returns true when any Markers changed since last call to update.
     struct UpdateState { bool dirty, easing; };
-    UpdateState update(const View& _view, float _dt);
+    UpdateState update(const View& _view, float _dt, bool _viewChanged);
 
     // Remove and destroy all markers.
     void removeAll();
@@ -89,25 +100,57 @@ public:
 
 private:
 
+    struct BuildContext;
+    struct BuiltMesh;
+    struct LineMesh;
+    struct MeshBatch;
+
     Marker* getMarkerOrNull(MarkerID markerID);
 
     bool setStyling(MarkerID markerID, const char* styling, bool isPath);
     bool buildStyling(Marker& marker);
+    bool mergePathRules(Marker& marker, std::string path);
     bool buildMesh(Marker& marker, int zoom);
+    bool buildMesh(const Marker& marker, DrawRule& rule, int zoom, BuildContext& context,
+                   BuiltMesh& result) const;
+    StyleBuilder* evaluateRule(const Marker& marker, DrawRule& rule, int zoom, BuildContext& context,
+                               uint32_t& selectionColor) const;
+    bool buildLineParts(const Marker& marker, const DrawRule& rule, int zoom, StyleBuilder& styler,
+                        size_t first, LineMesh& mesh) const;
+    // Rebuild the last parts of a polyline marker after points were appended
+    bool updateLineMesh(Marker& marker);
+
+    // Rebuild the meshes of markers built for another zoom level on the marker worker
+    void startMeshBatch();
+    void finishMeshBatch(MeshBatch& batch);
 
     const Scene& m_scene;
     // Custom functions and stops from styling strings
     SceneStops m_stops;
     SceneFunctions m_functions;
 
-    std::unique_ptr<StyleContext> m_styleContext;
+    // Draw rules resolved from styling strings and paths
+    fastmap<std::string, std::shared_ptr<DrawRuleData>> m_stylingRules;
+    fastmap<std::string, std::unique_ptr<DrawRule>> m_pathRules;
+
+    std::unique_ptr<BuildContext> m_buildContext;
     std::vector<std::unique_ptr<Marker>> m_markers;
-    fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilders;
+    // Visible markers with an ease in progress, collected when all markers are visited; may
+    // contain removed markers while m_dirty is set
+    std::vector<Marker*> m_easingMarkers;
 
     uint32_t m_idCounter = 0;
     int m_zoom = 0;
     bool m_dirty = false;
 
+    // Batch being built on the marker worker, with its own BuildContext
+    std::shared_ptr<MeshBatch> m_meshBatch;
+    std::unique_ptr<BuildContext> m_workerContext;
+    // Number of functions from styling strings added to the worker context
+    size_t m_workerFunctions = 0;
+    // Destroyed first to finish the running batch
+    std::unique_ptr<AsyncWorker> m_worker;
+
 };
 
 } // namespace Tangram
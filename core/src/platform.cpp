@@ -125,6 +125,11 @@ UrlRequestHandle Platform::startUrlRequest(Url _url, const HttpOptions& _options
     return handle;
 }
 
+size_t Platform::activeUrlRequests() const {
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    return m_urlCallbacks.size();
+}
+
 void Platform::cancelUrlRequest(const UrlRequestHandle _request) {
     if (_request == 0) { return; }
 
@@ -104,6 +104,9 @@ void DrawRule::logGetError(StyleParamKey _expectedKey, const StyleParam& _param)
 
 bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx) {
 
+    restoreCachedRules();
+    m_rules = &m_matchedRules;
+
     _ctx.setFeature(_feature);
     m_matchedRules.clear();
     m_queuedLayers.clear();
@@ -114,7 +117,7 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
     }
 
     // If the first filter doesn't match, return immediately
-    if (!_layer.filter().eval(_feature, _ctx)) { return false; }
+    if (!_layer.filterProgram().eval(_feature, _ctx)) { return false; }
 
     m_queuedLayers.push_back({ &_layer, 1 });
 
@@ -136,7 +139,7 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
                 continue;
             }
 
-            if (sublayer.filter().eval(_feature, _ctx)) {
+            if (sublayer.filterProgram().eval(_feature, _ctx)) {
                 m_queuedLayers.push_back({ &sublayer, depth + 1 });
                 if (sublayer.exclusive()) {
                     break;
@@ -148,6 +151,86 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
     return true;
 }
 
+struct value_hash {
+    using result_type = size_t;
+    size_t operator()(const none_type&) const { return 0; }
+    size_t operator()(const double& v) const { return std::hash<double>{}(v); }
+    size_t operator()(const std::string& v) const { return std::hash<std::string>{}(v); }
+};
+
+bool DrawRuleMergeSet::matchCached(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx) {
+
+    // Bounds the memory held by cached rules on tiles with many distinct features
+    static constexpr size_t maxCacheEntries = 1024;
+
+    if (!_layer.matchCacheable() || !_layer.enabled()) {
+        return match(_feature, _layer, _ctx);
+    }
+
+    restoreCachedRules();
+
+    size_t hash = 0;
+    hash_combine(hash, &_layer);
+    hash_combine(hash, int(_feature.geometryType));
+
+    m_matchValues.clear();
+    for (const auto& key : _layer.matchKeys()) {
+        const Value& value = _feature.props.get(key);
+        m_matchValues.push_back(&value);
+        hash_combine(hash, Value::visit(value, value_hash{}));
+    }
+
+    auto it = m_matchCache.find(hash);
+    if (it != m_matchCache.end()) {
+        const auto& entry = it->second;
+        bool hit = entry.layer == &_layer && entry.geometryType == _feature.geometryType;
+        for (size_t i = 0; hit && i < m_matchValues.size(); i++) {
+            hit = entry.values[i] == *m_matchValues[i];
+        }
+        if (hit) {
+            // Style functions of the matched rules are evaluated for the current feature
+            _ctx.setFeature(_feature);
+            m_rules = &it->second.rules;
+            return entry.matched;
+        }
+    }
+
+    bool matched = match(_feature, _layer, _ctx);
+
+    if (m_matchCache.size() >= maxCacheEntries) {
+        m_matchCache.clear();
+    }
+
+    auto& entry = m_matchCache[hash];
+    entry.layer = &_layer;
+    entry.geometryType = _feature.geometryType;
+    entry.values.clear();
+    for (const auto* value : m_matchValues) {
+        entry.values.push_back(*value);
+    }
+    entry.matched = matched;
+    entry.rules = m_matchedRules;
+
+    return matched;
+}
+
+void DrawRuleMergeSet::clearMatchCache() {
+    restoreCachedRules();
+    m_rules = &m_matchedRules;
+    m_matchCache.clear();
+}
+
+void DrawRuleMergeSet::restoreCachedRules() {
+    for (auto it = m_savedParams.rbegin(); it != m_savedParams.rend(); ++it) {
+        it->rule->params[it->key].param = it->param;
+    }
+    for (auto it = m_savedActive.rbegin(); it != m_savedActive.rend(); ++it) {
+        it->rule->active = it->active;
+    }
+    m_savedParams.clear();
+    m_savedActive.clear();
+}
+
 bool DrawRuleMergeSet::evaluateRuleForContext(DrawRule& rule, StyleContext& context) {
 
     bool visible;
@@ -155,6 +238,11 @@ bool DrawRuleMergeSet::evaluateRuleForContext(DrawRule& rule, StyleContext& cont
         return false;
     }
 
+    // Cached rules are shared by the features with the same match
+    bool cached = m_rules != &m_matchedRules && &rule >= m_rules->data() &&
+        &rule < m_rules->data() + m_rules->size();
+    if (cached) { m_savedActive.push_back({ &rule, rule.active }); }
+
     bool valid = true;
     for (size_t i = 0; i < StyleParamKeySize; ++i) {
 
@@ -165,6 +253,10 @@ bool DrawRuleMergeSet::evaluateRuleForContext(DrawRule& rule, StyleContext& cont
 
         auto*& param = rule.params[i].param;
 
+        if (cached && (param->function >= 0 || param->stops)) {
+            m_savedParams.push_back({ &rule, i, param });
+        }
+
         // Evaluate JS functions and Stops
         if (param->function >= 0) {
 
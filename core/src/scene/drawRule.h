@@ -3,6 +3,7 @@
 #include "scene/styleParam.h"
 
 #include <bitset>
+#include <unordered_map>
 #include <vector>
 #include <set>
 
@@ -116,15 +117,29 @@ private:
 class DrawRuleMergeSet {
 
 public:
+    DrawRuleMergeSet() = default;
+    DrawRuleMergeSet(const DrawRuleMergeSet&) = delete;
+    DrawRuleMergeSet& operator=(const DrawRuleMergeSet&) = delete;
+
+    // Evaluates functions and stops of @rule for the current feature of @context. Rules
+    // reused from the match cache are evaluated in place and restored by the next match.
     bool evaluateRuleForContext(DrawRule& rule, StyleContext& context);
 
     // internal
     bool match(const Feature& feature, const SceneLayer& layer, StyleContext& context);
 
+    // Like match(), but reuses the merged rules of a previous feature that has the same geometry
+    // type and the same values for all properties read by the filters of @layer. Layers with
+    // filter functions are always matched. The cache must be cleared whenever the tile changes.
+    bool matchCached(const Feature& feature, const SceneLayer& layer, StyleContext& context);
+
+    void clearMatchCache();
+
     // internal
     void mergeRules(const SceneLayer& layer, int depth = 0);
 
-    auto& matchedRules() { return m_matchedRules; }
+    // Rules of the last match, either merged for the feature or reused from the match cache
+    auto& matchedRules() { return *m_rules; }
 
 private:
     struct LayerMatch {
@@ -139,6 +154,39 @@ private:
     // Container for dynamically-evaluated parameters
     StyleParam m_evaluated[StyleParamKeySize];
 
+    struct MatchCacheEntry {
+        const SceneLayer* layer;
+        int geometryType;
+        std::vector<Value> values;
+        bool matched;
+        std::vector<DrawRule> rules;
+    };
+
+    // Match results by hash of layer, geometry type and property values
+    std::unordered_map<size_t, MatchCacheEntry> m_matchCache;
+    // Reusable list of the feature values for the current lookup
+    std::vector<const Value*> m_matchValues;
+
+    // Either m_matchedRules or the rules of a match cache entry
+    std::vector<DrawRule>* m_rules = &m_matchedRules;
+
+    // Undo changes of evaluateRuleForContext() to the rules of a match cache entry
+    void restoreCachedRules();
+
+    // Active parameters of cached rules and the parameters replaced by evaluated ones, in the
+    // order of evaluation
+    struct SavedActive {
+        DrawRule* rule;
+        std::bitset<StyleParamKeySize> active;
+    };
+    struct SavedParam {
+        DrawRule* rule;
+        size_t key;
+        const StyleParam* param;
+    };
+    std::vector<SavedActive> m_savedActive;
+    std::vector<SavedParam> m_savedParams;
+
 };
 
 }
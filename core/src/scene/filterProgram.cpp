@@ -0,0 +1,292 @@
+#include "scene/filterProgram.h"
+
+#include "data/tileData.h"
+#include "log.h"
+#include "scene/filters.h"
+#include "scene/styleContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Tangram {
+
+constexpr uint8_t FilterProgram::maxSlots;
+constexpr uint8_t FilterProgram::noSlot;
+
+static bool numberEqual(double a, double b) {
+    if (a == b) { return true; }
+    return std::fabs(a - b) <= std::numeric_limits<double>::epsilon();
+}
+
+static bool containsNumber(const double* begin, const double* end, double num) {
+    // Values are sorted: only candidates within epsilon of num need to be compared
+    const double eps = std::numeric_limits<double>::epsilon();
+    for (auto it = std::lower_bound(begin, end, num - eps); it != end && *it <= num + eps; ++it) {
+        if (numberEqual(num, *it)) { return true; }
+    }
+    return false;
+}
+
+FilterProgram::FilterProgram() {}
+
+FilterProgram::FilterProgram(const Filter& _filter) {
+    if (!_filter.isValid()) { return; }
+
+    compile(_filter);
+    threadJumps();
+}
+
+void FilterProgram::emit(Opcode _op, uint32_t _arg) {
+    m_code.push_back({ _op, FilterKeyword::undefined, noSlot, 0, _arg, 0 });
+}
+
+void FilterProgram::emitTest(Opcode _op, const PropertyKey& _key, FilterKeyword _keyword,
+                             uint32_t _arg, uint32_t _count) {
+
+    Instruction ins{ _op, _keyword, noSlot, 0, _arg, _count };
+
+    if (_keyword == FilterKeyword::undefined) {
+        auto it = std::find(m_keys.begin(), m_keys.end(), _key);
+        ins.key = it - m_keys.begin();
+        if (it == m_keys.end()) { m_keys.push_back(_key); }
+        if (ins.key < maxSlots) { ins.slot = ins.key; }
+    }
+    m_code.push_back(ins);
+}
+
+void FilterProgram::compileOperator(const std::vector<Filter>& _operands, Opcode _jump, bool _empty) {
+    if (_operands.empty()) {
+        emit(Opcode::boolean, _empty);
+        return;
+    }
+
+    // Operands are already sorted by Filter::filterCost; the result of the first operand that
+    // decides the operator is the result of the whole operator.
+    std::vector<size_t> jumps;
+    for (size_t i = 0; i < _operands.size(); i++) {
+        compile(_operands[i]);
+        if (i + 1 < _operands.size()) {
+            jumps.push_back(m_code.size());
+            emit(_jump, 0);
+        }
+    }
+    for (size_t jump : jumps) {
+        m_code[jump].arg = m_code.size();
+    }
+}
+
+void FilterProgram::compile(const Filter& _filter) {
+    using Data = Filter::Data;
+    const auto& data = _filter.data;
+
+    switch (data.which()) {
+
+    case Data::type<Filter::OperatorAll>::value:
+        compileOperator(data.get<Filter::OperatorAll>().operands, Opcode::jump_if_false, true);
+        break;
+
+    case Data::type<Filter::OperatorAny>::value:
+        compileOperator(data.get<Filter::OperatorAny>().operands, Opcode::jump_if_true, false);
+        break;
+
+    case Data::type<Filter::OperatorNone>::value:
+        compileOperator(data.get<Filter::OperatorNone>().operands, Opcode::jump_if_true, false);
+        emit(Opcode::negate, 0);
+        break;
+
+    case Data::type<Filter::Existence>::value: {
+        auto& f = data.get<Filter::Existence>();
+        emitTest(Opcode::existence, f.key, FilterKeyword::undefined, f.exists);
+        break;
+    }
+    case Data::type<Filter::Equality>::value: {
+        auto& f = data.get<Filter::Equality>();
+        if (f.value.is<double>()) {
+            emitTest(Opcode::equal_number, f.key, f.keyword, m_numbers.size());
+            m_numbers.push_back(f.value.get<double>());
+        } else if (f.value.is<std::string>()) {
+            emitTest(Opcode::equal_string, f.key, f.keyword, m_strings.size());
+            m_strings.push_back(f.value.get<std::string>());
+        } else {
+            emit(Opcode::boolean, false);
+        }
+        break;
+    }
+    case Data::type<Filter::EqualitySet>::value: {
+        auto& f = data.get<Filter::EqualitySet>();
+
+        size_t numbers = m_numbers.size();
+        size_t strings = m_strings.size();
+        for (auto& value : f.values) {
+            if (value.is<double>()) {
+                m_numbers.push_back(value.get<double>());
+            } else if (value.is<std::string>()) {
+                m_strings.push_back(value.get<std::string>());
+            }
+        }
+        std::sort(m_numbers.begin() + numbers, m_numbers.end());
+        std::sort(m_strings.begin() + strings, m_strings.end());
+
+        size_t numberCount = m_numbers.size() - numbers;
+        size_t stringCount = m_strings.size() - strings;
+
+        if (numberCount > 0) {
+            emitTest(Opcode::in_numbers, f.key, f.keyword, numbers, numberCount);
+        }
+        if (numberCount > 0 && stringCount > 0) {
+            // Mixed sets are tested as 'any' of the two typed sets
+            emit(Opcode::jump_if_true, m_code.size() + 2);
+        }
+        if (stringCount > 0) {
+            emitTest(Opcode::in_strings, f.key, f.keyword, strings, stringCount);
+        }
+        if (numberCount == 0 && stringCount == 0) {
+            emit(Opcode::boolean, false);
+        }
+        break;
+    }
+    case Data::type<Filter::Range>::value: {
+        auto& f = data.get<Filter::Range>();
+        emitTest(Opcode::range, f.key, f.keyword, m_ranges.size());
+        m_ranges.push_back({ f.min, f.max, f.hasPixelArea });
+        break;
+    }
+    case Data::type<Filter::Function>::value:
+        emit(Opcode::function, data.get<Filter::Function>().id);
+        m_hasFunction = true;
+        break;
+
+    case Data::type<Filter::Boolean>::value:
+        emit(Opcode::boolean, data.get<Filter::Boolean>().value);
+        break;
+
+    default:
+        emit(Opcode::boolean, true);
+        break;
+    }
+}
+
+void FilterProgram::threadJumps() {
+    // A jump landing on a jump of the same kind would be taken again; one of the opposite kind
+    // would fall through. Skip directly to the final destination in both cases.
+    for (auto& ins : m_code) {
+        if (ins.op != Opcode::jump_if_true && ins.op != Opcode::jump_if_false) { continue; }
+
+        while (ins.arg < m_code.size()) {
+            const auto& target = m_code[ins.arg];
+            if (target.op == ins.op) {
+                ins.arg = target.arg;
+            } else if (target.op == Opcode::jump_if_true || target.op == Opcode::jump_if_false) {
+                ins.arg = ins.arg + 1;
+            } else {
+                break;
+            }
+        }
+    }
+}
+
+bool FilterProgram::eval(const Feature& _feature, StyleContext& _ctx) const {
+
+    const Value* slots[maxSlots];
+    uint32_t loaded = 0;
+
+    auto value = [&](const Instruction& ins) -> const Value& {
+        if (ins.keyword != FilterKeyword::undefined) {
+            return _ctx.getKeyword(ins.keyword);
+        }
+        if (ins.slot == noSlot) {
+            return _feature.props.get(m_keys[ins.key]);
+        }
+        uint32_t bit = 1u << ins.slot;
+        if (!(loaded & bit)) {
+            slots[ins.slot] = &_feature.props.get(m_keys[ins.key]);
+            loaded |= bit;
+        }
+        return *slots[ins.slot];
+    };
+
+    bool result = true;
+    const size_t end = m_code.size();
+
+    for (size_t pc = 0; pc < end;) {
+        const auto& ins = m_code[pc++];
+
+        switch (ins.op) {
+        case Opcode::boolean:
+            result = ins.arg != 0;
+            break;
+        case Opcode::function:
+            result = _ctx.evalFilter(ins.arg);
+            break;
+        case Opcode::existence:
+            result = !value(ins).is<none_type>() == (ins.arg != 0);
+            break;
+        case Opcode::equal_number: {
+            auto& v = value(ins);
+            result = v.is<double>() && numberEqual(v.get<double>(), m_numbers[ins.arg]);
+            break;
+        }
+        case Opcode::equal_string: {
+            auto& v = value(ins);
+            result = v.is<std::string>() && v.get<std::string>() == m_strings[ins.arg];
+            break;
+        }
+        case Opcode::in_numbers: {
+            auto& v = value(ins);
+            const double* begin = m_numbers.data() + ins.arg;
+            result = v.is<double>() && containsNumber(begin, begin + ins.count, v.get<double>());
+            break;
+        }
+        case Opcode::in_strings: {
+            auto& v = value(ins);
+            auto begin = m_strings.begin() + ins.arg;
+            result = v.is<std::string>() &&
+                std::binary_search(begin, begin + ins.count, v.get<std::string>());
+            break;
+        }
+        case Opcode::range: {
+            auto& v = value(ins);
+            if (!v.is<double>()) {
+                result = false;
+                break;
+            }
+            auto& r = m_ranges[ins.arg];
+            result = Filter::inRange(v.get<double>(), r.min, r.max,
+                                     Filter::rangeScale(r.hasPixelArea, _ctx));
+            break;
+        }
+        case Opcode::negate:
+            result = !result;
+            break;
+        case Opcode::jump_if_true:
+            if (result) { pc = ins.arg; }
+            break;
+        case Opcode::jump_if_false:
+            if (!result) { pc = ins.arg; }
+            break;
+        }
+    }
+    return result;
+}
+
+void FilterProgram::print() const {
+    static const char* names[] = {
+        "boolean", "function", "existence", "equal_number", "equal_string",
+        "in_numbers", "in_strings", "range", "negate", "jump_if_true", "jump_if_false"
+    };
+
+    for (size_t pc = 0; pc < m_code.size(); pc++) {
+        const auto& ins = m_code[pc];
+        std::string source;
+        if (ins.op >= Opcode::existence && ins.op <= Opcode::range) {
+            source = ins.keyword == FilterKeyword::undefined
+                ? m_keys[ins.key].str()
+                : filterKeywordToString(ins.keyword);
+        }
+        logMsg("%4d %-14s %-16s %d %d\n", int(pc), names[static_cast<uint8_t>(ins.op)],
+               source.c_str(), ins.arg, ins.count);
+    }
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "data/propertyKey.h"
+#include "util/variant.h"
+
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+class StyleContext;
+struct Feature;
+struct Filter;
+enum class FilterKeyword : uint8_t;
+
+/* Flat bytecode representation of a Filter tree
+ *
+ * The tree is compiled into a linear instruction stream: each test sets a single result flag and
+ * the 'all', 'any' and 'none' operators become conditional jumps over the remaining operands, so
+ * evaluation short-circuits in the same order the operands were sorted by Filter::filterCost.
+ * Each distinct property key is looked up at most once per evaluation, and equality sets are
+ * stored as sorted constant arrays.
+ */
+class FilterProgram {
+
+public:
+
+    FilterProgram();
+
+    explicit FilterProgram(const Filter& _filter);
+
+    bool eval(const Feature& _feature, StyleContext& _ctx) const;
+
+    size_t size() const { return m_code.size(); }
+
+    // Property keys read by the program
+    const std::vector<PropertyKey>& keys() const { return m_keys; }
+
+    // Whether the program calls a scene filter function
+    bool hasFunction() const { return m_hasFunction; }
+
+    void print() const;
+
+private:
+
+    enum class Opcode : uint8_t {
+        boolean,         // result = arg
+        function,        // result = evalFilter(arg)
+        existence,       // result = (value exists) == arg
+        equal_number,    // result = value == m_numbers[arg]
+        equal_string,    // result = value == m_strings[arg]
+        in_numbers,      // result = value in m_numbers[arg, arg + count)
+        in_strings,      // result = value in m_strings[arg, arg + count)
+        range,           // result = value in m_ranges[arg]
+        negate,          // result = !result
+        jump_if_true,    // if (result) pc = arg
+        jump_if_false,   // if (!result) pc = arg
+    };
+
+    struct Instruction {
+        Opcode op;
+        // Source of the tested value: a keyword from the StyleContext, or else a feature property
+        FilterKeyword keyword;
+        // Property cache slot, or noSlot when the key is not cached
+        uint8_t slot;
+        uint32_t key;
+        uint32_t arg;
+        uint32_t count;
+    };
+
+    struct Range {
+        float min;
+        float max;
+        bool hasPixelArea;
+    };
+
+    // Number of distinct property keys for which lookups are cached during evaluation
+    static constexpr uint8_t maxSlots = 32;
+    static constexpr uint8_t noSlot = 0xff;
+
+    void compile(const Filter& _filter);
+    void compileOperator(const std::vector<Filter>& _operands, Opcode _jump, bool _empty);
+    void emitTest(Opcode _op, const PropertyKey& _key, FilterKeyword _keyword,
+                  uint32_t _arg, uint32_t _count = 0);
+    void emit(Opcode _op, uint32_t _arg);
+    void threadJumps();
+
+    std::vector<Instruction> m_code;
+    std::vector<PropertyKey> m_keys;
+    std::vector<double> m_numbers;
+    std::vector<std::string> m_strings;
+    std::vector<Range> m_ranges;
+    bool m_hasFunction = false;
+};
+
+}
@@ -344,7 +344,7 @@ struct match_range {
     double scale;
 
     bool operator() (const double& num) const {
-        return num >= f.min * scale && num < f.max * scale;
+        return Filter::inRange(num, f.min, f.max, scale);
     }
     bool operator() (const std::string&) const { return false; }
     bool operator() (const none_type&) const { return false; }
@@ -399,7 +399,7 @@ struct matcher {
         return Value::visit(value, match_equal{f.value});
     }
     bool operator() (const Filter::Range& f) const {
-        auto scale = (f.hasPixelArea) ? ctx.getPixelAreaScale() : 1.f;
+        double scale = Filter::rangeScale(f.hasPixelArea, ctx);
         auto& value = (f.keyword == FilterKeyword::undefined)
             ? props.get(f.key)
             : ctx.getKeyword(f.keyword);
@@ -416,6 +416,10 @@ struct matcher {
     }
 };
 
+double Filter::rangeScale(bool _hasPixelArea, StyleContext& _ctx) {
+    return _hasPixelArea ? _ctx.getPixelAreaScale() : 1.0;
+}
+
 bool Filter::eval(const Feature& feat, StyleContext& ctx) const {
     return Data::visit(data, matcher(feat, ctx));
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/propertyKey.h"
 #include "util/variant.h"
 
 #include <memory>
@@ -35,24 +36,24 @@ struct Filter {
     };
 
     struct EqualitySet {
-        std::string key;
+        PropertyKey key;
         std::vector<Value> values;
         FilterKeyword keyword;
     };
     struct Equality {
-        std::string key;
+        PropertyKey key;
         Value value;
         FilterKeyword keyword;
     };
     struct Range {
-        std::string key;
+        PropertyKey key;
         float min;
         float max;
         FilterKeyword keyword;
         bool hasPixelArea;
     };
     struct Existence {
-        std::string key;
+        PropertyKey key;
         bool exists;
     };
     struct Function {
@@ -116,6 +117,15 @@ struct Filter {
         return { Boolean{ val }};
     }
 
+    // Whether _num is within [_min, _max) scaled by _scale; shared with FilterProgram so that
+    // values at the boundaries match alike
+    static bool inRange(double _num, float _min, float _max, double _scale) {
+        return _num >= _min * _scale && _num < _max * _scale;
+    }
+
+    // Scale of range bounds of a filter, see Range::hasPixelArea
+    static double rangeScale(bool _hasPixelArea, StyleContext& _ctx);
+
     /* Public for testing */
     static void sort(std::vector<Filter>& filters);
     void print(int _indent = 0) const;
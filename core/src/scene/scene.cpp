@@ -2,6 +2,7 @@
 
 #include "data/tileSource.h"
 #include "data/rasterSource.h"
+#include "debug/layerProfile.h"
 #include "gl/framebuffer.h"
 #include "gl/shaderProgram.h"
 #include "labels/labelManager.h"
@@ -22,6 +23,7 @@
 #include "style/rasterStyle.h"
 #include "style/style.h"
 #include "text/fontContext.h"
+#include "tile/tileGeometryCache.h"
 #include "util/base64.h"
 #include "util/util.h"
 #include "util/elevationManager.h"
@@ -49,6 +51,7 @@ Scene::Scene(Platform& _platform,
     m_sourceContext(_platform, this) {
 
     m_prana = std::make_shared<ScenePrana>(this);
+    m_layerProfile = std::make_unique<LayerProfile>();
     m_tileWorker = std::make_unique<TileWorker>(_platform, m_options.numTileWorkers);
     m_tileManager = std::make_unique<TileManager>(_platform, *m_tileWorker, m_prana);
     m_markerManager = std::make_unique<MarkerManager>(*this,
@@ -231,6 +234,16 @@ bool Scene::load() {
     m_layers = SceneLoader::applyLayers(m_config["layers"], m_jsFunctions, m_stops, m_names);
     LOGTO("<<< applyLayers");
 
+    /// Let sources skip decoding of collections that no enabled layer uses
+    for (auto& source : m_tileSources) {
+        std::vector<std::string> collections;
+        for (auto& layer : m_layers) {
+            if (!layer.enabled() || layer.source() != source->name()) { continue; }
+            collections.insert(collections.end(), layer.collections().begin(), layer.collections().end());
+        }
+        source->setCollections(std::move(collections));
+    }
+
     /// Remove unused styles
     std::set<std::string> activeStyles;
     for (auto& layer : m_layers) {
@@ -305,6 +318,14 @@ bool Scene::load() {
     }
 #endif
 
+    /// Built geometry is only reused for the same scene configuration
+    if (m_options.diskGeometryCacheSize > 0) {
+        auto content = YAML::Dump(m_config) + (m_options.debugStyles ? "debug" : "");
+        m_geometryCache = std::make_unique<TileGeometryCache>(m_options.diskCacheDir, content,
+                                                              m_options.diskGeometryCacheSize,
+                                                              m_options.diskTileCacheMaxAge);
+    }
+
     /// Now we are only waiting for pending fonts and textures:
     /// Let's initialize the TileBuilders on TileWorker threads
     /// in the meantime.
@@ -643,7 +664,7 @@ Scene::UpdateState Scene::update(RenderState& _rs, View& _view, float _dt) {
 
     bool viewChanged = _view.update();
 
-    auto markersState = m_markerManager->update(_view, _dt);
+    auto markersState = m_markerManager->update(_view, _dt, viewChanged);
 
     bool tilesChanged = m_tileManager->updateTileSets(_view);
 
@@ -34,6 +34,7 @@ class FeatureSelection;
 class FontContext;
 class FrameBuffer;
 class Importer;
+class LayerProfile;
 class LabelManager;
 class Light;
 class MapProjection;
@@ -43,6 +44,7 @@ class SceneLayer;
 class SelectionQuery;
 class Style;
 class Texture;
+class TileGeometryCache;
 class TileSource;
 class ElevationManager;
 class SkyManager;
@@ -150,6 +152,8 @@ public:
 
     auto& tileSources() const { return m_tileSources; }
     auto& featureSelection() const { return m_featureSelection; }
+    auto& layerProfile() const { return m_layerProfile; }
+    auto& geometryCache() const { return m_geometryCache; }
     auto& fontContext() const { return m_fontContext; }
     // so we can call SceneTextures::add() ... should we use a Scene::addTexture() instead?
     auto& sceneTextures() { return m_textures; }
@@ -195,6 +199,7 @@ public:
     LabelManager* labelManager() const { return m_labelManager.get(); }
     MarkerManager* markerManager() const { return m_markerManager.get(); }
     ElevationManager* elevationManager() const { return m_elevationManager.get(); }
+    TileWorker* tileWorker() const { return m_tileWorker.get(); }
 
     const SceneError* errors() const {
         return (m_errors.empty() ? nullptr : &m_errors.front());
@@ -318,6 +323,8 @@ protected:
 
     std::unique_ptr<FontContext> m_fontContext;
     std::unique_ptr<FeatureSelection> m_featureSelection;
+    std::unique_ptr<LayerProfile> m_layerProfile;
+    std::unique_ptr<TileGeometryCache> m_geometryCache;
     std::unique_ptr<TileWorker> m_tileWorker;
     std::unique_ptr<TileManager> m_tileManager;
     std::unique_ptr<MarkerManager> m_markerManager;
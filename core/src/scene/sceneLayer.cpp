@@ -1,5 +1,6 @@
 #include "scene/sceneLayer.h"
 
+#include <algorithm>
 #include <type_traits>
 
 namespace Tangram {
@@ -11,6 +12,7 @@ SceneLayer::SceneLayer(std::string name, Filter filter,
                        std::vector<SceneLayer> sublayers,
                        Options options) :
     m_filter(std::move(filter)),
+    m_filterProgram(m_filter),
     m_name(std::move(name)),
     m_rules(std::move(rules)),
     m_sublayers(std::move(sublayers)),
@@ -33,6 +35,15 @@ SceneLayer::SceneLayer(std::string name, Filter filter,
                   // first.
                   return a.name() > b.name();
               });
+
+    m_matchKeys = m_filterProgram.keys();
+    m_matchFunction = m_filterProgram.hasFunction();
+    for (const auto& sublayer : m_sublayers) {
+        m_matchKeys.insert(m_matchKeys.end(), sublayer.m_matchKeys.begin(), sublayer.m_matchKeys.end());
+        m_matchFunction |= sublayer.m_matchFunction;
+    }
+    std::sort(m_matchKeys.begin(), m_matchKeys.end());
+    m_matchKeys.erase(std::unique(m_matchKeys.begin(), m_matchKeys.end()), m_matchKeys.end());
 }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "scene/drawRule.h"
+#include "scene/filterProgram.h"
 #include "scene/filters.h"
 
 #include <string>
@@ -26,19 +27,31 @@ public:
 
     const auto& name() const { return m_name; }
     const auto& filter() const { return m_filter; }
+    const auto& filterProgram() const { return m_filterProgram; }
     const auto& rules() const { return m_rules; }
     const auto& sublayers() const { return m_sublayers; }
     auto priority() const { return m_options.priority; }
     auto enabled() const { return m_options.enabled; }
     auto exclusive() const { return m_options.exclusive; }
 
+    // Property keys read by the filters of this layer and its sublayers
+    const auto& matchKeys() const { return m_matchKeys; }
+    // Whether matching this layer depends only on matchKeys(), the geometry type and the tile,
+    // i.e. no filter of the layer or its sublayers is a function
+    bool matchCacheable() const { return !m_matchFunction; }
+
 private:
 
     Filter m_filter;
+    // m_filter compiled for matching
+    FilterProgram m_filterProgram;
     std::string m_name;
     std::vector<DrawRuleData> m_rules;
     std::vector<SceneLayer> m_sublayers;
     Options m_options;
+
+    std::vector<PropertyKey> m_matchKeys;
+    bool m_matchFunction = false;
 };
 
 }
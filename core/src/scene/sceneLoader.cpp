@@ -4,6 +4,7 @@
 #include "data/memoryCacheDataSource.h"
 #include "data/mbtilesDataSource.h"
 #include "data/networkDataSource.h"
+#include "data/pmtilesDataSource.h"
 #include "data/rasterSource.h"
 #include "data/tileSource.h"
 #include "gl/shaderSource.h"
@@ -769,7 +770,12 @@ std::shared_ptr<TileSource> SceneLoader::loadSource(const Node& _source, const s
 
     bool isTiled = url.empty() || NetworkDataSource::urlHasTilePattern(url);
     bool isMBTilesFile = Url::getPathExtension(url) == "mbtiles";
-    if (isMBTilesFile) {
+    bool isPMTilesFile = Url::getPathExtension(url) == "pmtiles";
+    if (isPMTilesFile) {
+        // PMTiles archives are tiled; tiles are read from the mapped archive file
+        isTiled = true;
+        rawSources = std::make_unique<PMTilesDataSource>(_name, url);
+    } else if (isMBTilesFile) {
 #ifdef TANGRAM_MBTILES_DATASOURCE
         // If we have MBTiles, we know the source is tiled.
         isTiled = true;
@@ -792,7 +798,8 @@ std::shared_ptr<TileSource> SceneLoader::loadSource(const Node& _source, const s
                 const char* mimetype = type == "MVT" ? "pbf" : type == "Raster" ? "png" : "";
                 cachefile = _options.diskCacheDir + cachename + ".mbtiles";
                 auto s = std::make_unique<MBTilesDataSource>(_context.getPlatform(),
-                        _name, cachefile, mimetype, maxAge > 0 ? maxAge : _options.diskTileCacheMaxAge);
+                        _name, cachefile, mimetype, maxAge > 0 ? maxAge : _options.diskTileCacheMaxAge,
+                        false, _options.diskTileCacheLimit);
                 s->next = std::move(rawSources);
                 rawSources = std::move(s);
                 LOGD("using %s as cache for source %s", cachefile.c_str(), _name.c_str());
@@ -807,6 +814,7 @@ std::shared_ptr<TileSource> SceneLoader::loadSource(const Node& _source, const s
         if (cacheSize > 0) {
             auto s = std::make_unique<MemoryCacheDataSource>();
             s->setCacheSize(cacheSize);
+            s->setCompressionLevel(_options.memoryTileCacheCompression);
             s->next = std::move(rawSources);
             rawSources = std::move(s);
         }
@@ -843,6 +851,10 @@ std::shared_ptr<TileSource> SceneLoader::loadSource(const Node& _source, const s
             return nullptr;
         }
         sourcePtr->setFormat(vectorFmt);
+
+        if (vectorFmt == TileSource::Format::Mvt) {
+            sourcePtr->setQuantizedGeometry(YamlUtil::getBoolOrDefault(_source["quantize_geometry"], false));
+        }
     }
 
     sourcePtr->setOfflineInfo({cachefile, url, urlOptions, vectorFmt});
@@ -436,7 +436,7 @@ std::string StyleParam::toString() const {
             return k + value.get<std::string>();
         } else if (value.is<TextSource>()) {
             // TODO add more..
-            return k + value.get<TextSource>().keys[0];
+            return k + value.get<TextSource>().keys[0].str();
         }
         break;
     case StyleParamKey::transition_hide_time:
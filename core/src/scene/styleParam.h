@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/propertyKey.h"
 #include "labels/labelProperty.h"
 #include "util/variant.h"
 
@@ -188,9 +189,10 @@ struct StyleParam {
     };
 
     struct TextSource {
-        std::vector<std::string> keys;
+        // Property keys, interned when the scene is loaded
+        std::vector<PropertyKey> keys;
         TextSource() {}
-        TextSource(std::vector<std::string>&& _keys) : keys(std::move(_keys)) {}
+        TextSource(std::vector<PropertyKey>&& _keys) : keys(std::move(_keys)) {}
         bool operator==(const TextSource& _other) const {
             return keys == _other.keys;
         }
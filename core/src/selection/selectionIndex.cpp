@@ -0,0 +1,324 @@
+#include "selection/selectionIndex.h"
+
+#include "util/geom.h"
+
+#include "glm/glm.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Tangram {
+
+// Cells of the grid along each axis of the unit square
+static constexpr int GRID_SIZE = 16;
+// Segments of a line in one item, so that long lines are only tested near the queried position
+static constexpr uint32_t MAX_ITEM_SEGMENTS = 16;
+
+static int cellIndex(float _coordinate) {
+    // Geometry outside of the unit square is kept in the edge cells
+    return glm::clamp(int(std::floor(_coordinate * GRID_SIZE)), 0, GRID_SIZE - 1);
+}
+
+static void append(std::vector<char>& _out, const void* _data, size_t _size) {
+    auto* bytes = static_cast<const char*>(_data);
+    _out.insert(_out.end(), bytes, bytes + _size);
+}
+
+void SelectionIndex::add(uint32_t _selectionColor, const Feature& _feature) {
+
+    if (_feature.geometryType == GeometryType::points) {
+        for (const auto& point : _feature.points) {
+            uint32_t begin = m_points.size();
+            m_points.push_back(point);
+            addItem(_selectionColor, GeometryType::points, { begin, begin + 1 });
+        }
+    } else if (_feature.isQuantized()) {
+        // Tile units are converted as they are added
+        addGeometry(_selectionColor, _feature.geometryType, _feature.quantizedLines(),
+                    _feature.quantizedPolygons(),
+                    [&](QuantizedPoint _point) { return _feature.dequantize(_point); });
+    } else {
+        addGeometry(_selectionColor, _feature.geometryType, _feature.lines(), _feature.polygons(),
+                    [](const Point& _point) { return _point; });
+    }
+}
+
+template<class LineList, class PolygonList, class Convert>
+void SelectionIndex::addGeometry(uint32_t _selectionColor, GeometryType _type,
+                                 const LineList& _lines, const PolygonList& _polygons,
+                                 Convert _convert) {
+
+    switch (_type) {
+    case GeometryType::lines:
+        for (const auto& line : _lines) {
+            if (line.empty()) { continue; }
+            uint32_t begin = m_points.size();
+            for (const auto& point : line) { m_points.push_back(_convert(point)); }
+            uint32_t end = m_points.size();
+            // Consecutive items share their end points
+            for (uint32_t start = begin; start == begin || start + 1 < end; start += MAX_ITEM_SEGMENTS) {
+                addItem(_selectionColor, GeometryType::lines,
+                        { start, std::min(start + MAX_ITEM_SEGMENTS + 1, end) });
+            }
+        }
+        break;
+    case GeometryType::polygons:
+        for (const auto& polygon : _polygons) {
+            uint32_t rings = m_rings.size();
+            for (const auto& ring : polygon) {
+                uint32_t begin = m_points.size();
+                for (const auto& point : ring) { m_points.push_back(_convert(point)); }
+                m_rings.push_back({ begin, uint32_t(m_points.size()) });
+            }
+            if (m_rings.size() == rings || m_rings[rings].size() == 0) {
+                m_rings.resize(rings);
+                continue;
+            }
+            addItem(_selectionColor, GeometryType::polygons, { rings, uint32_t(m_rings.size()) });
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void SelectionIndex::addItem(uint32_t _selectionColor, GeometryType _type, GeometryRange _range) {
+
+    // The bounds of a polygon are those of its outer ring
+    GeometryRange points = (_type == GeometryType::polygons) ? m_rings[_range.begin] : _range;
+
+    glm::vec2 min = m_points[points.begin];
+    glm::vec2 max = min;
+    for (uint32_t i = points.begin + 1; i < points.end; i++) {
+        min = glm::min(min, m_points[i]);
+        max = glm::max(max, m_points[i]);
+    }
+    m_items.push_back({ _selectionColor, _type, _range, min, max });
+}
+
+void SelectionIndex::build() {
+
+    // Count the items of each cell, then place them in one array by cell
+    m_cellStart.assign(GRID_SIZE * GRID_SIZE + 1, 0);
+
+    for (const auto& item : m_items) {
+        for (int y = cellIndex(item.min.y); y <= cellIndex(item.max.y); y++) {
+            for (int x = cellIndex(item.min.x); x <= cellIndex(item.max.x); x++) {
+                m_cellStart[y * GRID_SIZE + x + 1]++;
+            }
+        }
+    }
+    for (size_t i = 1; i < m_cellStart.size(); i++) {
+        m_cellStart[i] += m_cellStart[i - 1];
+    }
+
+    m_cellItems.resize(m_cellStart.back());
+    std::vector<uint32_t> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+
+    for (uint32_t i = 0; i < m_items.size(); i++) {
+        const auto& item = m_items[i];
+        for (int y = cellIndex(item.min.y); y <= cellIndex(item.max.y); y++) {
+            for (int x = cellIndex(item.min.x); x <= cellIndex(item.max.x); x++) {
+                m_cellItems[fill[y * GRID_SIZE + x]++] = i;
+            }
+        }
+    }
+
+    m_points.shrink_to_fit();
+    m_rings.shrink_to_fit();
+    m_items.shrink_to_fit();
+}
+
+float SelectionIndex::distance(const Item& _item, glm::vec2 _position) const {
+
+    switch (_item.type) {
+    case GeometryType::points:
+        return glm::distance(_position, m_points[_item.range.begin]);
+    case GeometryType::lines: {
+        const auto* points = &m_points[_item.range.begin];
+        if (_item.range.size() == 1) { return glm::distance(_position, points[0]); }
+        float distanceSq = std::numeric_limits<float>::max();
+        for (uint32_t i = 1; i < _item.range.size(); i++) {
+            distanceSq = std::min(distanceSq, pointSegmentDistanceSq(_position, points[i - 1], points[i]));
+        }
+        return std::sqrt(distanceSq);
+    }
+    case GeometryType::polygons: {
+        // Even-odd rule over all rings, so that positions in holes are outside
+        bool inside = false;
+        float distanceSq = std::numeric_limits<float>::max();
+        for (uint32_t r = _item.range.begin; r < _item.range.end; r++) {
+            const auto& ring = m_rings[r];
+            if (ring.size() == 0) { continue; }
+            for (uint32_t i = ring.begin, j = ring.end - 1; i < ring.end; j = i++) {
+                const auto& a = m_points[i];
+                const auto& b = m_points[j];
+                if ((a.y > _position.y) != (b.y > _position.y) &&
+                    _position.x < (b.x - a.x) * (_position.y - a.y) / (b.y - a.y) + a.x) {
+                    inside = !inside;
+                }
+                distanceSq = std::min(distanceSq, pointSegmentDistanceSq(_position, a, b));
+            }
+        }
+        return inside ? 0.f : std::sqrt(distanceSq);
+    }
+    default:
+        return std::numeric_limits<float>::max();
+    }
+}
+
+void SelectionIndex::query(glm::vec2 _position, float _radius, std::vector<Hit>& _hits) const {
+
+    if (m_cellStart.empty()) { return; }
+
+    // Both the bounds of items and of the query are clamped to the edge cells, so geometry
+    // outside of the unit square is still found
+    glm::vec2 min = _position - _radius;
+    glm::vec2 max = _position + _radius;
+
+    size_t first = _hits.size();
+
+    for (int y = cellIndex(min.y); y <= cellIndex(max.y); y++) {
+        for (int x = cellIndex(min.x); x <= cellIndex(max.x); x++) {
+            int cell = y * GRID_SIZE + x;
+            for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; i++) {
+                const auto& item = m_items[m_cellItems[i]];
+
+                if (item.min.x > max.x || item.min.y > max.y || item.max.x < min.x || item.max.y < min.y) {
+                    continue;
+                }
+                float distance = this->distance(item, _position);
+                if (distance > _radius) { continue; }
+
+                // Items spanning several cells or of the same feature report one hit
+                auto it = std::find_if(_hits.begin() + first, _hits.end(), [&](const Hit& _hit) {
+                    return _hit.selectionColor == item.selectionColor;
+                });
+                if (it == _hits.end()) {
+                    _hits.push_back({ item.selectionColor, distance });
+                } else {
+                    it->distance = std::min(it->distance, distance);
+                }
+            }
+        }
+    }
+}
+
+size_t SelectionIndex::memoryUsage() const {
+    return m_points.capacity() * sizeof(glm::vec2) +
+        m_rings.capacity() * sizeof(GeometryRange) +
+        m_items.capacity() * sizeof(Item) +
+        (m_cellStart.capacity() + m_cellItems.capacity()) * sizeof(uint32_t);
+}
+
+void SelectionIndex::serialize(const std::vector<uint32_t>& _colors, std::vector<char>& _out) const {
+
+    std::vector<uint32_t> colors(_colors);
+    std::sort(colors.begin(), colors.end());
+
+    auto appendRange = [&](GeometryRange _range) {
+        uint32_t size = _range.size();
+        append(_out, &size, sizeof(size));
+        append(_out, m_points.data() + _range.begin, size * sizeof(glm::vec2));
+    };
+
+    // Each item is written as its selection color, type and number of point ranges, followed by
+    // the size and points of each range
+    for (const auto& item : m_items) {
+        if (!std::binary_search(colors.begin(), colors.end(), item.selectionColor)) { continue; }
+
+        uint8_t type = item.type;
+        uint32_t ranges = (item.type == GeometryType::polygons) ? item.range.size() : 1;
+        append(_out, &item.selectionColor, sizeof(uint32_t));
+        append(_out, &type, sizeof(type));
+        append(_out, &ranges, sizeof(ranges));
+
+        if (item.type == GeometryType::polygons) {
+            for (uint32_t r = item.range.begin; r < item.range.end; r++) { appendRange(m_rings[r]); }
+        } else {
+            appendRange(item.range);
+        }
+    }
+}
+
+bool SelectionIndex::deserialize(const char* _data, size_t _size,
+                                 const fastmap<uint32_t, uint32_t>& _colors) {
+
+    const char* end = _data + _size;
+    auto read = [&](void* _value, size_t _bytes) {
+        if (size_t(end - _data) < _bytes) { return false; }
+        std::memcpy(_value, _data, _bytes);
+        _data += _bytes;
+        return true;
+    };
+
+    while (_data < end) {
+        uint32_t color = 0;
+        uint8_t type = 0;
+        uint32_t ranges = 0;
+        if (!read(&color, sizeof(color)) || !read(&type, sizeof(type)) || !read(&ranges, sizeof(ranges))) {
+            return false;
+        }
+        // Points and lines are written as one range
+        if (type != GeometryType::polygons &&
+            ((type != GeometryType::points && type != GeometryType::lines) || ranges != 1)) {
+            return false;
+        }
+
+        uint32_t points = m_points.size();
+        uint32_t rings = m_rings.size();
+        for (uint32_t i = 0; i < ranges; i++) {
+            uint32_t size = 0;
+            if (!read(&size, sizeof(size)) || size_t(end - _data) / sizeof(glm::vec2) < size) {
+                m_points.resize(points);
+                m_rings.resize(rings);
+                return false;
+            }
+            uint32_t begin = m_points.size();
+            m_points.resize(begin + size);
+            read(m_points.data() + begin, size * sizeof(glm::vec2));
+            m_rings.push_back({ begin, begin + size });
+        }
+
+        auto it = _colors.find(color);
+        if (it == _colors.end() || ranges == 0 || m_rings[rings].size() == 0) {
+            m_points.resize(points);
+            m_rings.resize(rings);
+            continue;
+        }
+        if (type == GeometryType::polygons) {
+            addItem(it->second, GeometryType::polygons, { rings, uint32_t(m_rings.size()) });
+        } else {
+            m_rings.resize(rings);
+            addItem(it->second, GeometryType(type), { points, uint32_t(m_points.size()) });
+        }
+    }
+    return true;
+}
+
+float SelectionIndex::quadDistance(glm::vec2 _position, const std::array<glm::vec2, 4>& _quad) {
+
+    bool inside = true;
+    float distanceSq = std::numeric_limits<float>::max();
+
+    // Winding of the quad is not known, so the position is inside when it is on the same side
+    // of all edges
+    float side = 0.f;
+    for (int i = 0; i < 4; i++) {
+        const auto& a = _quad[i];
+        const auto& b = _quad[(i + 1) % 4];
+        float cross = (b.x - a.x) * (_position.y - a.y) - (b.y - a.y) * (_position.x - a.x);
+        if (cross != 0.f) {
+            if (side == 0.f) {
+                side = cross;
+            } else if ((side > 0.f) != (cross > 0.f)) {
+                inside = false;
+            }
+        }
+        distanceSq = std::min(distanceSq, pointSegmentDistanceSq(_position, a, b));
+    }
+    return inside ? 0.f : std::sqrt(distanceSq);
+}
+
+}
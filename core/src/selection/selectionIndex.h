@@ -0,0 +1,78 @@
+#pragma once
+
+#include "data/tileData.h"
+#include "util/fastmap.h"
+
+#include "glm/vec2.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+/* Grid of the geometry of interactive features, in the normalized coordinates of a tile or
+ * marker, for finding the features near a position without rendering the selection buffer */
+class SelectionIndex {
+
+public:
+
+    struct Hit {
+        uint32_t selectionColor;
+        // Distance to the nearest geometry of the feature, 0 inside of polygons
+        float distance;
+    };
+
+    // Add the geometry of @_feature with its @_selectionColor
+    void add(uint32_t _selectionColor, const Feature& _feature);
+
+    // Sort the added geometry into grid cells; must be called before query()
+    void build();
+
+    bool empty() const { return m_items.empty(); }
+
+    // Append the features within @_radius of @_position to @_hits, once for each selection color
+    void query(glm::vec2 _position, float _radius, std::vector<Hit>& _hits) const;
+
+    size_t memoryUsage() const;
+
+    // Append the geometry of features with a selection color in @_colors to @_out
+    void serialize(const std::vector<uint32_t>& _colors, std::vector<char>& _out) const;
+
+    /* Add the geometry written by serialize() from @_size bytes at @_data with the selection
+     * colors mapped by @_colors, skipping features without one; returns false if the data is
+     * truncated */
+    bool deserialize(const char* _data, size_t _size, const fastmap<uint32_t, uint32_t>& _colors);
+
+    // Distance from @_position to the convex quad @_quad, 0 inside of it
+    static float quadDistance(glm::vec2 _position, const std::array<glm::vec2, 4>& _quad);
+
+private:
+
+    struct Item {
+        uint32_t selectionColor;
+        GeometryType type;
+        // Points or line of m_points, or polygon rings of m_rings
+        GeometryRange range;
+        glm::vec2 min;
+        glm::vec2 max;
+    };
+
+    // Add lines or polygons with points converted to tile coordinates by @_convert
+    template<class LineList, class PolygonList, class Convert>
+    void addGeometry(uint32_t _selectionColor, GeometryType _type, const LineList& _lines,
+                     const PolygonList& _polygons, Convert _convert);
+
+    void addItem(uint32_t _selectionColor, GeometryType _type, GeometryRange _range);
+
+    float distance(const Item& _item, glm::vec2 _position) const;
+
+    std::vector<glm::vec2> m_points;
+    std::vector<GeometryRange> m_rings;
+    std::vector<Item> m_items;
+
+    // Items of each cell as ranges of m_cellItems
+    std::vector<uint32_t> m_cellStart;
+    std::vector<uint32_t> m_cellItems;
+};
+
+}
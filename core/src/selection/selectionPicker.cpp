@@ -0,0 +1,190 @@
+#include "selection/selectionPicker.h"
+
+#include "data/tileData.h"
+#include "labels/label.h"
+#include "labels/labelManager.h"
+#include "marker/marker.h"
+#include "marker/markerManager.h"
+#include "selection/selectionIndex.h"
+#include "tile/tile.h"
+#include "tile/tileManager.h"
+#include "util/mapProjection.h"
+#include "view/view.h"
+
+#include "glm/glm.hpp"
+#include <algorithm>
+
+namespace Tangram {
+
+SelectionPicker::SelectionPicker(View& _view, const TileManager& _tileManager, LabelManager& _labelManager,
+                                 const MarkerManager& _markerManager)
+    : m_view(_view), m_tileManager(_tileManager), m_labelManager(_labelManager), m_markerManager(_markerManager) {}
+
+bool SelectionPicker::projectToGround(glm::vec2 _position, float _radius) {
+
+    double distance = 0;
+    m_ground = m_view.screenToGroundPlane(_position.x, _position.y, 0, &distance);
+    if (distance < 0) { return false; }
+
+    // Take the larger ground distance along both screen axes, as the view may be tilted
+    float sample = std::max(_radius * m_view.pixelScale(), 1.f);
+    glm::dvec2 right = m_view.screenToGroundPlane(_position.x + sample, _position.y);
+    glm::dvec2 down = m_view.screenToGroundPlane(_position.x, _position.y + sample);
+    m_metersPerPixel = std::max(glm::distance(m_ground, right), glm::distance(m_ground, down)) *
+        m_view.pixelScale() / sample;
+    m_groundRadius = _radius * m_metersPerPixel;
+
+    return m_metersPerPixel > 0;
+}
+
+std::vector<FeaturePickResult> SelectionPicker::pickFeatures(glm::vec2 _position, float _radius) {
+
+    struct Hit {
+        std::shared_ptr<Properties> properties;
+        double distance;
+    };
+    std::vector<Hit> hits;
+
+    // Features of overlapping proxy tiles are distinct properties; keep the nearest of each
+    auto addHit = [&](std::shared_ptr<Properties> _properties, double _distance) {
+        auto it = std::find_if(hits.begin(), hits.end(), [&](const Hit& _hit) {
+            return _hit.properties == _properties;
+        });
+        if (it == hits.end()) {
+            hits.push_back({ std::move(_properties), _distance });
+        } else {
+            it->distance = std::min(it->distance, _distance);
+        }
+    };
+
+    if (projectToGround(_position, _radius)) {
+        std::vector<SelectionIndex::Hit> indexHits;
+
+        for (const auto& tile : m_tileManager.getVisibleTiles()) {
+            const auto* index = tile->getSelectionIndex();
+            if (!index) { continue; }
+
+            double scale = tile->getScale();
+            glm::dvec2 tilePosition = (m_ground - m_view.getRelativeMeters(tile->getOrigin())) / scale;
+
+            indexHits.clear();
+            index->query(glm::vec2(tilePosition), float(m_groundRadius / scale), indexHits);
+
+            for (const auto& hit : indexHits) {
+                if (auto props = tile->getSelectionFeature(hit.selectionColor)) {
+                    // Distances are compared in pixels, like those of labels
+                    addHit(std::move(props), hit.distance * scale / m_metersPerPixel);
+                }
+            }
+        }
+    }
+
+    // Labels are part of the rendered features, e.g. icons of points or text of lines
+    std::vector<LabelManager::LabelHit> labelHits;
+    m_labelManager.getLabelsNear(_position, _radius * m_view.pixelScale(), labelHits);
+
+    for (const auto& hit : labelHits) {
+        if (!hit.tile) { continue; }
+        if (auto props = hit.tile->getSelectionFeature(hit.label->options().featureId)) {
+            addHit(std::move(props), hit.distance / m_view.pixelScale());
+        }
+    }
+
+    std::stable_sort(hits.begin(), hits.end(), [](const Hit& _a, const Hit& _b) {
+        return _a.distance < _b.distance;
+    });
+
+    std::vector<FeaturePickResult> results;
+    for (auto& hit : hits) {
+        results.emplace_back(std::move(hit.properties), std::array<float, 2>{{ _position.x, _position.y }});
+    }
+    return results;
+}
+
+std::vector<LabelPickResult> SelectionPicker::pickLabels(glm::vec2 _position, float _radius) {
+
+    std::vector<LabelManager::LabelHit> hits;
+    m_labelManager.getLabelsNear(_position, _radius * m_view.pixelScale(), hits);
+
+    std::stable_sort(hits.begin(), hits.end(), [](const auto& _a, const auto& _b) {
+        return _a.distance < _b.distance;
+    });
+
+    std::vector<LabelPickResult> results;
+    for (const auto& hit : hits) {
+        if (!hit.tile) { continue; }
+
+        auto props = hit.tile->getSelectionFeature(hit.label->options().featureId);
+        if (!props) { continue; }
+
+        auto coordinate = hit.tile->coordToLngLat(hit.label->modelCenter());
+        results.emplace_back(hit.label->renderType(), coordinate.wrapped(),
+                             FeaturePickResult(props, {{ _position.x, _position.y }}));
+    }
+    return results;
+}
+
+std::vector<MarkerPickResult> SelectionPicker::pickMarkers(glm::vec2 _position, float _radius) {
+
+    struct Hit {
+        const Marker* marker;
+        double distance;
+    };
+    std::vector<Hit> hits;
+
+    auto addHit = [&](const Marker* _marker, double _distance) {
+        auto it = std::find_if(hits.begin(), hits.end(), [&](const Hit& _hit) {
+            return _hit.marker == _marker;
+        });
+        if (it == hits.end()) {
+            hits.push_back({ _marker, _distance });
+        } else {
+            it->distance = std::min(it->distance, _distance);
+        }
+    };
+
+    // Point markers and text of markers are drawn as labels
+    std::vector<LabelManager::LabelHit> labelHits;
+    m_labelManager.getLabelsNear(_position, _radius * m_view.pixelScale(), labelHits);
+
+    for (const auto& hit : labelHits) {
+        if (hit.marker && hit.marker->selectionColor() != 0) {
+            addHit(hit.marker, hit.distance / m_view.pixelScale());
+        }
+    }
+
+    if (projectToGround(_position, _radius)) {
+        std::vector<SelectionIndex::Hit> indexHits;
+
+        for (const auto& marker : m_markerManager.markers()) {
+            if (!marker->isVisible() || !marker->mesh() || marker->selectionColor() == 0) { continue; }
+
+            const auto* feature = marker->feature();
+            double extent = marker->extent();
+            if (!feature || feature->geometryType == GeometryType::points || extent <= 0) { continue; }
+
+            glm::dvec2 markerPosition = (m_ground - m_view.getRelativeMeters(marker->origin())) / extent;
+
+            indexHits.clear();
+            marker->selectionIndex().query(glm::vec2(markerPosition), float(m_groundRadius / extent), indexHits);
+
+            if (!indexHits.empty()) {
+                addHit(marker.get(), indexHits.front().distance * extent / m_metersPerPixel);
+            }
+        }
+    }
+
+    std::stable_sort(hits.begin(), hits.end(), [](const Hit& _a, const Hit& _b) {
+        return _a.distance < _b.distance;
+    });
+
+    std::vector<MarkerPickResult> results;
+    for (const auto& hit : hits) {
+        glm::dvec2 bbCenter = hit.marker->bounds().center();
+        LngLat lngLat = MapProjection::projectedMetersToLngLat(bbCenter).wrapped();
+        results.emplace_back(hit.marker->id(), lngLat, std::array<float, 2>{{ _position.x, _position.y }});
+    }
+    return results;
+}
+
+}
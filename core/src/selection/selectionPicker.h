@@ -0,0 +1,55 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "map.h"
+
+#include <vector>
+
+namespace Tangram {
+
+class LabelManager;
+class MarkerManager;
+class TileManager;
+class View;
+
+/* Answers picks of features, labels and markers on the CPU from the SelectionIndex of tiles
+ * and markers and the label bounding boxes of the last update, as an alternative to
+ * SelectionQuery which reads the rendered selection framebuffer
+ *
+ * Positions are in screen pixels as for SelectionQuery and the radius in density-independent
+ * pixels. Geometry is picked on the ground plane, without terrain elevation.
+ */
+class SelectionPicker {
+
+public:
+    SelectionPicker(View& _view, const TileManager& _tileManager, LabelManager& _labelManager,
+                    const MarkerManager& _markerManager);
+
+    // Interactive features with geometry or labels within _radius of _position, nearest first
+    std::vector<FeaturePickResult> pickFeatures(glm::vec2 _position, float _radius);
+
+    // Labels of interactive features within _radius of _position, nearest first
+    std::vector<LabelPickResult> pickLabels(glm::vec2 _position, float _radius);
+
+    // Interactive markers within _radius of _position, nearest first
+    std::vector<MarkerPickResult> pickMarkers(glm::vec2 _position, float _radius);
+
+private:
+
+    // Set the ground position and radius for _position and _radius; returns false when the
+    // position is not on the ground plane
+    bool projectToGround(glm::vec2 _position, float _radius);
+
+    View& m_view;
+    const TileManager& m_tileManager;
+    LabelManager& m_labelManager;
+    const MarkerManager& m_markerManager;
+
+    // Picked position on the ground in meters relative to the view position, the radius in
+    // meters and the scale of distances on the ground at that position
+    glm::dvec2 m_ground;
+    double m_groundRadius = 0;
+    double m_metersPerPixel = 1;
+};
+
+}
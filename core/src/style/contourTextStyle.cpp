@@ -45,7 +45,7 @@ void ContourTextStyleBuilder::setup(const Tile& _tile) {
     TextStyleBuilder::setup(_tile);
 }
 
-static float getContourLine(Texture& tex, TileID& tileId, glm::vec2 pos, float elevStep, Line& line) {
+static float getContourLine(Texture& tex, TileID& tileId, glm::vec2 pos, float elevStep, std::vector<Point>& line) {
 
     const float tileSize = 256.0f * std::exp2(tileId.s - tileId.z);
     const float maxPosErr = 0.25f/tileSize;
@@ -140,7 +140,7 @@ bool ContourTextStyleBuilder::addFeature(const Feature& _feat, const DrawRule& _
         for (int row = 0; row < ngrid; row++) {
             pos.x = (row + gridstart)/ngrid;
 
-            Line line;
+            std::vector<Point> line;
             float level = getContourLine(*m_texture, m_tileId, pos, elevStep, line);
             if (std::isnan(level)) { continue; }
 
@@ -227,7 +227,7 @@ bool ContourDebugStyleBuilder::addFeature(const Feature& _feat, const DrawRule&
         for (int row = 0; row < ngrid; row++) {
             pos.x = (row + gridstart)/ngrid;
 
-            Line line;
+            std::vector<Point> line;
             float level = getContourLine(*m_texture, m_tileId, pos, elevStep, line);
             if(line.empty()) { continue; }
 
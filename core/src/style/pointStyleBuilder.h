@@ -72,6 +72,13 @@ struct PointStyleBuilder : public StyleBuilder {
 
     bool addFeature(const Feature& _feat, const DrawRule& _rule) override;
 
+    size_t vertexCount() const override {
+        return m_quads.size() * 4 + m_textStyleBuilder->vertexCount();
+    }
+    size_t labelCount() const override {
+        return m_labels.size() + m_textStyleBuilder->labelCount();
+    }
+
 private:
 
     /*
@@ -112,12 +112,19 @@ public:
         m_meshData.clear();
     }
 
+    bool addFeature(const Feature& _feat, const DrawRule& _rule) override;
+
     bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
 
+    template<class P>
+    void buildPolygon(const P& _polygon, const Parameters& _params);
+
     const Style& style() const override { return m_style; }
 
     std::unique_ptr<StyledMesh> build() override;
 
+    size_t vertexCount() const override { return m_meshData.vertices.size(); }
+
     PolygonStyleBuilder(const PolygonStyle& _style) : m_style(_style) {}
 
     Parameters parseRule(const DrawRule& _rule, const Properties& _props);
@@ -173,10 +180,36 @@ auto PolygonStyleBuilder<V>::parseRule(const DrawRule& _rule, const Properties&
     return p;
 }
 
+template <class V>
+bool PolygonStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _rule) {
+
+    if (!_feat.isQuantized()) { return StyleBuilder::addFeature(_feat, _rule); }
+
+    if (_feat.geometryType != GeometryType::polygons || !checkRule(_rule)) { return false; }
+
+    // Build directly from the tile units of quantized features
+    auto p = parseRule(_rule, _feat.props);
+    m_builder.quantizedScale = _feat.quantizedScale;
+
+    for (auto& polygon : _feat.quantizedPolygons()) {
+        buildPolygon(polygon, p);
+    }
+    return true;
+}
+
 template <class V>
 bool PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) {
 
-    auto p = parseRule(_rule, _props);
+    buildPolygon(_polygon, parseRule(_rule, _props));
+
+    return true;
+}
+
+template <class V>
+template <class P>
+void PolygonStyleBuilder<V>::buildPolygon(const P& _polygon, const Parameters& _params) {
+
+    auto& p = _params;
 
     m_builder.keepTileEdges = p.keepTileEdges;
 
@@ -200,8 +233,6 @@ bool PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Propertie
     m_meshData.offsets.emplace_back(m_builder.indices.size(),
                                     m_builder.numVertices);
     m_builder.clear();
-
-    return true;
 }
 
 std::unique_ptr<StyleBuilder> PolygonStyle::createBuilder() const {
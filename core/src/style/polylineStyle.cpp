@@ -187,15 +187,24 @@ public:
 
     std::unique_ptr<StyledMesh> build() override;
 
+    size_t vertexCount() const override {
+        return m_meshData[0].vertices.size() + m_meshData[1].vertices.size();
+    }
+
     PolylineStyleBuilder(const PolylineStyle& _style)
         : m_style(_style),
           m_meshData(2) {}
 
-    void addMesh(const Line& _line, const Parameters& _params);
+    template<class L>
+    void addMesh(const L& _line, const Parameters& _params);
 
-    void buildLine(const Line& _line, const typename Parameters::Attributes& _att,
+    template<class L>
+    void buildLine(const L& _line, const typename Parameters::Attributes& _att,
                    MeshData<V>& _mesh, GLuint _selection);
 
+    template<class LineList, class PolygonList>
+    void addGeometry(const LineList& _lines, const PolygonList& _polygons, Parameters& _params);
+
     Parameters parseRule(const DrawRule& _rule, const Properties& _props);
 
     bool evalWidth(const StyleParam& _styleParam, float& width, float& slope);
@@ -423,25 +432,40 @@ bool PolylineStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _
         params.keepTileEdges = true;
         // allow override (for 3D terrain)
         _rule.get(StyleParamKey::tile_edges, params.keepTileEdges);
-
-        for (auto& line : _feat.lines) {
-            addMesh(line, params);
-        }
     } else {
         params.closedPolygon = true;
+    }
+
+    if (_feat.isQuantized()) {
+        m_builder.quantizedScale = _feat.quantizedScale;
+        addGeometry(_feat.quantizedLines(), _feat.quantizedPolygons(), params);
+    } else {
+        addGeometry(_feat.lines(), _feat.polygons(), params);
+    }
 
-        for (auto& polygon : _feat.polygons) {
+    return true;
+}
+
+template <class V>
+template <class LineList, class PolygonList>
+void PolylineStyleBuilder<V>::addGeometry(const LineList& _lines, const PolygonList& _polygons,
+                                          Parameters& _params) {
+    if (_params.closedPolygon) {
+        for (auto& polygon : _polygons) {
             for (const auto& line : polygon) {
-                addMesh(line, params);
+                addMesh(line, _params);
             }
         }
+    } else {
+        for (auto& line : _lines) {
+            addMesh(line, _params);
+        }
     }
-
-    return true;
 }
 
 template <class V>
-void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parameters::Attributes& _att,
+template <class L>
+void PolylineStyleBuilder<V>::buildLine(const L& _line, const typename Parameters::Attributes& _att,
                                         MeshData<V>& _mesh, GLuint selection) {
 
     float zoom = m_overzoom2;
@@ -463,7 +487,8 @@ void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parame
 }
 
 template <class V>
-void PolylineStyleBuilder<V>::addMesh(const Line& _line, const Parameters& _params) {
+template <class L>
+void PolylineStyleBuilder<V>::addMesh(const L& _line, const Parameters& _params) {
 
     m_builder.cap = _params.fill.cap;
     m_builder.join = _params.fill.join;
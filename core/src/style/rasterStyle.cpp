@@ -142,7 +142,7 @@ bool RasterStyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule)
 
     if (!checkRule(_rule)) { return false; }
 
-    if (_feat.geometryType != GeometryType::polygons || _feat.polygons.size() != 1) {
+    if (_feat.geometryType != GeometryType::polygons || _feat.polygons().size() != 1) {
         LOGE("Invalid geometry passed to RasterStyle");
         return false;
     }
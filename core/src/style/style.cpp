@@ -551,14 +551,14 @@ bool StyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
             }
             break;
         case GeometryType::lines:
-            for (auto& line : _feat.lines) {
-                added |= addLine(line, _feat.props, _rule);
-            }
+            forEachLine(_feat, [&](const Line& _line) {
+                added |= addLine(_line, _feat.props, _rule);
+            });
             break;
         case GeometryType::polygons:
-            for (auto& polygon : _feat.polygons) {
-                added |= addPolygon(polygon, _feat.props, _rule);
-            }
+            forEachPolygon(_feat, [&](const Polygon& _polygon) {
+                added |= addPolygon(_polygon, _feat.props, _rule);
+            });
             break;
         default:
             break;
@@ -567,6 +567,27 @@ bool StyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
     return added;
 }
 
+Line StyleBuilder::tileLine(const Feature& _feat, const QuantizedLine& _line) {
+    m_tileCoordinates.clear();
+    for (auto& point : _line) {
+        m_tileCoordinates.push_back(_feat.dequantize(point));
+    }
+    return Line(m_tileCoordinates);
+}
+
+Polygon StyleBuilder::tilePolygon(const Feature& _feat, const QuantizedPolygon& _polygon) {
+    m_tileCoordinates.clear();
+    m_tileRings.clear();
+    for (auto& ring : _polygon) {
+        uint32_t begin = m_tileCoordinates.size();
+        for (auto& point : ring) {
+            m_tileCoordinates.push_back(_feat.dequantize(point));
+        }
+        m_tileRings.push_back({ begin, uint32_t(m_tileCoordinates.size()) });
+    }
+    return Polygon(m_tileCoordinates.data(), m_tileRings.data(), m_tileRings.size());
+}
+
 bool StyleBuilder::addPoint(const Point& _point, const Properties& _props, const DrawRule& _rule) {
     // No-op by default
     return false;
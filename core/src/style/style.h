@@ -68,6 +68,10 @@ struct StyledMesh {
     virtual bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) = 0;
     virtual size_t bufferSize() const = 0;
 
+    /* Append the compiled geometry to @_out, for a TileGeometryCache; returns false for meshes
+     * which cannot be restored from their vertex data alone */
+    virtual bool serialize(std::vector<char>& _out) const { return false; }
+
     virtual ~StyledMesh() {}
 };
 
@@ -100,7 +104,43 @@ public:
 
     virtual void addSelectionItems(LabelCollider& _layout) {}
 
+    /* Number of vertices and labels added since setup(), for DebugFlags::layer_profile */
+    virtual size_t vertexCount() const { return 0; }
+    virtual size_t labelCount() const { return 0; }
+
     virtual const Style& style() const = 0;
+
+protected:
+
+    /* Call @_fn with each line of @_feat in tile coordinates. Lines of quantized features are
+     * converted one at a time into a buffer that is reused for the next line. */
+    template<class Fn>
+    void forEachLine(const Feature& _feat, Fn _fn) {
+        if (!_feat.isQuantized()) {
+            for (auto& line : _feat.lines()) { _fn(line); }
+            return;
+        }
+        for (auto& line : _feat.quantizedLines()) { _fn(tileLine(_feat, line)); }
+    }
+
+    /* Call @_fn with each polygon of @_feat in tile coordinates, see forEachLine() */
+    template<class Fn>
+    void forEachPolygon(const Feature& _feat, Fn _fn) {
+        if (!_feat.isQuantized()) {
+            for (auto& polygon : _feat.polygons()) { _fn(polygon); }
+            return;
+        }
+        for (auto& polygon : _feat.quantizedPolygons()) { _fn(tilePolygon(_feat, polygon)); }
+    }
+
+private:
+
+    Line tileLine(const Feature& _feat, const QuantizedLine& _line);
+    Polygon tilePolygon(const Feature& _feat, const QuantizedPolygon& _polygon);
+
+    // Tile coordinates of the current line or polygon of a quantized feature
+    std::vector<Point> m_tileCoordinates;
+    std::vector<GeometryRange> m_tileRings;
 };
 
 /* Means of constructing and rendering map geometry
@@ -216,7 +256,7 @@ public:
 
     virtual ~Style();
 
-    StyleType type() { return m_type; }
+    StyleType type() const { return m_type; }
 
     static bool compare(std::unique_ptr<Style>& a, std::unique_ptr<Style>& b) {
 
@@ -34,7 +34,7 @@
 
 namespace Tangram {
 
-const static std::string key_name("name");
+const static PropertyKey key_name("name");
 
 TextStyleBuilder::TextStyleBuilder(const TextStyle& _style) : m_style(_style) {}
 
@@ -249,9 +249,9 @@ bool TextStyleBuilder::handleBoundaryLabel(const Feature& _feat, const DrawRule&
     };
 
     bool added = false;
-    for (auto& line : _feat.lines) {
-        added |= addStraightTextLabels(line, labelWidth, onAddLabel);
-    }
+    forEachLine(_feat, [&](const Line& _line) {
+        added |= addStraightTextLabels(_line, labelWidth, onAddLabel);
+    });
 
     return added;
 }
@@ -288,14 +288,13 @@ bool TextStyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
             }
 
         } else if (_feat.geometryType == GeometryType::polygons) {
-            const auto& polygons = _feat.polygons;
-            for (const auto& polygon : polygons) {
-                if (!polygon.empty()) {
+            forEachPolygon(_feat, [&](const Polygon& _polygon) {
+                if (!_polygon.empty()) {
                     glm::vec2 c;
-                    c = centroid(polygon.front().begin(), polygon.front().end());
+                    c = centroid(_polygon.front().begin(), _polygon.front().end());
                     addLabel(Label::Type::point, {{ c }}, params, attrib, _rule);
                 }
-            }
+            });
 
         } else if (_feat.geometryType == GeometryType::lines) {
             addLineTextLabels(_feat, params, attrib, _rule);
@@ -589,15 +588,15 @@ void TextStyleBuilder::addLineTextLabels(const Feature& _feat, const TextStyle::
         addLabel(Label::Type::line, {{ a, b }}, _params, _attributes, _rule);
     };
 
-    for (auto& line : _feat.lines) {
+    forEachLine(_feat, [&](const Line& _line) {
 
-        if (!addStraightTextLabels(line, _attributes.width, straightLabelCb) &&
-            line.size() > 2 && !_params.hasComplexShaping &&
+        if (!addStraightTextLabels(_line, _attributes.width, straightLabelCb) &&
+            _line.size() > 2 && !_params.hasComplexShaping &&
             // TODO: support line offset for curved labels
             _params.labelOptions.offset == glm::vec2(0)) {
-            addCurvedTextLabels(line, _params, _attributes, _rule);
+            addCurvedTextLabels(_line, _params, _attributes, _rule);
         }
-    }
+    });
 }
 
 bool TextStyleBuilder::checkRule(const DrawRule& _rule) const {
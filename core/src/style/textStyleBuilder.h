@@ -62,6 +62,9 @@ public:
 
     void addLayoutItems(LabelCollider& _layout) override;
 
+    size_t vertexCount() const override { return m_quads.size() * 4; }
+    size_t labelCount() const override { return m_labels.size(); }
+
 protected:
 
     const TextStyle& m_style;
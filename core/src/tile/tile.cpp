@@ -1,6 +1,7 @@
 #include "tile/tile.h"
 
 #include "labels/labelSet.h"
+#include "selection/selectionIndex.h"
 #include "style/style.h"
 #include "tile/tileID.h"
 #include "util/mapProjection.h"
@@ -77,6 +78,11 @@ void Tile::setSelectionFeatures(const fastmap<uint32_t, std::shared_ptr<Properti
     m_selectionFeatures = _selectionFeatures;
 }
 
+void Tile::setSelectionIndex(std::unique_ptr<SelectionIndex> _selectionIndex) {
+    m_selectionIndex = std::move(_selectionIndex);
+    m_memoryUsage = 0;
+}
+
 std::shared_ptr<Properties> Tile::getSelectionFeature(uint32_t _id) const {
     auto it = m_selectionFeatures.find(_id);
     if (it != m_selectionFeatures.end()) {
@@ -97,6 +103,9 @@ size_t Tile::getMemoryUsage() const {
                 m_memoryUsage += raster.texture->bufferSize();
             }
         }
+        if (m_selectionIndex) {
+            m_memoryUsage += m_selectionIndex->memoryUsage();
+        }
     }
 
     return m_memoryUsage;
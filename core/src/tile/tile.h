@@ -16,6 +16,7 @@ namespace Tangram {
 
 class MapProjection;
 struct Properties;
+class SelectionIndex;
 class Style;
 class View;
 struct StyledMesh;
@@ -73,6 +74,11 @@ public:
 
     const auto& getSelectionFeatures() const { return m_selectionFeatures; }
 
+    /* Set the geometry of the selection features built for this tile, see SelectionIndex */
+    void setSelectionIndex(std::unique_ptr<SelectionIndex> _selectionIndex);
+
+    const SelectionIndex* getSelectionIndex() const { return m_selectionIndex.get(); }
+
     auto& rasters() { return m_rasters; }
     const auto& rasters() const { return m_rasters; }
 
@@ -81,13 +87,20 @@ public:
 
     void resetState();
 
-    /* Get the sum in bytes of static <Mesh>es */
+    /* Get the sum in bytes of static <Mesh>es, rasters and the selection index */
     size_t getMemoryUsage() const;
 
     int64_t sourceGeneration() const { return m_sourceGeneration; }
 
+    /* Mark the tile as up to date with @_generation of its TileSource */
+    void setSourceGeneration(int64_t _generation) { m_sourceGeneration = _generation; }
+
     int32_t sourceID() const { return m_sourceId; }
 
+    /* Time in ms spent building the tile, used to weigh which cached tiles to keep */
+    float buildTime() const { return m_buildTime; }
+    void setBuildTime(float _ms) { m_buildTime = _ms; }
+
     int8_t proxyDepth() const { return m_proxyDepth; }
     bool isProxy() const { return m_proxyDepth > 0; }
 
@@ -103,10 +116,12 @@ private:
     const int32_t m_sourceId;
 
     /* State of the TileSource for which this tile was created */
-    const int64_t m_sourceGeneration;
+    int64_t m_sourceGeneration;
 
     int8_t m_proxyDepth = 0;
 
+    float m_buildTime = 0;
+
     glm::dvec2 m_tileOrigin; // South-West corner of the tile in 2D projection space in meters (e.g. mercator meters)
 
     glm::mat4 m_modelMatrix; // Matrix relating tile-local coordinates to global projection space coordinates;
@@ -124,6 +139,8 @@ private:
 
     fastmap<uint32_t, std::shared_ptr<Properties>> m_selectionFeatures;
 
+    std::unique_ptr<SelectionIndex> m_selectionIndex;
+
 };
 
 }
@@ -5,13 +5,17 @@
 #include "data/tileSource.h"
 #include "gl/mesh.h"
 #include "log.h"
+#include "map.h"
 #include "scene/dataLayer.h"
 #include "scene/scene.h"
 #include "selection/featureSelection.h"
 #include "tile/tile.h"
+#include "tile/tileGeometryCache.h"
 #include "util/mapProjection.h"
 #include "view/view.h"
 
+#include <algorithm>
+
 namespace Tangram {
 
 TileBuilder::TileBuilder(const Scene& _scene)
@@ -27,12 +31,34 @@ TileBuilder::TileBuilder(const Scene& _scene, StyleContext* _styleContext)
 void TileBuilder::init() {
     m_styleContext->initFunctions(m_scene);
 
+    // Index DataLayers by source and collection once per scene
+    for (const auto& datalayer : m_scene.layers()) {
+        if (!datalayer.enabled()) { continue; }
+
+        auto& sourceLayers = m_sourceLayers[datalayer.source()];
+        size_t index = sourceLayers.dataLayers.size();
+        sourceLayers.dataLayers.push_back(&datalayer);
+
+        for (const auto& collection : datalayer.collections()) {
+            auto& indices = sourceLayers.collections[collection];
+            if (indices.empty() || indices.back() != index) { indices.push_back(index); }
+        }
+    }
+
     // Initialize StyleBuilders
     for (const auto& style : m_scene.styles()) {
         if (auto builder = style->createBuilder()) {
             m_styleBuilder[style->getName()] = std::move(builder);
         }
     }
+
+    // Labels depend on font atlas and sprite textures of the running scene, so only meshes of
+    // polygons and lines are kept in the TileGeometryCache
+    m_cacheableStyles.assign(m_scene.styles().size(), false);
+    for (const auto& style : m_scene.styles()) {
+        m_cacheableStyles[style->getID()] = (style->type() == StyleType::polygon ||
+                                             style->type() == StyleType::polyline);
+    }
 }
 
 StyleBuilder* TileBuilder::getStyleBuilder(const std::string& _name) {
@@ -42,13 +68,151 @@ StyleBuilder* TileBuilder::getStyleBuilder(const std::string& _name) {
     return it->second.get();
 }
 
+namespace {
+
+// Cost of building one draw rule, see DebugFlags::layer_profile
+struct ProfileSample {
+    LayerProfile::Cost* cost = nullptr;
+    const StyleBuilder* builders[2] = {};
+    size_t numBuilders = 0;
+    int64_t vertices = 0;
+    int64_t labels = 0;
+    LayerProfile::Clock::time_point start;
+
+    void begin(LayerProfile::Cost& _cost, const StyleBuilder& _builder) {
+        cost = &_cost;
+        track(_builder);
+        start = LayerProfile::Clock::now();
+    }
+
+    // Count the output of @_builder from now until end()
+    void track(const StyleBuilder& _builder) {
+        if (!cost) { return; }
+        vertices -= _builder.vertexCount();
+        labels -= _builder.labelCount();
+        builders[numBuilders++] = &_builder;
+    }
+
+    void end(bool _added) {
+        if (!cost) { return; }
+        cost->time += LayerProfile::Clock::now() - start;
+        for (size_t i = 0; i < numBuilders; i++) {
+            vertices += builders[i]->vertexCount();
+            labels += builders[i]->labelCount();
+        }
+        cost->vertices += vertices;
+        cost->labels += labels;
+        if (_added) { cost->features++; }
+    }
+};
+
+// Deepest sublayer contributing parameters to @_rule
+const char* ruleLayerName(const DrawRule& _rule) {
+    const char* name = nullptr;
+    int depth = -1;
+    for (size_t i = 0; i < StyleParamKeySize; i++) {
+        if (_rule.active[i] && _rule.params[i].layerDepth > depth) {
+            name = _rule.params[i].layerName;
+            depth = _rule.params[i].layerDepth;
+        }
+    }
+    return name;
+}
+
+}
+
+void TileBuilder::profileMatch(const SceneLayer& _dataLayer, LayerProfile::Clock::time_point _start,
+                               bool _matched) {
+    auto& cost = m_profile[{ &_dataLayer, nullptr, nullptr }];
+    cost.time += LayerProfile::Clock::now() - _start;
+    if (_matched) { cost.features++; }
+}
+
 void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer) {
 
+    LayerProfile::Clock::time_point start;
+    if (m_profiling) { start = LayerProfile::Clock::now(); }
+
+    bool matched = m_ruleSet.matchCached(_feature, _layer, *m_styleContext);
+
+    if (m_profiling) { profileMatch(_layer, start, matched); }
+
     // If no rules matched the feature, return immediately
-    if (!m_ruleSet.match(_feature, _layer, *m_styleContext)) { return; }
+    if (!matched) { return; }
+
+    addFeature(_feature, _layer);
+}
+
+void TileBuilder::applyStyling(LazyLayer& _layer, const SceneLayer& _sceneLayer) {
+
+    _layer.rewind();
+
+    LayerProfile::Clock::time_point start;
+    if (m_profiling) { start = LayerProfile::Clock::now(); }
+
+    while (_layer.nextFeature(m_lazyFeature)) {
+
+        if (!m_ruleSet.matchCached(m_lazyFeature, _sceneLayer, *m_styleContext)) { continue; }
+
+        _layer.getGeometry(m_lazyFeature);
+
+        // Decoding of properties and geometry counts as matching cost of the data layer
+        if (m_profiling) { profileMatch(_sceneLayer, start, true); }
+
+        addFeature(m_lazyFeature, _sceneLayer);
+
+        if (m_profiling) { start = LayerProfile::Clock::now(); }
+    }
+
+    if (m_profiling) { profileMatch(_sceneLayer, start, false); }
+}
+
+void TileBuilder::decodeShared(LazyLayer& _layer, SharedLazyLayer& _shared) {
+
+    _shared.layer = &_layer;
+    _shared.numFeatures = 0;
+    _layer.rewind();
+
+    while (true) {
+        if (_shared.numFeatures == _shared.features.size()) { _shared.features.emplace_back(); }
+        if (!_layer.nextFeature(_shared.features[_shared.numFeatures])) { break; }
+        _shared.numFeatures++;
+    }
+    _shared.hasGeometry.assign(_shared.numFeatures, false);
+}
+
+void TileBuilder::applyStyling(SharedLazyLayer& _shared, const SceneLayer& _sceneLayer) {
+
+    LayerProfile::Clock::time_point start;
+    if (m_profiling) { start = LayerProfile::Clock::now(); }
+
+    for (size_t i = 0; i < _shared.numFeatures; i++) {
+        auto& feature = _shared.features[i];
+
+        if (!m_ruleSet.matchCached(feature, _sceneLayer, *m_styleContext)) { continue; }
+
+        if (!_shared.hasGeometry[i]) {
+            _shared.layer->getGeometry(i, feature);
+            _shared.hasGeometry[i] = true;
+        }
+
+        if (m_profiling) { profileMatch(_sceneLayer, start, true); }
+
+        addFeature(feature, _sceneLayer);
+
+        if (m_profiling) { start = LayerProfile::Clock::now(); }
+    }
+
+    if (m_profiling) { profileMatch(_sceneLayer, start, false); }
+}
+
+void TileBuilder::addFeature(const Feature& _feature, const SceneLayer& _dataLayer) {
 
     uint32_t selectionColor = 0;
     bool added = false;
+    // Whether the feature was built with cacheable styles and with other styles
+    bool builtCacheable = false;
+    bool builtUncacheable = false;
 
     // For each matched rule, find the style to be used and
     // build the feature with the rule's parameters
@@ -61,10 +225,24 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
             continue;
         }
 
+        ProfileSample sample;
+        if (m_profiling) {
+            sample.begin(m_profile[{ &_dataLayer, ruleLayerName(rule), &builder->style().getName() }],
+                         *builder);
+        }
+
         // Apply default draw rules defined for this style
         builder->style().applyDefaultDrawRules(rule);
 
+        // Geometry of restored styles and its selection index are already in the tile
+        bool restored = isRestored(*builder);
+        if (restored && !rule.findParameter(StyleParamKey::outline_style)) {
+            sample.end(false);
+            continue;
+        }
+
         if (!m_ruleSet.evaluateRuleForContext(rule, *m_styleContext)) {
+            sample.end(false);
             continue;
         }
 
@@ -86,29 +264,146 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
             auto* outlineStyle = getStyleBuilder(styleName);
             if (!outlineStyle) {
                 LOGN("Invalid style %s", styleName.c_str());
-            } else {
+            } else if (!isRestored(*outlineStyle)) {
                 rule.isOutlineOnly = true;
-                outlineStyle->addFeature(_feature, rule);
+                sample.track(*outlineStyle);
+                bool builtOutline = outlineStyle->addFeature(_feature, rule);
                 rule.isOutlineOnly = false;
+                // Outlines of restored geometry need the selection feature as well
+                added |= builtOutline && restored;
+                if (builtOutline && selectionColor != 0) {
+                    if (m_cacheableStyles[outlineStyle->style().getID()]) {
+                        m_cacheableSelection.push_back(selectionColor);
+                        builtCacheable = true;
+                    } else {
+                        builtUncacheable = true;
+                    }
+                }
             }
         }
 
         // build feature with style
-        added |= builder->addFeature(_feature, rule);
+        bool builtRule = !restored && builder->addFeature(_feature, rule);
+        sample.end(builtRule);
+        added |= builtRule;
+
+        if (builtRule && selectionColor != 0) {
+            if (m_cacheableStyles[builder->style().getID()]) {
+                m_cacheableSelection.push_back(selectionColor);
+                builtCacheable = true;
+            } else {
+                builtUncacheable = true;
+            }
+        }
     }
 
     if (added && (selectionColor != 0)) {
         m_selectionFeatures[selectionColor] = std::make_shared<Properties>(_feature.props);
+        m_selectionIndex->add(selectionColor, _feature);
+
+        // Features also built with other styles are indexed again when the tile is restored,
+        // by the selection color of the rebuilt geometry
+        if (builtCacheable && !builtUncacheable) { m_cacheableIndex.push_back(selectionColor); }
+    }
+}
+
+bool TileBuilder::restoreGeometry(Tile& _tile, const TileSource& _source) {
+    const auto& styles = m_scene.styles();
+
+    std::vector<std::pair<uint32_t, std::unique_ptr<CachedMesh>>> meshes;
+    TileGeometryCache::SelectionFeatures selection;
+    std::vector<char> selectionIndex;
+
+    bool found = m_scene.geometryCache()->get(_source.name(), _tile.getID(), m_scene.pixelScale(),
+        [&](uint32_t _styleId, const char* _data, size_t _size) {
+            if (_styleId >= styles.size() || !m_cacheableStyles[_styleId]) { return false; }
+
+            std::unique_ptr<CachedMesh> mesh;
+            if (_size > 0) {
+                const auto& style = *styles[_styleId];
+                mesh = std::make_unique<CachedMesh>(style.vertexLayout(), style.drawMode());
+                if (!mesh->deserialize(_data, _size)) { return false; }
+            }
+            meshes.emplace_back(_styleId, std::move(mesh));
+            return true;
+        }, selection, selectionIndex);
+
+    if (!found) { return false; }
+
+    // Selection colors are only unique within the running scene
+    fastmap<uint32_t, uint32_t> colors;
+    for (auto& feature : selection) {
+        uint32_t color = m_scene.featureSelection()->nextColorIdentifier();
+        colors[feature.first] = color;
+        feature.second->sourceId = _source.id();
+        m_selectionFeatures[color] = std::move(feature.second);
+    }
+
+    // Restored features are picked by the selection colors of their meshes
+    if (!m_selectionIndex->deserialize(selectionIndex.data(), selectionIndex.size(), colors)) {
+        LOGW("Invalid selection index in tile geometry cache entry for %s",
+             _tile.getID().toString().c_str());
+    }
+
+    for (auto& mesh : meshes) {
+        if (mesh.second) {
+            mesh.second->remapAttribute("a_selection_color", colors);
+            _tile.setMesh(*styles[mesh.first], std::move(mesh.second));
+        }
+        m_restoredStyles[mesh.first] = true;
+    }
+    return true;
+}
+
+void TileBuilder::storeGeometry(const Tile& _tile, const TileSource& _source) {
+    TileGeometryCache::Meshes meshes;
+
+    for (const auto& style : m_scene.styles()) {
+        if (!m_cacheableStyles[style->getID()]) { continue; }
+
+        // Styles without geometry in the tile are stored empty, so that they are skipped as well
+        std::vector<char> data;
+        const auto& mesh = _tile.getMesh(*style);
+        if (mesh && !mesh->serialize(data)) { continue; }
+
+        meshes.emplace_back(style->getID(), std::move(data));
+    }
+    if (meshes.empty()) { return; }
+
+    TileGeometryCache::SelectionFeatures selection;
+    for (uint32_t color : m_cacheableSelection) {
+        auto it = m_selectionFeatures.find(color);
+        if (it != m_selectionFeatures.end()) { selection[color] = it->second; }
     }
+
+    std::vector<char> selectionIndex;
+    m_selectionIndex->serialize(m_cacheableIndex, selectionIndex);
+
+    m_scene.geometryCache()->put(_source.name(), _tile.getID(), m_scene.pixelScale(),
+                                 meshes, selection, selectionIndex);
 }
 
-void TileBuilder::build(Tile& tile, const TileData& _tileData, const TileSource& _source) {
+void TileBuilder::build(Tile& tile, TileData& _tileData, const TileSource& _source) {
 
     m_selectionFeatures.clear();
+    m_selectionIndex = std::make_unique<SelectionIndex>();
+    m_cacheableSelection.clear();
+    m_cacheableIndex.clear();
+    m_restoredStyles.assign(m_scene.styles().size(), false);
+
+    m_profiling = getDebugFlag(DebugFlags::layer_profile);
 
     tile.initGeometry(int(m_scene.styles().size()));
 
+    // Entries are keyed by the scene configuration as loaded, so neither changed globals nor
+    // sources with data of the running app can use them
+    bool useGeometryCache = m_scene.geometryCache() && m_scene.globalsGeneration == 0 &&
+        !_source.isClient() && !_source.isRaster();
+    bool restored = useGeometryCache && restoreGeometry(tile, _source);
+
     m_styleContext->setTileID(tile.getID());
+    // Matches depend on tile keywords ($zoom, $latitude, ...)
+    m_ruleSet.clearMatchCache();
     // update globals in JS context if changed ... should be doing atomic cmp xchg
     if(globalsGeneration < m_scene.globalsGeneration) {
       globalsGeneration = m_scene.globalsGeneration;
@@ -119,22 +414,63 @@ void TileBuilder::build(Tile& tile, const TileData& _tileData, const TileSource&
         if (builder.second) { builder.second->setup(tile); }
     }
 
-    for (const auto& datalayer : m_scene.layers()) {
-
-        if (datalayer.source() != _source.name() || !datalayer.enabled()) { continue; }
+    auto sourceLayersIt = m_sourceLayers.find(_source.name());
+    if (sourceLayersIt != m_sourceLayers.end()) {
+        const auto& sourceLayers = sourceLayersIt->second;
+        size_t numLayers = sourceLayers.dataLayers.size();
+
+        // Collect the tile's collections for each DataLayer, keeping the order of the tile data
+        m_layerCollections.resize(numLayers);
+        m_lazyCollections.resize(numLayers);
+        for (size_t i = 0; i < numLayers; i++) {
+            m_layerCollections[i].clear();
+            m_lazyCollections[i].clear();
+        }
 
         for (const auto& collection : _tileData.layers) {
+            // empty collection name matches all layers
+            if (collection.name.empty()) {
+                for (auto& layers : m_layerCollections) { layers.push_back(&collection); }
+                continue;
+            }
+            auto it = sourceLayers.collections.find(collection.name);
+            if (it == sourceLayers.collections.end()) { continue; }
+            for (size_t index : it->second) { m_layerCollections[index].push_back(&collection); }
+        }
 
-            if (!collection.name.empty()) {
-                const auto& dlc = datalayer.collections();
-                bool layerContainsCollection =
-                    std::find(dlc.begin(), dlc.end(), collection.name) != dlc.end();
-
-                if (!layerContainsCollection) { continue; }
+        m_numSharedLayers = 0;
+        for (const auto& collection : _tileData.lazyLayers) {
+            size_t numDataLayers = numLayers;
+            if (collection->name.empty()) {
+                for (auto& layers : m_lazyCollections) { layers.push_back(collection.get()); }
+            } else {
+                auto it = sourceLayers.collections.find(collection->name);
+                if (it == sourceLayers.collections.end()) { continue; }
+                for (size_t index : it->second) { m_lazyCollections[index].push_back(collection.get()); }
+                numDataLayers = it->second.size();
+            }
+            if (numDataLayers > 1) {
+                if (m_numSharedLayers == m_sharedLayers.size()) { m_sharedLayers.emplace_back(); }
+                decodeShared(*collection, m_sharedLayers[m_numSharedLayers++]);
             }
+        }
 
-            for (const auto& feat : collection.features) {
-                applyStyling(feat, datalayer);
+        for (size_t i = 0; i < numLayers; i++) {
+            const auto& datalayer = *sourceLayers.dataLayers[i];
+
+            for (const auto* collection : m_layerCollections[i]) {
+                for (const auto& feat : collection->features) {
+                    applyStyling(feat, datalayer);
+                }
+            }
+            for (auto* collection : m_lazyCollections[i]) {
+                auto shared = std::find_if(m_sharedLayers.begin(), m_sharedLayers.begin() + m_numSharedLayers,
+                                           [&](const SharedLazyLayer& _shared) { return _shared.layer == collection; });
+                if (shared != m_sharedLayers.begin() + m_numSharedLayers) {
+                    applyStyling(*shared, datalayer);
+                } else {
+                    applyStyling(*collection, datalayer);
+                }
             }
         }
     }
@@ -149,10 +485,20 @@ void TileBuilder::build(Tile& tile, const TileData& _tileData, const TileSource&
     m_labelLayout.process(tile.getID(), tile.getInverseScale(), tileSize);
 
     for (auto& builder : m_styleBuilder) {
+        if (isRestored(*builder.second)) { continue; }
         tile.setMesh(builder.second->style(), builder.second->build());
     }
 
+    if (useGeometryCache && !restored) { storeGeometry(tile, _source); }
+
     tile.setSelectionFeatures(m_selectionFeatures);
+
+    if (!m_selectionIndex->empty()) {
+        m_selectionIndex->build();
+        tile.setSelectionIndex(std::move(m_selectionIndex));
+    }
+
+    if (m_profiling) { m_scene.layerProfile()->merge(m_profile); }
 }
 
 }
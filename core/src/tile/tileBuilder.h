@@ -1,7 +1,10 @@
 #pragma once
 
+#include "data/tileData.h"
 #include "data/tileSource.h"
+#include "debug/layerProfile.h"
 #include "labels/labelCollider.h"
+#include "selection/selectionIndex.h"
 #include "scene/styleContext.h"
 #include "scene/drawRule.h"
 #include "style/style.h"
@@ -11,9 +14,7 @@ namespace Tangram {
 class DataLayer;
 class Tile;
 class TileSource;
-struct Feature;
 struct Properties;
-struct TileData;
 
 class TileBuilder {
 
@@ -23,7 +24,8 @@ public:
 
     StyleBuilder* getStyleBuilder(const std::string& _name);
 
-    void build(Tile& tile, const TileData& _tileData, const TileSource& _source);
+    // Build @tile from @_tileData; the LazyLayers of @_tileData are decoded in the process
+    void build(Tile& tile, TileData& _tileData, const TileSource& _source);
 
     const Scene& scene() const { return m_scene; }
 
@@ -37,6 +39,45 @@ private:
     // Determine and apply DrawRules for a @_feature
     void applyStyling(const Feature& _feature, const SceneLayer& _layer);
 
+    // Build @_feature of @_dataLayer with the rules matched by m_ruleSet
+    void addFeature(const Feature& _feature, const SceneLayer& _dataLayer);
+
+    // Add the time since @_start and a matched feature to the profile of @_dataLayer
+    void profileMatch(const SceneLayer& _dataLayer, LayerProfile::Clock::time_point _start,
+                      bool _matched);
+
+    // Apply DrawRules to features of @_layer, decoding geometry only for matched features
+    void applyStyling(LazyLayer& _layer, const SceneLayer& _sceneLayer);
+
+    // Features of a LazyLayer used by several DataLayers, whose properties are decoded once
+    // for all of them
+    struct SharedLazyLayer {
+        LazyLayer* layer = nullptr;
+        // Decoded features, reused across tiles; only the first numFeatures are of this tile
+        std::vector<Feature> features;
+        size_t numFeatures = 0;
+        // Whether the geometry of each feature was decoded
+        std::vector<bool> hasGeometry;
+    };
+
+    // Decode the properties of all features of @_layer into @_shared
+    void decodeShared(LazyLayer& _layer, SharedLazyLayer& _shared);
+
+    // Apply DrawRules to the features of @_shared, decoding geometry once for matched features
+    void applyStyling(SharedLazyLayer& _shared, const SceneLayer& _sceneLayer);
+
+    // Set meshes, selection features and their selection index geometry of @_tile from the
+    // Scene's TileGeometryCache and mark their styles as restored; returns false when the cache
+    // has no entry for the tile
+    bool restoreGeometry(Tile& _tile, const TileSource& _source);
+
+    // Store the meshes of cacheable styles in the Scene's TileGeometryCache
+    void storeGeometry(const Tile& _tile, const TileSource& _source);
+
+    bool isRestored(const StyleBuilder& _builder) const {
+        return m_restoredStyles[_builder.style().getID()];
+    }
+
     const Scene& m_scene;
 
     std::unique_ptr<StyleContext> m_styleContext;
@@ -48,6 +89,42 @@ private:
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilder;
 
     fastmap<uint32_t, std::shared_ptr<Properties>> m_selectionFeatures;
+    // Geometry of the selection features of the current tile, passed on to the tile
+    std::unique_ptr<SelectionIndex> m_selectionIndex;
+
+    // Enabled DataLayers of a TileSource and the collections they use
+    struct SourceLayers {
+        std::vector<const DataLayer*> dataLayers;
+        // collection name -> indices into dataLayers
+        fastmap<std::string, std::vector<size_t>> collections;
+    };
+    // TileSource name -> SourceLayers, set up in init()
+    fastmap<std::string, SourceLayers> m_sourceLayers;
+
+    // Reusable per-build lists of tile collections matching each DataLayer of the source
+    std::vector<std::vector<const Layer*>> m_layerCollections;
+    std::vector<std::vector<LazyLayer*>> m_lazyCollections;
+
+    // Reused for decoding features of LazyLayers
+    Feature m_lazyFeature;
+    // LazyLayers of the current tile used by several DataLayers, the first m_numSharedLayers
+    std::vector<SharedLazyLayer> m_sharedLayers;
+    size_t m_numSharedLayers = 0;
+
+    // Styles whose meshes can be serialized for the TileGeometryCache, by Style ID
+    std::vector<bool> m_cacheableStyles;
+    // Styles of which the current tile's meshes were restored from the TileGeometryCache
+    std::vector<bool> m_restoredStyles;
+    // Selection colors of features built with cacheable styles in the current tile
+    std::vector<uint32_t> m_cacheableSelection;
+    // Selection colors of features built only with cacheable styles, whose geometry in the
+    // selection index is stored with the tile's meshes
+    std::vector<uint32_t> m_cacheableIndex;
+
+    // Whether DebugFlags::layer_profile was set when the current tile build started
+    bool m_profiling = false;
+    // Costs of the current tile, merged into the Scene's LayerProfile after the build
+    LayerProfile::Batch m_profile;
 };
 
 }
@@ -0,0 +1,203 @@
+#include "tile/tileCache.h"
+
+#include "log.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+constexpr uint32_t TileCache::npos;
+constexpr int TileCache::evictionCandidates;
+
+void TileCache::put(int32_t _sourceId, std::shared_ptr<Tile> _tile, float _reuse) {
+    TileCacheKey k(_sourceId, _tile->getID());
+    size_t hash = std::hash<TileCacheKey>{}(k);
+
+    if (m_index.empty()) { growIndex(); }
+
+    size_t slot = findSlot(k, hash);
+    if (m_index[slot] != npos) {
+        remove(m_index[slot], slot);
+    }
+
+    uint32_t index = m_free;
+    if (index != npos) {
+        m_free = m_entries[index].next;
+    } else {
+        index = m_entries.size();
+        m_entries.emplace_back();
+    }
+
+    auto& entry = m_entries[index];
+    entry.key = k;
+    entry.hash = hash;
+    entry.size = _tile->getMemoryUsage();
+    // Build time in ms per KB, with a minimum cost for tiles of unknown build time
+    entry.value = m_clock + _reuse * (1.f + _tile->buildTime()) / (1.f + entry.size / 1024.f);
+    entry.tile = std::move(_tile);
+
+    insertSlot(index);
+    linkFront(index);
+    m_numEntries++;
+    m_cacheUsage += entry.size;
+
+    limitCacheSize(m_cacheMaxUsage);
+}
+
+std::shared_ptr<Tile> TileCache::get(int32_t _sourceId, TileID _tileId) {
+    TileCacheKey k(_sourceId, _tileId);
+    size_t slot = m_index.empty() ? 0 : findSlot(k, std::hash<TileCacheKey>{}(k));
+
+    if (m_index.empty() || m_index[slot] == npos) {
+        m_misses.add();
+        return nullptr;
+    }
+    m_hits.add();
+    return remove(m_index[slot], slot);
+}
+
+std::shared_ptr<Tile> TileCache::contains(int32_t _source, TileID _tileID) const {
+    if (m_index.empty()) { return nullptr; }
+
+    TileCacheKey k(_source, _tileID);
+    size_t slot = findSlot(k, std::hash<TileCacheKey>{}(k));
+
+    if (m_index[slot] == npos) { return nullptr; }
+    return m_entries[m_index[slot]].tile;
+}
+
+int64_t TileCache::oldestGeneration(int32_t _sourceId, int64_t _default) const {
+    int64_t oldest = _default;
+    for (uint32_t i = m_head; i != npos; i = m_entries[i].next) {
+        const auto& entry = m_entries[i];
+        if (entry.key.first == _sourceId) {
+            oldest = std::min(oldest, entry.tile->sourceGeneration());
+        }
+    }
+    return oldest;
+}
+
+void TileCache::limitCacheSize(size_t _cacheSizeBytes) {
+    m_cacheMaxUsage = _cacheSizeBytes;
+
+    while (m_cacheUsage > m_cacheMaxUsage) {
+        if (m_tail == npos) {
+            LOGE("Invalid cache state!");
+            m_cacheUsage = 0;
+            break;
+        }
+        evict();
+    }
+}
+
+void TileCache::clear() {
+    // Keep the allocated slab and index for reuse
+    m_entries.clear();
+    std::fill(m_index.begin(), m_index.end(), npos);
+    m_head = m_tail = m_free = npos;
+    m_numEntries = 0;
+    m_cacheUsage = 0;
+    m_clock = 0;
+}
+
+void TileCache::evict() {
+    uint32_t victim = m_tail;
+    int candidates = 0;
+
+    for (uint32_t i = m_tail; i != npos && candidates < evictionCandidates; i = m_entries[i].prev) {
+        if (m_entries[i].value < m_entries[victim].value) { victim = i; }
+        candidates++;
+    }
+
+    const auto& entry = m_entries[victim];
+    // Entries added from now on are valued above the evicted one, so that kept entries lose
+    // their advantage as other entries come and go. The victim is only the least valuable of
+    // the candidates, so the clock must not go back to it.
+    m_clock = std::max(m_clock, entry.value);
+
+    // Give the other candidates another round through the LRU list
+    for (uint32_t i = m_tail; i != npos && candidates-- > 0;) {
+        uint32_t prev = m_entries[i].prev;
+        if (i != victim) {
+            unlink(i);
+            linkFront(i);
+        }
+        i = prev;
+    }
+    remove(victim, findSlot(entry.key, entry.hash));
+    m_evictions.add();
+}
+
+std::shared_ptr<Tile> TileCache::remove(uint32_t _entry, size_t _slot) {
+    auto& entry = m_entries[_entry];
+    auto tile = std::move(entry.tile);
+
+    eraseSlot(_slot);
+    unlink(_entry);
+    m_numEntries--;
+    m_cacheUsage -= entry.size;
+
+    entry.next = m_free;
+    m_free = _entry;
+
+    return tile;
+}
+
+size_t TileCache::findSlot(const TileCacheKey& _key, size_t _hash) const {
+    size_t mask = m_index.size() - 1;
+    for (size_t slot = _hash & mask;; slot = (slot + 1) & mask) {
+        uint32_t index = m_index[slot];
+        if (index == npos || m_entries[index].key == _key) { return slot; }
+    }
+}
+
+void TileCache::insertSlot(uint32_t _entry) {
+    // Keep the index at most half full
+    if ((m_numEntries + 1) * 2 > m_index.size()) { growIndex(); }
+
+    size_t slot = findSlot(m_entries[_entry].key, m_entries[_entry].hash);
+    m_index[slot] = _entry;
+}
+
+void TileCache::eraseSlot(size_t _slot) {
+    size_t mask = m_index.size() - 1;
+
+    // Move following entries of the probe sequence into the gap
+    for (size_t next = (_slot + 1) & mask; m_index[next] != npos; next = (next + 1) & mask) {
+        size_t home = m_entries[m_index[next]].hash & mask;
+        // Entry can move to the gap unless its home lies cyclically in (_slot, next]
+        bool keep = (_slot < next) ? (home > _slot && home <= next) : (home > _slot || home <= next);
+        if (!keep) {
+            m_index[_slot] = m_index[next];
+            _slot = next;
+        }
+    }
+    m_index[_slot] = npos;
+}
+
+void TileCache::growIndex() {
+    size_t size = std::max<size_t>(64, m_index.size() * 2);
+    m_index.assign(size, npos);
+
+    for (uint32_t i = m_head; i != npos; i = m_entries[i].next) {
+        m_index[findSlot(m_entries[i].key, m_entries[i].hash)] = i;
+    }
+}
+
+void TileCache::linkFront(uint32_t _entry) {
+    auto& entry = m_entries[_entry];
+    entry.prev = npos;
+    entry.next = m_head;
+    if (m_head != npos) { m_entries[m_head].prev = _entry; }
+    m_head = _entry;
+    if (m_tail == npos) { m_tail = _entry; }
+}
+
+void TileCache::unlink(uint32_t _entry) {
+    auto& entry = m_entries[_entry];
+    if (entry.prev != npos) { m_entries[entry.prev].next = entry.next; } else { m_head = entry.next; }
+    if (entry.next != npos) { m_entries[entry.next].prev = entry.prev; } else { m_tail = entry.prev; }
+    entry.prev = entry.next = npos;
+}
+
+}
@@ -4,10 +4,10 @@
 #include "tile/tile.h"
 #include "tile/tileHash.h"
 #include "tile/tileID.h"
+#include "util/stats.h"
 
-#include <list>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 namespace Tangram {
 // TileSet serial + TileID
@@ -28,14 +28,18 @@ namespace std {
 
 namespace Tangram {
 
+/* Cache of built tiles which are no longer visible
+ *
+ * Entries live in a slab of slots that is reused after removal, linked in LRU order by slot
+ * index and found through an open addressing index, so that once the cache has grown to its
+ * working size, put() and get() do not allocate.
+ *
+ * When the cache is full, the least valuable of the least recently used entries is evicted, as
+ * in GreedyDual-Size: an entry is valued at its build time and likelihood of reuse per byte,
+ * plus the highest value of evicted entries at the time it was added. Tiles which are expensive
+ * to rebuild thus stay longer, but not forever.
+ */
 class TileCache {
-    struct CacheEntry {
-        TileCacheKey key;
-        std::shared_ptr<Tile> tile;
-    };
-
-    using CacheList = std::list<CacheEntry>;
-    using CacheMap = std::unordered_map<TileCacheKey, typename CacheList::iterator>;
 
 public:
 
@@ -43,81 +47,88 @@ public:
         m_cacheUsage(0),
         m_cacheMaxUsage(_cacheSizeMB) {}
 
-    void put(int32_t _sourceId, std::shared_ptr<Tile> _tile) {
-        TileCacheKey k(_sourceId, _tile->getID());
+    /* Add @_tile, with @_reuse the relative likelihood that it will be needed again, e.g.
+     * higher for parents of visible tiles which serve as proxies */
+    void put(int32_t _sourceId, std::shared_ptr<Tile> _tile, float _reuse = 1.f);
 
-        m_cacheList.push_front({k, _tile});
-        m_cacheMap[k] = m_cacheList.begin();
-        m_cacheUsage += _tile->getMemoryUsage();
+    /* Remove the tile from the cache and return it */
+    std::shared_ptr<Tile> get(int32_t _sourceId, TileID _tileId);
 
-        limitCacheSize(m_cacheMaxUsage);
-    }
+    /* Return the tile if it is cached, keeping it in the cache */
+    std::shared_ptr<Tile> contains(int32_t _source, TileID _tileID) const;
 
-    std::shared_ptr<Tile> get(int32_t _sourceId, TileID _tileId) {
-        std::shared_ptr<Tile> tile;
-        TileCacheKey k(_sourceId, _tileId);
-
-        auto it = m_cacheMap.find(k);
-        if (it != m_cacheMap.end()) {
-            std::swap(tile, (*(it->second)).tile);
-            m_cacheList.erase(it->second);
-            m_cacheMap.erase(it);
-            m_cacheUsage -= tile->getMemoryUsage();
-        }
-        return tile;
+    /* Lowest source generation of the cached tiles of @_sourceId, or @_default if there are none */
+    int64_t oldestGeneration(int32_t _sourceId, int64_t _default) const;
+
+    size_t cacheSizeLimit() const { return m_cacheMaxUsage; }
+
+    void limitCacheSize(size_t _cacheSizeBytes);
+
+    size_t getMemoryUsage() const { return m_cacheUsage; }
+
+    size_t getNumEntries() const { return m_numEntries; }
+
+    void getStats(MapStats& _stats) const {
+        _stats.tileCacheHits = m_hits.get();
+        _stats.tileCacheMisses = m_misses.get();
+        _stats.tileCacheEvictions = m_evictions.get();
+        _stats.tileCacheEntries = m_numEntries;
+        _stats.tileCacheBytes = m_cacheUsage;
     }
 
-    std::shared_ptr<Tile> contains(int32_t _source, TileID _tileID) {
+    void clear();
+
+private:
+
+    static constexpr uint32_t npos = uint32_t(-1);
+
+    // Number of least recently used entries compared for eviction
+    static constexpr int evictionCandidates = 8;
+
+    struct CacheEntry {
+        TileCacheKey key = { 0, TileID(0, 0, 0) };
+        size_t hash = 0;
         std::shared_ptr<Tile> tile;
-        TileCacheKey k(_source, _tileID);
+        size_t size = 0;
+        // Value of keeping the tile, see put()
+        float value = 0;
+        // More and less recently used neighbours, next free slot for unused entries
+        uint32_t prev = npos;
+        uint32_t next = npos;
+    };
 
-        auto it = m_cacheMap.find(k);
-        if (it != m_cacheMap.end()) {
-            return it->second->tile;
-        }
-        return nullptr;
-    }
+    // Position of @_key in m_index, or of the empty slot where it would be inserted
+    size_t findSlot(const TileCacheKey& _key, size_t _hash) const;
 
-    size_t cacheSizeLimit() const { return m_cacheMaxUsage; }
+    void insertSlot(uint32_t _entry);
+    void eraseSlot(size_t _slot);
+    void growIndex();
 
-    void limitCacheSize(size_t _cacheSizeBytes) {
-        m_cacheMaxUsage = _cacheSizeBytes;
-
-        while (m_cacheUsage > m_cacheMaxUsage) {
-            if (m_cacheList.empty()) {
-                LOGE("Invalid cache state!");
-                m_cacheUsage = 0;
-                break;
-            }
-            auto& tile = m_cacheList.back().tile;
-            m_cacheUsage -= tile->getMemoryUsage();
-            m_cacheMap.erase(m_cacheList.back().key);
-            m_cacheList.pop_back();
-        }
-    }
+    void linkFront(uint32_t _entry);
+    void unlink(uint32_t _entry);
 
-    size_t getMemoryUsage() const {
-        size_t sum = 0;
-        for (auto& entry : m_cacheList) {
-            sum += entry.tile->getMemoryUsage();
-        }
-        return sum;
-    }
+    // Remove the entry from the cache and return its tile
+    std::shared_ptr<Tile> remove(uint32_t _entry, size_t _slot);
 
-    size_t getNumEntries() const { return m_cacheList.size(); }
+    void evict();
 
-    void clear() {
-        m_cacheMap.clear();
-        m_cacheList.clear();
-        m_cacheUsage = 0;
-    }
+    std::vector<CacheEntry> m_entries;
+    // Entry indices by hash with linear probing; the size is a power of two
+    std::vector<uint32_t> m_index;
 
-private:
-    CacheMap m_cacheMap;
-    CacheList m_cacheList;
+    uint32_t m_head = npos;
+    uint32_t m_tail = npos;
+    uint32_t m_free = npos;
+    size_t m_numEntries = 0;
+    // Highest value of evicted entries
+    float m_clock = 0;
 
     size_t m_cacheUsage;
     size_t m_cacheMaxUsage;
+
+    StatCounter m_hits;
+    StatCounter m_misses;
+    StatCounter m_evictions;
 };
 
 }
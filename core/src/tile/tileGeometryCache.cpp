@@ -0,0 +1,396 @@
+#include "tile/tileGeometryCache.h"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+#include "log.h"
+#include "util/mappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#endif
+
+namespace Tangram {
+
+namespace {
+
+constexpr uint32_t magic = 0x31434754; // "TGC1"
+// Increment when the entry or mesh format or the geometry built by styles changes
+constexpr uint32_t version = 2;
+
+const std::string filePrefix = "geometry-";
+const std::string fileSuffix = ".tgc";
+
+// FNV-1a, stable across runs and platforms unlike std::hash
+uint64_t hashString(const std::string& _string) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : _string) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+bool hasPrefix(const std::string& _s, const std::string& _prefix) {
+    return _s.size() >= _prefix.size() && _s.compare(0, _prefix.size(), _prefix) == 0;
+}
+
+bool hasSuffix(const std::string& _s, const std::string& _suffix) {
+    return _s.size() >= _suffix.size() &&
+        _s.compare(_s.size() - _suffix.size(), _suffix.size(), _suffix) == 0;
+}
+
+struct Writer {
+    std::vector<char>& out;
+
+    template<typename T>
+    void put(T _value) { bytes(&_value, sizeof(T)); }
+
+    void bytes(const void* _data, size_t _size) {
+        auto* bytes = static_cast<const char*>(_data);
+        out.insert(out.end(), bytes, bytes + _size);
+    }
+
+    void string(const std::string& _string) {
+        put(uint32_t(_string.size()));
+        bytes(_string.data(), _string.size());
+    }
+};
+
+// Reads values until the end of data, after which ok is false and values are zero
+struct Reader {
+    const char* pos;
+    const char* end;
+    bool ok = true;
+
+    template<typename T>
+    T get() {
+        T value{};
+        if (const char* data = bytes(sizeof(T))) { std::memcpy(&value, data, sizeof(T)); }
+        return value;
+    }
+
+    const char* bytes(size_t _size) {
+        if (!ok || size_t(end - pos) < _size) {
+            ok = false;
+            return nullptr;
+        }
+        const char* data = pos;
+        pos += _size;
+        return data;
+    }
+
+    // Number of following records of at least @_minSize bytes each; larger counts than the
+    // remaining data can hold are invalid
+    uint32_t count(size_t _minSize) {
+        uint32_t n = get<uint32_t>();
+        if (n > size_t(end - pos) / _minSize) {
+            ok = false;
+            return 0;
+        }
+        return n;
+    }
+
+    std::string string() {
+        uint32_t size = get<uint32_t>();
+        const char* data = bytes(size);
+        return data ? std::string(data, size) : std::string();
+    }
+};
+
+enum ValueType : uint8_t { none_value, double_value, string_value };
+
+}
+
+TileGeometryCache::TileGeometryCache(std::string _directory, const std::string& _sceneContent,
+                                     size_t _maxSize, int64_t _maxAge)
+    : m_directory(std::move(_directory)),
+      m_sceneHash(hashString(_sceneContent)),
+      m_maxSize(_maxSize),
+      m_maxAge(_maxAge) {
+
+    scanDirectory();
+}
+
+std::string TileGeometryCache::fileName(const std::string& _source, const TileID& _tileID) const {
+    char name[128];
+    snprintf(name, sizeof(name), "%016llx-%08x-%d-%d-%d-%d",
+             (unsigned long long)m_sceneHash, uint32_t(hashString(_source)),
+             int(_tileID.z), int(_tileID.s), _tileID.x, _tileID.y);
+    return filePrefix + name + fileSuffix;
+}
+
+void TileGeometryCache::put(const std::string& _source, const TileID& _tileID, float _pixelScale,
+                            const Meshes& _meshes, const SelectionFeatures& _selection,
+                            const std::vector<char>& _selectionIndex) {
+
+    std::vector<char> data;
+    Writer out{data};
+
+    out.put(magic);
+    out.put(version);
+    out.put(m_sceneHash);
+    out.put(_tileID.x);
+    out.put(_tileID.y);
+    out.put(int32_t(_tileID.z));
+    out.put(int32_t(_tileID.s));
+    out.put(_pixelScale);
+    out.put(int64_t(std::time(nullptr)));
+
+    out.put(uint32_t(_meshes.size()));
+    for (auto& mesh : _meshes) {
+        out.put(mesh.first);
+        out.put(uint32_t(mesh.second.size()));
+        out.bytes(mesh.second.data(), mesh.second.size());
+    }
+
+    out.put(uint32_t(_selection.size()));
+    for (auto& feature : _selection) {
+        out.put(feature.first);
+        auto& items = feature.second->items();
+        out.put(uint32_t(items.size()));
+        for (auto& item : items) {
+            out.string(item.key.str());
+            if (item.value.is<double>()) {
+                out.put(double_value);
+                out.put(item.value.get<double>());
+            } else if (item.value.is<std::string>()) {
+                out.put(string_value);
+                out.string(item.value.get<std::string>());
+            } else {
+                out.put(none_value);
+            }
+        }
+    }
+
+    out.put(uint32_t(_selectionIndex.size()));
+    out.bytes(_selectionIndex.data(), _selectionIndex.size());
+
+    // Write to a temporary file first, so that readers never see a partial entry
+    auto name = fileName(_source, _tileID);
+    auto path = m_directory + name;
+    auto thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    auto tmpPath = path + "." + std::to_string(thread) + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ofstream::binary | std::ofstream::trunc);
+        if (!file.write(data.data(), data.size())) {
+            LOGW("Failed to write tile geometry cache file: %s", tmpPath.c_str());
+            file.close();
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        // Renaming does not replace existing files on all platforms
+        std::remove(path.c_str());
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+
+    std::vector<std::string> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        touch(name, data.size());
+        evicted = evict();
+    }
+    for (auto& file : evicted) {
+        std::remove((m_directory + file).c_str());
+    }
+}
+
+bool TileGeometryCache::get(const std::string& _source, const TileID& _tileID, float _pixelScale,
+                            const MeshReader& _readMesh, SelectionFeatures& _selection,
+                            std::vector<char>& _selectionIndex) {
+
+    auto name = fileName(_source, _tileID);
+    MappedFile file(m_directory + name);
+
+    if (!file.data()) {
+        m_misses.add();
+        return false;
+    }
+
+    Reader in{file.data(), file.data() + file.size()};
+
+    bool valid = (in.get<uint32_t>() == magic &&
+                  in.get<uint32_t>() == version &&
+                  in.get<uint64_t>() == m_sceneHash &&
+                  in.get<int32_t>() == _tileID.x &&
+                  in.get<int32_t>() == _tileID.y &&
+                  in.get<int32_t>() == _tileID.z &&
+                  in.get<int32_t>() == _tileID.s);
+
+    float pixelScale = in.get<float>();
+    int64_t created = in.get<int64_t>();
+
+    bool expired = m_maxAge > 0 && int64_t(std::time(nullptr)) - created > m_maxAge;
+
+    // Entry of another pixel scale is replaced once the tile is built
+    if (valid && !expired && pixelScale != _pixelScale) {
+        m_misses.add();
+        return false;
+    }
+
+    struct StyleMesh { uint32_t styleId; const char* data; uint32_t size; };
+    // Style id and size
+    std::vector<StyleMesh> meshes(valid ? in.count(2 * sizeof(uint32_t)) : 0);
+    for (auto& mesh : meshes) {
+        mesh.styleId = in.get<uint32_t>();
+        mesh.size = in.get<uint32_t>();
+        mesh.data = in.bytes(mesh.size);
+    }
+
+    SelectionFeatures selection;
+    // Color and number of items
+    uint32_t numFeatures = valid ? in.count(2 * sizeof(uint32_t)) : 0;
+    for (uint32_t i = 0; i < numFeatures && in.ok; i++) {
+        uint32_t color = in.get<uint32_t>();
+        // Key size and value type
+        uint32_t numItems = in.count(sizeof(uint32_t) + sizeof(uint8_t));
+
+        std::vector<Properties::Item> items;
+        for (uint32_t j = 0; j < numItems && in.ok; j++) {
+            auto key = in.string();
+            switch (in.get<uint8_t>()) {
+            case double_value:
+                items.emplace_back(key, in.get<double>());
+                break;
+            case string_value:
+                items.emplace_back(key, in.string());
+                break;
+            default:
+                items.emplace_back(key, Value());
+            }
+        }
+        selection[color] = std::make_shared<Properties>(std::move(items));
+    }
+
+    uint32_t indexSize = valid ? in.get<uint32_t>() : 0;
+    const char* index = in.bytes(indexSize);
+
+    valid = valid && !expired && in.ok;
+    for (size_t i = 0; valid && i < meshes.size(); i++) {
+        valid = _readMesh(meshes[i].styleId, meshes[i].data, meshes[i].size);
+    }
+
+    if (!valid) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            remove(name);
+        }
+        std::remove((m_directory + name).c_str());
+        m_misses.add();
+        return false;
+    }
+
+    for (auto& feature : selection) {
+        _selection[feature.first] = std::move(feature.second);
+    }
+    _selectionIndex.assign(index, index + indexSize);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        touch(name, file.size());
+    }
+#ifndef _WIN32
+    // Entries of earlier runs are ordered by modification time, see scanDirectory()
+    utime((m_directory + name).c_str(), nullptr);
+#endif
+    m_hits.add();
+    return true;
+}
+
+size_t TileGeometryCache::getUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+void TileGeometryCache::getStats(MapStats& _stats) const {
+    _stats.geometryCacheHits = m_hits.get();
+    _stats.geometryCacheMisses = m_misses.get();
+    _stats.geometryCacheBytes = getUsage();
+}
+
+void TileGeometryCache::touch(const std::string& _name, size_t _size) {
+    auto it = m_files.find(_name);
+    if (it == m_files.end()) {
+        m_lru.push_front(_name);
+        m_files.emplace(_name, File{ m_lru.begin(), _size });
+    } else {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+        m_usage -= it->second.size;
+        it->second.size = _size;
+    }
+    m_usage += _size;
+}
+
+void TileGeometryCache::remove(const std::string& _name) {
+    auto it = m_files.find(_name);
+    if (it == m_files.end()) { return; }
+
+    m_usage -= it->second.size;
+    m_lru.erase(it->second.lru);
+    m_files.erase(it);
+}
+
+std::vector<std::string> TileGeometryCache::evict() {
+    std::vector<std::string> evicted;
+    // Keep the most recent file even if it exceeds the limit by itself
+    while (m_usage > m_maxSize && m_lru.size() > 1) {
+        evicted.push_back(m_lru.back());
+        remove(m_lru.back());
+    }
+    return evicted;
+}
+
+void TileGeometryCache::scanDirectory() {
+#ifndef _WIN32
+    DIR* dir = opendir(m_directory.empty() ? "." : m_directory.c_str());
+    if (!dir) { return; }
+
+    struct Entry { std::string name; size_t size; time_t mtime; };
+    std::vector<Entry> entries;
+
+    while (struct dirent* dirent = readdir(dir)) {
+        std::string name = dirent->d_name;
+        if (!hasPrefix(name, filePrefix)) { continue; }
+
+        if (hasSuffix(name, ".tmp")) {
+            // Left behind by an interrupted write
+            std::remove((m_directory + name).c_str());
+            continue;
+        }
+        struct stat st;
+        if (hasSuffix(name, fileSuffix) && stat((m_directory + name).c_str(), &st) == 0) {
+            entries.push_back({ name, size_t(st.st_size), st.st_mtime });
+        }
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end(),
+              [](auto& a, auto& b) { return a.mtime < b.mtime; });
+
+    std::vector<std::string> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& entry : entries) { touch(entry.name, entry.size); }
+        evicted = evict();
+    }
+    for (auto& file : evicted) {
+        std::remove((m_directory + file).c_str());
+    }
+#endif
+}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "tile/tileID.h"
+#include "util/fastmap.h"
+#include "util/stats.h"
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+struct Properties;
+
+/* Persistent cache of built tile geometry
+ *
+ * Stores the serialized meshes which TileBuilder built for a tile, together with the properties
+ * and SelectionIndex geometry of the selectable features they reference, in one file per tile
+ * under the cache directory.
+ * File names include a hash of the scene configuration, so that a changed scene never uses
+ * entries of another. Entries are read through mmap where available.
+ *
+ * Files of all scenes share the size limit and are removed in least recently used order, taking
+ * the modification time of files from earlier runs as their last use.
+ */
+class TileGeometryCache {
+
+public:
+
+    using SelectionFeatures = fastmap<uint32_t, std::shared_ptr<Properties>>;
+
+    // Serialized meshes by Style ID, empty for styles without geometry in the tile
+    using Meshes = std::vector<std::pair<uint32_t, std::vector<char>>>;
+
+    // Called with the serialized mesh of each style of an entry; returns false to reject the entry
+    using MeshReader = std::function<bool(uint32_t _styleId, const char* _data, size_t _size)>;
+
+    /* Cache in @_directory for tiles of the scene with configuration @_sceneContent, keeping
+     * files within @_maxSize bytes and using entries which are at most @_maxAge seconds old */
+    TileGeometryCache(std::string _directory, const std::string& _sceneContent,
+                      size_t _maxSize, int64_t _maxAge);
+
+    /* Store @_meshes, the @_selection features they reference and the serialized
+     * SelectionIndex geometry @_selectionIndex of these features for @_tileID of @_source,
+     * built at @_pixelScale */
+    void put(const std::string& _source, const TileID& _tileID, float _pixelScale,
+             const Meshes& _meshes, const SelectionFeatures& _selection,
+             const std::vector<char>& _selectionIndex = {});
+
+    /* Pass the meshes of the entry for @_tileID of @_source to @_readMesh, add its selection
+     * features to @_selection and set @_selectionIndex to their stored geometry; returns false
+     * when there is no valid entry */
+    bool get(const std::string& _source, const TileID& _tileID, float _pixelScale,
+             const MeshReader& _readMesh, SelectionFeatures& _selection,
+             std::vector<char>& _selectionIndex);
+
+    size_t getUsage() const;
+
+    void getStats(MapStats& _stats) const;
+
+private:
+
+    std::string fileName(const std::string& _source, const TileID& _tileID) const;
+
+    // Add the file to the front of the LRU list, or move it there
+    void touch(const std::string& _name, size_t _size);
+
+    void remove(const std::string& _name);
+
+    // Remove least recently used files from the index until the cache is within its size limit
+    // and return their names, for deleting the files outside of the lock
+    std::vector<std::string> evict();
+
+    // Find cache files of earlier runs
+    void scanDirectory();
+
+    const std::string m_directory;
+    const uint64_t m_sceneHash;
+    const size_t m_maxSize;
+    const int64_t m_maxAge;
+
+    mutable std::mutex m_mutex;
+    // File names, most recently used first
+    std::list<std::string> m_lru;
+    struct File {
+        std::list<std::string>::iterator lru;
+        size_t size;
+    };
+    std::unordered_map<std::string, File> m_files;
+    size_t m_usage = 0;
+
+    StatCounter m_hits;
+    StatCounter m_misses;
+};
+
+}
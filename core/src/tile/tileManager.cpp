@@ -1,7 +1,9 @@
 #include "tile/tileManager.h"
 
+#include "data/missingTileCache.h"
 #include "data/tileSource.h"
 #include "data/rasterSource.h"
+#include "debug/trace.h"
 #include "map.h"
 #include "platform.h"
 #include "tile/tile.h"
@@ -36,6 +38,9 @@ struct TileManager::TileEntry {
     // is tile in TileSet.visibleTiles?
     bool m_visible = false;
 
+    // is tile left empty because its source remembers a failed load?
+    bool m_missing = false;
+
     bool isInProgress() {
         return bool(task) && !task->isCanceled();
     }
@@ -202,8 +207,20 @@ void TileManager::clearTileSet(int32_t _sourceId) {
     m_tileSetChanged = true;
 }
 
+void TileManager::getStats(MapStats& _stats) const {
+    _stats.tilesInProgress = m_tilesInProgress;
+
+    m_tileCache->getStats(_stats);
+
+    for (const auto& tileSet : m_tileSets) {
+        _stats.sources.push_back(tileSet.source->getStats());
+    }
+}
+
 bool TileManager::updateTileSets(const View& _view) {
 
+    Trace::scope _trace("TileManager::updateTileSets");
+
     m_tiles.clear();
     m_tilesInProgress = 0;
     m_tileSetChanged = false;
@@ -317,8 +334,6 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
     auto curTilesIt = tiles.begin();
     auto visTilesIt = visibleTiles.begin();
 
-    auto generation = _tileSet.source->generation();
-
     while (visTilesIt != visibleTiles.end() || curTilesIt != tiles.end()) {
 
         auto& visTileId = visTilesIt == visibleTiles.end() ? NOT_A_TILE : *visTilesIt;
@@ -348,17 +363,29 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
             // Can be removed once ClientDataSource is immutable
             if (entry.tile) {
                 auto sourceGeneration = entry.tile->sourceGeneration();
-                if ((sourceGeneration < generation) && !entry.isInProgress()) {
-                    // Tile needs update - enqueue for loading
-                    entry.task = _tileSet.source->createTask(visTileId);
-                    enqueueTask(_tileSet, visTileId, _view);
+                if (!entry.isInProgress() && sourceGeneration < _tileSet.sourceGeneration) {
+                    if (_tileSet.source->tileChanged(visTileId, sourceGeneration)) {
+                        // Tile needs update - enqueue for loading
+                        entry.task = _tileSet.source->createTask(visTileId);
+                        enqueueTask(_tileSet, visTileId, _view);
+                    } else {
+                        // Not affected by the changes, so only later ones need to be checked
+                        entry.tile->setSourceGeneration(_tileSet.sourceGeneration);
+                    }
                 }
             } else if (entry.isCanceled()) {
                 auto sourceGeneration = entry.task->sourceGeneration();
-                if (sourceGeneration < generation) {
+                bool missing = _tileSet.source->missingTiles().contains(visTileId);
+                // Tiles left empty after a remembered failure are retried once it expired;
+                // other failures are not retried until the source changes
+                if (_tileSet.source->tileChanged(visTileId, sourceGeneration) ||
+                    (entry.m_missing && !missing)) {
                     // Tile needs update - enqueue for loading
                     entry.task = _tileSet.source->createTask(visTileId);
+                    entry.m_missing = false;
                     enqueueTask(_tileSet, visTileId, _view);
+                } else if (missing) {
+                    entry.m_missing = true;
                 }
             }
 
@@ -377,9 +404,16 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
             assert(visTilesIt != visibleTiles.end());
 
             if (!addTile(_tileSet, visTileId)) {
-                // Not in cache - enqueue for loading
-                enqueueTask(_tileSet, visTileId, _view);
-                m_tilesInProgress++;
+                if (_tileSet.source->missingTiles().contains(visTileId)) {
+                    // Loading failed recently - leave tile empty as after the failed load
+                    auto& entry = _tileSet.tiles.find(visTileId)->second;
+                    entry.task->cancel();
+                    entry.m_missing = true;
+                } else {
+                    // Not in cache - enqueue for loading
+                    enqueueTask(_tileSet, visTileId, _view);
+                    m_tilesInProgress++;
+                }
             }
 
             ++visTilesIt;
@@ -425,6 +459,9 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
         }
     }
 
+    // Generations of the tiles kept, which the source still needs to know about changes since
+    int64_t oldestGeneration = _tileSet.sourceGeneration, newestGeneration = 0;
+
     // add ready tiles to m_tiles and remove tiles not in visibleTiles and not being used as proxy
     for (curTilesIt = tiles.begin(); curTilesIt != tiles.end();) {
         auto& tileId = curTilesIt->first;
@@ -485,17 +522,27 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
                 task->setPriority(glm::length2(tileCenter - _view.center) * scaleDiv);
                 task->setProxyState(entry.m_proxyCounter > 0);
             }
+            if (entry.tile || entry.task) {
+                auto generation = entry.tile ? entry.tile->sourceGeneration() : entry.task->sourceGeneration();
+                oldestGeneration = std::min(oldestGeneration, generation);
+                newestGeneration = std::max(newestGeneration, generation);
+            }
             entry.m_proxyCounter = 0;  // reset for next update
             ++curTilesIt;
         } else {
             // Remove entry and move tile (if present) to cache
             if (entry.tile) {
-                m_tileCache->put(_tileSet.source->id(), entry.tile);
+                // Tiles below the current zoom are likely needed again as proxies
+                float reuse = curTilesIt->first.s < _view.zoom ? 2.f : 1.f;
+                m_tileCache->put(_tileSet.source->id(), entry.tile, reuse);
             }
             // Remove tile from set - this will call clearTask() and thus cancelLoadingTile() as appropriate
             curTilesIt = tiles.erase(curTilesIt);
         }
     }
+
+    oldestGeneration = m_tileCache->oldestGeneration(_tileSet.source->id(), oldestGeneration);
+    _tileSet.source->setLiveGenerations(oldestGeneration, newestGeneration);
 }
 
 void TileManager::enqueueTask(TileSet& _tileSet, const TileID& _tileID,
@@ -568,9 +615,10 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
     auto tile = m_tileCache->get(_tileSet.source->id(), _tileID);
 
     if (tile) {
-        if (tile->sourceGeneration() == _tileSet.source->generation()) {
+        if (!_tileSet.source->tileChanged(_tileID, tile->sourceGeneration())) {
             // Reset tile on potential internal dynamic data set
             tile->resetState();
+            tile->setSourceGeneration(std::max(tile->sourceGeneration(), _tileSet.sourceGeneration));
         } else {
             // Clear stale tile data
             tile.reset();
@@ -61,6 +61,9 @@ public:
 
     const std::unique_ptr<TileCache>& getTileCache() const { return m_tileCache; }
 
+    /* Add tiles in progress, tile cache and TileSource counters to @_stats */
+    void getStats(MapStats& _stats) const;
+
     /* @_cacheSize: Set size of in-memory tile cache in bytes.
      * This cache holds recently used <Tile>s that are ready for rendering.
      */
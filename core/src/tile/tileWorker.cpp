@@ -1,6 +1,7 @@
 #include "tile/tileWorker.h"
 
 #include "data/tileSource.h"
+#include "debug/trace.h"
 #include "log.h"
 #include "map.h"
 #include "platform.h"
@@ -15,6 +16,117 @@
 
 namespace Tangram {
 
+TileWorker::Entry::Entry(std::shared_ptr<TileTask> _task) : task(std::move(_task)) {
+    sourceId = task->sourceId();
+    sourceGeneration = task->sourceGeneration();
+    refresh();
+}
+
+void TileWorker::Entry::refresh() {
+    proxy = task->isProxy();
+    priority = task->getPriority();
+}
+
+bool TileWorker::Entry::before(const Entry& _other) const {
+    if (proxy != _other.proxy) {
+        return !proxy;
+    }
+    if (sourceId == _other.sourceId && sourceGeneration != _other.sourceGeneration) {
+        return sourceGeneration < _other.sourceGeneration;
+    }
+    return priority < _other.priority;
+}
+
+TileWorker::TaskQueue::~TaskQueue() {
+    clear();
+}
+
+void TileWorker::TaskQueue::place(size_t _position, Entry&& _entry) {
+    _entry.task->queuePosition = _position;
+    heap[_position] = std::move(_entry);
+}
+
+void TileWorker::TaskQueue::siftUp(size_t _position) {
+    Entry entry = std::move(heap[_position]);
+    while (_position > 0) {
+        size_t parent = (_position - 1) / 2;
+        if (!entry.before(heap[parent])) { break; }
+        place(_position, std::move(heap[parent]));
+        _position = parent;
+    }
+    place(_position, std::move(entry));
+}
+
+void TileWorker::TaskQueue::siftDown(size_t _position) {
+    Entry entry = std::move(heap[_position]);
+    size_t count = heap.size();
+    while (true) {
+        size_t child = 2 * _position + 1;
+        if (child >= count) { break; }
+        if (child + 1 < count && heap[child + 1].before(heap[child])) { child++; }
+        if (!heap[child].before(entry)) { break; }
+        place(_position, std::move(heap[child]));
+        _position = child;
+    }
+    place(_position, std::move(entry));
+}
+
+void TileWorker::TaskQueue::push(std::shared_ptr<TileTask>&& _task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    _task->setObserver(this);
+    heap.emplace_back(std::move(_task));
+    siftUp(heap.size() - 1);
+    size = heap.size();
+}
+
+void TileWorker::TaskQueue::priorityChanged(TileTask& _task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // The task may have been popped since the notification started
+    if (_task.observer() != this) { return; }
+    changed.push_back(&_task);
+}
+
+std::shared_ptr<TileTask> TileWorker::TaskQueue::pop(size_t& _dropped) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // TileManager updates priorities of pending tasks on view change - re-key only those tasks
+    for (auto* task : changed) {
+        // Tasks changed repeatedly are listed once for each change
+        size_t position = task->queuePosition;
+        heap[position].refresh();
+        siftUp(position);
+        siftDown(task->queuePosition);
+    }
+    changed.clear();
+
+    std::shared_ptr<TileTask> task;
+    while (!heap.empty()) {
+        task = std::move(heap.front().task);
+        task->setObserver(nullptr);
+        if (heap.size() > 1) {
+            place(0, std::move(heap.back()));
+            heap.pop_back();
+            siftDown(0);
+        } else {
+            heap.pop_back();
+        }
+        // canceled tasks are removed lazily once they reach the front
+        if (!task->isCanceled()) { break; }
+        task.reset();
+        _dropped++;
+    }
+    size = heap.size();
+    return task;
+}
+
+void TileWorker::TaskQueue::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : heap) { entry.task->setObserver(nullptr); }
+    heap.clear();
+    changed.clear();
+    size = 0;
+}
+
 TileWorker::TileWorker(Platform& _platform, int _numWorker) : m_platform(_platform) {
     m_running = true;
 
@@ -31,25 +143,51 @@ TileWorker::~TileWorker(){
     }
 }
 
+std::shared_ptr<TileTask> TileWorker::nextTask(Worker* instance) {
+
+    size_t dropped = 0;
+    auto task = instance->queue.pop(dropped);
+
+    // Own queue is empty: steal the next task of the busiest worker. A queue which only held
+    // canceled tasks is empty after the pop, so try the next busiest until none is left.
+    while (!task) {
+        Worker* victim = nullptr;
+        size_t victimSize = 0;
+        for (auto& worker : m_workers) {
+            size_t size = worker->queue.size;
+            if (worker.get() != instance && size > victimSize) {
+                victim = worker.get();
+                victimSize = size;
+            }
+        }
+        if (!victim) { break; }
+        task = victim->queue.pop(dropped);
+    }
+
+    m_pending -= dropped + (task ? 1 : 0);
+    Trace::counter("TileWorker::pending", m_pending);
+    return task;
+}
+
 void TileWorker::run(Worker* instance) {
 
     setCurrentThreadPriority(WORKER_NICENESS);
+    Trace::setThreadName("TileWorker");
 
     std::unique_ptr<TileBuilder> builder;
 
     while (true) {
-
-        std::shared_ptr<TileTask> task;
         {
             std::unique_lock<std::mutex> lock(m_mutex);
 
             m_condition.wait(lock, [&] {
-                return (!m_queue.empty() && m_sceneComplete) || !m_running || instance->tileBuilder;
+                return (m_pending > 0 && m_sceneComplete) || !m_running || instance->tileBuilder;
             });
 
             if (instance->tileBuilder) {
                 LOGTInit();
                 builder = std::move(instance->tileBuilder);
+                Trace::scope _trace("TileBuilder::init");
                 builder->init();
                 LOGT("Took init of TileBuilder");
             }
@@ -62,38 +200,27 @@ void TileWorker::run(Worker* instance) {
                 if (builder) LOGTO("Waiting for Scene to become ready");
                 continue;
             }
-
-            // Remove all canceled tasks
-            auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
-                                          [](const auto& a) { return a->isCanceled(); });
-
-            m_queue.erase(removes, m_queue.end());
-
-            if (m_queue.empty()) {
-                continue;
-            }
-
-            // Pop highest priority tile from queue
-            auto it = std::min_element(m_queue.begin(), m_queue.end(),
-                [](const auto& a, const auto& b) {
-                    if (a->isProxy() != b->isProxy()) {
-                        return !a->isProxy();
-                    }
-                    if (a->sourceId() == b->sourceId() &&
-                        a->sourceGeneration() != b->sourceGeneration()) {
-                        return a->sourceGeneration() < b->sourceGeneration();
-                    }
-                    return a->getPriority() < b->getPriority();
-                });
-
-            task = std::move(*it);
-            m_queue.erase(it);
         }
 
-        if (task->isCanceled()) { continue; }
+        auto task = nextTask(instance);
+        if (!task) {
+            // Queues were emptied by other workers or only held canceled tasks, which are not
+            // pending anymore - wait for the next enqueue
+            continue;
+        }
 
         LOGTInit(">>> process %s %s", task->source()->name().c_str(), task->tileId().toString().c_str());
+        Trace::begin("TileTask::process");
+        auto start = DurationCounter::Clock::now();
         task->process(*builder);
+        auto duration = DurationCounter::Clock::now() - start;
+        Trace::end("TileTask::process");
+
+        instance->busyTime.add(duration);
+        task->source()->buildTime().add(duration);
+        if (auto* tile = task->tile()) {
+            tile->setBuildTime(std::chrono::duration<float, std::milli>(duration).count());
+        }
         LOGT("<<< process %s %s", task->source()->name().c_str(), task->tileId().toString().c_str());
 
         m_platform.requestRender();
@@ -111,13 +238,27 @@ void TileWorker::setScene(Scene& _scene) {
 }
 
 void TileWorker::enqueue(std::shared_ptr<TileTask> task) {
+    if (!m_running || m_workers.empty()) { return; }
+
+    LOGTO("--- %d enqueue %s %s", m_pending+1, task->source()->name().c_str(), task->tileId().toString().c_str());
+
+    // Round-robin start, then prefer the shortest queue
+    size_t n = m_workers.size();
+    size_t start = m_nextWorker++ % n;
+    Worker* target = m_workers[start].get();
+    for (size_t i = 1; i < n && target->queue.size > 0; i++) {
+        Worker* worker = m_workers[(start + i) % n].get();
+        if (worker->queue.size < target->queue.size) { target = worker; }
+    }
+
+    // count before push so that m_pending never underflows when popped right away
+    m_pending++;
+    target->queue.push(std::move(task));
+
     {
+        // lock to not miss a worker that is about to wait
         std::unique_lock<std::mutex> lock(m_mutex);
-        if (!m_running) { return; }
-        LOGTO("--- %d enqueue %s %s", m_queue.size()+1, task->source()->name().c_str(), task->tileId().toString().c_str());
-        m_queue.push_back(std::move(task));
-
-        m_condition.notify_all();
+        m_condition.notify_one();
     }
 }
 
@@ -126,13 +267,20 @@ void TileWorker::startJobs() {
         std::unique_lock<std::mutex> lock(m_mutex);
         m_sceneComplete = true;
 
-        LOGTO("Poking TileWorker - enqueued %d", m_queue.size());
-        if (!m_running || m_queue.empty()) { return; }
+        LOGTO("Poking TileWorker - enqueued %d", m_pending.load());
+        if (!m_running || m_pending == 0) { return; }
 
         m_condition.notify_all();
     }
 }
 
+void TileWorker::getStats(MapStats& _stats) const {
+    _stats.tileWorkerPending = m_pending;
+    for (auto& worker : m_workers) {
+        _stats.tileWorkerBusyMs.push_back(worker->busyTime.get().totalMs);
+    }
+}
+
 void TileWorker::stop() {
     {
         std::unique_lock<std::mutex> lock(m_mutex);
@@ -144,7 +292,10 @@ void TileWorker::stop() {
         worker->thread.join();
     }
 
-    m_queue.clear();
+    for (auto& worker : m_workers) {
+        worker->queue.clear();
+    }
+    m_pending = 0;
 }
 
 }
@@ -2,6 +2,7 @@
 
 #include "tile/tileTask.h"
 #include "util/jobQueue.h"
+#include "util/stats.h"
 
 #include <atomic>
 #include <condition_variable>
@@ -37,26 +38,80 @@ public:
     /// Start jobs when scene is complete.
     void startJobs();
 
+    /// Number of tasks waiting in all worker queues
+    size_t pendingTasks() const { return m_pending; }
+
+    /// Add queue depth and busy time of the workers to _stats
+    void getStats(MapStats& _stats) const;
+
 private:
 
+    /// Queue entry with the task's ordering key captured at (re)insertion, so heap operations don't
+    /// read atomics that the main thread keeps changing; keys of changed tasks are refreshed on the
+    /// next pop (see TaskQueue::priorityChanged)
+    struct Entry {
+        std::shared_ptr<TileTask> task;
+        int64_t sourceId;
+        int64_t sourceGeneration;
+        double priority;
+        bool proxy;
+
+        explicit Entry(std::shared_ptr<TileTask> _task);
+        void refresh();
+        // true if this entry should be processed before _other
+        bool before(const Entry& _other) const;
+    };
+
+    /// Per-worker binary heap of tasks; front is the next task to process. Tasks know their
+    /// position in the heap, so that only the tasks whose priority changed are re-sorted.
+    struct TaskQueue : TileTask::Observer {
+        std::mutex mutex;
+        std::vector<Entry> heap;
+        // Queued tasks whose priority or proxy state changed since the last pop
+        std::vector<TileTask*> changed;
+        std::atomic<size_t> size{0};
+
+        ~TaskQueue();
+
+        void push(std::shared_ptr<TileTask>&& _task);
+        // Pop next task, dropping canceled ones; returns number of tasks dropped in _dropped
+        std::shared_ptr<TileTask> pop(size_t& _dropped);
+        void clear();
+
+        void priorityChanged(TileTask& _task) override;
+
+    private:
+        void place(size_t _position, Entry&& _entry);
+        void siftUp(size_t _position);
+        void siftDown(size_t _position);
+    };
+
     struct Worker {
         std::thread thread;
         std::unique_ptr<TileBuilder> tileBuilder;
+        TaskQueue queue;
+        DurationCounter busyTime;
     };
 
     void run(Worker* instance);
 
-    bool m_running;
+    /// Pop from own queue or, if empty, steal from the other workers
+    std::shared_ptr<TileTask> nextTask(Worker* instance);
+
+    std::atomic<bool> m_running;
 
     /// Set true by startJobs()
-    bool m_sceneComplete = false;
+    std::atomic<bool> m_sceneComplete{false};
 
     std::vector<std::unique_ptr<Worker>> m_workers;
 
+    /// Only used to put idle workers to sleep; task queues have their own locks
     std::condition_variable m_condition;
-
     std::mutex m_mutex;
-    std::vector<std::shared_ptr<TileTask>> m_queue;
+
+    /// Total number of queued tasks across all workers
+    std::atomic<size_t> m_pending{0};
+    std::atomic<uint32_t> m_nextWorker{0};
 
     Platform& m_platform;
 };
@@ -1,13 +1,16 @@
 #pragma once
 
+#include "debug/trace.h"
+
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <thread>
 #include <functional>
 #include <atomic>
-#ifdef DEBUG
 #include <string>
+#ifdef DEBUG
 #include <cassert>
 #endif
 
@@ -24,7 +27,7 @@ public:
         assert(_tag && _tag[0] && "AsyncWorker requires identifying tag!");
         m_tag = _tag;
 #endif
-        thread = std::thread(&AsyncWorker::run, this);
+        thread = std::thread(&AsyncWorker::run, this, std::string(_tag ? _tag : "AsyncWorker"));
     }
 
     ~AsyncWorker() {
@@ -49,14 +52,31 @@ public:
     void waitForCompletion() {
         m_waitForCompletion = true;
     }
+
+    // Run @_task on the worker once its queue stayed empty for @_delay after other tasks ran
+    void setIdleTask(std::chrono::milliseconds _delay, std::function<void()> _task) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idleDelay = _delay;
+        m_idleTask = std::move(_task);
+    }
 private:
 
-    void run() {
+    void run(std::string _tag) {
+        Trace::setThreadName(_tag.c_str());
+
         while (true) {
             std::function<void()> task;
             {
                 std::unique_lock<std::mutex> lock(m_mutex);
-                m_condition.wait(lock, [&]{ return !m_running || !m_queue.empty(); });
+                auto ready = [&]{ return !m_running || !m_queue.empty(); };
+                if (m_idlePending && m_idleTask) {
+                    if (!m_condition.wait_for(lock, m_idleDelay, ready)) {
+                        m_idlePending = false;
+                        task = m_idleTask;
+                    }
+                } else {
+                    m_condition.wait(lock, ready);
+                }
 
                 if (!m_running) {
                     if (!m_waitForCompletion) {
@@ -66,8 +86,11 @@ private:
                     }
                 }
 
-                task = std::move(m_queue.front());
-                m_queue.pop_front();
+                if (!task) {
+                    task = std::move(m_queue.front());
+                    m_queue.pop_front();
+                    m_idlePending = true;
+                }
             }
             task();
         }
@@ -79,6 +102,9 @@ private:
     std::condition_variable m_condition;
     std::mutex m_mutex;
     std::deque<std::function<void()>> m_queue;
+    std::function<void()> m_idleTask;
+    std::chrono::milliseconds m_idleDelay {0};
+    bool m_idlePending = false;
 };
 
 }
@@ -5,6 +5,8 @@
 #include "glm/gtx/rotate_vector.hpp"
 #include "glm/gtx/norm.hpp"
 
+#include <cmath>
+
 namespace mapbox { namespace util {
 template <>
 struct nth<0, Tangram::Point> {
@@ -14,22 +16,31 @@ template <>
 struct nth<1, Tangram::Point> {
     inline static float get(const Tangram::Point &t) { return t.y; };
 };
+template <>
+struct nth<0, Tangram::QuantizedPoint> {
+    inline static int16_t get(const Tangram::QuantizedPoint &t) { return t.x; };
+};
+template <>
+struct nth<1, Tangram::QuantizedPoint> {
+    inline static int16_t get(const Tangram::QuantizedPoint &t) { return t.y; };
+};
 }}
 
 namespace {
+
+// tweak this adjust if catching too few/many line segments near tile edges
+// TODO: make tolerance configurable by source if necessary
+constexpr float tileEdgeTolerance = 0.0005f;
+constexpr float tileMin = 0.0f + tileEdgeTolerance;
+constexpr float tileMax = 1.0f - tileEdgeTolerance;
+
 // Tests if a line segment (from point A to B) is outside the edge of a tile
 bool isOutsideTile(const glm::vec2& _a, const glm::vec2& _b) {
 
-    // tweak this adjust if catching too few/many line segments near tile edges
-    // TODO: make tolerance configurable by source if necessary
-    float tolerance = 0.0005f;
-    float tile_min = 0.0f + tolerance;
-    float tile_max = 1.0f - tolerance;
-
-    if ( (_a.x < tile_min && _b.x < tile_min) ||
-         (_a.x > tile_max && _b.x > tile_max) ||
-         (_a.y < tile_min && _b.y < tile_min) ||
-         (_a.y > tile_max && _b.y > tile_max) ) {
+    if ( (_a.x < tileMin && _b.x < tileMin) ||
+         (_a.x > tileMax && _b.x > tileMax) ||
+         (_a.y < tileMin && _b.y < tileMin) ||
+         (_a.y > tileMax && _b.y > tileMax) ) {
         return true;
     }
 
@@ -37,12 +48,53 @@ bool isOutsideTile(const glm::vec2& _a, const glm::vec2& _b) {
 }
 
 bool isOutsideTile(const glm::vec2& p) {
-    float tolerance = 0.0005f;
-    float tile_min = 0.0f + tolerance;
-    float tile_max = 1.0f - tolerance;
-    return ((p.x < tile_min) || (p.x > tile_max) ||
-            (p.y < tile_min) || (p.y > tile_max));
+    return ((p.x < tileMin) || (p.x > tileMax) ||
+            (p.y < tileMin) || (p.y > tileMax));
 }
+
+// Access to the coordinates of Line and Polygon
+struct TileCoordinates {
+    glm::vec2 operator()(const Tangram::Point& _p) const { return _p; }
+
+    bool isOutside(const Tangram::Point& _a, const Tangram::Point& _b) const { return isOutsideTile(_a, _b); }
+    bool isOutside(const Tangram::Point& _p) const { return isOutsideTile(_p); }
+};
+
+// Access to the coordinates of QuantizedLine and QuantizedPolygon: tile edge tests are done on
+// integer bounds, which give the same results as isOutsideTile() on the converted coordinates
+struct QuantizedCoordinates {
+    double scale;
+    int min;
+    int max;
+
+    explicit QuantizedCoordinates(double _scale) : scale(_scale) {
+        // Smallest and largest tile units inside of [tileMin, tileMax] after conversion
+        min = int(std::ceil(tileMin / scale));
+        while (convert(min - 1) >= tileMin) { min--; }
+        while (convert(min) < tileMin) { min++; }
+
+        max = int(std::floor(tileMax / scale));
+        while (convert(max + 1) <= tileMax) { max++; }
+        while (convert(max) > tileMax) { max--; }
+    }
+
+    float convert(int _units) const { return float(scale * _units); }
+
+    glm::vec2 operator()(const Tangram::QuantizedPoint& _p) const {
+        return { convert(_p.x), convert(_p.y) };
+    }
+
+    bool isOutside(const Tangram::QuantizedPoint& _a, const Tangram::QuantizedPoint& _b) const {
+        return ((_a.x < min && _b.x < min) ||
+                (_a.x > max && _b.x > max) ||
+                (_a.y < min && _b.y < min) ||
+                (_a.y > max && _b.y > max));
+    }
+    bool isOutside(const Tangram::QuantizedPoint& _p) const {
+        return ((_p.x < min) || (_p.x > max) ||
+                (_p.y < min) || (_p.y > max));
+    }
+};
 }
 
 namespace Tangram {
@@ -59,14 +111,17 @@ JoinTypes JoinTypeFromString(const std::string& str) {
     return JoinTypes::miter;
 }
 
-void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
+template<class PolygonType, class Coordinates>
+static void buildPolygonWith(const PolygonType& _polygon, const Coordinates& _coordinates,
+                             float _height, PolygonBuilder& _ctx) {
 
     glm::vec2 min, max;
     if (_ctx.useTexCoords) {
         min = glm::vec2(std::numeric_limits<float>::max());
         max = glm::vec2(std::numeric_limits<float>::min());
 
-        for (auto& p : _polygon[0]) {
+        for (auto& point : _polygon[0]) {
+            glm::vec2 p = _coordinates(point);
             min.x = std::min(min.x, p.x);
             min.y = std::min(min.y, p.y);
             max.x = std::max(max.x, p.x);
@@ -113,7 +168,7 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
         // Keep track of skipped points to update indices
         _ctx.used[src] = dst++;
 
-        auto& p = _polygon[ring][src - offset];
+        glm::vec2 p = _coordinates(_polygon[ring][src - offset]);
         glm::vec3 coord(p.x, p.y, _height);
 
         if (_ctx.useTexCoords) {
@@ -130,7 +185,17 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     }
 }
 
-void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
+void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
+    buildPolygonWith(_polygon, TileCoordinates(), _height, _ctx);
+}
+
+void Builders::buildPolygon(const QuantizedPolygon& _polygon, float _height, PolygonBuilder& _ctx) {
+    buildPolygonWith(_polygon, QuantizedCoordinates(_ctx.quantizedScale), _height, _ctx);
+}
+
+template<class PolygonType, class Coordinates>
+static void buildPolygonExtrusionWith(const PolygonType& _polygon, const Coordinates& _coordinates,
+                                      float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
 
     auto vertexDataOffset = _ctx.numVertices;
 
@@ -143,12 +208,13 @@ void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight,
 
         for (size_t i = 0; i < lineSize - 1; i++) {
 
-            glm::vec3 a(line[i], 0.f);
-            glm::vec3 b(line[i+1], 0.f);
-
-            if (!_ctx.keepTileEdges && isOutsideTile(a, b)) {
+            if (!_ctx.keepTileEdges && _coordinates.isOutside(line[i], line[i+1])) {
                 continue;
             }
+
+            glm::vec3 a(_coordinates(line[i]), 0.f);
+            glm::vec3 b(_coordinates(line[i+1]), 0.f);
+
             normalVector = glm::cross(upVector, b - a);
             normalVector = glm::normalize(normalVector);
 
@@ -190,6 +256,14 @@ void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight,
     }
 }
 
+void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
+    buildPolygonExtrusionWith(_polygon, TileCoordinates(), _minHeight, _maxHeight, _ctx);
+}
+
+void Builders::buildPolygonExtrusion(const QuantizedPolygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
+    buildPolygonExtrusionWith(_polygon, QuantizedCoordinates(_ctx.quantizedScale), _minHeight, _maxHeight, _ctx);
+}
+
 // Get 2D perpendicular of two points
 static glm::vec2 perp2d(const glm::vec2& _v1, const glm::vec2& _v2 ){
     return glm::vec2(_v2.y - _v1.y, _v1.x - _v2.x);
@@ -288,8 +362,9 @@ static void addCap(const glm::vec2& _coord, const glm::vec2& _normal, int _numCo
     addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
 }
 
-static void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _startIndex,
-                          size_t _endIndex, bool startCap = true, bool endCap = true) {
+template<class LineType, class Coordinates>
+static void buildPolyLineSegment(const LineType& _line, const Coordinates& _coordinates, PolyLineBuilder& _ctx,
+                                 size_t _startIndex, size_t _endIndex, bool startCap = true, bool endCap = true) {
 
     float distance = 0; // Cumulative distance along the polyline.
 
@@ -301,9 +376,9 @@ static void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_
                    (origLineSize - _startIndex + _endIndex));
     if (lineSize < 2) { return; }
 
-    glm::vec2 coordCurr(_line[_startIndex]);
+    glm::vec2 coordCurr(_coordinates(_line[_startIndex]));
     // get the Point using wrapped index in the original line geometry
-    glm::vec2 coordNext(_line[(_startIndex + 1) % origLineSize]);
+    glm::vec2 coordNext(_coordinates(_line[(_startIndex + 1) % origLineSize]));
     glm::vec2 normPrev, normNext, miterVec;
 
     int cornersOnCap = (int)_ctx.cap;
@@ -327,7 +402,7 @@ static void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_
         distance += glm::distance(coordCurr, coordNext);
 
         coordCurr = coordNext;
-        coordNext = _line[nextIndex];
+        coordNext = _coordinates(_line[nextIndex]);
 
         if (coordCurr == coordNext) {
             continue;
@@ -409,13 +484,14 @@ static void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_
 
 }
 
-void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
+template<class LineType, class Coordinates>
+static void buildPolyLineWith(const LineType& _line, const Coordinates& _coordinates, PolyLineBuilder& _ctx) {
 
     size_t lineSize = _line.size();
 
     if (_ctx.keepTileEdges) {
 
-        buildPolyLineSegment(_line, _ctx, 0, lineSize);
+        buildPolyLineSegment(_line, _coordinates, _ctx, 0, lineSize);
 
     } else {
 
@@ -424,26 +500,24 @@ void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
 
         // Determine cuts
         for (size_t i = 0; i < lineSize - 1; i++) {
-            const glm::vec2& coordCurr = _line[i];
-            const glm::vec2& coordNext = _line[i+1];
-            if (isOutsideTile(coordCurr, coordNext)) {
+            if (_coordinates.isOutside(_line[i], _line[i+1])) {
                 if (cut == 0) {
                     firstCutEnd = i + 1;
                 }
-                buildPolyLineSegment(_line, _ctx, cut, i + 1);
+                buildPolyLineSegment(_line, _coordinates, _ctx, cut, i + 1);
                 cut = i + 1;
             } else if (!_ctx.closedPolygon) {
                 // note that both endpoints can be outside tile even if the line segment intersects tile!
-                bool currOutside = isOutsideTile(coordCurr);
-                bool nextOutside = isOutsideTile(coordNext);
+                bool currOutside = _coordinates.isOutside(_line[i]);
+                bool nextOutside = _coordinates.isOutside(_line[i+1]);
 
                 if (currOutside || nextOutside) {
                     if (!currOutside) {
-                        buildPolyLineSegment(_line, _ctx, cut, i + 1, true, false);
+                        buildPolyLineSegment(_line, _coordinates, _ctx, cut, i + 1, true, false);
                     }
-                    glm::vec2 a = coordCurr, b = coordNext;
-                    if (clipLine(a, b, {0, 0}, {1, 1})) {
-                        buildPolyLineSegment({ a, b }, _ctx, 0, 2,
+                    glm::vec2 segment[2] = { _coordinates(_line[i]), _coordinates(_line[i+1]) };
+                    if (clipLine(segment[0], segment[1], {0, 0}, {1, 1})) {
+                        buildPolyLineSegment(Line(segment, 2), TileCoordinates(), _ctx, 0, 2,
                                              !currOutside && i == 0, !nextOutside && i+1 == lineSize-1);
                     }
                     cut = i + 1;
@@ -455,19 +529,27 @@ void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
             if (cut == 0) {
                 // no tile edge cuts!
                 // loop and close the polygon with no endcaps
-                buildPolyLineSegment(_line, _ctx, 0, lineSize+2, false, false);
+                buildPolyLineSegment(_line, _coordinates, _ctx, 0, lineSize+2, false, false);
             } else {
                 // merge first and last cut line-segments together
-                buildPolyLineSegment(_line, _ctx, cut, firstCutEnd);
+                buildPolyLineSegment(_line, _coordinates, _ctx, cut, firstCutEnd);
             }
         } else {
-            buildPolyLineSegment(_line, _ctx, cut, lineSize);
+            buildPolyLineSegment(_line, _coordinates, _ctx, cut, lineSize);
         }
 
     }
 
 }
 
+void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
+    buildPolyLineWith(_line, TileCoordinates(), _ctx);
+}
+
+void Builders::buildPolyLine(const QuantizedLine& _line, PolyLineBuilder& _ctx) {
+    buildPolyLineWith(_line, QuantizedCoordinates(_ctx.quantizedScale), _ctx);
+}
+
 void Builders::buildQuadAtPoint(const glm::vec2& _screenPosition, const glm::vec2& _size, const glm::vec2& _uvBL, const glm::vec2& _uvTR, SpriteBuilder& _ctx) {
     float halfWidth = _size.x * .5f;
     float halfHeight = _size.y * .5f;
@@ -45,6 +45,8 @@ struct PolygonBuilder {
     size_t numVertices = 0;
     bool keepTileEdges;
     bool useTexCoords;
+    // Scale from tile units to tile coordinates for quantized polygons, see Feature::quantizedScale
+    double quantizedScale = 0;
 
     mapbox::detail::Earcut<uint16_t> earcut;
 
@@ -80,6 +82,8 @@ struct PolyLineBuilder {
     bool keepTileEdges;
     bool closedPolygon;
     bool useTexCoords = false;
+    // Scale from tile units to tile coordinates for quantized lines, see Feature::quantizedScale
+    double quantizedScale = 0;
 
     PolyLineBuilder(PolyLineVertexFn _addVertex = [](auto&,auto&,auto&){},
                     CapTypes _cap = CapTypes::butt,
@@ -120,6 +124,9 @@ public:
      */
     static void buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx);
 
+    /* Build a tesselated polygon from tile units scaled by _ctx.quantizedScale */
+    static void buildPolygon(const QuantizedPolygon& _polygon, float _height, PolygonBuilder& _ctx);
+
     /* Build extruded 'walls' from a polygon
      * @_polygon input coordinates describing the polygon
      * @_minHeight the extrusion will extend from this z coordinate to the z of the polygon points
@@ -127,6 +134,9 @@ public:
      */
     static void buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx);
 
+    /* Build extruded 'walls' from a polygon in tile units scaled by _ctx.quantizedScale */
+    static void buildPolygonExtrusion(const QuantizedPolygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx);
+
     /* Build a tesselated polygon line of fixed width from line coordinates
      * @_line input coordinates describing the line
      * @_options parameters for polyline construction
@@ -134,6 +144,9 @@ public:
      */
     static void buildPolyLine(const Line& _line, PolyLineBuilder& _ctx);
 
+    /* Build a tesselated polygon line from tile units scaled by _ctx.quantizedScale */
+    static void buildPolyLine(const QuantizedLine& _line, PolyLineBuilder& _ctx);
+
     /* Build a tesselated quad centered on _screenOrigin
      * @_screenOrigin the sprite origin in screen space
      * @_size the size of the sprite in pixels
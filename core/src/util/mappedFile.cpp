@@ -0,0 +1,70 @@
+#include "util/mappedFile.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tangram {
+
+MappedFile::MappedFile(const std::string& _path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return; }
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping) {
+            void* data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data) {
+                m_data = static_cast<const char*>(data);
+                m_size = size_t(size.QuadPart);
+            }
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(_path.c_str(), O_RDONLY);
+    if (fd < 0) { return; }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const char*>(data);
+            m_size = st.st_size;
+        }
+    }
+    close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (m_data) { UnmapViewOfFile(m_data); }
+    if (m_mapping) { CloseHandle(m_mapping); }
+#else
+    if (m_data) { munmap(const_cast<char*>(m_data), m_size); }
+#endif
+}
+
+void MappedFile::prefetch(size_t _offset, size_t _length) const {
+#ifndef _WIN32
+    if (!m_data || _offset >= m_size) { return; }
+
+    // madvise needs a page aligned start
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t start = _offset - _offset % pageSize;
+    size_t end = std::min(_offset + _length, m_size);
+    madvise(const_cast<char*>(m_data) + start, end - start, MADV_WILLNEED);
+#endif
+}
+
+}
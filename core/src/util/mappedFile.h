@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Tangram {
+
+/* Read-only view of a whole file, mapped into memory */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& _path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Null when the file could not be mapped or is empty
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    // Hint that @_length bytes at @_offset will be read soon, to page them in with one read
+    void prefetch(size_t _offset, size_t _length) const;
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#endif
+};
+
+}
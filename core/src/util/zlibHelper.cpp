@@ -67,4 +67,33 @@ int zlib_inflate(const char* _data, size_t _size, std::vector<char>& dst) {
     return ret == Z_STREAM_END ? Z_OK : Z_DATA_ERROR;
 }
 
+int zlib_deflate(const char* _data, size_t _size, std::vector<char>& dst, int _level) {
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(z_stream));
+
+#ifdef MZ_DEFAULT_WINDOW_BITS
+    // raw deflate stream, see zlib_inflate()
+    int ret = deflateInit2(&strm, _level, Z_DEFLATED, -MZ_DEFAULT_WINDOW_BITS, 9, Z_DEFAULT_STRATEGY);
+#else
+    int ret = deflateInit2(&strm, _level, Z_DEFLATED, 16+MAX_WBITS, 9, Z_DEFAULT_STRATEGY);
+#endif
+    if (ret != Z_OK) { return ret; }
+
+    dst.resize(deflateBound(&strm, _size));
+
+    strm.avail_in = _size;
+    strm.next_in = (Bytef*)_data;
+    strm.avail_out = dst.size();
+    strm.next_out = (Bytef*)dst.data();
+
+    // output buffer is large enough to finish in one call
+    ret = deflate(&strm, Z_FINISH);
+
+    dst.resize(strm.total_out);
+    deflateEnd(&strm);
+
+    return ret == Z_STREAM_END ? Z_OK : Z_DATA_ERROR;
+}
+
 }
@@ -7,4 +7,7 @@ namespace Tangram {
 
 int zlib_inflate(const char* _data, size_t _size, std::vector<char>& dst);
 
+// Compress into a stream that zlib_inflate() can read, @_level from 1 (fastest) to 9 (smallest)
+int zlib_deflate(const char* _data, size_t _size, std::vector<char>& dst, int _level);
+
 }
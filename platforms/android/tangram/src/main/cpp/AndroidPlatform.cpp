@@ -16,6 +16,7 @@
 #include <android/log.h>
 #include <android/asset_manager_jni.h>
 #include <cstdarg>
+#include <cstdio>
 #include <dlfcn.h> // dlopen, dlsym
 #include <libgen.h>
 #include <unistd.h>
@@ -263,6 +264,8 @@ void AndroidPlatform::onUrlComplete(JNIEnv* _jniEnv, jlong _jRequestHandle, jbyt
     if (_jError != nullptr) {
         error = JniHelpers::stringFromJavaString(_jniEnv, _jError);
         response.error = error.c_str();
+        // MapController reports HTTP errors as "Unexpected response code: <code> ..."
+        sscanf(error.c_str(), "Unexpected response code: %d", &response.httpStatus);
     }
 
     // Handle callbacks on worker thread to not block Java side.
@@ -1,5 +1,6 @@
 #include "urlClient.h"
 #include "log.h"
+#include "debug/trace.h"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
@@ -271,6 +272,7 @@ UrlClient::RequestId UrlClient::addRequest(const std::string& _url, const HttpOp
         // list by the curl thread.
         std::lock_guard<std::mutex> lock(m_requestMutex);
         m_requests.push_back(request);
+        m_pendingRequests = m_requests.size();
     }
     curlWakeUp();
 
@@ -287,6 +289,7 @@ void UrlClient::cancelRequest(RequestId _id) {
             if (request.id == _id) {
                 callback = std::move(request.callback);
                 m_requests.erase(it);
+                m_pendingRequests = m_requests.size();
                 break;
             }
         }
@@ -329,6 +332,7 @@ void UrlClient::cancelAllRequests()
         }
     }
     m_requests.clear();
+    m_pendingRequests = 0;
 }
 
 void UrlClient::startPendingRequests() {
@@ -353,6 +357,7 @@ void UrlClient::startPendingRequests() {
 
         task.request = std::move(m_requests.front());
         m_requests.erase(m_requests.begin());
+        m_pendingRequests = m_requests.size();
 
         // Configure the easy handle.
         const char* url = task.request.url.c_str();
@@ -390,6 +395,8 @@ void UrlClient::startPendingRequests() {
 void UrlClient::curlLoop() {
     // Based on: https://curl.haxx.se/libcurl/c/multi-app.html
 
+    Trace::setThreadName("UrlClient");
+
     // Loop until the session is destroyed.
     while (m_curlRunning) {
 
@@ -454,12 +461,15 @@ void UrlClient::curlLoop() {
                 m_curlNotified = false;
             }
 
+            Trace::scope _trace("UrlClient::perform");
+
             // Create tasks from request queue
             startPendingRequests();
 
             //
             int activeRequests = 0;
             curl_multi_perform(m_curlHandle, &activeRequests);
+            Trace::counter("UrlClient::activeRequests", activeRequests);
         }
 
         while (true) {
@@ -500,6 +510,9 @@ void UrlClient::curlLoop() {
                 // Get Response content and Request callback
                 callback = std::move(task.request.callback);
                 response.content = task.content;
+                long httpStatus = 0;
+                curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &httpStatus);
+                response.httpStatus = int(httpStatus);
 
                 const char* url = task.request.url.c_str();
                 if (resultCode == CURLE_OK) {
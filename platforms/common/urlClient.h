@@ -40,6 +40,11 @@ public:
     void cancelRequest(RequestId request);
     void cancelAllRequests();
 
+    // Number of requests being downloaded
+    uint32_t activeRequests() const { return m_activeTasks; }
+    // Number of requests waiting for a download slot
+    uint32_t pendingRequests() const { return m_pendingRequests; }
+
 private:
 
     struct Request {
@@ -87,9 +92,11 @@ private:
     AsyncWorker m_dispatcher = {"UrlClient dispatcher"};
 
     std::list<Task> m_tasks;
-    uint32_t m_activeTasks = 0;
+    std::atomic<uint32_t> m_activeTasks{0};
 
     std::deque<Request> m_requests;
+    // Size of m_requests, readable without m_requestMutex
+    std::atomic<uint32_t> m_pendingRequests{0};
 
     // Synchronize m_tasks and m_requests
     std::mutex m_requestMutex;
@@ -162,6 +162,7 @@ bool iOSPlatform::startUrlRequestImpl(const Url& _url, const HttpOptions& _optio
 
             NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
             long statusCode = [httpResponse statusCode];
+            urlResponse.httpStatus = int(statusCode);
             if (statusCode < 200 || statusCode >= 300) {
                 urlResponse.error = [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String];
             }
@@ -85,6 +85,10 @@ void LinuxPlatform::cancelUrlRequestImpl(const UrlRequestId _id) {
     }
 }
 
+size_t LinuxPlatform::pendingUrlRequests() const {
+    return m_urlClient ? m_urlClient->pendingRequests() : 0;
+}
+
 void setCurrentThreadPriority(int priority) {
     setpriority(PRIO_PROCESS, 0, priority);
 }
@@ -22,6 +22,8 @@ public:
         const UrlRequestHandle _request, UrlRequestId& _id) override;
     void cancelUrlRequestImpl(const UrlRequestId _id) override;
 
+    size_t pendingUrlRequests() const override;
+
 protected:
     FcConfig* m_fcConfig = nullptr;
 
@@ -154,6 +154,7 @@ bool OSXPlatform::startUrlRequestImpl(const Url& _url, const UrlRequestHandle _r
 
             NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
             int statusCode = [httpResponse statusCode];
+            urlResponse.httpStatus = statusCode;
             if (statusCode >= 400) {
                 urlResponse.error = [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String];
             }
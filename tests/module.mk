@@ -6,30 +6,46 @@ MODULE_BASE = $(MAKE_BASE)
 
 # unit tests
 MODULE_SOURCES = \
+  unit/clientDataSourceTests.cpp \
   unit/curlTests.cpp \
   unit/drawRuleTests.cpp \
   unit/dukTests.cpp \
   unit/fileTests.cpp \
   unit/flyToTest.cpp \
+  unit/geoJsonTests.cpp \
   unit/jobQueueTests.cpp \
   unit/labelsTests.cpp \
   unit/labelTests.cpp \
   unit/layerTests.cpp \
   unit/lngLatTests.cpp \
   unit/mapProjectionTests.cpp \
+  unit/markerManagerTests.cpp \
+  unit/mbtilesDataSourceTests.cpp \
+  unit/memoryCacheDataSourceTests.cpp \
   unit/meshTests.cpp \
+  unit/missingTileCacheTests.cpp \
   unit/networkDataSourceTests.cpp \
+  unit/pbfTests.cpp \
+  unit/pmtilesDataSourceTests.cpp \
+  unit/propertiesTests.cpp \
   unit/sceneImportTests.cpp \
   unit/sceneLoaderTests.cpp \
   unit/sceneUpdateTests.cpp \
+  unit/selectionIndexTests.cpp \
+  unit/statsTests.cpp \
   unit/stopsTests.cpp \
   unit/styleMixerTests.cpp \
   unit/styleParamTests.cpp \
   unit/styleSortingTests.cpp \
   unit/styleUniformsTests.cpp \
   unit/textureTests.cpp \
+  unit/tileBuilderTests.cpp \
+  unit/tileCacheTests.cpp \
+  unit/tileDataTests.cpp \
+  unit/tileGeometryCacheTests.cpp \
   unit/tileIDTests.cpp \
   unit/tileManagerTests.cpp \
+  unit/traceTests.cpp \
   unit/urlTests.cpp \
   unit/yamlFilterTests.cpp \
   unit/yamlUtilTests.cpp
@@ -0,0 +1,200 @@
+#include "catch.hpp"
+
+#include "data/clientDataSource.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "mockPlatform.h"
+
+#include <chrono>
+#include <cmath>
+#include <future>
+
+using namespace Tangram;
+
+#define TAGS "[ClientDataSource]"
+
+namespace {
+
+struct TestClientDataSource : ClientDataSource {
+    using ClientDataSource::ClientDataSource;
+
+    // Features of @_tileId, by their "id" property
+    std::vector<double> tileFeatures(const TileID& _tileId) {
+        TileTask task(_tileId, this);
+        auto data = parse(task);
+        std::vector<double> ids;
+        if (!data) { return ids; }
+        for (const auto& feature : data->layers[0].features) {
+            ids.push_back(feature.props.getNumber("id"));
+        }
+        return ids;
+    }
+
+    // Lock held while tiles are clipped
+    std::mutex& storeMutex() { return m_mutexStore; }
+};
+
+Properties featureProperties(double _id) {
+    Properties props;
+    props.set("id", _id);
+    return props;
+}
+
+}
+
+TEST_CASE("ClientDataSource returns the features within each tile", TAGS) {
+    MockPlatform platform;
+    TestClientDataSource source(platform, "test", "");
+
+    source.addPointFeature(featureProperties(0), LngLat(-90, 45));
+    source.addPointFeature(featureProperties(1), LngLat(90, 45));
+    source.addPointFeature(featureProperties(2), LngLat(90, -45));
+
+    ClientDataSource::PolylineBuilder line;
+    line.beginPolyline(2);
+    line.addPoint(LngLat(-90, -30));
+    line.addPoint(LngLat(-10, -30));
+    source.addPolylineFeature(featureProperties(3), std::move(line));
+
+    source.generateTiles();
+
+    CHECK(source.tileFeatures(TileID(0, 0, 0)) == std::vector<double>({ 0, 1, 2, 3 }));
+    CHECK(source.tileFeatures(TileID(0, 0, 1)) == std::vector<double>({ 0 }));
+    CHECK(source.tileFeatures(TileID(1, 0, 1)) == std::vector<double>({ 1 }));
+    CHECK(source.tileFeatures(TileID(1, 1, 1)) == std::vector<double>({ 2 }));
+    CHECK(source.tileFeatures(TileID(0, 1, 1)) == std::vector<double>({ 3 }));
+    CHECK(source.tileFeatures(TileID(0, 0, 2)).empty());
+}
+
+TEST_CASE("ClientDataSource reloads only tiles of changed features", TAGS) {
+    MockPlatform platform;
+    TestClientDataSource source(platform, "test", "");
+
+    // One feature at the center of each tile of zoom 4 but the last of the first column
+    uint64_t id = 0;
+    for (int x = 0; x < 16; x++) {
+        for (int y = 0; y < 16; y++) {
+            if (x == 0 && y == 15) { continue; }
+            LngLat center((x + 0.5) * 22.5 - 180,
+                          std::atan(std::sinh(M_PI * (1 - (y + 0.5) / 8))) * 180 / M_PI);
+            auto featureId = source.addPointFeature(featureProperties(x * 16 + y), center);
+            if (x == 3 && y == 7) { id = featureId; }
+        }
+    }
+    source.generateTiles();
+    auto generation = source.generation();
+
+    REQUIRE(source.tileFeatures(TileID(3, 7, 4)) == std::vector<double>({ 3 * 16 + 7 }));
+    REQUIRE(source.tileFeatures(TileID(0, 15, 4)).empty());
+
+    // Move the feature to the tile without features
+    REQUIRE(source.movePointFeature(id, LngLat(-170, -84)));
+    source.generateTiles();
+
+    CHECK(source.generation() > generation);
+    CHECK(source.tileChanged(TileID(0, 0, 0), generation));
+    CHECK(source.tileChanged(TileID(3, 7, 4), generation));
+    CHECK(source.tileChanged(TileID(0, 15, 4), generation));
+    CHECK(source.tileChanged(TileID(1, 3, 3), generation));
+    CHECK_FALSE(source.tileChanged(TileID(4, 7, 4), generation));
+    CHECK_FALSE(source.tileChanged(TileID(12, 2, 4), generation));
+    CHECK_FALSE(source.tileChanged(TileID(0, 15, 4), source.generation()));
+
+    CHECK(source.tileFeatures(TileID(3, 7, 4)).empty());
+    CHECK(source.tileFeatures(TileID(0, 15, 4)) == std::vector<double>({ 3 * 16 + 7 }));
+
+    generation = source.generation();
+    source.setProperties(id, featureProperties(1000));
+    source.generateTiles();
+    CHECK(source.tileChanged(TileID(0, 15, 4), generation));
+    CHECK_FALSE(source.tileChanged(TileID(3, 7, 4), generation));
+    CHECK(source.tileFeatures(TileID(0, 15, 4)) == std::vector<double>({ 1000 }));
+
+    generation = source.generation();
+    REQUIRE(source.removeFeature(id));
+    source.generateTiles();
+    CHECK(source.tileChanged(TileID(0, 15, 4), generation));
+    CHECK(source.tileFeatures(TileID(0, 15, 4)).empty());
+    CHECK(source.tileFeatures(TileID(0, 0, 0)).size() == 254);
+
+    // Clearing features reloads all tiles
+    generation = source.generation();
+    source.clearFeatures();
+    source.generateTiles();
+    CHECK(source.tileChanged(TileID(12, 2, 4), generation));
+    CHECK(source.tileFeatures(TileID(0, 0, 0)).empty());
+}
+
+TEST_CASE("ClientDataSource adds features from GeoJSON", TAGS) {
+    MockPlatform platform;
+    TestClientDataSource source(platform, "test", "");
+
+    source.addData(R"({ "type": "FeatureCollection", "features": [
+        { "type": "Feature", "properties": { "id": 1 }, "geometry": { "type": "Point", "coordinates": [-90, 45] } },
+        { "type": "Feature", "properties": { "id": 2 },
+          "geometry": { "type": "LineString", "coordinates": [[90, -45], [100, -50]] } } ] })");
+
+    // Features read before invalid input are kept
+    std::string json = R"({ "type": "Feature", "properties": { "id": 3 },
+                            "geometry": { "type": "Point", "coordinates": [90, 45] } } trailing)";
+    size_t offset = 0;
+    source.addData([&](char* _buffer, size_t _size) {
+        size_t size = std::min(_size, json.size() - offset);
+        json.copy(_buffer, size, offset);
+        offset += size;
+        return size;
+    });
+    source.generateTiles();
+
+    CHECK(source.tileFeatures(TileID(0, 0, 0)) == std::vector<double>({ 1, 2, 3 }));
+    CHECK(source.tileFeatures(TileID(0, 0, 1)) == std::vector<double>({ 1 }));
+    CHECK(source.tileFeatures(TileID(1, 1, 1)) == std::vector<double>({ 2 }));
+}
+
+TEST_CASE("ClientDataSource checks for changed tiles without waiting for tile clipping", TAGS) {
+    MockPlatform platform;
+    TestClientDataSource source(platform, "test", "");
+
+    auto id = source.addPointFeature(featureProperties(0), LngLat(-90, 45));
+    source.generateTiles();
+    auto generation = source.generation();
+
+    REQUIRE(source.movePointFeature(id, LngLat(90, 45)));
+    source.generateTiles();
+
+    // Declared first to be released after the lock when the check fails
+    std::future<bool> changed;
+    std::lock_guard<std::mutex> lock(source.storeMutex());
+    changed = std::async(std::launch::async, [&]() {
+        return source.tileChanged(TileID(1, 0, 1), generation);
+    });
+    REQUIRE(changed.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    CHECK(changed.get());
+}
+
+TEST_CASE("ClientDataSource keeps changes only for generations of tiles in use", TAGS) {
+    MockPlatform platform;
+    TestClientDataSource source(platform, "test", "");
+
+    auto a = source.addPointFeature(featureProperties(0), LngLat(-90, 45));
+    auto b = source.addPointFeature(featureProperties(1), LngLat(90, -45));
+    source.generateTiles();
+    auto generation = source.generation();
+
+    REQUIRE(source.movePointFeature(a, LngLat(-80, 40)));
+    source.generateTiles();
+
+    source.setLiveGenerations(generation, generation);
+    CHECK(source.tileChanged(TileID(0, 0, 1), generation));
+    CHECK_FALSE(source.tileChanged(TileID(1, 1, 1), generation));
+
+    // Tiles older than those in use are outdated once their changes are dropped
+    source.setLiveGenerations(source.generation(), source.generation());
+    CHECK(source.tileChanged(TileID(1, 1, 1), generation));
+
+    generation = source.generation();
+    REQUIRE(source.movePointFeature(b, LngLat(80, -40)));
+    source.generateTiles();
+    CHECK(source.tileChanged(TileID(1, 1, 1), generation));
+    CHECK_FALSE(source.tileChanged(TileID(0, 0, 1), generation));
+}
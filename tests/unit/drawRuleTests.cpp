@@ -1,7 +1,10 @@
 #include "catch.hpp"
 
+#include "data/tileData.h"
 #include "scene/drawRule.h"
 #include "scene/sceneLayer.h"
+#include "scene/styleContext.h"
+#include "scene/stops.h"
 #include "log.h"
 
 #include <cstdio>
@@ -132,4 +135,93 @@ TEST_CASE("DrawRule correctly merges with another DrawRule", TAGS) {
     }
 }
 
+TEST_CASE("DrawRuleMergeSet reuses cached matches for equal filter properties", TAGS) {
+
+    const DrawRuleData rule_a = { "draw_group_0", 0, { { StyleParamKey::order, "order_a" } } };
+    const DrawRuleData rule_b = { "draw_group_0", 0, { { StyleParamKey::order, "order_b" } } };
+
+    const SceneLayer sublayer = { "b", Filter::MatchEquality("kind", { Value(std::string("park")) }), { rule_b }, {},
+                                  SceneLayer::Options() };
+    const SceneLayer layer = { "a", Filter::MatchExistence("kind", true), { rule_a }, { sublayer },
+                               SceneLayer::Options() };
+
+    REQUIRE(layer.matchCacheable());
+    REQUIRE(layer.matchKeys().size() == 1);
+
+    StyleContext ctx;
+    DrawRuleMergeSet mergeSet;
+
+    auto order = [&]() {
+        return mergeSet.matchedRules()[0].findParameter(StyleParamKey::order).value.get<std::string>();
+    };
+
+    Feature park, forest, unnamed;
+    park.props.set("kind", "park");
+    park.props.set("name", "a");
+    forest.props.set("kind", "forest");
+    unnamed.props.set("name", "b");
+
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(mergeSet.matchCached(park, layer, ctx));
+        REQUIRE(order() == "order_b");
+
+        REQUIRE(mergeSet.matchCached(forest, layer, ctx));
+        REQUIRE(order() == "order_a");
+
+        REQUIRE(!mergeSet.matchCached(unnamed, layer, ctx));
+        REQUIRE(mergeSet.matchedRules().empty());
+    }
+}
+
+TEST_CASE("DrawRuleMergeSet evaluates cached rules in place and restores them on the next match", TAGS) {
+
+    Stops colors({ Stops::Frame(0, Color(0xff000000)), Stops::Frame(10, Color(0xffffffff)) });
+    const DrawRuleData rule = { "draw_group_0", 0, {
+            StyleParam(StyleParamKey::color, &colors),
+            { StyleParamKey::order, "order_a" }
+    } };
+    const SceneLayer layer = { "a", Filter::MatchExistence("kind", true), { rule }, {},
+                               SceneLayer::Options() };
+    REQUIRE(layer.matchCacheable());
+
+    StyleContext ctx;
+    ctx.setTileID(TileID(0, 0, 5));
+    DrawRuleMergeSet mergeSet;
+
+    Feature park;
+    park.props.set("kind", "park");
+    REQUIRE(mergeSet.matchCached(park, layer, ctx));
+
+    auto colorKey = static_cast<uint8_t>(StyleParamKey::color);
+    const DrawRule* cached = nullptr;
+    const StyleParam* stopsParam = nullptr;
+
+    for (int i = 0; i < 3; i++) {
+        Feature feature;
+        feature.props.set("kind", "park");
+        feature.props.set("name", std::to_string(i));
+        REQUIRE(mergeSet.matchCached(feature, layer, ctx));
+
+        // Hits share the rules of the cache entry, restored after the previous evaluation
+        auto& matched = mergeSet.matchedRules()[0];
+        if (!cached) {
+            cached = &matched;
+            stopsParam = matched.params[colorKey].param;
+        }
+        CHECK(&matched == cached);
+        REQUIRE(matched.params[colorKey].param == stopsParam);
+        REQUIRE(stopsParam->stops == &colors);
+
+        REQUIRE(mergeSet.evaluateRuleForContext(matched, ctx));
+        CHECK(matched.params[colorKey].param != stopsParam);
+        uint32_t color = 0;
+        REQUIRE(matched.get(StyleParamKey::color, color));
+        CHECK(color == colors.evalColor(5));
+    }
+
+    mergeSet.clearMatchCache();
+    REQUIRE(mergeSet.matchCached(park, layer, ctx));
+    CHECK(mergeSet.matchedRules()[0].params[colorKey].param->stops == &colors);
+}
+
 }
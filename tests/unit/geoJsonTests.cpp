@@ -0,0 +1,136 @@
+#include "catch.hpp"
+
+#include "data/formats/geoJson.h"
+#include "data/propertyItem.h"
+
+#include <cstring>
+#include <string>
+
+using namespace Tangram;
+
+#define TAGS "[GeoJson]"
+
+namespace {
+
+struct ReadFeature {
+    std::string layer;
+    GeoJson::Geometry geometry;
+    Properties properties;
+};
+
+std::vector<ReadFeature> readFeatures(const std::string& _json, bool& _ok) {
+    std::vector<ReadFeature> features;
+    const char* error;
+    size_t offset;
+    _ok = GeoJson::readFeatures(_json.data(), _json.size(), 0,
+        [&](const std::string& _layer, GeoJson::Geometry& _geometry, Properties& _properties) {
+            features.push_back({ _layer, _geometry, std::move(_properties) });
+        }, &error, &offset);
+    return features;
+}
+
+const char* collection = R"({
+  "type": "FeatureCollection",
+  "features": [
+    { "type": "Feature", "properties": { "name": "a", "height": 10, "visible": true, "tags": [1, 2], "nested": { "x": 1 }, "none": null },
+      "geometry": { "type": "Point", "coordinates": [ 10.5, 20.25 ] } },
+    { "type": "Feature",
+      "geometry": { "coordinates": [ [0, 0, 100], [1, 1, 100], [2, 0, 100] ], "type": "LineString" },
+      "properties": { "name": "b" } },
+    { "type": "Feature", "properties": {},
+      "geometry": { "type": "MultiPolygon", "coordinates": [
+        [ [ [0, 0], [1, 0], [1, 1], [0, 0] ], [ [0.2, 0.2], [0.4, 0.2], [0.4, 0.4], [0.2, 0.2] ] ],
+        [ [ [5, 5], [6, 5], [6, 6], [5, 5] ] ] ] } },
+    { "type": "Feature", "properties": {},
+      "geometry": { "type": "GeometryCollection", "geometries": [ { "type": "Point", "coordinates": [0, 0] } ] } },
+    { "type": "Feature", "properties": {}, "geometry": null }
+  ]
+})";
+
+}
+
+TEST_CASE("GeoJSON reader builds features of a FeatureCollection", TAGS) {
+    bool ok = false;
+    auto features = readFeatures(collection, ok);
+    REQUIRE(ok);
+    // Features without supported geometry are skipped
+    REQUIRE(features.size() == 3);
+
+    auto& point = features[0];
+    CHECK(point.layer == "");
+    CHECK(point.geometry.type == GeometryType::points);
+    REQUIRE(point.geometry.positions.size() == 1);
+    CHECK(point.geometry.positions[0].longitude == 10.5);
+    CHECK(point.geometry.positions[0].latitude == 20.25);
+    CHECK(point.properties.getString("name") == "a");
+    CHECK(point.properties.getNumber("height") == 10);
+    CHECK(point.properties.getNumber("visible") == 1);
+    CHECK(!point.properties.contains("tags"));
+    CHECK(!point.properties.contains("nested"));
+    CHECK(!point.properties.contains("none"));
+
+    auto& line = features[1];
+    CHECK(line.geometry.type == GeometryType::lines);
+    CHECK(line.geometry.positions.size() == 3);
+    REQUIRE(line.geometry.lines.size() == 1);
+    CHECK(line.geometry.lines[0].size() == 3);
+    CHECK(line.properties.getString("name") == "b");
+
+    auto& polygons = features[2];
+    CHECK(polygons.geometry.type == GeometryType::polygons);
+    CHECK(polygons.geometry.positions.size() == 12);
+    CHECK(polygons.geometry.lines.size() == 3);
+    REQUIRE(polygons.geometry.polygons.size() == 2);
+    CHECK(polygons.geometry.polygons[0].size() == 2);
+    CHECK(polygons.geometry.polygons[1].size() == 1);
+}
+
+TEST_CASE("GeoJSON reader names features of collections in a top-level object", TAGS) {
+    bool ok = false;
+    auto features = readFeatures(R"({
+        "water": { "type": "FeatureCollection", "features": [
+            { "type": "Feature", "properties": {}, "geometry": { "type": "Point", "coordinates": [1, 2] } } ] },
+        "roads": { "type": "FeatureCollection", "features": [
+            { "type": "Feature", "properties": {}, "geometry": { "type": "MultiPoint", "coordinates": [[1, 2], [3, 4]] } } ] }
+    })", ok);
+    REQUIRE(ok);
+    REQUIRE(features.size() == 2);
+    CHECK(features[0].layer == "water");
+    CHECK(features[1].layer == "roads");
+    CHECK(features[1].geometry.positions.size() == 2);
+
+    // A single feature or geometry
+    features = readFeatures(R"({ "type": "Polygon", "coordinates": [ [ [0, 0], [1, 0], [1, 1], [0, 0] ] ] })", ok);
+    REQUIRE(ok);
+    REQUIRE(features.size() == 1);
+    CHECK(features[0].geometry.type == GeometryType::polygons);
+}
+
+TEST_CASE("GeoJSON reader reads input in chunks", TAGS) {
+    std::string json = collection;
+
+    for (size_t chunk : { size_t(1), size_t(7), size_t(4096) }) {
+        size_t offset = 0;
+        std::vector<Properties> properties;
+        const char* error;
+        size_t errorOffset;
+        bool ok = GeoJson::readFeatures([&](char* _buffer, size_t _size) {
+                size_t size = std::min({ _size, chunk, json.size() - offset });
+                std::memcpy(_buffer, json.data() + offset, size);
+                offset += size;
+                return size;
+            }, 0, [&](const std::string&, GeoJson::Geometry&, Properties& _properties) {
+                properties.push_back(std::move(_properties));
+            }, &error, &errorOffset);
+
+        REQUIRE(ok);
+        REQUIRE(properties.size() == 3);
+        CHECK(properties[1].getString("name") == "b");
+    }
+
+    // Features before an error are returned
+    bool ok = true;
+    auto features = readFeatures(json.substr(0, json.find("MultiPolygon")), ok);
+    CHECK(!ok);
+    CHECK(features.size() == 2);
+}
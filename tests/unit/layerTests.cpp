@@ -1,6 +1,7 @@
 #include "catch.hpp"
 
 #include "scene/sceneLayer.h"
+#include "debug/layerProfile.h"
 #include "data/tileData.h"
 #include "scene/styleContext.h"
 
@@ -144,4 +145,52 @@ TEST_CASE("SceneLayer exclusive and priority", TAGS) {
     }
 }
 
+TEST_CASE("LayerProfile sums the costs of tile builds", TAGS) {
+    const Filter matchEverything;
+    const SceneLayer layer = {"roads", matchEverything, {}, {}, SceneLayer::Options()};
+    const std::string sublayer = "roads:major";
+    const std::string lines = "lines";
+    const std::string text = "text";
+
+    LayerProfile profile;
+    LayerProfile::Batch batch;
+
+    auto& matching = batch[{ &layer, nullptr, nullptr }];
+    matching.time = std::chrono::milliseconds(1);
+    matching.features = 10;
+
+    auto& line = batch[{ &layer, sublayer.c_str(), &lines }];
+    line.time = std::chrono::milliseconds(2);
+    line.features = 4;
+    line.vertices = 40;
+
+    // Batches of two tiles
+    LayerProfile::Batch other = batch;
+    auto& label = other[{ &layer, sublayer.c_str(), &text }];
+    label.time = std::chrono::milliseconds(5);
+    label.labels = 3;
+
+    profile.merge(batch);
+    profile.merge(other);
+    REQUIRE(batch.empty());
+
+    auto stats = profile.get();
+    REQUIRE(stats.size() == 3);
+
+    CHECK(stats[0].style == "text");
+    CHECK(stats[0].labels == 3);
+    CHECK(stats[1].style == "lines");
+    CHECK(stats[1].sublayer == "roads:major");
+    CHECK(stats[1].timeMs == Approx(4.0));
+    CHECK(stats[1].features == 8);
+    CHECK(stats[1].vertices == 80);
+    CHECK(stats[2].dataLayer == "roads");
+    CHECK(stats[2].sublayer.empty());
+    CHECK(stats[2].style.empty());
+    CHECK(stats[2].features == 20);
+
+    profile.reset();
+    CHECK(profile.get().empty());
+}
+
 } // namespace
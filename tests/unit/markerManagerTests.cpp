@@ -0,0 +1,349 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/tileData.h"
+#include "marker/marker.h"
+#include "marker/markerManager.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "style/style.h"
+#include "util/mapProjection.h"
+#include "view/view.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+#define TAGS "[MarkerManager]"
+
+namespace {
+
+const char* sceneYaml = R"END(
+styles:
+    thick:
+        base: lines
+)END";
+
+const char* linesStyling = "{ style: lines, color: red, width: 2px, order: 100 }";
+const char* thickStyling = "{ style: thick, color: blue, width: 8px, order: 100 }";
+const char* pointStyling = "{ style: points, color: red, size: 10px, order: 100 }";
+
+struct TestScene {
+    MockPlatform platform;
+    std::unique_ptr<Scene> scene;
+    View view{256, 256};
+
+    TestScene() {
+        SceneOptions options{sceneYaml, Url()};
+        options.numTileWorkers = 0;
+        options.prefetchTiles = false;
+        scene = std::make_unique<Scene>(platform, std::move(options));
+        REQUIRE(scene->load());
+        REQUIRE(scene->completeScene(view));
+        view.setZoom(10);
+    }
+
+    MarkerManager& markers() { return *scene->markerManager(); }
+
+    const Marker& marker(MarkerID _id) {
+        const Marker* found = nullptr;
+        for (const auto& marker : markers().markers()) {
+            if (marker->id() == _id) { found = marker.get(); }
+        }
+        REQUIRE(found);
+        return *found;
+    }
+
+    uint32_t styleId(const std::string& _name) {
+        for (const auto& style : scene->styles()) {
+            if (style->getName() == _name) { return style->getID(); }
+        }
+        return 0;
+    }
+
+    MarkerID addPolyline(const char* _styling,
+                         std::vector<LngLat> _coordinates = { { 0, 0 }, { 0.1, 0.1 }, { 0.2, 0 } }) {
+        MarkerID id = markers().add();
+        REQUIRE(markers().setPolyline(id, _coordinates.data(), _coordinates.size()));
+        REQUIRE(markers().setStylingFromString(id, _styling));
+        return id;
+    }
+
+    // Update until meshes rebuilt for another zoom level on the marker worker were swapped in
+    void update() {
+        for (int i = 0; i < 1000; i++) {
+            if (!markers().update(view, 0.f, view.update()).easing) { return; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        FAIL("Marker meshes were not rebuilt");
+    }
+};
+
+// Check that the points of the polyline marker are at _coordinates, in range of 16-bit vertex
+// positions, and that consecutive parts of the line share one point
+void checkPolyline(const Marker& _marker, const std::vector<LngLat>& _coordinates) {
+    double extent = _marker.extent();
+    REQUIRE(extent > 0);
+    REQUIRE(std::isfinite(extent));
+
+    std::vector<glm::vec2> points;
+    auto addPart = [&](const Feature& _part) {
+        REQUIRE(_part.coordinates.size() >= 2);
+        if (!points.empty()) {
+            REQUIRE(_part.coordinates.front() == points.back());
+            points.pop_back();
+        }
+        points.insert(points.end(), _part.coordinates.begin(), _part.coordinates.end());
+    };
+    for (const auto& part : _marker.lineParts()) { addPart(*part); }
+    addPart(*_marker.feature());
+
+    REQUIRE(points.size() == _coordinates.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        INFO("point " << i);
+        REQUIRE(std::abs(points[i].x) < 4.f);
+        REQUIRE(std::abs(points[i].y) < 4.f);
+
+        glm::dvec2 meters = glm::dvec2(points[i]) * extent + _marker.origin();
+        glm::dvec2 expected = MapProjection::lngLatToProjectedMeters(_coordinates[i]);
+        CHECK(meters.x == Approx(expected.x).margin(extent * 1e-5));
+        CHECK(meters.y == Approx(expected.y).margin(extent * 1e-5));
+        CHECK(_marker.bounds().contains(expected.x, expected.y));
+    }
+}
+
+}
+
+TEST_CASE("Marker meshes rebuilt for a zoom level are not swapped in for modified markers", TAGS) {
+    TestScene test;
+    auto& markers = test.markers();
+
+    MarkerID propertiesId = test.addPolyline(linesStyling);
+    MarkerID stylingId = test.addPolyline(linesStyling);
+    MarkerID unchangedId = test.addPolyline(linesStyling);
+    test.update();
+    REQUIRE(test.marker(unchangedId).builtZoomLevel() == 10);
+
+    // Start rebuilding all markers on the worker, then modify two of them
+    test.view.setZoom(12);
+    markers.update(test.view, 0.f, test.view.update());
+
+    Properties properties;
+    properties.set("name", "track");
+    REQUIRE(markers.setProperties(propertiesId, std::move(properties)));
+    REQUIRE(markers.setStylingFromString(stylingId, thickStyling));
+
+    // The modified markers are built on the main thread with their new state
+    markers.update(test.view, 0.f, test.view.update());
+    const auto* propertiesMesh = test.marker(propertiesId).mesh();
+    const auto* stylingMesh = test.marker(stylingId).mesh();
+    REQUIRE(propertiesMesh);
+    REQUIRE(stylingMesh);
+    CHECK(test.marker(propertiesId).feature()->props.getString("name") == "track");
+
+    test.update();
+
+    CHECK(test.marker(propertiesId).mesh() == propertiesMesh);
+    CHECK(test.marker(stylingId).mesh() == stylingMesh);
+    CHECK(test.marker(stylingId).styleId() == test.styleId("thick"));
+
+    CHECK(test.marker(unchangedId).builtZoomLevel() == 12);
+    CHECK(test.marker(unchangedId).mesh());
+    CHECK(test.marker(unchangedId).styleId() == test.styleId("lines"));
+}
+
+TEST_CASE("Marker meshes of the previous zoom level are drawn until the rebuilt meshes are swapped in", TAGS) {
+    TestScene test;
+    auto& markers = test.markers();
+
+    MarkerID id = test.addPolyline(linesStyling);
+    test.update();
+    REQUIRE(test.marker(id).mesh());
+
+    test.view.setZoom(12);
+    for (int i = 0; i < 1000 && test.marker(id).builtZoomLevel() != 12; i++) {
+        auto state = markers.update(test.view, 0.f, test.view.update());
+        REQUIRE(test.marker(id).mesh());
+        if (test.marker(id).builtZoomLevel() != 12) {
+            CHECK(test.marker(id).builtZoomLevel() == 10);
+            // Frames continue until the swap
+            CHECK(state.easing);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(test.marker(id).builtZoomLevel() == 12);
+    CHECK(!markers.update(test.view, 0.f, test.view.update()).easing);
+}
+
+TEST_CASE("Marker updates without changes of markers or the view only update eases", TAGS) {
+    TestScene test;
+    auto& markers = test.markers();
+
+    MarkerID line = test.addPolyline(linesStyling);
+    MarkerID point = markers.add();
+    REQUIRE(markers.setStylingFromString(point, pointStyling));
+    REQUIRE(markers.setPoint(point, { 0, 0 }));
+    test.update();
+
+    REQUIRE(markers.setPointEased(point, { 0.1, 0.1 }, 1.f, EaseType::linear));
+    REQUIRE(markers.update(test.view, 0.f, test.view.update()).easing);
+    glm::dvec2 origin = test.marker(point).origin();
+    glm::mat4 lineMatrix = test.marker(line).modelMatrix();
+
+    // The line marker is not visited while the view is not reported as changed
+    test.view.setPosition(1000, 1000);
+    test.view.update();
+    CHECK(markers.update(test.view, 0.5f, false).easing);
+    CHECK(test.marker(point).origin() != origin);
+    CHECK(test.marker(line).modelMatrix() == lineMatrix);
+
+    CHECK(markers.update(test.view, 0.f, true).easing);
+    CHECK(test.marker(line).modelMatrix() != lineMatrix);
+
+    CHECK(!markers.update(test.view, 0.5f, false).easing);
+    glm::dvec2 end = MapProjection::lngLatToProjectedMeters({ 0.1, 0.1 });
+    CHECK(test.marker(point).origin().x == Approx(end.x));
+    CHECK(test.marker(point).origin().y == Approx(end.y));
+}
+
+TEST_CASE("Markers with the same styling share their draw rule across zoom levels", TAGS) {
+    TestScene test;
+
+    MarkerID first = test.addPolyline(linesStyling);
+    MarkerID second = test.addPolyline(linesStyling);
+    MarkerID other = test.addPolyline(thickStyling);
+    test.update();
+
+    auto drawRuleData = test.marker(first).drawRuleData();
+    REQUIRE(drawRuleData);
+    CHECK(test.marker(second).drawRuleData() == drawRuleData);
+    CHECK(test.marker(other).drawRuleData() != drawRuleData);
+
+    test.view.setZoom(14);
+    test.update();
+
+    for (MarkerID id : { first, second, other }) {
+        CHECK(test.marker(id).builtZoomLevel() == 14);
+        CHECK(test.marker(id).mesh());
+    }
+    CHECK(test.marker(first).drawRuleData() == drawRuleData);
+    CHECK(test.marker(second).drawRuleData() == drawRuleData);
+
+    // Markers added later reuse the parsed styling
+    MarkerID third = test.addPolyline(linesStyling);
+    test.update();
+    CHECK(test.marker(third).drawRuleData() == drawRuleData);
+    CHECK(test.marker(third).mesh());
+}
+
+TEST_CASE("Markers are styled correctly beyond the number of cached stylings", TAGS) {
+    TestScene test;
+
+    // More distinct stylings than are cached
+    std::vector<MarkerID> ids;
+    for (int i = 0; i < 300; i++) {
+        auto styling = "{ style: lines, color: red, width: " + std::to_string(i + 1) + "px, order: 100 }";
+        ids.push_back(test.addPolyline(styling.c_str()));
+    }
+    test.update();
+
+    for (MarkerID id : ids) {
+        REQUIRE(test.marker(id).mesh());
+        REQUIRE(test.marker(id).drawRuleData());
+    }
+
+    // Rules of markers whose styling was dropped from the cache still build at other zoom levels
+    test.view.setZoom(13);
+    test.update();
+    for (MarkerID id : ids) {
+        CHECK(test.marker(id).builtZoomLevel() == 13);
+        CHECK(test.marker(id).mesh());
+    }
+
+    // A styling dropped from the cache is parsed again
+    MarkerID again = test.addPolyline("{ style: lines, color: red, width: 1px, order: 100 }");
+    test.update();
+    CHECK(test.marker(again).mesh());
+    CHECK(test.marker(again).drawRuleData());
+    CHECK(test.marker(again).drawRuleData() != test.marker(ids[0]).drawRuleData());
+}
+
+TEST_CASE("Appended polyline points far outside of the line move it into new bounds", TAGS) {
+    TestScene test;
+    auto& markers = test.markers();
+
+    std::vector<LngLat> coordinates = { { 0, 0 }, { 0.001, 0.001 } };
+    MarkerID id = test.addPolyline(linesStyling, coordinates);
+    test.update();
+    float extent = test.marker(id).extent();
+
+    // Within the range of the current coordinates
+    std::vector<LngLat> near = { { 0.002, 0.0015 } };
+    REQUIRE(markers.appendPolyline(id, near.data(), near.size()));
+    coordinates.insert(coordinates.end(), near.begin(), near.end());
+    CHECK(test.marker(id).extent() == extent);
+    checkPolyline(test.marker(id), coordinates);
+
+    // A track growing to a thousand times its first extent
+    for (int i = 1; i <= 100; i++) {
+        std::vector<LngLat> far = { { i * 0.01, i * 0.005 }, { i * 0.01 + 0.005, -i * 0.005 } };
+        REQUIRE(markers.appendPolyline(id, far.data(), far.size()));
+        coordinates.insert(coordinates.end(), far.begin(), far.end());
+        checkPolyline(test.marker(id), coordinates);
+    }
+    CHECK(test.marker(id).extent() > 100 * extent);
+
+    test.update();
+    CHECK(test.marker(id).mesh());
+}
+
+TEST_CASE("Parts of appended polylines share a point but no segment", TAGS) {
+    TestScene test;
+    auto& markers = test.markers();
+
+    std::vector<LngLat> coordinates = { { 0, 0 }, { 1, 1 } };
+    MarkerID id = test.addPolyline(linesStyling, coordinates);
+    test.update();
+
+    // Enough points for several parts, appended in chunks and at once
+    std::vector<LngLat> points;
+    for (int i = 0; i < 3000; i++) { points.push_back({ 1 - i / 3000.0, (i % 2) * 0.5 }); }
+    for (size_t i = 0; i < 1500; i += 100) {
+        REQUIRE(markers.appendPolyline(id, points.data() + i, 100));
+    }
+    REQUIRE(markers.appendPolyline(id, points.data() + 1500, 1500));
+    coordinates.insert(coordinates.end(), points.begin(), points.end());
+
+    CHECK(test.marker(id).lineParts().size() >= 2);
+    checkPolyline(test.marker(id), coordinates);
+
+    test.update();
+    CHECK(test.marker(id).mesh());
+}
+
+TEST_CASE("Polylines of equal points can be appended to", TAGS) {
+    TestScene test;
+    auto& markers = test.markers();
+
+    std::vector<LngLat> coordinates = { { 10, 20 }, { 10, 20 } };
+    MarkerID id = test.addPolyline(linesStyling, coordinates);
+    test.update();
+    checkPolyline(test.marker(id), coordinates);
+
+    std::vector<LngLat> same = { { 10, 20 } };
+    REQUIRE(markers.appendPolyline(id, same.data(), same.size()));
+    coordinates.push_back(same[0]);
+    checkPolyline(test.marker(id), coordinates);
+
+    std::vector<LngLat> moved = { { 10.01, 20.01 } };
+    REQUIRE(markers.appendPolyline(id, moved.data(), moved.size()));
+    coordinates.push_back(moved[0]);
+    checkPolyline(test.marker(id), coordinates);
+
+    test.update();
+    CHECK(test.marker(id).mesh());
+}
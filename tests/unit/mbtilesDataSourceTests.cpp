@@ -0,0 +1,319 @@
+#include "catch.hpp"
+
+#include "data/mbtilesDataSource.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "sqlite3.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace Tangram;
+
+#define TAGS "[MBTilesDataSource]"
+
+namespace {
+
+std::string tileData(const TileID& _tileID) {
+    return "tile " + _tileID.toString();
+}
+
+// Create an MBTiles file with tiles of zoom @_zoom in columns and rows below @_size
+void createMBTiles(const std::string& _path, int _zoom, int _size) {
+    std::remove(_path.c_str());
+
+    sqlite3* db = nullptr;
+    REQUIRE(sqlite3_open(_path.c_str(), &db) == SQLITE_OK);
+    REQUIRE(sqlite3_exec(db, "BEGIN;"
+                         "CREATE TABLE metadata (name TEXT, value TEXT);"
+                         "CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER,"
+                         " tile_row INTEGER, tile_data BLOB);"
+                         "CREATE UNIQUE INDEX tile_index ON tiles (zoom_level, tile_column, tile_row);",
+                         nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "INSERT INTO tiles VALUES (?, ?, ?, ?);", -1, &stmt, nullptr);
+    for (int x = 0; x < _size; x++) {
+        for (int y = 0; y < _size; y++) {
+            auto data = tileData(TileID(x, y, _zoom));
+            sqlite3_bind_int(stmt, 1, _zoom);
+            sqlite3_bind_int(stmt, 2, x);
+            sqlite3_bind_int(stmt, 3, (1 << _zoom) - 1 - y);
+            sqlite3_bind_blob(stmt, 4, data.data(), data.size(), SQLITE_TRANSIENT);
+            REQUIRE(sqlite3_step(stmt) == SQLITE_DONE);
+            sqlite3_reset(stmt);
+        }
+    }
+    sqlite3_finalize(stmt);
+    REQUIRE(sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(db);
+}
+
+int countRows(const std::string& _path, const char* _table) {
+    sqlite3* db = nullptr;
+    REQUIRE(sqlite3_open(_path.c_str(), &db) == SQLITE_OK);
+    int rows = -1;
+    sqlite3_exec(db, (std::string("SELECT COUNT(*) FROM ") + _table + ";").c_str(),
+                 [](void* _rows, int, char** _values, char**) {
+                     *static_cast<int*>(_rows) = std::atoi(_values[0]);
+                     return 0;
+                 }, &rows, nullptr);
+    sqlite3_close(db);
+    return rows;
+}
+
+// Returns the tile data of each requested tile, like a network source would
+struct TestSource : TileSource::DataSource {
+    size_t padding = 0;
+    std::atomic<size_t> loads{0};
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        loads++;
+        auto data = tileData(_task->tileId()) + std::string(padding, ' ');
+        static_cast<BinaryTileTask&>(*_task).rawTileData =
+            std::make_shared<std::vector<char>>(data.begin(), data.end());
+        _cb.func(_task);
+        return true;
+    }
+};
+
+}
+
+TEST_CASE("MBTiles reader threads return the data of each requested tile", TAGS) {
+    std::string path = "/tmp/tangram-mbtiles-test.mbtiles";
+    createMBTiles(path, 6, 8);
+
+    MockPlatform platform;
+    MBTilesDataSource source(platform, "test", path, "");
+    auto prana = std::make_shared<ScenePrana>(nullptr);
+
+    std::mutex mutex;
+    std::condition_variable loaded;
+    size_t numLoaded = 0;
+
+    TileTaskCb cb{[&](std::shared_ptr<TileTask>) {
+        std::lock_guard<std::mutex> lock(mutex);
+        numLoaded++;
+        loaded.notify_one();
+    }};
+
+    // All tiles of the file and one which is missing
+    std::vector<std::shared_ptr<BinaryTileTask>> tasks;
+    for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < 8; y++) {
+            tasks.push_back(std::make_shared<BinaryTileTask>(TileID(x, y, 6), nullptr));
+        }
+    }
+    tasks.push_back(std::make_shared<BinaryTileTask>(TileID(9, 9, 6), nullptr));
+
+    for (auto& task : tasks) {
+        task->setScenePrana(prana);
+        REQUIRE(source.loadTileData(task, cb));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        REQUIRE(loaded.wait_for(lock, std::chrono::seconds(10),
+                                [&]{ return numLoaded == tasks.size(); }));
+    }
+
+    for (size_t i = 0; i < tasks.size() - 1; i++) {
+        auto& task = *tasks[i];
+        REQUIRE(task.hasData());
+        auto expected = tileData(task.tileId());
+        CHECK(std::string(task.rawTileData->begin(), task.rawTileData->end()) == expected);
+    }
+    CHECK(!tasks.back()->hasData());
+
+    TileSourceStats stats;
+    source.getStats(stats);
+    CHECK(stats.mbtilesQueryTiles == tasks.size());
+    CHECK(stats.mbtilesQueryTime.count <= tasks.size());
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("MBTiles cache writes downloaded tiles in batches", TAGS) {
+    std::string path = "/tmp/tangram-mbtiles-cache-test.mbtiles";
+    std::remove(path.c_str());
+
+    std::vector<std::shared_ptr<BinaryTileTask>> tasks;
+    for (int x = 0; x < 10; x++) {
+        for (int y = 0; y < 10; y++) {
+            tasks.push_back(std::make_shared<BinaryTileTask>(TileID(x, y, 7), nullptr));
+        }
+    }
+
+    {
+        MockPlatform platform;
+        MBTilesDataSource source(platform, "test", path, "", 3600);
+        source.setNext(std::make_unique<TestSource>());
+        auto prana = std::make_shared<ScenePrana>(nullptr);
+
+        std::atomic<size_t> numLoaded{0};
+        TileTaskCb cb{[&](std::shared_ptr<TileTask>) { numLoaded++; }};
+
+        for (auto& task : tasks) {
+            task->setScenePrana(prana);
+            REQUIRE(source.loadTileData(task, cb));
+        }
+        for (int i = 0; i < 1000 && numLoaded < tasks.size(); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(numLoaded == tasks.size());
+
+        TileSourceStats stats;
+        source.getStats(stats);
+        CHECK(stats.mbtilesWriteTime.count < tasks.size() / 10);
+        // Pending tiles are written when the source is deleted
+    }
+
+    CHECK(countRows(path, "map") == tasks.size());
+    CHECK(countRows(path, "images") == tasks.size());
+    CHECK(countRows(path, "tile_last_access") == tasks.size());
+
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
+
+TEST_CASE("MBTiles cache writes all downloaded tiles when deleted right after loading", TAGS) {
+    std::string path = "/tmp/tangram-mbtiles-shutdown-test.mbtiles";
+    std::remove(path.c_str());
+
+    size_t numTiles = 500;
+    {
+        MockPlatform platform;
+        MBTilesDataSource source(platform, "test", path, "", 3600);
+        source.setNext(std::make_unique<TestSource>());
+        static_cast<TestSource&>(*source.next).padding = 10000;
+        auto prana = std::make_shared<ScenePrana>(nullptr);
+
+        std::atomic<size_t> numLoaded{0};
+        TileTaskCb cb{[&](std::shared_ptr<TileTask>) { numLoaded++; }};
+
+        for (size_t i = 0; i < numTiles; i++) {
+            auto task = std::make_shared<BinaryTileTask>(TileID(i % 32, i / 32, 7), nullptr);
+            task->setScenePrana(prana);
+            REQUIRE(source.loadTileData(task, cb));
+        }
+        for (int i = 0; i < 10000 && numLoaded < numTiles; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(numLoaded == numTiles);
+        // Tiles still queued for writing are written when the source is deleted
+    }
+
+    CHECK(countRows(path, "map") == numTiles);
+    CHECK(countRows(path, "tile_last_access") == numTiles);
+
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
+
+TEST_CASE("MBTiles cache returns downloaded tiles before they are written", TAGS) {
+    std::string path = "/tmp/tangram-mbtiles-pending-test.mbtiles";
+    std::remove(path.c_str());
+
+    {
+        MockPlatform platform;
+        MBTilesDataSource source(platform, "test", path, "", 3600);
+        source.setNext(std::make_unique<TestSource>());
+        auto& next = static_cast<TestSource&>(*source.next);
+        auto prana = std::make_shared<ScenePrana>(nullptr);
+
+        std::atomic<size_t> numLoaded{0};
+        TileTaskCb cb{[&](std::shared_ptr<TileTask>) { numLoaded++; }};
+
+        auto load = [&](size_t _count) {
+            std::vector<std::shared_ptr<BinaryTileTask>> tasks;
+            for (int x = 0; x < 10; x++) {
+                auto task = std::make_shared<BinaryTileTask>(TileID(x, 0, 7), nullptr);
+                task->setScenePrana(prana);
+                REQUIRE(source.loadTileData(task, cb));
+                tasks.push_back(task);
+            }
+            for (int i = 0; i < 1000 && numLoaded < _count; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            REQUIRE(numLoaded == _count);
+            return tasks;
+        };
+
+        load(10);
+        REQUIRE(next.loads == 10);
+
+        // Loaded again before the worker is idle long enough to write them
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (auto& task : load(20)) {
+            REQUIRE(task->hasData());
+            auto expected = tileData(task->tileId());
+            CHECK(std::string(task->rawTileData->begin(), task->rawTileData->end()) == expected);
+        }
+        CHECK(next.loads == 10);
+    }
+
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
+
+TEST_CASE("MBTiles cache evicts least recently used tiles beyond its size limit", TAGS) {
+    std::string path = "/tmp/tangram-mbtiles-evict-test.mbtiles";
+    std::remove(path.c_str());
+
+    std::vector<std::shared_ptr<BinaryTileTask>> tasks;
+    for (int x = 0; x < 20; x++) {
+        for (int y = 0; y < 10; y++) {
+            tasks.push_back(std::make_shared<BinaryTileTask>(TileID(x, y, 8), nullptr));
+        }
+    }
+    // Tiles of offline downloads are kept
+    tasks[0]->offlineId = 1;
+
+    const size_t maxCacheSize = 256 * 1024;
+    {
+        MockPlatform platform;
+        MBTilesDataSource source(platform, "test", path, "", 3600, false, maxCacheSize);
+        auto next = std::make_unique<TestSource>();
+        next->padding = 4096;
+        source.setNext(std::move(next));
+        auto prana = std::make_shared<ScenePrana>(nullptr);
+
+        std::atomic<size_t> numLoaded{0};
+        TileTaskCb cb{[&](std::shared_ptr<TileTask>) { numLoaded++; }};
+
+        for (auto& task : tasks) {
+            task->setScenePrana(prana);
+            REQUIRE(source.loadTileData(task, cb));
+        }
+
+        TileSourceStats stats;
+        for (int i = 0; i < 1000; i++) {
+            source.getStats(stats);
+            if (numLoaded == tasks.size() && stats.mbtilesEvictedTiles > 0 &&
+                stats.mbtilesCacheBytes <= maxCacheSize) { break; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(numLoaded == tasks.size());
+        CHECK(stats.mbtilesEvictedTiles > 0);
+        CHECK(stats.mbtilesCacheBytes <= maxCacheSize);
+    }
+
+    int tiles = countRows(path, "images");
+    CHECK(tiles < int(tasks.size()));
+    CHECK(countRows(path, "map") == tiles);
+    CHECK(countRows(path, "tile_last_access") == tiles - 1);
+    CHECK(countRows(path, "offline_tiles JOIN images USING (tile_id)") == 1);
+
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
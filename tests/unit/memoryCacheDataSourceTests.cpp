@@ -0,0 +1,183 @@
+#include "catch.hpp"
+
+#include "data/memoryCacheDataSource.h"
+
+#include <string>
+
+using namespace Tangram;
+
+#define TAGS "[MemoryCacheDataSource]"
+
+namespace {
+
+// Returns compressible tile data for each request
+struct TestDataSource : TileSource::DataSource {
+    int loads = 0;
+    int repeat = 1000;
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        loads++;
+        auto& task = static_cast<BinaryTileTask&>(*_task);
+        task.rawTileData = std::make_shared<std::vector<char>>(tileData(_task->tileId(), repeat));
+        _cb.func(_task);
+        return true;
+    }
+
+    static std::vector<char> tileData(const TileID& _tileID, int _repeat = 1000) {
+        std::string data;
+        for (int i = 0; i < _repeat; i++) { data += "tile " + _tileID.toString() + " "; }
+        return { data.begin(), data.end() };
+    }
+};
+
+std::shared_ptr<BinaryTileTask> load(MemoryCacheDataSource& _cache, const TileID& _tileID) {
+    auto task = std::make_shared<BinaryTileTask>(_tileID, nullptr);
+    _cache.loadTileData(task, {[](std::shared_ptr<TileTask>) {}});
+    return task;
+}
+
+}
+
+TEST_CASE("Cached tile data is stored compressed and restored on hit", TAGS) {
+    MemoryCacheDataSource cache;
+    cache.setCacheSize(1 << 20);
+    cache.setNext(std::make_unique<TestDataSource>());
+    auto& source = static_cast<TestDataSource&>(*cache.next);
+
+    TileID tileID(1, 2, 3);
+    auto miss = load(cache, tileID);
+    REQUIRE(source.loads == 1);
+
+    auto hit = load(cache, tileID);
+    REQUIRE(source.loads == 1);
+    REQUIRE(*hit->rawTileData == TestDataSource::tileData(tileID));
+
+    TileSourceStats stats;
+    cache.getStats(stats);
+    CHECK(stats.memoryCacheHits == 1);
+    CHECK(stats.memoryCacheMisses == 1);
+    CHECK(stats.memoryCacheEntries == 1);
+    CHECK(stats.memoryCacheRawBytes == miss->rawTileData->size());
+    CHECK(stats.memoryCacheBytes < stats.memoryCacheRawBytes / 4);
+}
+
+TEST_CASE("Loaded tile data is handed on before it is compressed for the cache", TAGS) {
+    MemoryCacheDataSource cache;
+    cache.setCacheSize(1 << 20);
+    cache.setNext(std::make_unique<TestDataSource>());
+
+    TileSourceStats stats;
+    auto task = std::make_shared<BinaryTileTask>(TileID(1, 2, 3), nullptr);
+    cache.loadTileData(task, {[&](std::shared_ptr<TileTask>) { cache.getStats(stats); }});
+    CHECK(stats.memoryCacheEntries == 0);
+
+    TileSourceStats cached;
+    cache.getStats(cached);
+    CHECK(cached.memoryCacheEntries == 1);
+}
+
+TEST_CASE("Uncompressed cache keeps tile data as loaded", TAGS) {
+    MemoryCacheDataSource cache;
+    cache.setCacheSize(1 << 20);
+    cache.setCompressionLevel(0);
+    cache.setNext(std::make_unique<TestDataSource>());
+
+    TileID tileID(1, 2, 3);
+    auto miss = load(cache, tileID);
+    auto hit = load(cache, tileID);
+    REQUIRE(hit->rawTileData == miss->rawTileData);
+
+    TileSourceStats stats;
+    cache.getStats(stats);
+    CHECK(stats.memoryCacheBytes == stats.memoryCacheRawBytes);
+}
+
+TEST_CASE("Cache evicts least recently used tiles to stay within its budget", TAGS) {
+    MemoryCacheDataSource cache;
+    cache.setCacheSize(64 * 1024);
+    cache.setNext(std::make_unique<TestDataSource>());
+    auto& source = static_cast<TestDataSource&>(*cache.next);
+
+    for (int x = 0; x < 1000; x++) { load(cache, TileID(x, 0, 10)); }
+    REQUIRE(source.loads == 1000);
+
+    TileSourceStats stats;
+    cache.getStats(stats);
+    CHECK(stats.memoryCacheBytes <= 64 * 1024);
+    CHECK(stats.memoryCacheEntries > 0);
+    CHECK(stats.memoryCacheEntries < 1000);
+
+    // The most recent tile is still cached, the first one was evicted
+    load(cache, TileID(999, 0, 10));
+    CHECK(source.loads == 1000);
+    load(cache, TileID(0, 0, 10));
+    CHECK(source.loads == 1001);
+
+    cache.clear();
+    load(cache, TileID(999, 0, 10));
+    CHECK(source.loads == 1002);
+}
+
+TEST_CASE("Cache keeps tiles larger than an even share of its budget", TAGS) {
+    MemoryCacheDataSource cache;
+    cache.setCompressionLevel(0);
+    cache.setNext(std::make_unique<TestDataSource>());
+    auto& source = static_cast<TestDataSource&>(*cache.next);
+
+    // Budget for a few tiles, much less than one tile for each shard
+    size_t tileSize = TestDataSource::tileData(TileID(0, 0, 10)).size();
+    cache.setCacheSize(tileSize * 3);
+
+    load(cache, TileID(0, 0, 10));
+    load(cache, TileID(0, 0, 10));
+    CHECK(source.loads == 1);
+
+    for (int x = 1; x < 10; x++) { load(cache, TileID(x, 0, 10)); }
+
+    TileSourceStats stats;
+    cache.getStats(stats);
+    CHECK(stats.memoryCacheBytes <= tileSize * 3);
+    CHECK(stats.memoryCacheEntries >= 2);
+
+    // The most recent tile is still cached
+    load(cache, TileID(9, 0, 10));
+    CHECK(source.loads == 10);
+
+    // Tiles larger than the whole budget are not cached and do not evict others
+    cache.setCacheSize(tileSize - 1);
+    cache.clear();
+    load(cache, TileID(0, 0, 10));
+    load(cache, TileID(0, 0, 10));
+    CHECK(source.loads == 12);
+}
+
+TEST_CASE("Cache drops the outdated entry of a tile reloaded larger than its budget", TAGS) {
+    MemoryCacheDataSource cache;
+    cache.setCompressionLevel(0);
+    cache.setNext(std::make_unique<TestDataSource>());
+    auto& source = static_cast<TestDataSource&>(*cache.next);
+
+    TileID tileID(1, 2, 3);
+    size_t tileSize = TestDataSource::tileData(tileID).size();
+    cache.setCacheSize(tileSize * 3);
+
+    load(cache, tileID);
+    REQUIRE(source.loads == 1);
+
+    // Reload the tile from the source, now too large to be cached
+    source.repeat = 10000;
+    auto task = std::make_shared<BinaryTileTask>(tileID, nullptr);
+    task->rawSource = source.level;
+    cache.loadTileData(task, {[](std::shared_ptr<TileTask>) {}});
+    REQUIRE(source.loads == 2);
+
+    // The earlier data of the tile is not returned anymore
+    auto reloaded = load(cache, tileID);
+    CHECK(source.loads == 3);
+    CHECK(*reloaded->rawTileData == TestDataSource::tileData(tileID, 10000));
+
+    TileSourceStats stats;
+    cache.getStats(stats);
+    CHECK(stats.memoryCacheEntries == 0);
+    CHECK(stats.memoryCacheBytes == 0);
+}
@@ -0,0 +1,68 @@
+#include "catch.hpp"
+
+#include "data/missingTileCache.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace Tangram;
+
+#define TAGS "[MissingTileCache]"
+
+using Failure = MissingTileCache::Failure;
+
+TEST_CASE("Missing tiles are remembered until their failure expires", TAGS) {
+    MissingTileCache cache;
+    cache.setTimeout(Failure::offline, std::chrono::milliseconds(20));
+
+    TileID notFound(1, 2, 3), offline(2, 1, 3);
+    cache.put(notFound, Failure::notFound);
+    cache.put(offline, Failure::offline);
+
+    CHECK(cache.contains(notFound));
+    CHECK(cache.contains(offline));
+    CHECK(!cache.contains(TileID(0, 0, 0)));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    CHECK(cache.contains(notFound));
+    CHECK(!cache.contains(offline));
+
+    TileSourceStats stats;
+    cache.getStats(stats);
+    CHECK(stats.missingTileEntries == 1);
+    CHECK(stats.missingTileHits == 3);
+}
+
+TEST_CASE("Missing tiles are forgotten once loaded or cleared", TAGS) {
+    MissingTileCache cache;
+
+    TileID a(1, 2, 3), b(2, 1, 3);
+    cache.put(a, Failure::notFound);
+    cache.put(b, Failure::timeout);
+
+    cache.erase(a);
+    CHECK(!cache.contains(a));
+    CHECK(cache.contains(b));
+
+    cache.clear();
+    CHECK(!cache.contains(b));
+}
+
+TEST_CASE("Missing tiles expiring first are forgotten when there are too many", TAGS) {
+    MissingTileCache cache;
+
+    const int count = 4096;
+    for (int i = 0; i < count; i++) {
+        cache.put(TileID(i, 0, 12), Failure::notFound);
+    }
+    cache.put(TileID(0, 1, 12), Failure::notFound);
+
+    TileSourceStats stats;
+    cache.getStats(stats);
+    CHECK(stats.missingTileEntries == count);
+
+    CHECK(!cache.contains(TileID(0, 0, 12)));
+    CHECK(cache.contains(TileID(1, 0, 12)));
+    CHECK(cache.contains(TileID(count - 1, 0, 12)));
+    CHECK(cache.contains(TileID(0, 1, 12)));
+}
@@ -0,0 +1,131 @@
+#include "catch.hpp"
+
+#include "pbf/pbf.hpp"
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define TAGS "[Pbf]"
+
+namespace {
+
+void appendVarint(std::string& _buffer, uint64_t _value) {
+    while (_value >= 0x80) {
+        _buffer.push_back(static_cast<char>((_value & 0x7f) | 0x80));
+        _value >>= 7;
+    }
+    _buffer.push_back(static_cast<char>(_value));
+}
+
+struct Decoded {
+    std::vector<uint64_t> values;
+    bool failed = false;
+};
+
+// Decode all varints of _buffer with repeated varint() calls
+Decoded decodeScalar(const std::string& _buffer) {
+    Decoded decoded;
+    protobuf::message msg(_buffer.data(), _buffer.size());
+    try {
+        while (msg.getData() < msg.getEnd()) { decoded.values.push_back(msg.varint()); }
+    } catch (const std::runtime_error&) {
+        decoded.failed = true;
+    }
+    return decoded;
+}
+
+// Decode all varints of _buffer with varints() calls of at most _max values
+Decoded decodeBlocks(const std::string& _buffer, size_t _max) {
+    Decoded decoded;
+    protobuf::message msg(_buffer.data(), _buffer.size());
+    std::vector<uint64_t> out(_max);
+    try {
+        while (size_t n = msg.varints(out.data(), _max)) {
+            decoded.values.insert(decoded.values.end(), out.begin(), out.begin() + n);
+        }
+    } catch (const std::runtime_error&) {
+        decoded.failed = true;
+    }
+    return decoded;
+}
+
+void checkDecoders(const std::string& _buffer) {
+    auto scalar = decodeScalar(_buffer);
+    for (size_t max : { 1, 3, 8, 16, 64, 1024 }) {
+        INFO("max " << max);
+        auto blocks = decodeBlocks(_buffer, max);
+        REQUIRE(blocks.failed == scalar.failed);
+        if (!scalar.failed) {
+            REQUIRE(blocks.values == scalar.values);
+        }
+    }
+}
+
+}
+
+TEST_CASE("Block decoding matches single varints of 1 to 10 bytes", TAGS) {
+    for (int bytes = 1; bytes <= 10; bytes++) {
+        INFO("bytes " << bytes);
+        // Smallest and largest values of this length
+        uint64_t min = bytes == 1 ? 0 : uint64_t(1) << (7 * (bytes - 1));
+        uint64_t max = bytes == 10 ? UINT64_MAX : (uint64_t(1) << (7 * bytes)) - 1;
+
+        for (uint64_t value : { min, max }) {
+            // Alone, and within runs long enough for the block paths
+            for (size_t count : { 1, 7, 16, 40 }) {
+                std::string buffer;
+                for (size_t i = 0; i < count; i++) { appendVarint(buffer, value); }
+                REQUIRE(buffer.size() == count * bytes);
+
+                checkDecoders(buffer);
+                auto blocks = decodeBlocks(buffer, 1024);
+                REQUIRE(blocks.values == std::vector<uint64_t>(count, value));
+            }
+        }
+    }
+}
+
+TEST_CASE("Block decoding fails like varint() on buffers ending within a varint", TAGS) {
+    std::mt19937 random(1);
+    for (int bytes = 2; bytes <= 10; bytes++) {
+        for (size_t prefix : { 0, 5, 15, 16, 30 }) {
+            std::string buffer;
+            for (size_t i = 0; i < prefix; i++) { appendVarint(buffer, random() % 300); }
+            std::string varint;
+            appendVarint(varint, bytes == 10 ? UINT64_MAX : uint64_t(1) << (7 * (bytes - 1)));
+            buffer += varint.substr(0, bytes - 1);
+
+            INFO("bytes " << bytes << ", prefix " << prefix);
+            REQUIRE(decodeScalar(buffer).failed);
+            checkDecoders(buffer);
+        }
+    }
+}
+
+TEST_CASE("Block decoding matches varint() on random input", TAGS) {
+    std::mt19937_64 random(42);
+
+    for (int round = 0; round < 200; round++) {
+        std::string buffer;
+        size_t count = random() % 100;
+        for (size_t i = 0; i < count; i++) {
+            // Mostly short values as in MVT geometry, some up to 64 bits
+            int bits = (random() % 4 == 0) ? int(random() % 64) + 1 : int(random() % 14) + 1;
+            uint64_t value = random() & (bits == 64 ? UINT64_MAX : (uint64_t(1) << bits) - 1);
+            appendVarint(buffer, value);
+        }
+        INFO("round " << round);
+        checkDecoders(buffer);
+        REQUIRE(decodeBlocks(buffer, 1024).values.size() == count);
+    }
+
+    // Arbitrary bytes, including unterminated and over-long varints
+    for (int round = 0; round < 200; round++) {
+        std::string buffer(random() % 80, '\0');
+        for (auto& byte : buffer) { byte = static_cast<char>(random()); }
+        INFO("bytes round " << round);
+        checkDecoders(buffer);
+    }
+}
@@ -0,0 +1,171 @@
+#include "catch.hpp"
+
+#include "data/pmtilesDataSource.h"
+#include "scene/scene.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace Tangram;
+
+#define TAGS "[PMTilesDataSource]"
+
+namespace {
+
+struct Entry {
+    uint64_t tileId;
+    uint64_t offset;
+    uint64_t length;
+    uint64_t runLength;
+};
+
+void putVarint(std::string& _out, uint64_t _value) {
+    while (_value >= 0x80) {
+        _out.push_back(char((_value & 0x7f) | 0x80));
+        _value >>= 7;
+    }
+    _out.push_back(char(_value));
+}
+
+void putUint64(std::string& _out, size_t _pos, uint64_t _value) {
+    for (int i = 0; i < 8; i++) { _out[_pos + i] = char((_value >> (8 * i)) & 0xff); }
+}
+
+std::string directory(const std::vector<Entry>& _entries) {
+    std::string out;
+    putVarint(out, _entries.size());
+    uint64_t lastId = 0;
+    for (auto& entry : _entries) {
+        putVarint(out, entry.tileId - lastId);
+        lastId = entry.tileId;
+    }
+    for (auto& entry : _entries) { putVarint(out, entry.runLength); }
+    for (auto& entry : _entries) { putVarint(out, entry.length); }
+    for (size_t i = 0; i < _entries.size(); i++) {
+        bool continues = i > 0 && _entries[i].offset == _entries[i-1].offset + _entries[i-1].length;
+        putVarint(out, continues ? 0 : _entries[i].offset + 1);
+    }
+    return out;
+}
+
+std::string tileData(const TileID& _tileID) {
+    return "tile " + _tileID.toString();
+}
+
+// Write an uncompressed archive with the tiles of zoom 0 to 2, split over two leaf directories.
+// The last two tiles share their data.
+void createPMTiles(const std::string& _path) {
+    std::vector<TileID> tiles;
+    for (int z = 0; z <= 2; z++) {
+        for (int x = 0; x < (1 << z); x++) {
+            for (int y = 0; y < (1 << z); y++) { tiles.emplace_back(x, y, z); }
+        }
+    }
+    std::sort(tiles.begin(), tiles.end(), [](auto& _a, auto& _b) {
+        return PMTilesDataSource::tileIdToHilbert(_a) < PMTilesDataSource::tileIdToHilbert(_b);
+    });
+
+    std::string data;
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < tiles.size() - 1; i++) {
+        bool shared = i == tiles.size() - 2;
+        auto tile = shared ? std::string("shared") : tileData(tiles[i]);
+        entries.push_back({ PMTilesDataSource::tileIdToHilbert(tiles[i]), data.size(), tile.size(),
+                            shared ? 2u : 1u });
+        data += tile;
+    }
+
+    std::vector<Entry> first(entries.begin(), entries.begin() + 10);
+    std::vector<Entry> second(entries.begin() + 10, entries.end());
+    std::string leaves = directory(first);
+    size_t secondOffset = leaves.size();
+    leaves += directory(second);
+
+    std::string root = directory({
+        { first.front().tileId, 0, secondOffset, 0 },
+        { second.front().tileId, secondOffset, leaves.size() - secondOffset, 0 }
+    });
+
+    std::string header(127, '\0');
+    header.replace(0, 8, "PMTiles\x03", 8);
+    putUint64(header, 8, header.size());
+    putUint64(header, 16, root.size());
+    putUint64(header, 40, header.size() + root.size());
+    putUint64(header, 48, leaves.size());
+    putUint64(header, 56, header.size() + root.size() + leaves.size());
+    putUint64(header, 64, data.size());
+    header[97] = 1;  // uncompressed directories
+    header[98] = 1;  // uncompressed tiles
+    header[100] = 0;
+    header[101] = 2;
+
+    std::ofstream file(_path, std::ofstream::binary | std::ofstream::trunc);
+    file << header << root << leaves << data;
+}
+
+}
+
+TEST_CASE("Tile IDs follow the Hilbert curve of each zoom level", TAGS) {
+    CHECK(PMTilesDataSource::tileIdToHilbert(TileID(0, 0, 0)) == 0);
+    CHECK(PMTilesDataSource::tileIdToHilbert(TileID(0, 0, 1)) == 1);
+    CHECK(PMTilesDataSource::tileIdToHilbert(TileID(0, 1, 1)) == 2);
+    CHECK(PMTilesDataSource::tileIdToHilbert(TileID(1, 1, 1)) == 3);
+    CHECK(PMTilesDataSource::tileIdToHilbert(TileID(1, 0, 1)) == 4);
+    CHECK(PMTilesDataSource::tileIdToHilbert(TileID(0, 0, 2)) == 5);
+    CHECK(PMTilesDataSource::tileIdToHilbert(TileID(0, 0, 12)) == 5592405);
+}
+
+TEST_CASE("PMTiles archive returns the data of each requested tile", TAGS) {
+    std::string path = "/tmp/tangram-pmtiles-test.pmtiles";
+    createPMTiles(path);
+
+    PMTilesDataSource source("test", path);
+    auto prana = std::make_shared<ScenePrana>(nullptr);
+
+    std::atomic<size_t> numLoaded{0};
+    TileTaskCb cb{[&](std::shared_ptr<TileTask>) { numLoaded++; }};
+
+    std::vector<std::shared_ptr<BinaryTileTask>> tasks;
+    for (int z = 0; z <= 2; z++) {
+        for (int x = 0; x < (1 << z); x++) {
+            for (int y = 0; y < (1 << z); y++) {
+                tasks.push_back(std::make_shared<BinaryTileTask>(TileID(x, y, z), nullptr));
+            }
+        }
+    }
+    // Beyond the zoom levels of the archive
+    tasks.push_back(std::make_shared<BinaryTileTask>(TileID(0, 0, 3), nullptr));
+
+    for (auto& task : tasks) {
+        task->setScenePrana(prana);
+        REQUIRE(source.loadTileData(task, cb));
+    }
+    for (int i = 0; i < 1000 && numLoaded < tasks.size(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(numLoaded == tasks.size());
+
+    size_t shared = 0;
+    for (size_t i = 0; i < tasks.size() - 1; i++) {
+        auto& task = *tasks[i];
+        REQUIRE(task.hasData());
+        auto data = std::string(task.rawTileData->begin(), task.rawTileData->end());
+        if (data == "shared") {
+            shared++;
+        } else {
+            CHECK(data == tileData(task.tileId()));
+        }
+    }
+    CHECK(shared == 2);
+    CHECK(!tasks.back()->hasData());
+
+    TileSourceStats stats;
+    source.getStats(stats);
+    CHECK(stats.pmtilesReadTiles == tasks.size());
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,124 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+
+using namespace Tangram;
+
+TEST_CASE( "PropertyKeys are interned once per string", "[Core][Properties]" ) {
+
+    PropertyKey a("test_key_a");
+    PropertyKey b(std::string("test_key_a"));
+    PropertyKey c("test_key_c");
+
+    REQUIRE(a == b);
+    REQUIRE(a != c);
+    REQUIRE(&a.str() == &b.str());
+    REQUIRE(a.str() == "test_key_a");
+
+    REQUIRE(PropertyKey().empty());
+    REQUIRE(PropertyKey() == PropertyKey(""));
+}
+
+TEST_CASE( "PropertyKey::find does not intern unknown strings", "[Core][Properties]" ) {
+
+    PropertyKey found = PropertyKey::find("test_key_a");
+    REQUIRE(found.isValid());
+    REQUIRE(found == PropertyKey("test_key_a"));
+
+    PropertyKey missing = PropertyKey::find("test_key_never_interned");
+    REQUIRE(!missing.isValid());
+
+    // A later intern of the same string must be found
+    PropertyKey interned("test_key_never_interned");
+    REQUIRE(PropertyKey::find("test_key_never_interned") == interned);
+}
+
+TEST_CASE( "Properties lookup by interned key", "[Core][Properties]" ) {
+
+    Properties props;
+    props.set("name", "foo");
+    props.set("kind", "bar");
+    props.set("height", 10.0);
+
+    REQUIRE(props.contains("name"));
+    REQUIRE(props.getString("kind") == "bar");
+    REQUIRE(props.getNumber("height") == 10.0);
+    REQUIRE(!props.contains("test_key_unset"));
+    REQUIRE(!props.contains(PropertyKey::find("test_key_never_seen")));
+
+    props.set("name", "baz");
+    REQUIRE(props.getString("name") == "baz");
+    REQUIRE(props.items().size() == 3);
+
+    Properties sorted({{"zzz_key", 1.0}, {"aaa_key", 2.0}});
+    REQUIRE(sorted.getNumber("zzz_key") == 1.0);
+    REQUIRE(sorted.getNumber("aaa_key") == 2.0);
+}
+
+TEST_CASE( "Properties are output in key order independent of key ids", "[Core][Properties]" ) {
+
+    // Intern keys in an order unlike the output order
+    Properties props;
+    props.set("test_order_name", "a");
+    props.set("test_order_b", 2.0);
+    props.set("test_order_a", 1.0);
+
+    REQUIRE(props.toJson() == R"({"test_order_a":1.0,"test_order_b":2.0,"test_order_name":"a"})");
+
+    auto items = props.sortedItems();
+    REQUIRE(items.size() == 3);
+    REQUIRE(items[0]->key.str() == "test_order_a");
+    REQUIRE(items[2]->key.str() == "test_order_name");
+}
+
+TEST_CASE( "PropertyKeys beyond the table size are shared while referenced", "[Core][Properties]" ) {
+
+    PropertyKey name("name");
+
+    // Fill the table without adding keys
+    PropertyKey::setMaxInterned(PropertyKey::internedCount());
+
+    {
+        PropertyKey a("test_key_overflow_a");
+        PropertyKey b(std::string("test_key_overflow_a"));
+        PropertyKey c("test_key_overflow_c");
+
+        REQUIRE(a.isValid());
+        REQUIRE(!a.isInterned());
+        REQUIRE(a == b);
+        REQUIRE(a != c);
+        REQUIRE(&a.str() == &b.str());
+        REQUIRE(a.str() == "test_key_overflow_a");
+        REQUIRE(name < a);
+        REQUIRE(PropertyKey::find("test_key_overflow_a") == a);
+        REQUIRE(!PropertyKey::find("test_key_overflow_never_interned").isValid());
+        REQUIRE(PropertyKey("name").isInterned());
+
+        Properties props;
+        props.set(c, 1.0);
+        props.set("name", "foo");
+        props.set(a, 2.0);
+        props.set("test_key_overflow_b", 3.0);
+
+        REQUIRE(props.items().size() == 4);
+        REQUIRE(props.getNumber(b) == 2.0);
+        REQUIRE(props.getNumber("test_key_overflow_b") == 3.0);
+        REQUIRE(props.getNumber("test_key_overflow_c") == 1.0);
+        REQUIRE(props.getString("name") == "foo");
+        REQUIRE(!props.contains("test_key_overflow_d"));
+
+        // Copies of shared keys outlive the Properties they were taken from
+        PropertyKey copy;
+        for (auto& item : props.items()) {
+            if (item.key.str() == "test_key_overflow_b") { copy = item.key; }
+        }
+        props.clear();
+        REQUIRE(copy.str() == "test_key_overflow_b");
+    }
+
+    PropertyKey::setMaxInterned(PropertyKey::defaultMaxInterned);
+
+    PropertyKey interned("test_key_after_overflow");
+    REQUIRE(interned.isInterned());
+}
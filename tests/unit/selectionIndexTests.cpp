@@ -0,0 +1,146 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+#include "selection/selectionIndex.h"
+
+#include <algorithm>
+#include <array>
+
+using namespace Tangram;
+
+#define TAGS "[SelectionIndex]"
+
+namespace {
+
+std::vector<uint32_t> query(const SelectionIndex& _index, glm::vec2 _position, float _radius) {
+    std::vector<SelectionIndex::Hit> hits;
+    _index.query(_position, _radius, hits);
+    std::vector<uint32_t> colors;
+    for (const auto& hit : hits) { colors.push_back(hit.selectionColor); }
+    std::sort(colors.begin(), colors.end());
+    return colors;
+}
+
+}
+
+TEST_CASE("SelectionIndex finds points, lines and polygons near a position", TAGS) {
+    SelectionIndex index;
+
+    Feature points;
+    points.geometryType = GeometryType::points;
+    points.points = { { 0.1f, 0.1f }, { 0.9f, 0.9f } };
+    index.add(1, points);
+
+    // A line across the tile with many segments, split into several items
+    Feature line;
+    line.geometryType = GeometryType::lines;
+    std::vector<Point> coordinates;
+    for (int i = 0; i <= 100; i++) { coordinates.push_back({ i / 100.f, 0.5f }); }
+    line.addLine(coordinates.begin(), coordinates.end());
+    index.add(2, line);
+
+    // A square with a hole
+    Feature polygon;
+    polygon.geometryType = GeometryType::polygons;
+    polygon.beginPolygon();
+    std::vector<Point> outer = { { 0.6f, 0.6f }, { 0.8f, 0.6f }, { 0.8f, 0.8f }, { 0.6f, 0.8f }, { 0.6f, 0.6f } };
+    std::vector<Point> inner = { { 0.65f, 0.65f }, { 0.75f, 0.65f }, { 0.75f, 0.75f }, { 0.65f, 0.75f }, { 0.65f, 0.65f } };
+    polygon.addRing(outer.begin(), outer.end());
+    polygon.addRing(inner.begin(), inner.end());
+    index.add(3, polygon);
+
+    index.build();
+    REQUIRE(!index.empty());
+
+    CHECK(query(index, { 0.11f, 0.1f }, 0.02f) == std::vector<uint32_t>({ 1 }));
+    CHECK(query(index, { 0.2f, 0.1f }, 0.02f).empty());
+    CHECK(query(index, { 0.33f, 0.51f }, 0.02f) == std::vector<uint32_t>({ 2 }));
+    CHECK(query(index, { 0.62f, 0.62f }, 0.001f) == std::vector<uint32_t>({ 3 }));
+    CHECK(query(index, { 0.7f, 0.7f }, 0.001f).empty());
+    CHECK(query(index, { 0.7f, 0.7f }, 0.06f) == std::vector<uint32_t>({ 3 }));
+    CHECK(query(index, { 0.5f, 0.5f }, 1.f) == std::vector<uint32_t>({ 1, 2, 3 }));
+
+    // Distances are to the nearest geometry, one hit for each feature
+    std::vector<SelectionIndex::Hit> hits;
+    index.query({ 0.5f, 0.55f }, 0.1f, hits);
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].distance == Approx(0.05f));
+}
+
+TEST_CASE("SelectionIndex finds geometry outside of the tile", TAGS) {
+    SelectionIndex index;
+
+    Feature points;
+    points.geometryType = GeometryType::points;
+    points.points = { { -0.5f, 1.5f } };
+    index.add(1, points);
+    index.build();
+
+    CHECK(query(index, { -0.5f, 1.49f }, 0.02f) == std::vector<uint32_t>({ 1 }));
+    CHECK(query(index, { 0.f, 1.f }, 0.02f).empty());
+}
+
+TEST_CASE("SelectionIndex restores serialized geometry with other selection colors", TAGS) {
+    SelectionIndex index;
+
+    Feature line;
+    line.geometryType = GeometryType::lines;
+    std::vector<Point> coordinates = { { 0.1f, 0.5f }, { 0.9f, 0.5f } };
+    line.addLine(coordinates.begin(), coordinates.end());
+    index.add(1, line);
+
+    Feature polygon;
+    polygon.geometryType = GeometryType::polygons;
+    polygon.beginPolygon();
+    std::vector<Point> outer = { { 0.6f, 0.6f }, { 0.8f, 0.6f }, { 0.8f, 0.8f }, { 0.6f, 0.8f }, { 0.6f, 0.6f } };
+    std::vector<Point> inner = { { 0.65f, 0.65f }, { 0.75f, 0.65f }, { 0.75f, 0.75f }, { 0.65f, 0.75f }, { 0.65f, 0.65f } };
+    polygon.addRing(outer.begin(), outer.end());
+    polygon.addRing(inner.begin(), inner.end());
+    index.add(2, polygon);
+
+    Feature points;
+    points.geometryType = GeometryType::points;
+    points.points = { { 0.1f, 0.1f }, { 0.2f, 0.1f } };
+    index.add(3, points);
+
+    // Only the geometry of the given colors is written
+    std::vector<char> data;
+    index.serialize({ 2, 3 }, data);
+
+    // Geometry of colors without a mapping is skipped
+    fastmap<uint32_t, uint32_t> colors;
+    colors[2] = 20;
+    colors[3] = 30;
+
+    SelectionIndex restored;
+    REQUIRE(restored.deserialize(data.data(), data.size(), colors));
+    restored.build();
+
+    CHECK(query(restored, { 0.5f, 0.5f }, 0.01f).empty());
+    CHECK(query(restored, { 0.62f, 0.62f }, 0.001f) == std::vector<uint32_t>({ 20 }));
+    CHECK(query(restored, { 0.7f, 0.7f }, 0.001f).empty());
+    CHECK(query(restored, { 0.2f, 0.1f }, 0.01f) == std::vector<uint32_t>({ 30 }));
+
+    colors = {};
+    colors[3] = 40;
+    SelectionIndex partial;
+    REQUIRE(partial.deserialize(data.data(), data.size(), colors));
+    partial.build();
+    CHECK(query(partial, { 0.62f, 0.62f }, 0.001f).empty());
+    CHECK(query(partial, { 0.1f, 0.1f }, 0.01f) == std::vector<uint32_t>({ 40 }));
+
+    // Truncated data is rejected
+    CHECK(!SelectionIndex().deserialize(data.data(), data.size() - 1, colors));
+}
+
+TEST_CASE("SelectionIndex measures the distance to quads", TAGS) {
+    std::array<glm::vec2, 4> quad = {{ { 0, 0 }, { 10, 0 }, { 10, 5 }, { 0, 5 } }};
+
+    CHECK(SelectionIndex::quadDistance({ 5, 2 }, quad) == 0.f);
+    CHECK(SelectionIndex::quadDistance({ 13, 2 }, quad) == Approx(3.f));
+
+    // Either winding
+    std::reverse(quad.begin(), quad.end());
+    CHECK(SelectionIndex::quadDistance({ 5, 2 }, quad) == 0.f);
+    CHECK(SelectionIndex::quadDistance({ 5, -4 }, quad) == Approx(4.f));
+}
@@ -0,0 +1,50 @@
+#include "catch.hpp"
+
+#include "util/stats.h"
+
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+using namespace std::chrono;
+
+TEST_CASE( "DurationCounter sorts durations into power of two microsecond buckets", "[Core][Stats]" ) {
+
+    DurationCounter counter;
+    counter.add(microseconds(0));
+    counter.add(microseconds(1));
+    counter.add(microseconds(3));
+    counter.add(microseconds(1000));
+    counter.add(hours(1));
+
+    auto stats = counter.get();
+    REQUIRE(stats.count == 5);
+    REQUIRE(stats.buckets[0] == 2);
+    REQUIRE(stats.buckets[1] == 1);
+    // 2^9 <= 1000 < 2^10
+    REQUIRE(stats.buckets[9] == 1);
+    REQUIRE(stats.buckets[DurationStats::numBuckets - 1] == 1);
+    REQUIRE(stats.totalMs == Approx(3600.0 * 1000 + 1.004));
+}
+
+TEST_CASE( "Counters can be updated from multiple threads", "[Core][Stats]" ) {
+
+    StatCounter counter;
+    DurationCounter durations;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; i++) {
+                counter.add();
+                durations.add(microseconds(10));
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    REQUIRE(counter.get() == 4000);
+    REQUIRE(durations.get().count == 4000);
+    REQUIRE(durations.get().buckets[3] == 4000);
+    REQUIRE(durations.get().averageMs() == Approx(0.01));
+}
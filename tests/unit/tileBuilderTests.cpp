@@ -0,0 +1,308 @@
+#include "catch.hpp"
+
+#include "data/formats/mvt.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "style/style.h"
+#include "tile/tile.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileTask.h"
+#include "view/view.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+#define TAGS "[TileBuilder]"
+
+namespace {
+
+const char* sceneYaml = R"END(
+sources:
+    src:
+        type: GeoJSON
+        url: https://localhost/{z}/{x}/{y}.json
+layers:
+    major:
+        data: { source: src, layer: roads }
+        filter: { kind: major }
+        draw:
+            lines: { color: red, width: 2px, order: 2 }
+    roads:
+        data: { source: src, layer: roads }
+        draw:
+            lines: { color: blue, width: 1px, order: 1 }
+    water:
+        data: { source: src, layer: water }
+        draw:
+            lines: { color: blue, width: 1px, order: 0 }
+)END";
+
+// LazyLayer of lines, counting how often features are decoded
+struct CountingLayer : public LazyLayer {
+
+    CountingLayer(const std::string& _name, std::vector<std::string> _kinds)
+        : LazyLayer(_name), kinds(std::move(_kinds)) {}
+
+    std::vector<std::string> kinds;
+    size_t next = 0;
+    int decodedProperties = 0;
+    int decodedGeometry = 0;
+
+    void rewind() override { next = 0; }
+
+    bool nextFeature(Feature& _feature) override {
+        _feature.props.clear();
+        _feature.geometryType = GeometryType::lines;
+        _feature.clearGeometry();
+        if (next == kinds.size()) { return false; }
+        _feature.props.set("kind", kinds[next++]);
+        decodedProperties++;
+        return true;
+    }
+
+    void getGeometry(Feature& _feature) override { getGeometry(next - 1, _feature); }
+
+    void getGeometry(size_t _index, Feature& _feature) override {
+        float y = 0.1f + 0.1f * _index;
+        std::vector<Point> line = { { 0.1f, y }, { 0.9f, y } };
+        _feature.addLine(line.begin(), line.end());
+        decodedGeometry++;
+    }
+};
+
+const char* quantizedSceneYaml = R"END(
+sources:
+    plain:
+        type: MVT
+        url: https://localhost/plain/{z}/{x}/{y}.mvt
+    quantized:
+        type: MVT
+        url: https://localhost/quantized/{z}/{x}/{y}.mvt
+        quantize_geometry: true
+layers:
+    plain:
+        data: { source: plain, layer: shapes }
+        draw:
+            polygons: { color: green, order: 1 }
+            lines: { color: red, width: 2px, order: 2 }
+    quantized:
+        data: { source: quantized, layer: shapes }
+        draw:
+            polygons: { color: green, order: 1 }
+            lines: { color: red, width: 2px, order: 2 }
+)END";
+
+// Minimal protobuf encoding of MVT tiles
+void appendVarint(std::vector<char>& _out, uint64_t _value) {
+    while (_value >= 0x80) {
+        _out.push_back(char((_value & 0x7f) | 0x80));
+        _value >>= 7;
+    }
+    _out.push_back(char(_value));
+}
+
+void appendVarintField(std::vector<char>& _out, uint32_t _field, uint64_t _value) {
+    appendVarint(_out, (_field << 3) | 0);
+    appendVarint(_out, _value);
+}
+
+void appendBytesField(std::vector<char>& _out, uint32_t _field, const std::vector<char>& _bytes) {
+    appendVarint(_out, (_field << 3) | 2);
+    appendVarint(_out, _bytes.size());
+    _out.insert(_out.end(), _bytes.begin(), _bytes.end());
+}
+
+void appendPackedField(std::vector<char>& _out, uint32_t _field, const std::vector<uint32_t>& _values) {
+    std::vector<char> packed;
+    for (auto value : _values) { appendVarint(packed, value); }
+    appendBytesField(_out, _field, packed);
+}
+
+uint32_t command(uint32_t _id, uint32_t _count) { return (_id & 0x7) | (_count << 3); }
+uint32_t zigzag(int32_t _n) { return uint32_t((_n << 1) ^ (_n >> 31)); }
+
+// Tile with layer 'shapes' of a square polygon and a line, both of kind 'park'
+std::vector<char> shapesTile() {
+    enum { moveTo = 1, lineTo = 2, closePath = 7 };
+
+    std::vector<char> polygon;
+    appendPackedField(polygon, 2, { 0, 0 });
+    appendVarintField(polygon, 3, 3);
+    appendPackedField(polygon, 4, {
+        command(moveTo, 1), zigzag(512), zigzag(512),
+        command(lineTo, 3), zigzag(512), zigzag(0), zigzag(0), zigzag(512), zigzag(-512), zigzag(0),
+        command(closePath, 1) });
+
+    std::vector<char> line;
+    appendPackedField(line, 2, { 0, 0 });
+    appendVarintField(line, 3, 2);
+    appendPackedField(line, 4, {
+        command(moveTo, 1), zigzag(100), zigzag(3000),
+        command(lineTo, 2), zigzag(1000), zigzag(0), zigzag(1000), zigzag(-500) });
+
+    std::vector<char> value;
+    appendBytesField(value, 1, { 'p', 'a', 'r', 'k' });
+
+    std::vector<char> layer;
+    appendVarintField(layer, 15, 2);
+    appendBytesField(layer, 1, { 's', 'h', 'a', 'p', 'e', 's' });
+    appendBytesField(layer, 2, polygon);
+    appendBytesField(layer, 2, line);
+    appendBytesField(layer, 3, { 'k', 'i', 'n', 'd' });
+    appendBytesField(layer, 4, value);
+    appendVarintField(layer, 5, 4096);
+
+    std::vector<char> tile;
+    appendBytesField(tile, 3, layer);
+    return tile;
+}
+
+}
+
+TEST_CASE("Features of collections used by several data layers are decoded once per tile", TAGS) {
+    MockPlatform platform;
+    SceneOptions options{sceneYaml, Url()};
+    options.numTileWorkers = 0;
+    options.prefetchTiles = false;
+    Scene scene(platform, std::move(options));
+    REQUIRE(scene.load());
+    View view(256, 256);
+    REQUIRE(scene.completeScene(view));
+    REQUIRE(scene.tileSources().size() == 1);
+    const auto& source = *scene.tileSources().front();
+
+    TileData tileData;
+    auto roads = std::make_unique<CountingLayer>("roads", std::vector<std::string>{ "major", "minor", "minor" });
+    auto water = std::make_unique<CountingLayer>("water", std::vector<std::string>{ "river", "lake" });
+    auto* roadsLayer = roads.get();
+    auto* waterLayer = water.get();
+    tileData.lazyLayers.push_back(std::move(roads));
+    tileData.lazyLayers.push_back(std::move(water));
+
+    TileBuilder builder(scene);
+    builder.init();
+
+    for (int build = 0; build < 2; build++) {
+        INFO("build " << build);
+        roadsLayer->decodedProperties = roadsLayer->decodedGeometry = 0;
+        waterLayer->decodedProperties = waterLayer->decodedGeometry = 0;
+
+        Tile tile(TileID(1, 2, 3), source.id());
+        builder.build(tile, tileData, source);
+
+        // Decoded for both data layers at once, with geometry of the features matched by either
+        CHECK(roadsLayer->decodedProperties == 3);
+        CHECK(roadsLayer->decodedGeometry == 3);
+
+        CHECK(waterLayer->decodedProperties == 2);
+        CHECK(waterLayer->decodedGeometry == 2);
+
+        for (const auto& style : scene.styles()) {
+            if (style->getName() == "lines") { CHECK(tile.getMesh(*style)); }
+        }
+    }
+}
+
+TEST_CASE("MVT sources with quantize_geometry build the same meshes from quantized geometry", TAGS) {
+    MockPlatform platform;
+    SceneOptions options{quantizedSceneYaml, Url()};
+    options.numTileWorkers = 0;
+    options.prefetchTiles = false;
+    Scene scene(platform, std::move(options));
+    REQUIRE(scene.load());
+    View view(256, 256);
+    REQUIRE(scene.completeScene(view));
+    REQUIRE(scene.tileSources().size() == 2);
+
+    TileBuilder builder(scene);
+    builder.init();
+
+    TileID tileID(0, 0, 0);
+    auto rawTile = std::make_shared<std::vector<char>>(shapesTile());
+    // Tiles of the plain and the quantized source
+    std::unique_ptr<Tile> tiles[2];
+
+    for (const auto& source : scene.tileSources()) {
+        bool quantized = source->name() == "quantized";
+        INFO("source " << source->name());
+        CHECK(source->quantizedGeometry() == quantized);
+
+        auto task = source->createTask(tileID);
+        static_cast<BinaryTileTask&>(*task).rawTileData = rawTile;
+        auto tileData = source->parse(*task);
+        REQUIRE(tileData);
+        REQUIRE(tileData->lazyLayers.size() == 1);
+
+        auto& layer = *tileData->lazyLayers.front();
+        Feature feature(source->id());
+        int numFeatures = 0;
+        layer.rewind();
+        while (layer.nextFeature(feature)) {
+            layer.getGeometry(feature);
+            CHECK(feature.isQuantized() == quantized);
+            CHECK(feature.coordinates.empty() == quantized);
+            numFeatures++;
+        }
+        CHECK(numFeatures == 2);
+
+        auto& tile = tiles[quantized ? 1 : 0];
+        tile = std::make_unique<Tile>(tileID, source->id());
+        builder.build(*tile, *tileData, *source);
+    }
+
+    REQUIRE(tiles[0]);
+    REQUIRE(tiles[1]);
+
+    // Tile units convert to the same tile coordinates as decoded by the plain source, so both
+    // tiles have identical vertices
+    for (const auto& style : scene.styles()) {
+        if (style->getName() != "polygons" && style->getName() != "lines") { continue; }
+        INFO("style " << style->getName());
+        const auto& plainMesh = tiles[0]->getMesh(*style);
+        const auto& quantizedMesh = tiles[1]->getMesh(*style);
+        REQUIRE(plainMesh);
+        REQUIRE(quantizedMesh);
+
+        std::vector<char> plainBytes, quantizedBytes;
+        REQUIRE(plainMesh->serialize(plainBytes));
+        REQUIRE(quantizedMesh->serialize(quantizedBytes));
+        CHECK(plainBytes == quantizedBytes);
+    }
+}
+
+TEST_CASE("MVT geometry is decoded into tile units only when quantized", TAGS) {
+    enum { moveTo = 1, lineTo = 2 };
+
+    auto decode = [](Mvt::ParserContext& _ctx, const std::vector<uint32_t>& _commands) {
+        std::vector<char> packed;
+        for (auto value : _commands) { appendVarint(packed, value); }
+        Mvt::getGeometry(_ctx, protobuf::message(packed.data(), packed.size()), true);
+    };
+
+    Mvt::ParserContext ctx(0);
+    ctx.tileExtent = 4096;
+
+    decode(ctx, { command(moveTo, 1), zigzag(100), zigzag(3000),
+                  command(lineTo, 2), zigzag(1000), zigzag(0), zigzag(0), zigzag(0) });
+    CHECK(ctx.geometry.quantizable);
+    CHECK(ctx.geometry.coordinates.empty());
+    CHECK(ctx.geometry.sizes == std::vector<int>({ 2 }));
+    REQUIRE(ctx.geometry.tileCoordinates.size() == 2);
+    CHECK(ctx.geometry.tileCoordinates[1] == QuantizedPoint(1100, 1096));
+
+    // Geometry beyond the range of tile units continues in tile coordinates
+    decode(ctx, { command(moveTo, 1), zigzag(100), zigzag(3000),
+                  command(lineTo, 1), zigzag(40000), zigzag(0) });
+    CHECK(!ctx.geometry.quantizable);
+    CHECK(ctx.geometry.tileCoordinates.empty());
+    REQUIRE(ctx.geometry.coordinates.size() == 2);
+    const double scale = 1.0 / 4095;
+    CHECK(ctx.geometry.coordinates[0] == Point(scale * 100, scale * 1096));
+    CHECK(ctx.geometry.coordinates[1] == Point(scale * 40100, scale * 1096));
+}
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+#include "selection/selectionIndex.h"
+#include "tile/tileCache.h"
+
+#include <map>
+#include <random>
+
+using namespace Tangram;
+
+#define TAGS "[TileCache]"
+
+namespace {
+
+// Tiles of the same memory usage, which only have a selection index
+std::shared_ptr<Tile> makeTile(TileID _id, float _buildTime) {
+    Feature feature;
+    feature.geometryType = GeometryType::points;
+    feature.points = { { 0.5f, 0.5f } };
+
+    auto index = std::make_unique<SelectionIndex>();
+    index->add(1, feature);
+    index->build();
+
+    auto tile = std::make_shared<Tile>(_id, 0);
+    tile->setSelectionIndex(std::move(index));
+    tile->setBuildTime(_buildTime);
+    return tile;
+}
+
+}
+
+TEST_CASE("Cached tiles can be found until they are taken", TAGS) {
+    TileCache cache(1 << 20);
+
+    auto tile = std::make_shared<Tile>(TileID(1, 2, 3), 7);
+    cache.put(7, tile);
+
+    CHECK(cache.getNumEntries() == 1);
+    CHECK(cache.contains(7, TileID(1, 2, 3)) == tile);
+    CHECK(cache.contains(8, TileID(1, 2, 3)) == nullptr);
+    CHECK(cache.contains(7, TileID(2, 1, 3)) == nullptr);
+
+    CHECK(cache.get(7, TileID(1, 2, 3)) == tile);
+    CHECK(cache.get(7, TileID(1, 2, 3)) == nullptr);
+    CHECK(cache.getNumEntries() == 0);
+
+    MapStats stats;
+    cache.getStats(stats);
+    CHECK(stats.tileCacheHits == 1);
+    CHECK(stats.tileCacheMisses == 1);
+}
+
+TEST_CASE("TileCache index stays consistent over many insertions and removals", TAGS) {
+    TileCache cache(1 << 20);
+    std::map<TileCacheKey, std::shared_ptr<Tile>> expected;
+
+    std::mt19937 random(0);
+    for (int i = 0; i < 20000; i++) {
+        int32_t source = random() % 3;
+        TileID id(random() % 16, random() % 16, 4);
+        TileCacheKey key(source, id);
+
+        if (random() % 3) {
+            auto tile = std::make_shared<Tile>(id, source);
+            cache.put(source, tile);
+            expected[key] = tile;
+        } else {
+            auto it = expected.find(key);
+            auto tile = cache.get(source, id);
+            if (it == expected.end()) {
+                REQUIRE(tile == nullptr);
+            } else {
+                REQUIRE(tile == it->second);
+                expected.erase(it);
+            }
+        }
+        REQUIRE(cache.getNumEntries() == expected.size());
+    }
+
+    for (auto& entry : expected) {
+        REQUIRE(cache.contains(entry.first.first, entry.first.second) == entry.second);
+    }
+
+    cache.clear();
+    CHECK(cache.getNumEntries() == 0);
+    CHECK(cache.contains(0, TileID(0, 0, 4)) == nullptr);
+}
+
+TEST_CASE("TileCache evicts cheap tiles before expensive tiles of the same age", TAGS) {
+    size_t tileSize = makeTile(TileID(0, 0, 4), 0)->getMemoryUsage();
+    REQUIRE(tileSize > 0);
+
+    // Room for two tiles
+    TileCache cache(tileSize * 2 + tileSize / 2);
+
+    // The expensive tile is the least recently used one
+    cache.put(0, makeTile(TileID(0, 0, 4), 100.f));
+    cache.put(0, makeTile(TileID(1, 0, 4), 0.f));
+    cache.put(0, makeTile(TileID(2, 0, 4), 0.f));
+
+    CHECK(cache.getNumEntries() == 2);
+    CHECK(cache.contains(0, TileID(0, 0, 4)) != nullptr);
+    CHECK(cache.contains(0, TileID(1, 0, 4)) == nullptr);
+    CHECK(cache.contains(0, TileID(2, 0, 4)) != nullptr);
+
+    // But it does not stay forever as cheap tiles come and go
+    for (int x = 3; x < 1000; x++) { cache.put(0, makeTile(TileID(x % 16, x / 16, 6), 0.f)); }
+    CHECK(cache.contains(0, TileID(0, 0, 4)) == nullptr);
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE( "Feature stores lines in a flat coordinate buffer", "[Core][TileData]" ) {
+
+    Feature feature;
+    feature.geometryType = GeometryType::lines;
+
+    std::vector<Point> a = { {0, 0}, {1, 0}, {1, 1} };
+    std::vector<Point> b = { {2, 2}, {3, 3} };
+    feature.addLine(a);
+    feature.addLine(b);
+
+    auto lines = feature.lines();
+    REQUIRE(lines.size() == 2);
+    REQUIRE(feature.coordinates.size() == 5);
+    REQUIRE(lines[0].size() == 3);
+    REQUIRE(lines[1].size() == 2);
+    REQUIRE(lines[0].back() == Point(1, 1));
+    REQUIRE(lines[1].front() == Point(2, 2));
+
+    size_t count = 0;
+    for (const auto& line : lines) { count += line.size(); }
+    REQUIRE(count == 5);
+
+    feature.clearGeometry();
+    REQUIRE(feature.lines().size() == 0);
+    REQUIRE(feature.coordinates.empty());
+}
+
+TEST_CASE( "Feature stores polygon rings in a flat coordinate buffer", "[Core][TileData]" ) {
+
+    Feature feature;
+    feature.geometryType = GeometryType::polygons;
+
+    std::vector<Point> outer = { {0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0} };
+    std::vector<Point> inner = { {1, 1}, {1, 2}, {2, 2}, {1, 1} };
+
+    feature.beginPolygon();
+    feature.addRing(outer);
+    feature.addRing(inner.rbegin(), inner.rend());
+
+    feature.beginPolygon();
+    size_t begin = feature.coordinates.size();
+    feature.coordinates.insert(feature.coordinates.end(), outer.begin(), outer.end());
+    feature.endRing(begin);
+
+    auto polygons = feature.polygons();
+    REQUIRE(polygons.size() == 2);
+    REQUIRE(polygons[0].size() == 2);
+    REQUIRE(polygons[1].size() == 1);
+    REQUIRE(polygons[0][1].size() == 4);
+    REQUIRE(polygons[0][1][1] == Point(2, 2));
+    REQUIRE(polygons[1][0].size() == 5);
+
+    size_t rings = 0;
+    for (const auto& polygon : polygons) { rings += polygon.size(); }
+    REQUIRE(rings == 3);
+}
+
+TEST_CASE( "Quantized feature geometry is converted to tile coordinates", "[Core][TileData]" ) {
+
+    Feature feature;
+    feature.geometryType = GeometryType::polygons;
+    feature.quantizedScale = 1.0 / 4;
+    REQUIRE(feature.isQuantized());
+
+    std::vector<QuantizedPoint> ring = { {0, 0}, {4, 0}, {4, 4}, {0, 0} };
+
+    feature.beginPolygon();
+    feature.quantizedCoordinates.insert(feature.quantizedCoordinates.end(), ring.begin(), ring.end());
+    feature.endRing(0);
+
+    auto polygons = feature.quantizedPolygons();
+    REQUIRE(polygons.size() == 1);
+    REQUIRE(polygons[0][0].size() == 4);
+    REQUIRE(polygons[0][0][2] == QuantizedPoint(4, 4));
+    REQUIRE(feature.coordinates.empty());
+
+    Feature dequantized;
+    feature.dequantize(dequantized);
+    REQUIRE(!dequantized.isQuantized());
+    REQUIRE(dequantized.polygons().size() == 1);
+    REQUIRE(dequantized.polygons()[0][0][1] == Point(1, 0));
+    REQUIRE(dequantized.polygons()[0][0][2] == Point(1, 1));
+
+    feature.clearGeometry();
+    REQUIRE(!feature.isQuantized());
+    REQUIRE(feature.quantizedCoordinates.empty());
+}
@@ -0,0 +1,279 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "selection/selectionIndex.h"
+#include "tile/tile.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileGeometryCache.h"
+#include "view/view.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <dirent.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+using namespace Tangram;
+
+#define TAGS "[TileGeometryCache]"
+
+namespace {
+
+std::string tempDirectory() {
+    char path[] = "/tmp/tangram-geometry-XXXXXX";
+    REQUIRE(mkdtemp(path) != nullptr);
+    return std::string(path) + "/";
+}
+
+TileGeometryCache::Meshes meshes(size_t _size) {
+    TileGeometryCache::Meshes meshes;
+    meshes.emplace_back(1, std::vector<char>(_size, 'a'));
+    meshes.emplace_back(3, std::vector<char>());
+    return meshes;
+}
+
+// Read the entry for @_tileID, returning the sizes of its meshes by style
+std::vector<std::pair<uint32_t, size_t>> read(TileGeometryCache& _cache, const TileID& _tileID,
+                                              float _pixelScale = 1.f) {
+    std::vector<std::pair<uint32_t, size_t>> sizes;
+    TileGeometryCache::SelectionFeatures selection;
+    std::vector<char> selectionIndex;
+    _cache.get("source", _tileID, _pixelScale, [&](uint32_t _styleId, const char*, size_t _size) {
+        sizes.emplace_back(_styleId, _size);
+        return true;
+    }, selection, selectionIndex);
+    return sizes;
+}
+
+// Set the modification time of files in @_directory written in the last minute to @_age
+// seconds ago
+void setFileAge(const std::string& _directory, time_t _age) {
+    DIR* dir = opendir(_directory.c_str());
+    REQUIRE(dir);
+    time_t now = std::time(nullptr);
+    struct utimbuf times;
+    times.actime = times.modtime = now - _age;
+    while (struct dirent* dirent = readdir(dir)) {
+        auto path = _directory + dirent->d_name;
+        struct stat st;
+        if (dirent->d_name[0] == '.' || stat(path.c_str(), &st) != 0) { continue; }
+        if (st.st_mtime > now - 60) { utime(path.c_str(), &times); }
+    }
+    closedir(dir);
+}
+
+const char* interactiveYaml = R"END(
+sources:
+    src:
+        type: GeoJSON
+        url: https://localhost/{z}/{x}/{y}.json
+layers:
+    parks:
+        data: { source: src }
+        draw:
+            polygons:
+                color: green
+                order: 1
+                interactive: true
+                outline: { style: lines, color: red, width: 1px }
+)END";
+
+}
+
+TEST_CASE("Geometry cache entries are restored with their selection features", TAGS) {
+    auto directory = tempDirectory();
+    TileGeometryCache cache(directory, "scene", 1 << 20, 0);
+
+    auto props = std::make_shared<Properties>();
+    props->set("name", "park");
+    props->set("area", 42.0);
+    TileGeometryCache::SelectionFeatures selection;
+    selection[7] = props;
+
+    TileID tileID(1, 2, 3);
+    cache.put("source", tileID, 1.f, meshes(100), selection, std::vector<char>(10, 'b'));
+
+    std::vector<std::pair<uint32_t, std::string>> restored;
+    TileGeometryCache::SelectionFeatures restoredSelection;
+    std::vector<char> restoredIndex;
+    bool found = cache.get("source", tileID, 1.f, [&](uint32_t _styleId, const char* _data, size_t _size) {
+        restored.emplace_back(_styleId, std::string(_data, _size));
+        return true;
+    }, restoredSelection, restoredIndex);
+
+    REQUIRE(found);
+    REQUIRE(restored.size() == 2);
+    CHECK(restored[0].first == 1);
+    CHECK(restored[0].second == std::string(100, 'a'));
+    CHECK(restored[1].first == 3);
+    CHECK(restored[1].second.empty());
+
+    REQUIRE(restoredSelection.size() == 1);
+    auto& restoredProps = restoredSelection.find(7)->second;
+    CHECK(restoredProps->getString("name") == "park");
+    CHECK(restoredProps->getNumber("area") == 42.0);
+    CHECK(restoredIndex == std::vector<char>(10, 'b'));
+
+    // Other tiles, sources and pixel scales miss
+    CHECK(read(cache, TileID(2, 1, 3)).empty());
+    CHECK(read(cache, tileID, 2.f).empty());
+
+    // Entries of another scene configuration are not used, even in the same directory
+    TileGeometryCache otherScene(directory, "other scene", 1 << 20, 0);
+    CHECK(read(otherScene, tileID).empty());
+
+    // A new instance for the same scene finds the entry of the earlier one
+    TileGeometryCache sameScene(directory, "scene", 1 << 20, 0);
+    CHECK(sameScene.getUsage() == cache.getUsage());
+    CHECK(read(sameScene, tileID).size() == 2);
+
+    MapStats stats;
+    cache.getStats(stats);
+    CHECK(stats.geometryCacheHits == 1);
+    CHECK(stats.geometryCacheMisses == 2);
+}
+
+TEST_CASE("Geometry cache rejects entries which the reader cannot restore", TAGS) {
+    TileGeometryCache cache(tempDirectory(), "scene", 1 << 20, 0);
+
+    TileID tileID(1, 2, 3);
+    cache.put("source", tileID, 1.f, meshes(100), {});
+
+    TileGeometryCache::SelectionFeatures selection;
+    std::vector<char> selectionIndex;
+    CHECK(!cache.get("source", tileID, 1.f, [](uint32_t, const char*, size_t) { return false; },
+                     selection, selectionIndex));
+
+    // The entry was removed
+    CHECK(read(cache, tileID).empty());
+    CHECK(cache.getUsage() == 0);
+}
+
+TEST_CASE("Geometry cache rejects entries with more records than their size can hold", TAGS) {
+    auto directory = tempDirectory();
+    TileGeometryCache cache(directory, "scene", 1 << 20, 0);
+
+    TileID tileID(1, 2, 3);
+    cache.put("source", tileID, 1.f, meshes(100), {});
+
+    // Overwrite the number of meshes, which follows the 44 bytes of the entry header
+    DIR* dir = opendir(directory.c_str());
+    REQUIRE(dir);
+    std::string path;
+    while (struct dirent* dirent = readdir(dir)) {
+        if (dirent->d_name[0] != '.') { path = directory + dirent->d_name; }
+    }
+    closedir(dir);
+    FILE* file = fopen(path.c_str(), "r+b");
+    REQUIRE(file);
+    uint32_t numMeshes = 0xffffffff;
+    fseek(file, 44, SEEK_SET);
+    fwrite(&numMeshes, sizeof(numMeshes), 1, file);
+    fclose(file);
+
+    CHECK(read(cache, tileID).empty());
+
+    // The entry was removed
+    CHECK(access(path.c_str(), F_OK) != 0);
+    CHECK(cache.getUsage() == 0);
+}
+
+TEST_CASE("Geometry cache removes least recently used entries to stay within its size", TAGS) {
+    TileGeometryCache cache(tempDirectory(), "scene", 10000, 0);
+
+    for (int x = 0; x < 20; x++) {
+        cache.put("source", TileID(x, 0, 5), 1.f, meshes(1000), {});
+        // Keep the first tile in use
+        CHECK(read(cache, TileID(0, 0, 5)).size() == 2);
+    }
+    CHECK(cache.getUsage() <= 10000);
+
+    CHECK(read(cache, TileID(0, 0, 5)).size() == 2);
+    CHECK(read(cache, TileID(19, 0, 5)).size() == 2);
+    CHECK(read(cache, TileID(1, 0, 5)).empty());
+}
+
+TEST_CASE("Geometry cache keeps entries last read in an earlier run", TAGS) {
+    auto directory = tempDirectory();
+    {
+        TileGeometryCache cache(directory, "scene", 1 << 20, 0);
+        cache.put("source", TileID(0, 0, 5), 1.f, meshes(1000), {});
+        setFileAge(directory, 2000);
+        cache.put("source", TileID(1, 0, 5), 1.f, meshes(1000), {});
+        setFileAge(directory, 1000);
+
+        // Reading the older entry marks it as used
+        CHECK(read(cache, TileID(0, 0, 5)).size() == 2);
+    }
+
+    // The next run has room for one entry, the one used last
+    TileGeometryCache cache(directory, "scene", 1500, 0);
+    CHECK(read(cache, TileID(1, 0, 5)).empty());
+    CHECK(read(cache, TileID(0, 0, 5)).size() == 2);
+}
+
+TEST_CASE("Features of tiles restored from the geometry cache can be picked", TAGS) {
+    MockPlatform platform;
+    SceneOptions options{interactiveYaml, Url()};
+    options.numTileWorkers = 0;
+    options.prefetchTiles = false;
+    options.diskCacheDir = tempDirectory();
+    options.diskGeometryCacheSize = 1 << 20;
+    Scene scene(platform, std::move(options));
+    REQUIRE(scene.load());
+    View view(256, 256);
+    REQUIRE(scene.completeScene(view));
+    REQUIRE(scene.geometryCache());
+    REQUIRE(scene.tileSources().size() == 1);
+    const auto& source = *scene.tileSources().front();
+
+    Feature park;
+    park.geometryType = GeometryType::polygons;
+    park.props.set("name", "park");
+    park.beginPolygon();
+    std::vector<Point> ring = { { 0.2f, 0.2f }, { 0.4f, 0.2f }, { 0.4f, 0.4f }, { 0.2f, 0.4f }, { 0.2f, 0.2f } };
+    park.addRing(ring.begin(), ring.end());
+
+    TileData tileData;
+    tileData.layers.emplace_back("parks");
+    tileData.layers.back().features.push_back(std::move(park));
+
+    TileBuilder builder(scene);
+    builder.init();
+
+    // Pick the park in the tile built from data and in the tile restored from the cache
+    for (int build = 0; build < 2; build++) {
+        INFO("build " << build);
+        Tile tile(TileID(1, 2, 3), source.id());
+        builder.build(tile, tileData, source);
+
+        const auto* index = tile.getSelectionIndex();
+        REQUIRE(index);
+        std::vector<SelectionIndex::Hit> hits;
+        index->query({ 0.3f, 0.3f }, 0.01f, hits);
+        REQUIRE(hits.size() == 1);
+
+        auto props = tile.getSelectionFeature(hits[0].selectionColor);
+        REQUIRE(props);
+        CHECK(props->getString("name") == "park");
+
+        // Restored polygons and outlines share the selection color of their meshes
+        CHECK(tile.getSelectionFeatures().size() == 1);
+
+        hits.clear();
+        index->query({ 0.6f, 0.6f }, 0.01f, hits);
+        CHECK(hits.empty());
+    }
+
+    MapStats stats;
+    scene.geometryCache()->getStats(stats);
+    CHECK(stats.geometryCacheHits == 1);
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 
+#include "data/missingTileCache.h"
 #include "data/tileSource.h"
 #include "mockPlatform.h"
 #include "tile/tileManager.h"
@@ -8,7 +9,9 @@
 #include "util/fastmap.h"
 #include "view/view.h"
 
+#include <chrono>
 #include <deque>
+#include <thread>
 
 using namespace Tangram;
 
@@ -310,3 +313,56 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,0));
 
 }
+
+TEST_CASE( "Reload visible Tile once its load failure expired", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    MockPlatform platform;
+    TestTileManager tileManager(platform, worker);
+
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    source->missingTiles().setTimeout(MissingTileCache::Failure::notFound, std::chrono::milliseconds(50));
+    source->missingTiles().put(TileID{0,0,0}, MissingTileCache::Failure::notFound);
+
+    /// Tile stays empty while its failure is remembered
+    std::set<TileID> visibleTiles = {TileID{0,0,0}};
+    tileManager.updateTiles(viewState, visibleTiles);
+    tileManager.updateTiles(viewState, visibleTiles);
+    REQUIRE(source->tileTaskCount == 0);
+
+    /// and is loaded again afterwards
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    tileManager.updateTiles(viewState, visibleTiles);
+    REQUIRE(source->tileTaskCount == 1);
+
+    worker.processTask();
+    tileManager.updateTiles(viewState, visibleTiles);
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(source->tileTaskCount == 1);
+}
+
+TEST_CASE( "Do not reload visible Tile after a load failure not remembered by its source", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    MockPlatform platform;
+    TestTileManager tileManager(platform, worker);
+
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    std::set<TileID> visibleTiles = {TileID{0,0,0}};
+    tileManager.updateTiles(viewState, visibleTiles);
+    REQUIRE(source->tileTaskCount == 1);
+
+    /// Task fails without an entry in the source's MissingTileCache
+    worker.dropTask();
+    REQUIRE(!source->missingTiles().contains(TileID{0,0,0}));
+
+    tileManager.updateTiles(viewState, visibleTiles);
+    tileManager.updateTiles(viewState, visibleTiles);
+    REQUIRE(source->tileTaskCount == 1);
+    REQUIRE(worker.tasks.empty());
+    REQUIRE(tileManager.numLoadingTiles() == 0);
+}
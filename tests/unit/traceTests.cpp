@@ -0,0 +1,91 @@
+#include "catch.hpp"
+
+#include "debug/trace.h"
+
+#include "rapidjson/document.h"
+
+#include <string>
+#include <thread>
+
+using namespace Tangram;
+
+static rapidjson::Document parseTrace(const std::string& _json) {
+    rapidjson::Document doc;
+    doc.Parse(_json.c_str());
+    REQUIRE(!doc.HasParseError());
+    REQUIRE(doc["traceEvents"].IsArray());
+    return doc;
+}
+
+TEST_CASE( "Trace records nothing while disabled", "[Core][Trace]" ) {
+
+    Trace::start();
+    Trace::stop();
+
+    Trace::begin("disabled");
+    Trace::end("disabled");
+    { Trace::scope trace("disabled"); }
+
+    auto doc = parseTrace(Trace::toJson());
+    for (auto& event : doc["traceEvents"].GetArray()) {
+        REQUIRE(std::string(event["name"].GetString()) != "disabled");
+    }
+}
+
+TEST_CASE( "Trace exports events of all threads as Chrome trace JSON", "[Core][Trace]" ) {
+
+    Trace::start();
+
+    { Trace::scope trace("main"); }
+
+    std::thread worker([] {
+        Trace::setThreadName("worker");
+        Trace::begin("work");
+        Trace::counter("items", 42);
+        Trace::end("work");
+    });
+    worker.join();
+
+    auto doc = parseTrace(Trace::stop());
+
+    int begins = 0, ends = 0, counters = 0, names = 0;
+    uint32_t mainTid = 0, workerTid = 0;
+    for (auto& event : doc["traceEvents"].GetArray()) {
+        std::string ph = event["ph"].GetString();
+        std::string name = event["name"].GetString();
+        if (ph == "B") { begins++; }
+        if (ph == "E") { ends++; }
+        if (ph == "C") {
+            counters++;
+            REQUIRE(name == "items");
+            REQUIRE(event["args"]["value"].GetInt64() == 42);
+        }
+        if (ph == "M") {
+            names++;
+            REQUIRE(std::string(event["args"]["name"].GetString()) == "worker");
+        }
+        if (name == "main") { mainTid = event["tid"].GetUint(); }
+        if (name == "work") { workerTid = event["tid"].GetUint(); }
+    }
+    REQUIRE(begins == 2);
+    REQUIRE(ends == 2);
+    REQUIRE(counters == 1);
+    REQUIRE(names == 1);
+    REQUIRE(mainTid != 0);
+    REQUIRE(workerTid != 0);
+    REQUIRE(mainTid != workerTid);
+}
+
+TEST_CASE( "Trace keeps the most recent events of a thread", "[Core][Trace]" ) {
+
+    Trace::start();
+    for (size_t i = 0; i < Trace::bufferSize + 10; i++) {
+        Trace::counter("count", i);
+    }
+    auto doc = parseTrace(Trace::stop());
+
+    auto events = doc["traceEvents"].GetArray();
+    REQUIRE(events.Size() == Trace::bufferSize);
+    REQUIRE(events[0]["args"]["value"].GetInt64() == 10);
+    REQUIRE(events[events.Size() - 1]["args"]["value"].GetInt64() == int64_t(Trace::bufferSize + 9));
+}
@@ -2,6 +2,7 @@
 
 #include "data/tileData.h"
 #include "mockPlatform.h"
+#include "scene/filterProgram.h"
 #include "scene/filters.h"
 #include "scene/scene.h"
 #include "scene/sceneLoader.h"
@@ -238,3 +239,74 @@ TEST_CASE("Sequences in filters implicitly create an 'any' filter", "[filters][c
     REQUIRE(filter.eval(bmw1, ctx));
     REQUIRE(!filter.eval(bike, ctx));
 }
+
+TEST_CASE("Compiled filter programs match the filter tree evaluation", "[filters][core][yaml]") {
+    init();
+    std::vector<std::string> filters = {
+        "filter: { series: '3' }",
+        "filter: { name : [civic, bmw320i] }",
+        "filter: { name : [civic, 4, bmw320i, 2] }",
+        "filter: { wheel : [2, 3] }",
+        "filter: {wheel : {min : 3}}",
+        "filter: {wheel : {max : 2}}",
+        "filter: {wheel : {min : 2, max : 5}}",
+        "filter: {any : [{name : civic}, {name : bmw320i}]}",
+        "filter: {all : [ {name : civic}, {brand : honda}, {wheel: 4} ] }",
+        "filter: {none : [{name : civic}, {name : bmw320i}]}",
+        "filter: {not : { any: [{name : civic}, {name : bmw320i}]}}",
+        "filter: {any : [{all : [{brand : honda}, {wheel : 2}]}, {none : [{type : car}]}]}",
+        "filter: {all : [{any : [{brand : bmw}, {series : CB}]}, {check : available}]}",
+        "filter: {$zoom : 10}",
+        "filter: {$zoom : {min : 11}}",
+        "filter: { drive : true }",
+        "filter: { drive : false}",
+        "filter: { not_a_property : false}",
+        "filter: { serial : [4398046511104] }",
+        "filter: [ { brand: 'bmw' }, { type: 'car' } ]",
+    };
+
+    for (auto& yaml : filters) {
+        Filter filter = load(yaml);
+        FilterProgram program(filter);
+
+        INFO(yaml);
+        for (auto* feature : { &civic, &bmw1, &bike }) {
+            REQUIRE(program.eval(*feature, ctx) == filter.eval(*feature, ctx));
+        }
+    }
+}
+
+TEST_CASE("Compiled filter programs match range boundaries like the filter tree", "[filters][core][yaml]") {
+    init();
+    // Bounds are stored as float: 0.1 is rounded up, 0.7 down and 0.5 is exact
+    Feature lower, upper, exact, area;
+    lower.props.set("height", 0.1);
+    upper.props.set("height", 0.7);
+    exact.props.set("height", 0.5);
+    // Pixel area bounds are scaled to square meters at the tile zoom
+    area.props.set("area", 100 * ctx.getPixelAreaScale());
+
+    struct Case { std::string yaml; std::vector<bool> matches; };
+    std::vector<Case> cases = {
+        { "filter: { height: { min: 0.1 } }", { false, true, true, false } },
+        { "filter: { height: { max: 0.7 } }", { true, false, true, false } },
+        { "filter: { height: { min: 0.7 } }", { false, true, false, false } },
+        { "filter: { height: { min: 0.5, max: 1 } }", { false, true, true, false } },
+        { "filter: { height: { max: 0.5 } }", { true, true, false, false } },
+        { "filter: { area: { min: 100px2 } }", { false, false, false, true } },
+        { "filter: { area: { max: 100px2 } }", { false, false, false, false } },
+    };
+
+    for (auto& test : cases) {
+        Filter filter = load(test.yaml);
+        FilterProgram program(filter);
+
+        INFO(test.yaml);
+        size_t i = 0;
+        for (auto* feature : { &lower, &upper, &exact, &area }) {
+            REQUIRE(filter.eval(*feature, ctx) == test.matches[i]);
+            REQUIRE(program.eval(*feature, ctx) == test.matches[i]);
+            i++;
+        }
+    }
+}